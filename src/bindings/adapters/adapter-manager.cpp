@@ -1,5 +1,6 @@
 #include "adapter-manager.hpp"
 #include "../config/build-config.hpp"
+#include "../inference/utf8.hpp"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -46,8 +47,9 @@ AdapterResult TextAdapter::convertInput(const std::string& input, std::string& o
         return AdapterResult::ERROR_INITIALIZATION_FAILED;
     }
     
-    // Basic text processing
+    // Basic text processing; malformed UTF-8 is replaced with U+FFFD
     output = input;
+    inference::utf8::repair(output);
     
     // Normalize whitespace
     std::regex whitespace_regex("\\s+");
@@ -65,8 +67,9 @@ AdapterResult TextAdapter::convertOutput(const std::string& input, std::string&
         return AdapterResult::ERROR_INITIALIZATION_FAILED;
     }
     
-    // Output processing - just pass through for now
+    // Output processing - pass through with malformed UTF-8 replaced
     output = input;
+    inference::utf8::repair(output);
     return AdapterResult::SUCCESS;
 }
 
@@ -75,12 +78,9 @@ AdapterResult TextAdapter::validate(const std::string& data) {
         return AdapterResult::ERROR_INVALID_CONFIG;
     }
     
-    // Check for valid UTF-8 (simplified check)
-    for (char c : data) {
-        if (static_cast<unsigned char>(c) > 127) {
-            // Extended ASCII - would need proper UTF-8 validation
-            continue;
-        }
+    // Well-formed UTF-8 only (SIMD-validated; see inference/utf8.hpp)
+    if (!inference::utf8::isValid(data)) {
+        return AdapterResult::ERROR_UNSUPPORTED_FORMAT;
     }
     
     return AdapterResult::SUCCESS;
@@ -289,7 +289,7 @@ AdapterResult RKLLMAdapter::initialize() {
         initialized_ = true;
         std::cout << "[RKLLMAdapter] Initialized successfully (production mode)" << std::endl;
         return AdapterResult::SUCCESS;
-        
+    
     } catch (const std::exception& e) {
         std::cerr << "[RKLLMAdapter] Initialization failed: " << e.what() << std::endl;
         return AdapterResult::ERROR_INITIALIZATION_FAILED;
@@ -390,12 +390,12 @@ AdapterFactory::AdapterFactory() {
     
     std::cout << "[AdapterFactory] Registering json adapter..." << std::endl;
     registerAdapter("json", []() { return std::make_unique<JsonAdapter>(); });
-    
+
 #if 0 // Removed RKLLM_COMPILE_MODE_REAL
     std::cout << "[AdapterFactory] Registering rkllm adapter..." << std::endl;
     registerAdapter("rkllm", []() { return std::make_unique<RKLLMAdapter>(); });
 #endif
-    
+
     std::cout << "[AdapterFactory] Setting up format mapping..." << std::endl;
     // Set up format mapping
     format_map_[DataFormat::RAW_TEXT] = "text";
@@ -405,7 +405,7 @@ AdapterFactory::AdapterFactory() {
 #else
     format_map_[DataFormat::CUSTOM] = "text";  // Default fallback to text format
 #endif
-    
+
     std::cout << "[AdapterFactory] Constructor completed successfully" << std::endl;
 }
 
@@ -619,7 +619,7 @@ AdapterResult AdapterManager::loadDefaultAdapters() {
 #else
     std::vector<std::string> default_adapters = {"text", "json"};  // Default supported adapters
 #endif
-    
+
     for (const auto& name : default_adapters) {
         auto result = loadAdapterInternal(name);  // Use internal method (no double lock)
         if (result != AdapterResult::SUCCESS) {
@@ -42,6 +42,17 @@ TEST(AdapterManagerTest, TextAdapterValidation) {
     std::string special = "Special chars: äöü 中文 🎉";
     AdapterResult validation_result = adapter.validate(special);
     EXPECT_EQ(AdapterResult::SUCCESS, validation_result);
+    
+    // Malformed UTF-8 is rejected by validate and repaired by convertInput
+    std::string truncated = "中文";
+    truncated.pop_back();
+    EXPECT_EQ(AdapterResult::ERROR_UNSUPPORTED_FORMAT, adapter.validate(truncated));
+    EXPECT_EQ(AdapterResult::ERROR_UNSUPPORTED_FORMAT, adapter.validate("overlong \xC0\xAF"));
+    
+    std::string repaired;
+    EXPECT_EQ(AdapterResult::SUCCESS, adapter.convertInput(truncated + " ok", repaired));
+    EXPECT_EQ(AdapterResult::SUCCESS, adapter.validate(repaired));
+    EXPECT_EQ(std::string("中\xEF\xBF\xBD ok"), repaired);
 }
 
 TEST(AdapterManagerTest, TextAdapterCleanup) {
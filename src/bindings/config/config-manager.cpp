@@ -1,4 +1,5 @@
 #include "config-manager.hpp"
+#include "json-parser.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -12,9 +13,22 @@ namespace config {
 // Static members
 std::map<std::string, ModelConfig> ConfigManager::models_;
 std::map<std::string, HardwareProfile> ConfigManager::hardware_profiles_;
+std::map<std::string, MemoryProfile> ConfigManager::memory_profiles_;
+PreloadConfig ConfigManager::preload_config_;
+SchedulingConfig ConfigManager::scheduling_config_;
 std::string ConfigManager::project_root_;
 bool ConfigManager::initialized_ = false;
 
+double SchedulingConfig::tenantWeight(const std::string& tenant) const {
+    auto it = tenant_weights.find(tenant);
+    return it != tenant_weights.end() ? it->second : 1.0;
+}
+
+double SchedulingConfig::classWeight(const std::string& request_class) const {
+    auto it = class_weights.find(request_class);
+    return it != class_weights.end() ? it->second : 1.0;
+}
+
 bool ModelConfig::isValid() const {
     return !id.empty() && !path.empty() && 
            max_context_len > 0 && max_new_tokens > 0 &&
@@ -97,12 +111,16 @@ bool ConfigManager::loadConfig(const std::string& config_file) {
         // Parse models (simplified JSON parsing)
         parseModelsFromJson(json_content);
         parseHardwareProfilesFromJson(json_content);
+        parseMemoryProfilesFromJson(json_content);
+        parsePreloadFromJson(json_content);
+        parseSchedulingFromJson(json_content);
         
         initialized_ = true;
-        std::cout << "[ConfigManager] Loaded " << models_.size() << " models and " 
-                  << hardware_profiles_.size() << " hardware profiles" << std::endl;
+        std::cout << "[ConfigManager] Loaded " << models_.size() << " models, " 
+                  << hardware_profiles_.size() << " hardware profiles and "
+                  << memory_profiles_.size() << " memory profiles" << std::endl;
         return true;
-        
+    
     } catch (const std::exception& e) {
         std::cerr << "[ConfigManager] Error loading config: " << e.what() << std::endl;
         return false;
@@ -148,6 +166,41 @@ HardwareProfile ConfigManager::getHardwareProfile(const std::string& profile_nam
     return default_profile;
 }
 
+MemoryProfile ConfigManager::getMemoryProfile(const std::string& profile_name) {
+    if (!initialized_) {
+        loadConfig();
+    }
+    
+    auto it = memory_profiles_.find(profile_name);
+    if (it != memory_profiles_.end()) {
+        return it->second;
+    }
+    
+    // Unknown profile - load with runtime defaults
+    MemoryProfile default_profile;
+    default_profile.name = "default";
+    return default_profile;
+}
+
+MemoryProfile ConfigManager::getMemoryProfileForHardware(const std::string& hardware_profile) {
+    HardwareProfile hw_profile = getHardwareProfile(hardware_profile);
+    return getMemoryProfile(hw_profile.memory_profile);
+}
+
+PreloadConfig ConfigManager::getPreloadConfig() {
+    if (!initialized_) {
+        loadConfig();
+    }
+    return preload_config_;
+}
+
+SchedulingConfig ConfigManager::getSchedulingConfig() {
+    if (!initialized_) {
+        loadConfig();
+    }
+    return scheduling_config_;
+}
+
 std::string ConfigManager::selectBestModel(const std::string& hardware_profile) {
     if (!initialized_) {
         loadConfig();
@@ -248,7 +301,100 @@ void ConfigManager::parseHardwareProfilesFromJson(const std::string& json_conten
     low_profile.npu_cores = 2;
     low_profile.max_memory_mb = 4096;
     low_profile.preferred_models = {"qwen_0.5b", "tinyllama"};
+    low_profile.memory_profile = "low_memory";
     hardware_profiles_[low_profile.name] = low_profile;
+    
+    // Memory profile references are read from the file when present
+    JsonValue root = JsonParser::parse(json_content);
+    const JsonValue& profiles = root["hardware_profiles"];
+    for (auto& [name, profile] : hardware_profiles_) {
+        const JsonValue& memory_profile = profiles[name]["memory_profile"];
+        if (memory_profile.isString()) {
+            profile.memory_profile = memory_profile.asString();
+        }
+    }
+}
+
+void ConfigManager::parseMemoryProfilesFromJson(const std::string& json_content) {
+    MemoryProfile default_profile;
+    default_profile.name = "default";
+    memory_profiles_[default_profile.name] = default_profile;
+    
+    MemoryProfile low_memory;
+    low_memory.name = "low_memory";
+    low_memory.embed_flash = true;
+    low_memory.memory_budget_mb = 128;
+    low_memory.n_keep = 64;
+    memory_profiles_[low_memory.name] = low_memory;
+    
+    // Overlay values from configs/runtime.json
+    JsonValue root = JsonParser::parse(json_content);
+    const JsonValue& profiles = root["memory_profiles"];
+    for (const auto& name : profiles.keys()) {
+        const JsonValue& entry = profiles[name];
+        MemoryProfile& profile = memory_profiles_[name];
+        profile.name = name;
+        if (entry["embed_flash"].isBool()) profile.embed_flash = entry["embed_flash"].asBool();
+        if (entry["memory_budget_mb"].isNumber()) profile.memory_budget_mb = entry["memory_budget_mb"].asInt();
+        if (entry["n_keep"].isNumber()) profile.n_keep = entry["n_keep"].asInt();
+        if (entry["kv_bytes_per_token"].isNumber()) profile.kv_bytes_per_token = entry["kv_bytes_per_token"].asInt();
+    }
+}
+
+void ConfigManager::parsePreloadFromJson(const std::string& json_content) {
+    preload_config_ = PreloadConfig();
+    
+    JsonValue root = JsonParser::parse(json_content);
+    const JsonValue& preload = root["preload"];
+    if (preload["max_parallel"].isNumber()) {
+        preload_config_.max_parallel = std::max(1, preload["max_parallel"].asInt());
+    }
+    
+    // Unknown ids are skipped so a stale list cannot block startup forever
+    const JsonValue& models = preload["models"];
+    for (size_t i = 0; models.isArray() && i < models.size(); ++i) {
+        const JsonValue& id = models.at(i);
+        if (!id.isString()) {
+            continue;
+        }
+        if (models_.count(id.asString()) == 0) {
+            std::cerr << "[ConfigManager] Unknown preload model: " << id.asString() << std::endl;
+            continue;
+        }
+        if (std::find(preload_config_.models.begin(), preload_config_.models.end(), id.asString()) ==
+            preload_config_.models.end()) {
+            preload_config_.models.push_back(id.asString());
+        }
+    }
+}
+
+static void parseWeights(const JsonValue& section, const char* kind, std::map<std::string, double>* weights) {
+    if (!section.isObject()) {
+        return;
+    }
+    for (const auto& key : section.keys()) {
+        const JsonValue& weight = section[key];
+        if (!weight.isNumber() || weight.asNumber() <= 0.0) {
+            std::cerr << "[ConfigManager] Ignoring non-positive " << kind << " weight: " << key << std::endl;
+            continue;
+        }
+        (*weights)[key] = weight.asNumber();
+    }
+}
+
+void ConfigManager::parseSchedulingFromJson(const std::string& json_content) {
+    scheduling_config_ = SchedulingConfig();
+    
+    JsonValue root = JsonParser::parse(json_content);
+    const JsonValue& scheduling = root["scheduling"];
+    if (scheduling["fair_queueing"].isBool()) {
+        scheduling_config_.fair_queueing = scheduling["fair_queueing"].asBool();
+    }
+    if (scheduling["prefill_cost_ratio"].isNumber() && scheduling["prefill_cost_ratio"].asNumber() >= 0.0) {
+        scheduling_config_.prefill_cost_ratio = scheduling["prefill_cost_ratio"].asNumber();
+    }
+    parseWeights(scheduling["tenants"], "tenant", &scheduling_config_.tenant_weights);
+    parseWeights(scheduling["classes"], "class", &scheduling_config_.class_weights);
 }
 
 } // namespace config
@@ -45,15 +45,61 @@ struct ModelConfig {
     std::string toString() const;
 };
 
+/**
+ * @brief Memory footprint profile applied when loading a model
+ * 
+ * Low-memory profiles query embeddings from flash and cap the context
+ * window so the KV cache fits a RAM budget on small boards.
+ */
+struct MemoryProfile {
+    std::string name;
+    bool embed_flash = false;       // Query word embeddings from flash instead of RAM
+    int memory_budget_mb = 0;       // KV cache budget used to cap max_context_len (0 = no cap)
+    int n_keep = -1;                // KV entries kept when shifting context (-1 = runtime default)
+    int kv_bytes_per_token = 0;     // KV cache bytes per token (0 = runtime estimate)
+    
+    bool isLowMemory() const { return embed_flash || memory_budget_mb > 0; }
+};
+
 struct HardwareProfile {
     std::string name;
     int npu_cores = 0;
     int max_memory_mb = 0;
     std::vector<std::string> preferred_models;
+    std::string memory_profile = "default";
     
     bool canRunModel(const ModelConfig& model) const;
 };
 
+/**
+ * @brief Models to load at process start
+ * 
+ * Listed models load in parallel before the process reports ready, so the
+ * first request after a deploy does not pay the model load.
+ */
+struct PreloadConfig {
+    std::vector<std::string> models; // Model ids from the "models" section
+    int max_parallel = 2;            // Concurrent loads (memory permitting)
+    
+    bool isEmpty() const { return models.empty(); }
+};
+
+/**
+ * @brief Weighted fair queueing in front of the inference engine
+ * 
+ * A request's share of the NPU is its tenant weight times its class weight;
+ * tenants and classes without an entry get weight 1.
+ */
+struct SchedulingConfig {
+    bool fair_queueing = false;
+    double prefill_cost_ratio = 0.1;             // NPU cost of a prompt token relative to a generated one
+    std::map<std::string, double> tenant_weights;
+    std::map<std::string, double> class_weights;
+    
+    double tenantWeight(const std::string& tenant) const;
+    double classWeight(const std::string& request_class) const;
+};
+
 /**
  * @brief Runtime configuration manager
  * 
@@ -71,6 +117,16 @@ public:
     // Get hardware profile
     static HardwareProfile getHardwareProfile(const std::string& profile_name = "auto");
     
+    // Get memory profile (by name, or the one referenced by a hardware profile)
+    static MemoryProfile getMemoryProfile(const std::string& profile_name = "default");
+    static MemoryProfile getMemoryProfileForHardware(const std::string& hardware_profile = "auto");
+    
+    // Get the startup preload list
+    static PreloadConfig getPreloadConfig();
+    
+    // Get the fair queueing weights
+    static SchedulingConfig getSchedulingConfig();
+    
     // Auto-select best model for current hardware
     static std::string selectBestModel(const std::string& hardware_profile = "auto");
     
@@ -85,10 +141,13 @@ public:
     
     // Get project root directory
     static std::string getProjectRoot();
-    
+
 private:
     static std::map<std::string, ModelConfig> models_;
     static std::map<std::string, HardwareProfile> hardware_profiles_;
+    static std::map<std::string, MemoryProfile> memory_profiles_;
+    static PreloadConfig preload_config_;
+    static SchedulingConfig scheduling_config_;
     static std::string project_root_;
     static bool initialized_;
     
@@ -97,6 +156,9 @@ private:
     static std::map<std::string, std::string> parseJsonObject(const std::string& json_object);
     static void parseModelsFromJson(const std::string& json_content);
     static void parseHardwareProfilesFromJson(const std::string& json_content);
+    static void parseMemoryProfilesFromJson(const std::string& json_content);
+    static void parsePreloadFromJson(const std::string& json_content);
+    static void parseSchedulingFromJson(const std::string& json_content);
 };
 
 } // namespace config
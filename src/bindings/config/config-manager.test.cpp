@@ -135,6 +135,69 @@ bool test_hardware_compatibility() {
     return true;
 }
 
+bool test_memory_profiles() {
+    std::cout << "Testing memory profiles..." << std::endl;
+    
+    // Low-end boards load models with the low-memory profile
+    HardwareProfile low = ConfigManager::getHardwareProfile("rk3588_low");
+    ASSERT_EQ(low.memory_profile, std::string("low_memory"));
+    
+    MemoryProfile low_memory = ConfigManager::getMemoryProfileForHardware("rk3588_low");
+    ASSERT_EQ(low_memory.name, std::string("low_memory"));
+    ASSERT_TRUE(low_memory.embed_flash);
+    ASSERT_TRUE(low_memory.memory_budget_mb > 0);
+    ASSERT_TRUE(low_memory.n_keep >= 0);
+    ASSERT_TRUE(low_memory.isLowMemory());
+    
+    // High-end boards keep runtime defaults
+    MemoryProfile high_memory = ConfigManager::getMemoryProfileForHardware("rk3588_high");
+    ASSERT_FALSE(high_memory.isLowMemory());
+    
+    // Unknown profiles fall back to defaults
+    MemoryProfile unknown = ConfigManager::getMemoryProfile("non_existent");
+    ASSERT_EQ(unknown.name, std::string("default"));
+    ASSERT_FALSE(unknown.embed_flash);
+    
+    return true;
+}
+
+bool test_preload_config() {
+    std::cout << "Testing preload config..." << std::endl;
+    
+    PreloadConfig preload = ConfigManager::getPreloadConfig();
+    ASSERT_TRUE(preload.max_parallel >= 1);
+    
+    // Every listed model resolves to a known model entry
+    for (const auto& id : preload.models) {
+        ASSERT_FALSE(ConfigManager::getModel(id).id.empty());
+    }
+    
+    std::cout << "Preloading " << preload.models.size() << " models, "
+              << preload.max_parallel << " in parallel" << std::endl;
+    return true;
+}
+
+bool test_scheduling_config() {
+    std::cout << "Testing scheduling config..." << std::endl;
+    
+    SchedulingConfig scheduling = ConfigManager::getSchedulingConfig();
+    ASSERT_TRUE(scheduling.prefill_cost_ratio >= 0.0);
+    for (const auto& entry : scheduling.tenant_weights) {
+        ASSERT_TRUE(entry.second > 0.0);
+    }
+    
+    // Interactive traffic outweighs batch traffic in the shipped config
+    ASSERT_TRUE(scheduling.classWeight("interactive") > scheduling.classWeight("batch"));
+    
+    // Unlisted tenants and classes get weight 1
+    ASSERT_EQ(scheduling.tenantWeight("unlisted-tenant"), 1.0);
+    ASSERT_EQ(scheduling.classWeight("unlisted-class"), 1.0);
+    
+    std::cout << "Fair queueing " << (scheduling.fair_queueing ? "on" : "off") << ", "
+              << scheduling.tenant_weights.size() << " tenant weights" << std::endl;
+    return true;
+}
+
 } // namespace config
 } // namespace rkllmjs
 
@@ -152,6 +215,9 @@ int main() {
     all_passed &= test_model_selection();
     all_passed &= test_path_resolution();
     all_passed &= test_hardware_compatibility();
+    all_passed &= test_memory_profiles();
+    all_passed &= test_preload_config();
+    all_passed &= test_scheduling_config();
     
     if (all_passed) {
         std::cout << "✅ All config manager tests passed!" << std::endl;
@@ -33,6 +33,17 @@ bool JsonValue::hasKey(const std::string& key) const {
     return obj_value_.find(key) != obj_value_.end();
 }
 
+std::vector<std::string> JsonValue::keys() const {
+    std::vector<std::string> result;
+    if (type_ != OBJECT) {
+        return result;
+    }
+    for (const auto& [key, value] : obj_value_) {
+        result.push_back(key);
+    }
+    return result;
+}
+
 void JsonValue::set(const std::string& key, const JsonValue& value) {
     if (type_ != OBJECT) {
         setObject();
@@ -40,6 +51,26 @@ void JsonValue::set(const std::string& key, const JsonValue& value) {
     obj_value_[key] = value;
 }
 
+size_t JsonValue::size() const {
+    if (type_ == ARRAY) return arr_value_.size();
+    if (type_ == OBJECT) return obj_value_.size();
+    return 0;
+}
+
+const JsonValue& JsonValue::at(size_t index) const {
+    if (type_ != ARRAY || index >= arr_value_.size()) {
+        return null_value_;
+    }
+    return arr_value_[index];
+}
+
+void JsonValue::push(const JsonValue& value) {
+    if (type_ != ARRAY) {
+        setArray();
+    }
+    arr_value_.push_back(value);
+}
+
 JsonValue JsonParser::parse(const std::string& json) {
     size_t pos = 0;
     skipWhitespace(json, pos);
@@ -57,6 +88,8 @@ JsonValue JsonParser::parseValue(const std::string& json, size_t& pos) {
     
     if (ch == '{') {
         return parseObject(json, pos);
+    } else if (ch == '[') {
+        return parseArray(json, pos);
     } else if (ch == '"') {
         return parseString(json, pos);
     } else if (ch == 't' && json.substr(pos, 4) == "true") {
@@ -123,6 +156,38 @@ JsonValue JsonParser::parseObject(const std::string& json, size_t& pos) {
     return obj;
 }
 
+JsonValue JsonParser::parseArray(const std::string& json, size_t& pos) {
+    JsonValue arr;
+    arr.setArray();
+    
+    pos++; // skip '['
+    skipWhitespace(json, pos);
+    
+    if (pos < json.length() && json[pos] == ']') {
+        pos++; // skip ']'
+        return arr;
+    }
+    
+    while (pos < json.length()) {
+        arr.push(parseValue(json, pos));
+        
+        skipWhitespace(json, pos);
+        
+        if (pos >= json.length()) break;
+        
+        if (json[pos] == ']') {
+            pos++; // skip ']'
+            break;
+        } else if (json[pos] == ',') {
+            pos++; // skip ','
+        } else {
+            break;
+        }
+    }
+    
+    return arr;
+}
+
 JsonValue JsonParser::parseString(const std::string& json, size_t& pos) {
     std::string result;
     pos++; // skip opening '"'
@@ -31,22 +31,33 @@ public:
     bool isNumber() const { return type_ == NUMBER; }
     bool isBool() const { return type_ == BOOLEAN; }
     bool isObject() const { return type_ == OBJECT; }
+    bool isArray() const { return type_ == ARRAY; }
     
     // Object access
     JsonValue& operator[](const std::string& key);
     const JsonValue& operator[](const std::string& key) const;
     bool hasKey(const std::string& key) const;
+    std::vector<std::string> keys() const;
+    
+    // Array access
+    size_t size() const;
+    const JsonValue& at(size_t index) const;
     
     // Object manipulation
     void setObject() { type_ = OBJECT; }
     void set(const std::string& key, const JsonValue& value);
     
+    // Array manipulation
+    void setArray() { type_ = ARRAY; }
+    void push(const JsonValue& value);
+    
 private:
     Type type_;
     std::string str_value_;
     double num_value_ = 0.0;
     bool bool_value_ = false;
     std::map<std::string, JsonValue> obj_value_;
+    std::vector<JsonValue> arr_value_;
     
     static JsonValue null_value_;
 };
@@ -62,6 +73,7 @@ public:
 private:
     static JsonValue parseValue(const std::string& json, size_t& pos);
     static JsonValue parseObject(const std::string& json, size_t& pos);
+    static JsonValue parseArray(const std::string& json, size_t& pos);
     static JsonValue parseString(const std::string& json, size_t& pos);
     static JsonValue parseNumber(const std::string& json, size_t& pos);
     static void skipWhitespace(const std::string& json, size_t& pos);
@@ -0,0 +1,230 @@
+#include "hw-telemetry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <dirent.h>
+
+namespace rkllmjs {
+namespace core {
+
+static int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool readFile(const std::string& path, std::string* text) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    *text = buffer.str();
+    return true;
+}
+
+static bool readInt(const std::string& path, int64_t* value) {
+    std::ifstream file(path);
+    long long parsed = 0;
+    if (!(file >> parsed)) {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+HardwareTelemetry::HardwareTelemetry(const TelemetryConfig& config)
+    : config_(config) {
+    config_.history_size = std::max<size_t>(config_.history_size, 1);
+    config_.sample_interval_ms = std::max(config_.sample_interval_ms, 1);
+}
+
+HardwareTelemetry::~HardwareTelemetry() {
+    stop();
+}
+
+std::vector<float> HardwareTelemetry::parseNpuLoad(const std::string& text) {
+    // Multi-core: "NPU load:  Core0:  12%, Core1:  0%, Core2:  3%,"; single core: "NPU load:  12%"
+    std::vector<float> loads;
+    const char* p = text.c_str();
+    while (*p) {
+        char* end = nullptr;
+        long value = std::strtol(p, &end, 10);
+        if (end == p) {
+            ++p;
+            continue;
+        }
+        const char* after = end;
+        while (*after == ' ') {
+            ++after;
+        }
+        if (*after == '%') {
+            loads.push_back(static_cast<float>(std::min(std::max(value, 0L), 100L)));
+        }
+        p = end;
+    }
+    return loads;
+}
+
+bool HardwareTelemetry::parseDdrLoad(const std::string& text, float* load, int64_t* freq_hz) {
+    // Rockchip dmc: "<load>@<freq>Hz"; the frequency part is optional
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str()) {
+        return false;
+    }
+    *load = static_cast<float>(std::min(std::max(value, 0L), 100L));
+    *freq_hz = *end == '@' ? std::strtoll(end + 1, nullptr, 10) : 0;
+    return true;
+}
+
+TelemetrySample HardwareTelemetry::read(int64_t now_ms) const {
+    TelemetrySample sample;
+    sample.timestamp_ms = now_ms;
+    
+    std::string text;
+    if (readFile(config_.npu_load_path, &text)) {
+        sample.npu_core_load = parseNpuLoad(text);
+        if (!sample.npu_core_load.empty()) {
+            sample.npu_available = true;
+            float sum = 0.0f;
+            for (float load : sample.npu_core_load) {
+                sum += load;
+            }
+            sample.npu_load = sum / sample.npu_core_load.size();
+        }
+    }
+    
+    if (readFile(config_.ddr_load_path, &text)) {
+        sample.ddr_available = parseDdrLoad(text, &sample.ddr_load, &sample.ddr_freq_hz);
+    }
+    
+    readInt(config_.npu_freq_path, &sample.npu_freq_hz);
+    
+    // One cpufreq policy per cluster (e.g. A55, A76 pairs on RK3588), in name order
+    if (DIR* dir = opendir(config_.cpu_freq_root.c_str())) {
+        std::vector<std::string> policies;
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.compare(0, 6, "policy") == 0) {
+                policies.push_back(name);
+            }
+        }
+        closedir(dir);
+        std::sort(policies.begin(), policies.end());
+        for (const auto& policy : policies) {
+            int64_t khz = 0;
+            if (readInt(config_.cpu_freq_root + "/" + policy + "/scaling_cur_freq", &khz)) {
+                sample.cpu_freq_khz.push_back(khz);
+            }
+        }
+    }
+    return sample;
+}
+
+bool HardwareTelemetry::sample(int64_t now_ms) {
+    TelemetrySample sample = read(now_ms >= 0 ? now_ms : steadyNowMs());
+    if (!sample.npu_available && !sample.ddr_available && sample.npu_freq_hz == 0 && sample.cpu_freq_khz.empty()) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    history_.push_back(std::move(sample));
+    while (history_.size() > config_.history_size) {
+        history_.pop_front();
+    }
+    return true;
+}
+
+TelemetrySample HardwareTelemetry::getLatest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return history_.empty() ? TelemetrySample() : history_.back();
+}
+
+std::vector<TelemetrySample> HardwareTelemetry::getHistory() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<TelemetrySample>(history_.begin(), history_.end());
+}
+
+TelemetrySummary HardwareTelemetry::getSummary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TelemetrySummary summary;
+    summary.samples = history_.size();
+    summary.available = !history_.empty();
+    
+    size_t npu_samples = 0;
+    size_t ddr_samples = 0;
+    for (const auto& sample : history_) {
+        if (sample.npu_available) {
+            summary.npu_load += sample.npu_load;
+            summary.npu_load_peak = std::max(summary.npu_load_peak, sample.npu_load);
+            npu_samples++;
+        }
+        if (sample.ddr_available) {
+            summary.ddr_load += sample.ddr_load;
+            summary.ddr_load_peak = std::max(summary.ddr_load_peak, sample.ddr_load);
+            ddr_samples++;
+        }
+    }
+    summary.npu_load = npu_samples > 0 ? summary.npu_load / npu_samples : 0.0f;
+    summary.ddr_load = ddr_samples > 0 ? summary.ddr_load / ddr_samples : 0.0f;
+    
+    // Whichever unit is saturated limits throughput; DDR wins a tie because a
+    // starved NPU still reports itself busy while it waits on weights
+    if (summary.ddr_load >= config_.busy_threshold && summary.ddr_load >= summary.npu_load) {
+        summary.bottleneck = "memory";
+    } else if (summary.npu_load >= config_.busy_threshold) {
+        summary.bottleneck = "npu";
+    }
+    return summary;
+}
+
+void HardwareTelemetry::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&HardwareTelemetry::run, this);
+}
+
+void HardwareTelemetry::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool HardwareTelemetry::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void HardwareTelemetry::run() {
+    if (!sample()) {
+        std::cout << "[HardwareTelemetry] No readable telemetry sources (rknpu load needs debugfs)" << std::endl;
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        wake_.wait_for(lock, std::chrono::milliseconds(config_.sample_interval_ms));
+        if (!running_) {
+            break;
+        }
+        lock.unlock();
+        sample();
+        lock.lock();
+    }
+}
+
+} // namespace core
+} // namespace rkllmjs
@@ -0,0 +1,193 @@
+#include "hw-telemetry.hpp"
+#include "rkllm-manager.hpp"
+#include "../testing/rkllmjs-test.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace rkllmjs::core;
+
+namespace rkllmjs {
+namespace core {
+namespace test {
+
+// Fake debugfs/devfreq/cpufreq files under /tmp
+class FakeTelemetryRoot {
+public:
+    explicit FakeTelemetryRoot(const std::string& name)
+        : root_("/tmp/rkllmjs-telemetry-test-" + name + "-" + std::to_string(::getpid())) {
+        ::mkdir(root_.c_str(), 0755);
+    }
+    
+    ~FakeTelemetryRoot() {
+        for (const auto& file : files_) {
+            std::remove(file.c_str());
+        }
+        for (auto it = dirs_.rbegin(); it != dirs_.rend(); ++it) {
+            ::rmdir(it->c_str());
+        }
+        ::rmdir(root_.c_str());
+    }
+    
+    void setNpuLoad(const std::string& text) { write(root_ + "/npu_load", text); }
+    void setDdrLoad(const std::string& text) { write(root_ + "/ddr_load", text); }
+    void setNpuFreq(int64_t hz) { write(root_ + "/npu_freq", std::to_string(hz)); }
+    
+    void setCpuFreq(int policy, int64_t khz) {
+        std::string dir = root_ + "/cpufreq/policy" + std::to_string(policy);
+        if (std::find(dirs_.begin(), dirs_.end(), dir) == dirs_.end()) {
+            if (dirs_.empty()) {
+                ::mkdir((root_ + "/cpufreq").c_str(), 0755);
+                dirs_.push_back(root_ + "/cpufreq");
+            }
+            ::mkdir(dir.c_str(), 0755);
+            dirs_.push_back(dir);
+        }
+        write(dir + "/scaling_cur_freq", std::to_string(khz));
+    }
+    
+    TelemetryConfig config() const {
+        TelemetryConfig config;
+        config.npu_load_path = root_ + "/npu_load";
+        config.ddr_load_path = root_ + "/ddr_load";
+        config.npu_freq_path = root_ + "/npu_freq";
+        config.cpu_freq_root = root_ + "/cpufreq";
+        config.history_size = 4;
+        return config;
+    }
+
+private:
+    void write(const std::string& path, const std::string& value) {
+        std::ofstream file(path, std::ios::trunc);
+        file << value << "\n";
+        if (std::find(files_.begin(), files_.end(), path) == files_.end()) {
+            files_.push_back(path);
+        }
+    }
+    
+    std::string root_;
+    std::vector<std::string> dirs_;
+    std::vector<std::string> files_;
+};
+
+TEST(HardwareTelemetryTest, ParsesKernelFormats) {
+    std::vector<float> loads = HardwareTelemetry::parseNpuLoad("NPU load:  Core0:  12%, Core1:  0%, Core2: 100%,\n");
+    EXPECT_EQ(3u, loads.size());
+    EXPECT_NEAR(12.0f, loads[0], 0.01f);
+    EXPECT_NEAR(100.0f, loads[2], 0.01f);
+    
+    loads = HardwareTelemetry::parseNpuLoad("NPU load:  37%\n");
+    EXPECT_EQ(1u, loads.size());
+    EXPECT_NEAR(37.0f, loads[0], 0.01f);
+    EXPECT_TRUE(HardwareTelemetry::parseNpuLoad("permission denied").empty());
+    
+    float load = 0.0f;
+    int64_t freq = 0;
+    EXPECT_TRUE(HardwareTelemetry::parseDdrLoad("45@1560000000Hz\n", &load, &freq));
+    EXPECT_NEAR(45.0f, load, 0.01f);
+    EXPECT_EQ(1560000000, freq);
+    EXPECT_TRUE(HardwareTelemetry::parseDdrLoad("7\n", &load, &freq));
+    EXPECT_EQ(0, freq);
+    EXPECT_FALSE(HardwareTelemetry::parseDdrLoad("", &load, &freq));
+}
+
+TEST(HardwareTelemetryTest, KeepsRingOfRecentSamples) {
+    FakeTelemetryRoot root("ring");
+    root.setNpuFreq(1000000000);
+    root.setCpuFreq(0, 1800000);
+    root.setCpuFreq(4, 2256000);
+    HardwareTelemetry telemetry(root.config());
+    
+    for (int i = 0; i < 6; ++i) {
+        root.setNpuLoad("NPU load:  Core0: " + std::to_string(i * 10) + "%, Core1: 0%, Core2: 0%,");
+        root.setDdrLoad(std::to_string(20 + i) + "@2112000000Hz");
+        EXPECT_TRUE(telemetry.sample(i * 100));
+    }
+    
+    std::vector<TelemetrySample> history = telemetry.getHistory();
+    EXPECT_EQ(4u, history.size());
+    EXPECT_EQ(200, history.front().timestamp_ms);
+    EXPECT_EQ(500, history.back().timestamp_ms);
+    
+    TelemetrySample latest = telemetry.getLatest();
+    EXPECT_NEAR(50.0f / 3.0f, latest.npu_load, 0.01f);
+    EXPECT_EQ(3u, latest.npu_core_load.size());
+    EXPECT_NEAR(25.0f, latest.ddr_load, 0.01f);
+    EXPECT_EQ(2112000000, latest.ddr_freq_hz);
+    EXPECT_EQ(1000000000, latest.npu_freq_hz);
+    EXPECT_EQ(2u, latest.cpu_freq_khz.size());
+    EXPECT_EQ(2256000, latest.cpu_freq_khz[1]);
+    
+    TelemetrySummary summary = telemetry.getSummary();
+    EXPECT_EQ(4u, summary.samples);
+    EXPECT_NEAR(23.5f, summary.ddr_load, 0.01f);
+    EXPECT_EQ("none", summary.bottleneck);
+}
+
+TEST(HardwareTelemetryTest, ClassifiesBottleneck) {
+    FakeTelemetryRoot root("bottleneck");
+    TelemetryConfig config = root.config();
+    config.history_size = 1;
+    HardwareTelemetry telemetry(config);
+    
+    root.setNpuLoad("NPU load:  Core0: 95%, Core1: 90%, Core2: 85%,");
+    root.setDdrLoad("40@2112000000Hz");
+    telemetry.sample(0);
+    EXPECT_EQ("npu", telemetry.getSummary().bottleneck);
+    
+    // NPU busy waiting on a saturated memory bus
+    root.setDdrLoad("93@2112000000Hz");
+    telemetry.sample(1);
+    EXPECT_EQ("memory", telemetry.getSummary().bottleneck);
+    
+    // Missing sources record nothing
+    config.npu_load_path = config.ddr_load_path = config.npu_freq_path = config.cpu_freq_root = "/nonexistent";
+    HardwareTelemetry missing(config);
+    EXPECT_FALSE(missing.sample(0));
+    EXPECT_FALSE(missing.getSummary().available);
+}
+
+TEST(HardwareTelemetryTest, ManagerReportsMeasuredLoad) {
+    FakeTelemetryRoot root("manager");
+    root.setNpuLoad("NPU load:  Core0: 60%, Core1: 30%, Core2: 0%,");
+    root.setDdrLoad("55@1560000000Hz");
+    root.setNpuFreq(800000000);
+    
+    auto& manager = RKLLMManager::getInstance();
+    EXPECT_FALSE(manager.getResourceStats().telemetry_available);
+    
+    TelemetryConfig config = root.config();
+    config.sample_interval_ms = 5;
+    manager.enableTelemetry(config);
+    EXPECT_TRUE(manager.isTelemetryEnabled());
+    for (int i = 0; i < 200 && manager.getTelemetrySummary().samples < 2; ++i) {
+        ::usleep(5000);
+    }
+    
+    ResourceStats stats = manager.getResourceStats();
+    EXPECT_TRUE(stats.telemetry_available);
+    EXPECT_NEAR(30.0f, stats.npu_utilization, 0.01f);
+    EXPECT_EQ(3u, stats.npu_core_load.size());
+    EXPECT_NEAR(55.0f, stats.ddr_load, 0.01f);
+    EXPECT_EQ(1560000000, stats.ddr_freq_hz);
+    EXPECT_EQ(800000000, stats.npu_freq_hz);
+    EXPECT_GE(stats.telemetry.size(), 2u);
+    
+    manager.disableTelemetry();
+    EXPECT_FALSE(manager.isTelemetryEnabled());
+    stats = manager.getResourceStats();
+    EXPECT_FALSE(stats.telemetry_available);
+    EXPECT_TRUE(stats.telemetry.empty());
+    EXPECT_NEAR(0.0f, stats.npu_utilization, 0.01f);
+}
+
+} // namespace test
+} // namespace core
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
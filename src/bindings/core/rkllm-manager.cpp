@@ -7,6 +7,7 @@
 #include <thread>
 #include <chrono>
 #include <cstring>
+#include <algorithm>
 
 #ifdef __linux__
 #include <sys/sysinfo.h>
@@ -15,8 +16,80 @@
 namespace rkllmjs {
 namespace core {
 
+// Stops a warm-up run once it has generated enough tokens
+class WarmupSink : public ResultSink {
+public:
+    explicit WarmupSink(int max_tokens) : max_tokens_(max_tokens) {}
+    
+    bool failed = false;
+    
+    int onResult(RKLLMResult* result, LLMCallState state) override {
+        if (state == RKLLM_RUN_ERROR) {
+            failed = true;
+            return 1;
+        }
+        if (result && result->text && ++tokens_ >= max_tokens_) {
+            return 1; // Pause; the KV cache is cleared afterwards
+        }
+        return 0;
+    }
+
+private:
+    int max_tokens_;
+    int tokens_ = 0;
+};
+
+/**
+ * Run a short synthetic prompt so lazy runtime allocation and clock ramp-up
+ * happen before the first real request. Fills the warm-up fields of stats.
+ */
+static void runWarmup(LLMHandle handle, const RKLLMModelConfig& config, ModelStats* stats) {
+    RKLLMInput input;
+    input.role = "user";
+    input.enable_thinking = false;
+    input.input_type = RKLLM_INPUT_PROMPT;
+    input.prompt_input = config.warmup_prompt.c_str();
+    
+    RKLLMInferParam infer_params;
+    std::memset(&infer_params, 0, sizeof(infer_params));
+    infer_params.mode = RKLLM_INFER_GENERATE;
+    infer_params.keep_history = 0;
+    
+    float warm_total_ms = 0.0f;
+    int warm_runs = 0;
+    for (int run = 0; run < config.warmup_runs; ++run) {
+        WarmupSink sink(config.warmup_tokens);
+        auto start = std::chrono::steady_clock::now();
+        int ret = rkllm_run(handle, &input, &infer_params, &sink);
+        float elapsed_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ret != 0 || sink.failed) {
+            std::cout << "[RKLLMManager] Warm-up run failed: " << ret << std::endl;
+            break;
+        }
+        
+        if (run == 0) {
+            stats->cold_run_ms = elapsed_ms;
+        } else {
+            warm_total_ms += elapsed_ms;
+            warm_runs++;
+        }
+        stats->warmed_up = true;
+    }
+    // Averaged over the warm runs that completed; a failed run ends the loop early
+    if (warm_runs > 0) {
+        stats->warm_run_ms = warm_total_ms / static_cast<float>(warm_runs);
+    }
+    
+    // Leave nothing from the synthetic prompt behind (system prompt is kept)
+    rkllm_clear_kv_cache(handle, 1, nullptr, nullptr);
+}
+
 // Global callback function for RKLLM inference
 static int global_rkllm_callback(RKLLMResult* result, void* userdata, LLMCallState state) {
+    if (userdata) {
+        return static_cast<ResultSink*>(userdata)->onResult(result, state);
+    }
+    
     if (result && result->text) {
         // Print streaming text in real-time
         std::cout << result->text << std::flush;
@@ -37,6 +110,26 @@ static int global_rkllm_callback(RKLLMResult* result, void* userdata, LLMCallSta
     }
 }
 
+// Memory accounting defaults
+static constexpr size_t kEstimatedModelMemoryMb = 1024;   // Reserved per load; used when nothing better is known
+static constexpr size_t kDefaultKVBytesPerToken = 57344;  // 28 layers x 4 KV heads x 128 dim x K/V x fp16
+static constexpr int kContextGranularity = 64;            // Capped context is rounded down to this
+
+// Current resident set size of this process in MB (0 if unavailable)
+static size_t readProcessRssMb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            std::istringstream iss(line.substr(6));
+            size_t rss_kb = 0;
+            iss >> rss_kb;
+            return rss_kb / 1024;
+        }
+    }
+    return 0;
+}
+
 // Static member definitions
 RKLLMManager& RKLLMManager::getInstance() {
     static RKLLMManager instance;
@@ -47,6 +140,7 @@ RKLLMManager::~RKLLMManager() {
     if (initialized_) {
         cleanup();
     }
+    joinWorkers();
 }
 
 // Configuration validation
@@ -58,7 +152,13 @@ bool RKLLMModelConfig::isValid() const {
            top_p > 0.0f && top_p <= 1.0f &&
            temperature > 0.0f && temperature <= 2.0f &&
            repeat_penalty >= 1.0f && repeat_penalty <= 2.0f &&
-           npu_core_num > 0 && npu_core_num <= 3;
+           npu_core_num > 0 && npu_core_num <= 3 &&
+           n_keep >= -1 && n_keep < max_context_len &&
+           n_batch > 0 && n_batch <= 255 && !scratch_dir.empty() &&
+           mirostat >= 0 && mirostat <= 2 &&
+           mirostat_tau > 0.0f && mirostat_tau <= 20.0f &&
+           mirostat_eta > 0.0f && mirostat_eta <= 1.0f &&
+           (!warmup || (warmup_runs > 0 && warmup_runs <= 8 && warmup_tokens > 0 && !warmup_prompt.empty()));
 }
 
 std::string RKLLMModelConfig::getValidationError() const {
@@ -70,6 +170,15 @@ std::string RKLLMModelConfig::getValidationError() const {
     if (temperature <= 0.0f || temperature > 2.0f) return "temperature must be 0.0-2.0";
     if (repeat_penalty < 1.0f || repeat_penalty > 2.0f) return "repeat_penalty must be 1.0-2.0";
     if (npu_core_num <= 0 || npu_core_num > 3) return "npu_core_num must be 1-3";
+    if (n_keep < -1 || n_keep >= max_context_len) return "n_keep must be -1 or less than max_context_len";
+    if (n_batch <= 0 || n_batch > 255) return "n_batch must be 1-255";
+    if (scratch_dir.empty()) return "scratch_dir cannot be empty";
+    if (mirostat < 0 || mirostat > 2) return "mirostat must be 0, 1 or 2";
+    if (mirostat_tau <= 0.0f || mirostat_tau > 20.0f) return "mirostat_tau must be 0.0-20.0";
+    if (mirostat_eta <= 0.0f || mirostat_eta > 1.0f) return "mirostat_eta must be 0.0-1.0";
+    if (warmup && (warmup_runs <= 0 || warmup_runs > 8)) return "warmup_runs must be 1-8";
+    if (warmup && warmup_tokens <= 0) return "warmup_tokens must be positive";
+    if (warmup && warmup_prompt.empty()) return "warmup_prompt cannot be empty";
     return "";
 }
 
@@ -92,11 +201,11 @@ ManagerResult RKLLMManager::initialize() {
 #else
     total_memory_mb_ = 4096; // Default fallback for non-Linux
 #endif
-    
+
     // Initialize resource tracking
     used_npu_cores_ = 0;
     used_memory_mb_ = 0;
-    updateResourceStats();
+    publishTable(std::make_shared<ModelTable>());
     
     initialized_ = true;
     std::cout << "[RKLLMManager] Initialized successfully" << std::endl;
@@ -107,122 +216,572 @@ ManagerResult RKLLMManager::initialize() {
 }
 
 ManagerResult RKLLMManager::cleanup() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (!initialized_) {
-        return ManagerResult::SUCCESS;
+    std::shared_ptr<const ModelTable> retired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        if (!initialized_) {
+            return ManagerResult::SUCCESS;
+        }
+        
+        // Unpublish all models; readers holding the old snapshot keep it alive
+        retired = loadTable();
+        used_npu_cores_ = 0;
+        used_memory_mb_ = 0;
+        publishTable(std::make_shared<ModelTable>());
+        initialized_ = false;
+        generation_++;
     }
     
-    // Destroy all active models
-    for (auto& [handle, instance] : models_) {
+    // Loads finishing after the generation bump destroy their own handles
+    joinWorkers();
+    
+    // Destroy handles outside the writer lock
+    for (const auto& [handle, instance] : retired->models) {
         if (instance && instance->is_active) {
             std::cout << "[RKLLMManager] Cleaning up model: " << instance->model_id << std::endl;
             rkllm_destroy(handle);
-            instance->is_active = false;
         }
     }
     
-    models_.clear();
-    used_npu_cores_ = 0;
-    used_memory_mb_ = 0;
-    initialized_ = false;
-    
     std::cout << "[RKLLMManager] Cleanup completed" << std::endl;
     return ManagerResult::SUCCESS;
 }
 
 bool RKLLMManager::isInitialized() const {
+    return initialized_.load(std::memory_order_acquire);
+}
+
+// ModelLoadTask implementation
+ModelLoadTask::ModelLoadTask(LoadProgressCallback on_progress, LoadDoneCallback on_done)
+    : on_progress_(std::move(on_progress))
+    , on_done_(std::move(on_done))
+    , start_time_(std::chrono::steady_clock::now())
+    , future_(promise_.get_future().share()) {}
+
+void ModelLoadTask::cancel() {
+    cancelled_ = true;
+}
+
+bool ModelLoadTask::isCancelled() const {
+    return cancelled_.load();
+}
+
+bool ModelLoadTask::isDone() const {
+    return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+LoadStage ModelLoadTask::getStage() const {
+    return stage_.load();
+}
+
+LLMHandle ModelLoadTask::getHandle() const {
+    return handle_.load();
+}
+
+ManagerResult ModelLoadTask::wait() const {
+    return future_.get();
+}
+
+bool ModelLoadTask::waitFor(std::chrono::milliseconds timeout) const {
+    return future_.wait_for(timeout) == std::future_status::ready;
+}
+
+void ModelLoadTask::report(LoadStage stage, float progress, const std::string& message) {
+    stage_ = stage;
+    if (!on_progress_) {
+        return;
+    }
+    
+    LoadProgress event;
+    event.stage = stage;
+    event.progress = progress;
+    event.elapsed_ms = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - start_time_).count();
+    event.message = message;
+    
+    try {
+        on_progress_(event);
+    } catch (...) {
+        // A failing listener must not take down the loader thread
+    }
+}
+
+void ModelLoadTask::finish(ManagerResult result, LLMHandle handle) {
+    handle_ = handle;
+    switch (result) {
+        case ManagerResult::SUCCESS:
+            report(LoadStage::READY, 1.0f, "Model ready");
+            break;
+        case ManagerResult::ERROR_CANCELLED:
+            report(LoadStage::CANCELLED, 1.0f, "Load cancelled");
+            break;
+        default:
+            report(LoadStage::FAILED, 1.0f, RKLLMManager::getErrorMessage(result));
+            break;
+    }
+    
+    // Listeners publish the result before waiters on the future see it
+    if (on_done_) {
+        try {
+            on_done_(result, handle);
+        } catch (...) {
+            // Same as progress listeners: never take down the loader thread
+        }
+    }
+    promise_.set_value(result);
+}
+
+// PreloadTask implementation
+void PreloadTask::cancel() {
+    cancelled_ = true;
+}
+
+bool PreloadTask::isCancelled() const {
+    return cancelled_.load();
+}
+
+bool PreloadTask::isDone() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return report_.done;
+}
+
+bool PreloadTask::isReady() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return report_.ready;
+}
+
+bool PreloadTask::waitFor(std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return done_cv_.wait_for(lock, timeout, [this] { return report_.done; });
+}
+
+bool PreloadTask::wait() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return report_.done; });
+    return report_.ready;
+}
+
+PreloadReport PreloadTask::getReport() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return initialized_;
+    return report_;
+}
+
+LLMHandle PreloadTask::getHandle(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& model : report_.models) {
+        if (model.id == id && model.result == ManagerResult::SUCCESS) {
+            return model.handle;
+        }
+    }
+    return nullptr;
+}
+
+void PreloadTask::update(size_t index, const PreloadResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    report_.models[index] = result;
+}
+
+void PreloadTask::finish(float total_ms) {
+    PreloadReport report;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        report_.total_ms = total_ms;
+        report_.ready = std::all_of(report_.models.begin(), report_.models.end(), [](const PreloadResult& model) {
+            return model.result == ManagerResult::SUCCESS;
+        });
+        report = report_;
+    }
+    
+    // The listener publishes the handles before waiters are released
+    if (on_done_) {
+        report.done = true;
+        try {
+            on_done_(report);
+        } catch (...) {
+            // A failing listener must not take down the coordinator
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    report_.done = true;
+    done_cv_.notify_all();
 }
 
 // Model management
 ManagerResult RKLLMManager::createModel(const RKLLMModelConfig& config, LLMHandle* handle) {
+    return loadModel(config, handle, nullptr);
+}
+
+std::shared_ptr<ModelLoadTask> RKLLMManager::createModelAsync(const RKLLMModelConfig& config,
+                                                              LoadProgressCallback on_progress,
+                                                              LoadDoneCallback on_done) {
+    auto task = std::make_shared<ModelLoadTask>(std::move(on_progress), std::move(on_done));
+    
+    std::lock_guard<std::mutex> lock(workers_mutex_);
+    
+    // Reap loaders that already finished so the list stays short
+    for (auto it = loaders_.begin(); it != loaders_.end();) {
+        if (it->task->isDone()) {
+            it->thread.join();
+            it = loaders_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    std::thread loader([this, config, task]() {
+        task->report(LoadStage::QUEUED, 0.0f, "Load queued");
+        LLMHandle handle = nullptr;
+        ManagerResult result = loadModel(config, &handle, task.get());
+        task->finish(result, result == ManagerResult::SUCCESS ? handle : nullptr);
+    });
+    loaders_.push_back({task, std::move(loader)});
+    
+    return task;
+}
+
+std::shared_ptr<PreloadTask> RKLLMManager::preloadModels(const std::vector<PreloadRequest>& requests,
+                                                        int max_parallel, PreloadDoneCallback on_done) {
+    auto task = std::make_shared<PreloadTask>(std::move(on_done));
+    task->report_.models.resize(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        task->report_.models[i].id = requests[i].id;
+    }
+    {
+        std::lock_guard<std::mutex> lock(preload_mutex_);
+        preload_ = task;
+    }
+    
+    std::thread coordinator([this, requests, max_parallel, task]() {
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        auto elapsed_ms = [](Clock::time_point since) {
+            return std::chrono::duration<float, std::milli>(Clock::now() - since).count();
+        };
+        
+        // Budget what is free now, against the same 80% limit allocateResources uses
+        ResourceStats stats = getResourceStats();
+        double limit_mb = stats.total_memory_mb * 0.8;
+        size_t budget_mb = limit_mb > stats.memory_usage_mb ? static_cast<size_t>(limit_mb) - stats.memory_usage_mb : 0;
+        size_t committed_mb = 0;
+        
+        struct InFlight {
+            size_t index;
+            size_t memory_mb;
+            Clock::time_point started;
+            std::shared_ptr<ModelLoadTask> load;
+        };
+        std::vector<InFlight> in_flight;
+        std::vector<bool> started(requests.size(), false);
+        size_t remaining = requests.size();
+        
+        // Loader threads wake the coordinator when they reach a terminal stage
+        auto wake_mutex = std::make_shared<std::mutex>();
+        auto wake = std::make_shared<std::condition_variable>();
+        auto on_progress = [wake_mutex, wake](const LoadProgress& progress) {
+            if (progress.stage == LoadStage::READY || progress.stage == LoadStage::FAILED ||
+                progress.stage == LoadStage::CANCELLED) {
+                std::lock_guard<std::mutex> lock(*wake_mutex);
+                wake->notify_all();
+            }
+        };
+        
+        while (remaining > 0 || !in_flight.empty()) {
+            // A cancelled preload starts nothing new and cancels what is loading
+            if (task->isCancelled() && remaining > 0) {
+                for (size_t i = 0; i < requests.size(); ++i) {
+                    if (!started[i]) {
+                        PreloadResult result;
+                        result.id = requests[i].id;
+                        result.done = true;
+                        result.result = ManagerResult::ERROR_CANCELLED;
+                        result.queued_ms = elapsed_ms(start);
+                        task->update(i, result);
+                        started[i] = true;
+                    }
+                }
+                remaining = 0;
+                for (auto& load : in_flight) {
+                    load.load->cancel();
+                }
+            }
+            
+            // First fit: start every pending model that fits the slots and the budget.
+            // With nothing in flight the next model always starts so an oversized
+            // model fails in allocateResources instead of waiting forever.
+            for (size_t i = 0; i < requests.size() && static_cast<int>(in_flight.size()) < std::max(1, max_parallel); ++i) {
+                if (started[i]) {
+                    continue;
+                }
+                size_t memory_mb = requests[i].memory_mb > 0 ? requests[i].memory_mb : kEstimatedModelMemoryMb;
+                if (!in_flight.empty() && committed_mb + memory_mb > budget_mb) {
+                    continue;
+                }
+                
+                PreloadResult result;
+                result.id = requests[i].id;
+                result.queued_ms = elapsed_ms(start);
+                task->update(i, result);
+                
+                started[i] = true;
+                remaining--;
+                committed_mb += memory_mb;
+                in_flight.push_back({i, memory_mb, Clock::now(), createModelAsync(requests[i].config, on_progress)});
+            }
+            
+            {
+                std::unique_lock<std::mutex> lock(*wake_mutex);
+                wake->wait_for(lock, std::chrono::milliseconds(20), [&in_flight] {
+                    return std::any_of(in_flight.begin(), in_flight.end(),
+                                       [](const InFlight& load) { return load.load->isDone(); });
+                });
+            }
+            
+            for (auto it = in_flight.begin(); it != in_flight.end();) {
+                if (!it->load->isDone()) {
+                    ++it;
+                    continue;
+                }
+                
+                PreloadResult result = task->getReport().models[it->index];
+                result.done = true;
+                result.result = it->load->wait();
+                result.handle = it->load->getHandle();
+                result.load_ms = elapsed_ms(it->started);
+                task->update(it->index, result);
+                
+                if (result.result != ManagerResult::SUCCESS) {
+                    committed_mb -= it->memory_mb; // Failed loads free their share of the budget
+                }
+                std::cout << "[RKLLMManager] Preload " << result.id << ": " << getErrorMessage(result.result)
+                          << " in " << result.load_ms << " ms" << std::endl;
+                it = in_flight.erase(it);
+            }
+        }
+        
+        task->finish(elapsed_ms(start));
+        std::cout << "[RKLLMManager] Preload finished in " << task->getReport().total_ms << " ms"
+                  << (task->isReady() ? "" : " with failures") << std::endl;
+    });
+    
+    std::lock_guard<std::mutex> lock(workers_mutex_);
+    for (auto it = preloaders_.begin(); it != preloaders_.end();) {
+        if (it->task->isDone()) {
+            it->thread.join();
+            it = preloaders_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    preloaders_.push_back({task, std::move(coordinator)});
+    
+    return task;
+}
+
+bool RKLLMManager::isReady() const {
+    if (!isInitialized()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    return !preload_ || preload_->isReady();
+}
+
+bool RKLLMManager::waitUntilReady(std::chrono::milliseconds timeout) const {
+    std::shared_ptr<PreloadTask> preload = getPreloadTask();
+    if (preload && !preload->waitFor(timeout)) {
+        return false;
+    }
+    return isReady();
+}
+
+std::shared_ptr<PreloadTask> RKLLMManager::getPreloadTask() const {
+    std::lock_guard<std::mutex> lock(preload_mutex_);
+    return preload_;
+}
+
+ManagerResult RKLLMManager::loadModel(const RKLLMModelConfig& config, LLMHandle* handle, ModelLoadTask* task) {
     if (!handle) {
         return ManagerResult::ERROR_INVALID_HANDLE;
     }
+    *handle = nullptr; // Failed loads leave no stale handle behind
     
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (task) {
+        task->report(LoadStage::VALIDATING, 0.05f, "Validating configuration");
+    }
     
-    if (!initialized_) {
-        return ManagerResult::ERROR_INITIALIZATION_FAILED;
+    // Resolve memory profile (context cap and n_keep)
+    RKLLMModelConfig resolved = applyMemoryProfile(config, getMemoryProfile());
+    std::vector<std::string> adjustments;
+    RKLLMModelConfig effective = applyMemoryBudget(resolved, &adjustments);
+    for (const auto& adjustment : adjustments) {
+        std::cout << "[RKLLMManager] Adjusted " << adjustment << std::endl;
     }
+    uint64_t generation = 0;
     
-    // Validate configuration
-    if (!config.isValid()) {
-        std::cout << "[RKLLMManager] Invalid config: " << config.getValidationError() << std::endl;
-        return ManagerResult::ERROR_INVALID_CONFIG;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        if (!initialized_) {
+            return ManagerResult::ERROR_INITIALIZATION_FAILED;
+        }
+        
+        // Validate configuration
+        if (!resolved.isValid()) {
+            std::cout << "[RKLLMManager] Invalid config: " << resolved.getValidationError() << std::endl;
+            return ManagerResult::ERROR_INVALID_CONFIG;
+        }
+        
+        // Reserve resources so concurrent loads cannot oversubscribe the board
+        if (allocateResources(config) != ManagerResult::SUCCESS) {
+            std::cout << "[RKLLMManager] Insufficient resources for model" << std::endl;
+            return ManagerResult::ERROR_RESOURCE_EXHAUSTED;
+        }
+        
+        // Cancelled before the expensive part: just drop the reservation
+        if (task && task->isCancelled()) {
+            releaseResources(config.npu_core_num, kEstimatedModelMemoryMb);
+            return ManagerResult::ERROR_CANCELLED;
+        }
+        publishTable(std::make_shared<ModelTable>(*loadTable()));
+        generation = generation_;
     }
     
-    // Check resource availability
-    if (!hasAvailableResources(config)) {
-        std::cout << "[RKLLMManager] Insufficient resources for model" << std::endl;
-        return ManagerResult::ERROR_RESOURCE_EXHAUSTED;
+    if (task) {
+        task->report(LoadStage::LOADING, 0.1f, "Loading " + effective.model_path);
     }
     
     // Create RKLLM parameters using default
     RKLLMParam param = rkllm_createDefaultParam();
     
     // Override with our config
-    param.model_path = config.model_path.c_str();
-    param.max_context_len = config.max_context_len;
-    param.max_new_tokens = config.max_new_tokens;
-    param.top_k = config.top_k;
-    param.top_p = config.top_p;
-    param.temperature = config.temperature;
-    param.repeat_penalty = config.repeat_penalty;
-    
-    // Initialize model with global callback
+    param.model_path = effective.model_path.c_str();
+    param.max_context_len = effective.max_context_len;
+    param.max_new_tokens = effective.max_new_tokens;
+    param.top_k = effective.top_k;
+    param.top_p = effective.top_p;
+    param.temperature = effective.temperature;
+    param.repeat_penalty = effective.repeat_penalty;
+    param.mirostat = effective.mirostat;
+    param.mirostat_tau = effective.mirostat_tau;
+    param.mirostat_eta = effective.mirostat_eta;
+    if (effective.n_keep >= 0) {
+        param.n_keep = effective.n_keep;
+    }
+    param.extend_param.embed_flash = effective.embed_flash ? 1 : 0;
+    param.extend_param.n_batch = static_cast<uint8_t>(effective.n_batch);
+    
+    // Initialize model with global callback, measuring its memory cost.
+    // Runs without the writer lock so readers and other loads proceed.
+    uint64_t init_id = ++inits_started_;
+    bool init_alone = ++inits_running_ == 1;
+    size_t rss_before = readProcessRssMb();
+    auto load_start = std::chrono::steady_clock::now();
     int ret = rkllm_init(handle, &param, global_rkllm_callback);
-    if (ret != 0) {
-        std::cout << "[RKLLMManager] Model initialization failed: " << ret << std::endl;
-        return ManagerResult::ERROR_MODEL_LOAD_FAILED;
+    auto load_end = std::chrono::steady_clock::now();
+    size_t rss_after = readProcessRssMb();
+    init_alone = init_alone && inits_started_ == init_id; // No init started while this one ran
+    inits_running_--;
+    
+    // Warm up before publishing so no request reaches a cold handle
+    ModelStats warmup_stats;
+    if (ret == 0 && effective.warmup && !(task && task->isCancelled())) {
+        if (task) {
+            task->report(LoadStage::WARMING_UP, 0.9f, "Warming up");
+        }
+        runWarmup(*handle, effective, &warmup_stats);
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // A cleanup while loading already dropped our reservation
+    bool cleaned_up = generation != generation_;
+    bool cancelled = task && task->isCancelled();
+    if (ret != 0 || cleaned_up || cancelled) {
+        if (ret == 0) {
+            rkllm_destroy(*handle);
+            *handle = nullptr;
+        } else {
+            std::cout << "[RKLLMManager] Model initialization failed: " << ret << std::endl;
+        }
+        if (cleaned_up) {
+            return ManagerResult::ERROR_INITIALIZATION_FAILED;
+        }
+        releaseResources(config.npu_core_num, kEstimatedModelMemoryMb);
+        publishTable(std::make_shared<ModelTable>(*loadTable()));
+        return ret != 0 ? ManagerResult::ERROR_MODEL_LOAD_FAILED : ManagerResult::ERROR_CANCELLED;
     }
     
     // Create model instance
     std::string model_id = generateModelId();
-    auto instance = std::make_unique<ModelInstance>(*handle, config, model_id);
-    models_[*handle] = std::move(instance);
+    auto instance = std::make_shared<ModelInstance>(*handle, effective, model_id);
+    ModelStats& stats = instance->stats;
+    stats.rss_before_mb = rss_before;
+    stats.rss_after_mb = rss_after;
+    // The RSS delta includes every load that overlapped this one
+    stats.memory_measured = init_alone && rss_after > rss_before;
+    stats.model_memory_mb = stats.memory_measured ? rss_after - rss_before : estimateModelMemoryMb(effective);
+    stats.load_time_ms = std::chrono::duration<float, std::milli>(load_end - load_start).count();
+    stats.context_len = effective.max_context_len;
+    stats.n_keep = effective.n_keep;
+    stats.embed_flash = effective.embed_flash;
+    stats.adjustments = std::move(adjustments);
+    stats.warmed_up = warmup_stats.warmed_up;
+    stats.cold_run_ms = warmup_stats.cold_run_ms;
+    stats.warm_run_ms = warmup_stats.warm_run_ms;
     
-    // Update resource usage
-    used_npu_cores_ += config.npu_core_num;
-    used_memory_mb_ += 1024; // Estimate, should be calculated based on model size
-    updateResourceStats();
+    // Replace the reservation estimate with the measured footprint
+    used_memory_mb_ = used_memory_mb_ - kEstimatedModelMemoryMb + stats.model_memory_mb;
+    
+    auto table = std::make_shared<ModelTable>(*loadTable());
+    table->models[*handle] = instance;
+    publishTable(table);
     
     std::cout << "[RKLLMManager] Model created: " << model_id << std::endl;
+    std::cout << "[RKLLMManager] Model memory: " << stats.model_memory_mb << " MB"
+              << (stats.memory_measured ? " measured" : " estimated")
+              << " (embed_flash=" << (effective.embed_flash ? "on" : "off")
+              << ", context=" << effective.max_context_len << ")" << std::endl;
+    if (stats.warmed_up) {
+        std::cout << "[RKLLMManager] Warm-up: first run " << stats.cold_run_ms << " ms, warm "
+                  << stats.warm_run_ms << " ms" << std::endl;
+    }
     std::cout << "[RKLLMManager] NPU cores used: " << used_npu_cores_ << "/" << total_npu_cores_ << std::endl;
     
     return ManagerResult::SUCCESS;
 }
 
 ManagerResult RKLLMManager::destroyModel(LLMHandle handle) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = models_.find(handle);
-    if (it == models_.end()) {
-        return ManagerResult::ERROR_INVALID_HANDLE;
-    }
-    
-    auto& instance = it->second;
-    if (!instance || !instance->is_active) {
-        return ManagerResult::ERROR_INVALID_HANDLE;
+    std::shared_ptr<const ModelInstance> instance;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        auto current = loadTable();
+        auto it = current->models.find(handle);
+        if (it == current->models.end()) {
+            return ManagerResult::ERROR_INVALID_HANDLE;
+        }
+        
+        instance = it->second;
+        if (!instance || !instance->is_active) {
+            return ManagerResult::ERROR_INVALID_HANDLE;
+        }
+        
+        // Unpublish first so no new reader can find the handle
+        releaseResources(instance->config.npu_core_num, instance->stats.model_memory_mb);
+        auto table = std::make_shared<ModelTable>(*current);
+        table->models.erase(handle);
+        publishTable(table);
     }
     
-    // Destroy RKLLM handle
+    // Destroy RKLLM handle outside the writer lock
     int ret = rkllm_destroy(handle);
     if (ret != 0) {
         std::cout << "[RKLLMManager] Warning: rkllmDestroy returned: " << ret << std::endl;
     }
     
-    // Update resource usage
-    used_npu_cores_ -= instance->config.npu_core_num;
-    used_memory_mb_ -= 1024; // Should match allocation estimate
-    
     std::cout << "[RKLLMManager] Model destroyed: " << instance->model_id << std::endl;
     
-    models_.erase(it);
-    updateResourceStats();
-    
     return ManagerResult::SUCCESS;
 }
 
@@ -231,10 +790,9 @@ ManagerResult RKLLMManager::getModelConfig(LLMHandle handle, RKLLMModelConfig* c
         return ManagerResult::ERROR_INVALID_CONFIG;
     }
     
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = models_.find(handle);
-    if (it == models_.end() || !it->second->is_active) {
+    auto table = loadTable();
+    auto it = table->models.find(handle);
+    if (it == table->models.end() || !it->second->is_active) {
         return ManagerResult::ERROR_INVALID_HANDLE;
     }
     
@@ -242,25 +800,156 @@ ManagerResult RKLLMManager::getModelConfig(LLMHandle handle, RKLLMModelConfig* c
     return ManagerResult::SUCCESS;
 }
 
+ManagerResult RKLLMManager::getModelStats(LLMHandle handle, ModelStats* stats) const {
+    if (!stats) {
+        return ManagerResult::ERROR_INVALID_CONFIG;
+    }
+    
+    auto table = loadTable();
+    auto it = table->models.find(handle);
+    if (it == table->models.end() || !it->second->is_active) {
+        return ManagerResult::ERROR_INVALID_HANDLE;
+    }
+    
+    *stats = it->second->stats;
+    
+    // The two counters may be a record apart under concurrent inferences
+    const ThroughputCounters& counters = *it->second->throughput;
+    int64_t inferences = counters.inferences.load(std::memory_order_relaxed);
+    uint64_t sum_milli = counters.tokens_per_second_milli.load(std::memory_order_relaxed);
+    stats->inferences = inferences;
+    stats->average_tokens_per_second = inferences > 0 ?
+        static_cast<float>(sum_milli / 1000.0 / inferences) : 0.0f;
+    return ManagerResult::SUCCESS;
+}
+
+void RKLLMManager::recordThroughput(LLMHandle handle, float tokens_per_second) {
+    auto table = loadTable();
+    auto it = table->models.find(handle);
+    if (it == table->models.end() || !it->second->is_active || tokens_per_second < 0.0f) {
+        return;
+    }
+    
+    // Counters are shared across snapshots; no writer lock, no table copy
+    ThroughputCounters& counters = *it->second->throughput;
+    counters.tokens_per_second_milli.fetch_add(
+        static_cast<uint64_t>(tokens_per_second * 1000.0f + 0.5f), std::memory_order_relaxed);
+    counters.inferences.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::shared_ptr<std::mutex> RKLLMManager::getKvMutex(LLMHandle handle) const {
+    auto table = loadTable();
+    auto it = table->models.find(handle);
+    if (it == table->models.end() || !it->second->is_active) {
+        return nullptr;
+    }
+    return it->second->kv_mutex;
+}
+
 // Resource monitoring
 ResourceStats RKLLMManager::getResourceStats() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return resource_stats_;
+    ResourceStats stats = loadTable()->resource_stats;
+    
+    {
+        std::lock_guard<std::mutex> lock(thermal_mutex_);
+        if (thermal_) {
+            ThermalState thermal = thermal_->getState();
+            stats.temperature_c = thermal.temperature_c;
+            stats.thermal_level = thermal.level;
+            stats.thermal_scale = thermal.scale;
+            stats.throttle_events = thermal.throttle_events;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(telemetry_mutex_);
+    if (telemetry_) {
+        TelemetrySummary summary = telemetry_->getSummary();
+        stats.telemetry = telemetry_->getHistory();
+        stats.telemetry_available = summary.available;
+        if (summary.available) {
+            const TelemetrySample& latest = stats.telemetry.back();
+            if (latest.npu_available) {
+                stats.npu_utilization = summary.npu_load;
+            }
+            stats.npu_load_peak = summary.npu_load_peak;
+            stats.npu_core_load = latest.npu_core_load;
+            stats.ddr_load = summary.ddr_load;
+            stats.npu_freq_hz = latest.npu_freq_hz;
+            stats.ddr_freq_hz = latest.ddr_freq_hz;
+            stats.cpu_freq_khz = latest.cpu_freq_khz;
+            stats.bottleneck = summary.bottleneck;
+        }
+    }
+    return stats;
 }
 
-bool RKLLMManager::hasAvailableResources(const RKLLMModelConfig& config) const {
-    // Check NPU cores
-    if (used_npu_cores_ + config.npu_core_num > total_npu_cores_) {
-        return false;
-    }
+void RKLLMManager::enableThermalGovernor(const ThermalConfig& config) {
+    auto governor = std::make_unique<ThermalGovernor>(config);
+    governor->start();
     
-    // Estimate memory requirement (rough calculation)
-    size_t estimated_memory = 1024; // MB, should be based on actual model size
-    if (used_memory_mb_ + estimated_memory > total_memory_mb_ * 0.8) { // 80% limit
-        return false;
+    std::unique_ptr<ThermalGovernor> previous;
+    {
+        std::lock_guard<std::mutex> lock(thermal_mutex_);
+        previous = std::move(thermal_);
+        thermal_ = std::move(governor);
     }
+    // previous stops its thread outside the lock
+}
+
+void RKLLMManager::disableThermalGovernor() {
+    std::unique_ptr<ThermalGovernor> previous;
+    std::lock_guard<std::mutex> lock(thermal_mutex_);
+    previous = std::move(thermal_);
+}
+
+bool RKLLMManager::isThermalGovernorEnabled() const {
+    std::lock_guard<std::mutex> lock(thermal_mutex_);
+    return thermal_ != nullptr;
+}
+
+ThermalState RKLLMManager::getThermalState() const {
+    std::lock_guard<std::mutex> lock(thermal_mutex_);
+    return thermal_ ? thermal_->getState() : ThermalState();
+}
+
+int RKLLMManager::getThermalLimit(int base) const {
+    std::lock_guard<std::mutex> lock(thermal_mutex_);
+    return thermal_ ? thermal_->scaleLimit(base) : base;
+}
+
+void RKLLMManager::enableTelemetry(const TelemetryConfig& config) {
+    auto sampler = std::make_unique<HardwareTelemetry>(config);
+    sampler->start();
     
-    return true;
+    std::unique_ptr<HardwareTelemetry> previous;
+    {
+        std::lock_guard<std::mutex> lock(telemetry_mutex_);
+        previous = std::move(telemetry_);
+        telemetry_ = std::move(sampler);
+    }
+    // previous stops its thread outside the lock
+}
+
+void RKLLMManager::disableTelemetry() {
+    std::unique_ptr<HardwareTelemetry> previous;
+    std::lock_guard<std::mutex> lock(telemetry_mutex_);
+    previous = std::move(telemetry_);
+}
+
+bool RKLLMManager::isTelemetryEnabled() const {
+    std::lock_guard<std::mutex> lock(telemetry_mutex_);
+    return telemetry_ != nullptr;
+}
+
+TelemetrySummary RKLLMManager::getTelemetrySummary() const {
+    std::lock_guard<std::mutex> lock(telemetry_mutex_);
+    return telemetry_ ? telemetry_->getSummary() : TelemetrySummary();
+}
+
+bool RKLLMManager::hasAvailableResources(const RKLLMModelConfig& config) const {
+    // Lock-free check against the published usage (includes in-flight loads)
+    const ResourceStats& stats = loadTable()->resource_stats;
+    return checkResources(config, stats.npu_cores_used, stats.memory_usage_mb, stats.total_memory_mb);
 }
 
 // Static methods
@@ -296,28 +985,115 @@ RKLLMModelConfig RKLLMManager::getOptimizedConfig(const std::string& model_path)
     return config;
 }
 
+RKLLMModelConfig RKLLMManager::getLowMemoryConfig(const std::string& model_path, size_t memory_budget_mb) {
+    auto config = createDefaultConfig();
+    config.model_path = model_path;
+    config.embed_flash = true;
+    config.memory_budget_mb = memory_budget_mb;
+    config.max_context_len = 4096; // Let the budget decide
+    config.n_keep = 64;            // Retain the system prompt when the window shifts
+    return applyMemoryBudget(config);
+}
+
+void RKLLMManager::setMemoryProfile(const MemoryProfile& profile) {
+    std::lock_guard<std::mutex> lock(profile_mutex_);
+    memory_profile_ = profile;
+}
+
+MemoryProfile RKLLMManager::getMemoryProfile() const {
+    std::lock_guard<std::mutex> lock(profile_mutex_);
+    return memory_profile_;
+}
+
+RKLLMModelConfig RKLLMManager::applyMemoryProfile(const RKLLMModelConfig& config, const MemoryProfile& profile) {
+    RKLLMModelConfig resolved = config;
+    resolved.embed_flash = config.embed_flash || profile.embed_flash;
+    if (config.memory_budget_mb == 0) {
+        resolved.memory_budget_mb = profile.memory_budget_mb;
+    }
+    if (config.n_keep < 0) {
+        resolved.n_keep = profile.n_keep;
+    }
+    if (config.kv_bytes_per_token == 0) {
+        resolved.kv_bytes_per_token = profile.kv_bytes_per_token;
+    }
+    return resolved;
+}
+
+RKLLMModelConfig RKLLMManager::applyMemoryBudget(const RKLLMModelConfig& config, std::vector<std::string>* adjustments) {
+    RKLLMModelConfig effective = config;
+    
+    if (config.memory_budget_mb > 0) {
+        size_t bytes_per_token = config.kv_bytes_per_token > 0 ? config.kv_bytes_per_token : kDefaultKVBytesPerToken;
+        size_t budget_tokens = (config.memory_budget_mb * 1024 * 1024) / bytes_per_token;
+        
+        int capped = static_cast<int>(std::min<size_t>(budget_tokens, static_cast<size_t>(config.max_context_len)));
+        capped = std::max(kContextGranularity, capped - capped % kContextGranularity);
+        effective.max_context_len = std::min(config.max_context_len, capped);
+        if (adjustments && effective.max_context_len != config.max_context_len) {
+            adjustments->push_back("max_context_len: " + std::to_string(config.max_context_len) + " -> " +
+                                   std::to_string(effective.max_context_len) + " (" +
+                                   std::to_string(config.memory_budget_mb) + " MB KV budget)");
+        }
+    }
+    
+    // n_keep must leave room for the window to slide
+    if (effective.n_keep >= effective.max_context_len / 2) {
+        effective.n_keep = effective.max_context_len / 4;
+        if (adjustments) {
+            adjustments->push_back("n_keep: " + std::to_string(config.n_keep) + " -> " +
+                                   std::to_string(effective.n_keep) + " (must stay below half of max_context_len " +
+                                   std::to_string(effective.max_context_len) + ")");
+        }
+    }
+    
+    return effective;
+}
+
+size_t RKLLMManager::estimateModelMemoryMb(const RKLLMModelConfig& config) {
+    std::ifstream model(config.model_path, std::ios::binary | std::ios::ate);
+    std::streamoff file_bytes = model ? static_cast<std::streamoff>(model.tellg()) : 0;
+    if (file_bytes <= 0) {
+        return kEstimatedModelMemoryMb;
+    }
+    
+    size_t bytes_per_token = config.kv_bytes_per_token > 0 ? config.kv_bytes_per_token : kDefaultKVBytesPerToken;
+    size_t kv_bytes = bytes_per_token * static_cast<size_t>(std::max(0, config.max_context_len));
+    return (static_cast<size_t>(file_bytes) + kv_bytes) / (1024 * 1024);
+}
+
+bool RKLLMManager::checkResources(const RKLLMModelConfig& config, int used_npu_cores,
+                                  size_t used_memory_mb, size_t total_memory_mb) const {
+    // Check NPU cores
+    if (used_npu_cores + config.npu_core_num > total_npu_cores_) {
+        return false;
+    }
+    
+    // Estimate memory requirement (rough calculation)
+    if (used_memory_mb + kEstimatedModelMemoryMb > total_memory_mb * 0.8) { // 80% limit
+        return false;
+    }
+    
+    return true;
+}
+
 ManagerResult RKLLMManager::allocateResources(const RKLLMModelConfig& config) {
-    // Check if resources are available
-    if (!hasAvailableResources(config)) {
+    // Caller holds mutex_
+    if (!checkResources(config, used_npu_cores_, used_memory_mb_, total_memory_mb_)) {
         return ManagerResult::ERROR_RESOURCE_EXHAUSTED;
     }
     
-    // Reserve resources
+    // Reserve resources (memory estimate is replaced once the load is measured)
     used_npu_cores_ += config.npu_core_num;
-    used_memory_mb_ += 1024; // Estimate
+    used_memory_mb_ += kEstimatedModelMemoryMb;
     
     return ManagerResult::SUCCESS;
 }
 
-void RKLLMManager::deallocateResources(const std::string& model_id) {
-    // Find model by ID and deallocate resources
-    for (const auto& [handle, instance] : models_) {
-        if (instance && instance->model_id == model_id) {
-            used_npu_cores_ -= instance->config.npu_core_num;
-            used_memory_mb_ -= 1024; // Should match allocation
-            break;
-        }
-    }
+void RKLLMManager::releaseResources(int npu_cores, size_t memory_mb) {
+    // Caller holds mutex_
+    used_npu_cores_ -= npu_cores;
+    used_memory_mb_ -= std::min(memory_mb, used_memory_mb_);
 }
 
 std::string RKLLMManager::getErrorMessage(ManagerResult result) {
@@ -334,17 +1110,32 @@ std::string RKLLMManager::getErrorMessage(ManagerResult result) {
             return "Invalid model handle";
         case ManagerResult::ERROR_INITIALIZATION_FAILED:
             return "Manager not initialized";
+        case ManagerResult::ERROR_CANCELLED:
+            return "Operation cancelled";
         default:
             return "Unknown error";
     }
 }
 
+std::string RKLLMManager::getLoadStageName(LoadStage stage) {
+    switch (stage) {
+        case LoadStage::QUEUED: return "queued";
+        case LoadStage::VALIDATING: return "validating";
+        case LoadStage::LOADING: return "loading";
+        case LoadStage::WARMING_UP: return "warming_up";
+        case LoadStage::READY: return "ready";
+        case LoadStage::FAILED: return "failed";
+        case LoadStage::CANCELLED: return "cancelled";
+        default: return "unknown";
+    }
+}
+
 // Utility methods
 std::vector<std::string> RKLLMManager::getActiveModelIds() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto table = loadTable();
     
     std::vector<std::string> ids;
-    for (const auto& [handle, instance] : models_) {
+    for (const auto& [handle, instance] : table->models) {
         if (instance && instance->is_active) {
             ids.push_back(instance->model_id);
         }
@@ -353,22 +1144,85 @@ std::vector<std::string> RKLLMManager::getActiveModelIds() const {
 }
 
 size_t RKLLMManager::getActiveModelCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return models_.size();
+    return loadTable()->models.size();
 }
 
 // Private methods
+void RKLLMManager::joinWorkers() {
+    auto join = [](std::thread& thread) {
+        if (thread.get_id() == std::this_thread::get_id()) {
+            thread.detach(); // cleanup() called from a listener; this thread is already finishing
+        } else if (thread.joinable()) {
+            thread.join();
+        }
+    };
+    
+    // Preload coordinators first: once they are gone nothing starts new loads
+    std::vector<PreloadThread> preloaders;
+    {
+        std::lock_guard<std::mutex> lock(workers_mutex_);
+        preloaders.swap(preloaders_);
+        for (auto& loader : loaders_) {
+            loader.task->cancel();
+        }
+    }
+    for (auto& preloader : preloaders) {
+        preloader.task->cancel();
+    }
+    for (auto& preloader : preloaders) {
+        join(preloader.thread);
+    }
+    
+    std::vector<LoaderThread> loaders;
+    {
+        std::lock_guard<std::mutex> lock(workers_mutex_);
+        loaders.swap(loaders_);
+    }
+    for (auto& loader : loaders) {
+        loader.task->cancel();
+        join(loader.thread);
+    }
+}
+
 std::string RKLLMManager::generateModelId() {
     return "model_" + std::to_string(next_model_id_++);
 }
 
-void RKLLMManager::updateResourceStats() {
-    resource_stats_.npu_utilization = total_npu_cores_ > 0 ? 
+std::shared_ptr<const RKLLMManager::ModelTable> RKLLMManager::loadTable() const {
+    // Lock-free: a read is only retried when a publish flipped the slot under it
+    for (;;) {
+        int slot = current_table_.load();
+        table_readers_[slot].fetch_add(1);
+        if (current_table_.load() == slot) {
+            std::shared_ptr<const ModelTable> table = tables_[slot];
+            table_readers_[slot].fetch_sub(1, std::memory_order_release);
+            if (!table) {
+                static const auto empty_table = std::make_shared<const ModelTable>();
+                return empty_table;
+            }
+            return table;
+        }
+        table_readers_[slot].fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void RKLLMManager::publishTable(std::shared_ptr<ModelTable> table) {
+    // Caller holds mutex_; stats are derived from the writer-side counters
+    ResourceStats& stats = table->resource_stats;
+    stats.npu_utilization = total_npu_cores_ > 0 ? 
         (static_cast<float>(used_npu_cores_) / total_npu_cores_) * 100.0f : 0.0f;
-    resource_stats_.memory_usage_mb = used_memory_mb_;
-    resource_stats_.total_memory_mb = total_memory_mb_;
-    resource_stats_.active_models = static_cast<int>(models_.size());
-    resource_stats_.npu_cores_used = used_npu_cores_;
+    stats.memory_usage_mb = used_memory_mb_;
+    stats.total_memory_mb = total_memory_mb_;
+    stats.active_models = static_cast<int>(table->models.size());
+    stats.npu_cores_used = used_npu_cores_;
+    
+    // Only the writer waits: for readers still copying the previous table out of the spare slot
+    int spare = 1 - current_table_.load(std::memory_order_relaxed);
+    while (table_readers_[spare].load() != 0) {
+        std::this_thread::yield();
+    }
+    tables_[spare] = std::move(table);
+    current_table_.store(spare);
 }
 
 } // namespace core
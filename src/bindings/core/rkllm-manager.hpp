@@ -16,11 +16,20 @@
 #include <string>
 #include <unordered_map>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <thread>
 #include <vector>
 
 // RKLLM library integration
 #include "../../../libs/rkllm/include/rkllm.h"
 
+#include "hw-telemetry.hpp"
+#include "thermal-governor.hpp"
+
 namespace rkllmjs {
 namespace core {
     using LLMHandle = ::LLMHandle;
@@ -31,6 +40,20 @@ namespace core {
 namespace rkllmjs {
 namespace core {
 
+/**
+ * Receiver for results streamed by rkllm_run
+ * 
+ * Models are initialized with a manager-owned callback. Pass a pointer to a
+ * ResultSink as the userdata argument of rkllm_run to receive every result;
+ * the return value follows the RKLLM callback contract (0 = continue,
+ * 1 = pause). Without a sink, results are echoed to stdout.
+ */
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+    virtual int onResult(RKLLMResult* result, LLMCallState state) = 0;
+};
+
 /**
  * Result codes for RKLLM operations
  */
@@ -41,6 +64,7 @@ enum class ManagerResult {
     ERROR_RESOURCE_EXHAUSTED,
     ERROR_INVALID_HANDLE,
     ERROR_INITIALIZATION_FAILED,
+    ERROR_CANCELLED,
     ERROR_UNKNOWN
 };
 
@@ -58,20 +82,105 @@ struct RKLLMModelConfig {
     int npu_core_num = 3;
     bool use_gpu = false;
     
+    // Memory profile
+    bool embed_flash = false;          // Query word embeddings from flash instead of RAM
+    int n_keep = -1;                   // KV entries kept when shifting context (-1 = runtime default)
+    size_t memory_budget_mb = 0;       // Cap max_context_len so the KV cache fits (0 = no cap)
+    size_t kv_bytes_per_token = 0;     // KV cache bytes per token (0 = 7B-class estimate)
+    
+    // Input sequences processed together in one forward pass (each gets its own KV cache)
+    int n_batch = 1;
+    
+    // Private prompt caches of logits-mode requests (scoring, beam search) are written here
+    std::string scratch_dir = "/tmp";
+    
+    // Runtime Mirostat sampler (0 = off, 1 or 2 = version), aiming for tau bits of surprise per token
+    int mirostat = 0;
+    float mirostat_tau = 5.0f;
+    float mirostat_eta = 0.1f;         // Learning rate of the surprise target
+    
+    // Warm-up pass run before the model is published as ready
+    bool warmup = false;
+    std::string warmup_prompt = "Hello";
+    int warmup_runs = 2;               // The first run is cold, the rest measure warm latency
+    int warmup_tokens = 8;             // Tokens generated per run before it is stopped
+    
     // Validation
     bool isValid() const;
     std::string getValidationError() const;
 };
 
+/**
+ * Board-wide memory settings (config::MemoryProfile) applied by the manager
+ * to every load that leaves the corresponding field unset
+ */
+struct MemoryProfile {
+    bool embed_flash = false;          // Forces flash embeddings on
+    size_t memory_budget_mb = 0;       // Used when the config has no budget
+    int n_keep = -1;                   // Used when the config keeps the runtime default
+    size_t kv_bytes_per_token = 0;     // Used when the config has no estimate
+};
+
 /**
  * Resource usage statistics
  */
 struct ResourceStats {
-    float npu_utilization = 0.0f;     // Percentage 0-100
+    float npu_utilization = 0.0f;     // Percentage 0-100 (measured load while telemetry runs, else reserved cores)
     size_t memory_usage_mb = 0;       // Memory usage in MB
     size_t total_memory_mb = 0;       // Total available memory
     int active_models = 0;            // Number of active model instances
     int npu_cores_used = 0;          // NPU cores in use
+    
+    // Thermal governor (zero while it is disabled)
+    float temperature_c = 0.0f;       // Hottest thermal zone
+    int thermal_level = 0;            // Current throttle level (0 = unthrottled)
+    float thermal_scale = 1.0f;       // Fraction of concurrency/batch limits admitted
+    int64_t throttle_events = 0;      // Times the throttle level was raised
+    
+    // Hardware telemetry (zero/empty while it is disabled)
+    bool telemetry_available = false;
+    float npu_load_peak = 0.0f;       // Highest NPU load in the window
+    std::vector<float> npu_core_load; // Latest per-core load
+    float ddr_load = 0.0f;            // Mean DDR load over the window
+    int64_t npu_freq_hz = 0;          // Latest NPU clock
+    int64_t ddr_freq_hz = 0;          // Latest DDR clock
+    std::vector<int64_t> cpu_freq_khz; // Latest clock per CPU cluster
+    std::string bottleneck = "none";  // "npu", "memory" or "none"
+    std::vector<TelemetrySample> telemetry; // Recent samples, oldest first
+};
+
+/**
+ * Per-model memory footprint and observed throughput
+ * 
+ * Captures the RSS cost of a load next to the tokens/s achieved with it,
+ * so memory profiles can be compared on the same board.
+ */
+struct ModelStats {
+    size_t rss_before_mb = 0;          // Process RSS before rkllm_init
+    size_t rss_after_mb = 0;           // Process RSS after rkllm_init
+    size_t model_memory_mb = 0;        // Memory accounted to this model
+    bool memory_measured = false;      // model_memory_mb is this load's RSS delta (no other load overlapped)
+    float load_time_ms = 0.0f;         // Wall time spent in rkllm_init
+    int context_len = 0;               // Effective max_context_len after budget cap
+    int n_keep = -1;                   // Effective n_keep passed to the runtime
+    bool embed_flash = false;          // Whether embeddings are served from flash
+    std::vector<std::string> adjustments; // Fields the memory profile rewrote, e.g. "n_keep: 600 -> 128"
+    bool warmed_up = false;            // Warm-up completed before the model was published
+    float cold_run_ms = 0.0f;          // First inference after rkllm_init
+    float warm_run_ms = 0.0f;          // Average of the following warm-up runs
+    int64_t inferences = 0;            // Inferences recorded against this model
+    float average_tokens_per_second = 0.0f;
+};
+
+/**
+ * Throughput counters updated lock-free on every inference
+ * 
+ * Shared by all table snapshots of a model, so recording a run never
+ * copies or republishes the model table.
+ */
+struct ThroughputCounters {
+    std::atomic<int64_t> inferences{0};
+    std::atomic<uint64_t> tokens_per_second_milli{0};  // Sum of tokens/s in 1/1000 units
 };
 
 /**
@@ -82,9 +191,158 @@ struct ModelInstance {
     RKLLMModelConfig config;
     std::string model_id;
     bool is_active;
+    ModelStats stats;
+    std::shared_ptr<ThroughputCounters> throughput;
+    std::shared_ptr<std::mutex> kv_mutex;  // Held by whoever runs on or changes the handle's KV cache
     
     ModelInstance(LLMHandle h, const RKLLMModelConfig& cfg, const std::string& id)
-        : handle(h), config(cfg), model_id(id), is_active(true) {}
+        : handle(h), config(cfg), model_id(id), is_active(true),
+          throughput(std::make_shared<ThroughputCounters>()),
+          kv_mutex(std::make_shared<std::mutex>()) {}
+};
+
+/**
+ * Stages of an asynchronous model load
+ */
+enum class LoadStage {
+    QUEUED,
+    VALIDATING,
+    LOADING,
+    WARMING_UP,
+    READY,
+    FAILED,
+    CANCELLED
+};
+
+/**
+ * Progress event emitted while a model loads
+ */
+struct LoadProgress {
+    LoadStage stage = LoadStage::QUEUED;
+    float progress = 0.0f;             // Fraction 0.0-1.0
+    float elapsed_ms = 0.0f;           // Time since the load was requested
+    std::string message;
+};
+
+using LoadProgressCallback = std::function<void(const LoadProgress& progress)>;
+
+/**
+ * Completion listener of an asynchronous load
+ * 
+ * Runs once on the loader thread with the final result and the handle
+ * (nullptr unless the result is SUCCESS), before the task's future is
+ * made ready. It must not wait on its own task.
+ */
+using LoadDoneCallback = std::function<void(ManagerResult result, LLMHandle handle)>;
+
+/**
+ * Handle to a model load running on a background thread
+ * 
+ * Returned by RKLLMManager::createModelAsync. Progress callbacks run on
+ * the loader thread. Cancellation is honoured before rkllm_init starts;
+ * a load cancelled while rkllm_init runs is destroyed once it returns.
+ */
+class ModelLoadTask {
+public:
+    explicit ModelLoadTask(LoadProgressCallback on_progress, LoadDoneCallback on_done = nullptr);
+    
+    // Control
+    void cancel();
+    bool isCancelled() const;
+    
+    // Status
+    bool isDone() const;
+    LoadStage getStage() const;
+    LLMHandle getHandle() const;       // Valid once the stage is READY
+    
+    // Completion
+    ManagerResult wait() const;
+    bool waitFor(std::chrono::milliseconds timeout) const;
+    std::shared_future<ManagerResult> getFuture() const { return future_; }
+
+private:
+    friend class RKLLMManager;
+    
+    void report(LoadStage stage, float progress, const std::string& message);
+    void finish(ManagerResult result, LLMHandle handle);
+    
+    LoadProgressCallback on_progress_;
+    LoadDoneCallback on_done_;
+    std::atomic<bool> cancelled_{false};
+    std::atomic<LoadStage> stage_{LoadStage::QUEUED};
+    std::atomic<LLMHandle> handle_{nullptr};
+    std::chrono::steady_clock::time_point start_time_;
+    std::promise<ManagerResult> promise_;
+    std::shared_future<ManagerResult> future_;
+};
+
+/**
+ * One model in a startup preload
+ */
+struct PreloadRequest {
+    std::string id;                    // Caller's name for the model
+    RKLLMModelConfig config;
+    size_t memory_mb = 0;              // Expected footprint (0 = runtime estimate)
+};
+
+/**
+ * Outcome of one preloaded model
+ */
+struct PreloadResult {
+    std::string id;
+    bool done = false;
+    ManagerResult result = ManagerResult::ERROR_UNKNOWN;
+    LLMHandle handle = nullptr;        // Valid when result is SUCCESS
+    float queued_ms = 0.0f;            // Waiting for memory or a load slot
+    float load_ms = 0.0f;              // From load start to ready
+};
+
+/**
+ * Per-model and total startup timings of a preload
+ */
+struct PreloadReport {
+    std::vector<PreloadResult> models;
+    float total_ms = 0.0f;             // Until the last model finished
+    bool done = false;
+    bool ready = false;                // Every model loaded successfully
+};
+
+using PreloadDoneCallback = std::function<void(const PreloadReport& report)>;
+
+/**
+ * Handle to a set of models loading in parallel at startup
+ * 
+ * Returned by RKLLMManager::preloadModels. Loads start as long as load
+ * slots and the memory budget allow; a model that does not fit waits for
+ * earlier loads to finish (or fail) instead of oversubscribing the board.
+ */
+class PreloadTask {
+public:
+    explicit PreloadTask(PreloadDoneCallback on_done = nullptr) : on_done_(std::move(on_done)) {}
+    
+    // Stops starting models and cancels loads in flight
+    void cancel();
+    bool isCancelled() const;
+    
+    bool isDone() const;
+    bool isReady() const;              // Done and every model resident
+    bool waitFor(std::chrono::milliseconds timeout) const;
+    bool wait() const;                 // Returns isReady()
+    
+    PreloadReport getReport() const;
+    LLMHandle getHandle(const std::string& id) const;
+
+private:
+    friend class RKLLMManager;
+    
+    void update(size_t index, const PreloadResult& result);
+    void finish(float total_ms);
+    
+    PreloadDoneCallback on_done_;
+    std::atomic<bool> cancelled_{false};
+    mutable std::mutex mutex_;
+    mutable std::condition_variable done_cv_;
+    PreloadReport report_;
 };
 
 /**
@@ -92,6 +350,13 @@ struct ModelInstance {
  * 
  * Thread-safe singleton that manages RKLLM model instances,
  * resource allocation, and configuration validation.
+ * 
+ * The model table is published as an immutable snapshot: accessors read
+ * it without any lock, and writers copy, modify and republish it. The
+ * pointer is double-buffered rather than a std::atomic_load'ed shared_ptr,
+ * which takes a hidden lock in libstdc++. rkllm_init/rkllm_destroy run
+ * outside the writer lock, so a multi-second model load never stalls
+ * readers or other loads.
  */
 class RKLLMManager {
 public:
@@ -108,13 +373,16 @@ public:
     /**
      * @brief Cleanup all models and release system resources
      * @return ManagerResult::SUCCESS on success, error code on failure
-     * @note Destroys all active models and releases NPU resources. Thread-safe.
+     * @note Destroys all active models and releases NPU resources. Cancels
+     *       background loads and waits for their threads, so it blocks until
+     *       an rkllm_init already in progress returns. Thread-safe.
      */
     ManagerResult cleanup();
     
     /**
      * @brief Check if the manager has been initialized
      * @return true if initialized, false otherwise
+     * @note Lock-free.
      */
     bool isInitialized() const;
     
@@ -127,6 +395,20 @@ public:
      */
     ManagerResult createModel(const RKLLMModelConfig& config, LLMHandle* handle);
     
+    /**
+     * @brief Load a model on a background thread
+     * @param config Model configuration parameters
+     * @param on_progress Optional progress listener (runs on the loader thread)
+     * @param on_done Optional completion listener (runs on the loader thread)
+     * @return Task handle, returned immediately; wait on it for the result
+     * @note Loads run in parallel as long as NPU cores and memory allow. The
+     *       loader thread is owned by the manager: cleanup() cancels it and
+     *       joins it. Thread-safe.
+     */
+    std::shared_ptr<ModelLoadTask> createModelAsync(const RKLLMModelConfig& config,
+                                                    LoadProgressCallback on_progress = nullptr,
+                                                    LoadDoneCallback on_done = nullptr);
+    
     /**
      * @brief Destroy an existing model instance and free its resources
      * @param handle Handle to the model to destroy
@@ -140,13 +422,40 @@ public:
      * @param handle Handle to the model
      * @param config Output parameter for the model configuration
      * @return ManagerResult::SUCCESS on success, error code on failure
+     * @note Reads the published snapshot; never waits for a model load.
      */
     ManagerResult getModelConfig(LLMHandle handle, RKLLMModelConfig* config);
     
+    /**
+     * @brief Get memory footprint and throughput statistics of a model
+     * @param handle Handle to the model
+     * @param stats Output parameter for the model statistics
+     * @return ManagerResult::SUCCESS on success, error code on failure
+     */
+    ManagerResult getModelStats(LLMHandle handle, ModelStats* stats) const;
+    
+    /**
+     * @brief Record the throughput of a completed inference on a model
+     * @param handle Handle to the model the inference ran on
+     * @param tokens_per_second Observed generation throughput
+     * @note Unknown handles are ignored. Does not take the writer lock or copy the table.
+     */
+    void recordThroughput(LLMHandle handle, float tokens_per_second);
+    
+    /**
+     * @brief Get the lock that serializes KV cache use of a model
+     * @param handle Handle to the model
+     * @return Mutex shared by every user of the handle, or nullptr for unknown handles
+     * @note rkllm_run, prompt-cache loads, KV clears and chat-template changes on
+     *       one handle must all happen under this lock. Lock-free lookup.
+     */
+    std::shared_ptr<std::mutex> getKvMutex(LLMHandle handle) const;
+    
     /**
      * @brief Get current resource usage statistics
      * @return ResourceStats structure with current usage information
-     * @note Includes NPU utilization, memory usage, and active model count
+     * @note Includes NPU utilization, memory usage, and active model count.
+     *       Reads the published snapshot; never waits for a model load.
      */
     ResourceStats getResourceStats() const;
     
@@ -157,11 +466,95 @@ public:
      */
     bool hasAvailableResources(const RKLLMModelConfig& config) const;
     
+    /**
+     * @brief Start sampling SoC temperatures to throttle inference concurrency
+     * @param config Thermal zone root, trip point and hysteresis settings
+     * @note Independent of initialize()/cleanup(); replaces a running governor.
+     */
+    void enableThermalGovernor(const ThermalConfig& config = ThermalConfig());
+    void disableThermalGovernor();
+    bool isThermalGovernorEnabled() const;
+    ThermalState getThermalState() const;
+    
+    /**
+     * @brief Scale a concurrency or batch-size limit by the thermal throttle level
+     * @param base Limit configured for a cool device
+     * @return base while the governor is disabled, otherwise at least 1
+     */
+    int getThermalLimit(int base) const;
+    
+    /**
+     * @brief Start sampling NPU/DDR load and clock frequencies in the background
+     * @param config Source paths, sample interval and ring size
+     * @note Independent of initialize()/cleanup(); replaces a running sampler.
+     *       While enabled, getResourceStats() reports measured load and history.
+     */
+    void enableTelemetry(const TelemetryConfig& config = TelemetryConfig());
+    void disableTelemetry();
+    bool isTelemetryEnabled() const;
+    TelemetrySummary getTelemetrySummary() const;
+    
+    /**
+     * @brief Load several models in parallel, bounded by load slots and memory
+     * @param requests Models to load; ids are echoed in the report
+     * @param max_parallel Maximum concurrent loads
+     * @param on_done Optional listener for the final report, run on the
+     *        coordinator thread before waiters on the task are released
+     * @return Task handle, returned immediately; it also drives isReady()
+     * @note Memory is budgeted against 80% of RAM minus current usage. The
+     *       coordinator thread is owned by the manager: cleanup() cancels the
+     *       preload and joins it. Thread-safe.
+     */
+    std::shared_ptr<PreloadTask> preloadModels(const std::vector<PreloadRequest>& requests, int max_parallel = 2,
+                                               PreloadDoneCallback on_done = nullptr);
+    
+    /**
+     * @brief Readiness signal for serving traffic
+     * @return true once initialized and the last preload has every model resident
+     * @note Without a preload this is the same as isInitialized(). Thread-safe.
+     */
+    bool isReady() const;
+    bool waitUntilReady(std::chrono::milliseconds timeout) const;
+    std::shared_ptr<PreloadTask> getPreloadTask() const;
+    
     // Configuration validation
     static ManagerResult validateConfig(const RKLLMModelConfig& config);
     static RKLLMModelConfig createDefaultConfig();  // Add this method
     static RKLLMModelConfig getDefaultConfig();
     static RKLLMModelConfig getOptimizedConfig(const std::string& model_path);
+    static RKLLMModelConfig getLowMemoryConfig(const std::string& model_path, size_t memory_budget_mb);
+    
+    /**
+     * @brief Set the memory profile applied to subsequent loads
+     * @param profile Board-wide defaults, normally from ConfigManager::getMemoryProfileForHardware
+     */
+    void setMemoryProfile(const MemoryProfile& profile);
+    MemoryProfile getMemoryProfile() const;
+    
+    /**
+     * @brief Fill the memory fields a configuration leaves unset from a profile
+     * @param config Configuration to resolve
+     * @param profile Board-wide memory settings
+     * @return Copy with the profile applied
+     */
+    static RKLLMModelConfig applyMemoryProfile(const RKLLMModelConfig& config, const MemoryProfile& profile);
+    
+    /**
+     * @brief Apply the memory budget of a configuration
+     * @param config Configuration to resolve
+     * @param adjustments Optional output listing every field that was changed and why
+     * @return Copy with max_context_len capped to the budget and n_keep clamped to it
+     */
+    static RKLLMModelConfig applyMemoryBudget(const RKLLMModelConfig& config,
+                                              std::vector<std::string>* adjustments = nullptr);
+    
+    /**
+     * @brief Estimate a model's resident footprint from its file and KV cache size
+     * @param config Resolved configuration (after applyMemoryBudget)
+     * @return Model file size plus max_context_len KV entries, in MB
+     * @note Used when a load overlapped another and its RSS delta cannot be attributed.
+     */
+    static size_t estimateModelMemoryMb(const RKLLMModelConfig& config);
     
     // Utility
     std::vector<std::string> getActiveModelIds() const;
@@ -169,6 +562,7 @@ public:
     
     // Error handling
     static std::string getErrorMessage(ManagerResult result);
+    static std::string getLoadStageName(LoadStage stage);
 
 private:
     // Singleton
@@ -177,20 +571,73 @@ private:
     RKLLMManager(const RKLLMManager&) = delete;
     RKLLMManager& operator=(const RKLLMManager&) = delete;
     
-    // Internal methods
+    /**
+     * Immutable model table snapshot shared with readers
+     */
+    struct ModelTable {
+        std::unordered_map<LLMHandle, std::shared_ptr<const ModelInstance>> models;
+        ResourceStats resource_stats;
+    };
+    
+    // Internal methods (writer side requires mutex_)
+    ManagerResult loadModel(const RKLLMModelConfig& config, LLMHandle* handle, ModelLoadTask* task);
     std::string generateModelId();
+    bool checkResources(const RKLLMModelConfig& config, int used_npu_cores,
+                        size_t used_memory_mb, size_t total_memory_mb) const;
     ManagerResult allocateResources(const RKLLMModelConfig& config);
-    void deallocateResources(const std::string& model_id);
-    void updateResourceStats();
+    void releaseResources(int npu_cores, size_t memory_mb);
+    std::shared_ptr<const ModelTable> loadTable() const;
+    void publishTable(std::shared_ptr<ModelTable> table);
+    void joinWorkers();
     
     // Member variables
-    mutable std::mutex mutex_;
-    bool initialized_ = false;
-    std::unordered_map<LLMHandle, std::unique_ptr<ModelInstance>> models_;
-    ResourceStats resource_stats_;
+    mutable std::mutex mutex_;                   // Serializes writers only
+    std::atomic<bool> initialized_{false};
+    
+    // Published table, double-buffered so readers never take a lock: a reader pins
+    // the current slot in its counter and copies the pointer; a writer fills the
+    // other slot once its pinned readers are gone, then flips current_table_
+    std::shared_ptr<const ModelTable> tables_[2];
+    std::atomic<int> current_table_{0};
+    mutable std::atomic<int64_t> table_readers_[2] = {{0}, {0}};
     size_t next_model_id_ = 1;
+    uint64_t generation_ = 0;                    // Bumped by cleanup() to orphan in-flight loads
+    
+    // Background load and preload threads; joined by cleanup() and the destructor
+    struct LoaderThread {
+        std::shared_ptr<ModelLoadTask> task;
+        std::thread thread;
+    };
+    struct PreloadThread {
+        std::shared_ptr<PreloadTask> task;
+        std::thread thread;
+    };
+    std::mutex workers_mutex_;
+    std::vector<LoaderThread> loaders_;
+    std::vector<PreloadThread> preloaders_;
+    
+    // Startup preload driving the readiness signal
+    mutable std::mutex preload_mutex_;
+    std::shared_ptr<PreloadTask> preload_;
+    
+    // Optional thermal governor
+    mutable std::mutex thermal_mutex_;
+    std::unique_ptr<ThermalGovernor> thermal_;
+    
+    // Optional hardware telemetry sampler
+    mutable std::mutex telemetry_mutex_;
+    std::unique_ptr<HardwareTelemetry> telemetry_;
+    
+    // Board-wide memory profile
+    mutable std::mutex profile_mutex_;
+    MemoryProfile memory_profile_;
+    
+    // rkllm_init calls in progress and started; RSS is process-wide, so a
+    // load's delta is attributed to it only if no other init overlapped
+    std::atomic<int> inits_running_{0};
+    std::atomic<uint64_t> inits_started_{0};
     
-    // Resource tracking
+    // Resource tracking (writer side, includes in-flight reservations)
     int total_npu_cores_ = 3;
     size_t total_memory_mb_ = 0;
     int used_npu_cores_ = 0;
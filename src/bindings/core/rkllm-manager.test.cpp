@@ -1,8 +1,12 @@
 #include "rkllm-manager.hpp"
 #include "../testing/rkllmjs-test.hpp"
 #include <thread>
+#include <atomic>
+#include <future>
+#include <mutex>
 #include <chrono>
 #include <vector>
+#include <algorithm>
 
 using namespace rkllmjs::core;
 using namespace rkllmjs::testing;
@@ -18,6 +22,7 @@ namespace core {
             case ManagerResult::ERROR_RESOURCE_EXHAUSTED: return os << "ERROR_RESOURCE_EXHAUSTED";
             case ManagerResult::ERROR_INVALID_HANDLE: return os << "ERROR_INVALID_HANDLE";
             case ManagerResult::ERROR_INITIALIZATION_FAILED: return os << "ERROR_INITIALIZATION_FAILED";
+            case ManagerResult::ERROR_CANCELLED: return os << "ERROR_CANCELLED";
             case ManagerResult::ERROR_UNKNOWN: return os << "ERROR_UNKNOWN";
             default: return os << "UNKNOWN_RESULT";
         }
@@ -109,6 +114,7 @@ TEST(RKLLMManagerTest, ErrorMessages) {
     EXPECT_FALSE(RKLLMManager::getErrorMessage(ManagerResult::ERROR_RESOURCE_EXHAUSTED).empty());
     EXPECT_FALSE(RKLLMManager::getErrorMessage(ManagerResult::ERROR_INVALID_HANDLE).empty());
     EXPECT_FALSE(RKLLMManager::getErrorMessage(ManagerResult::ERROR_INITIALIZATION_FAILED).empty());
+    EXPECT_FALSE(RKLLMManager::getErrorMessage(ManagerResult::ERROR_CANCELLED).empty());
 }
 
 TEST(RKLLMManagerTest, ResourceMonitoring) {
@@ -179,6 +185,349 @@ TEST(RKLLMManagerTest, InvalidHandleOperations) {
     EXPECT_EQ(ManagerResult::ERROR_INVALID_HANDLE, manager.destroyModel(INVALID_HANDLE_TEST));
 }
 
+TEST(RKLLMManagerTest, LowMemoryProfile) {
+    // Low-memory profile enables flash embeddings and caps the context by budget
+    auto config = RKLLMManager::getLowMemoryConfig("../../../models/test.rkllm", 128);
+    EXPECT_TRUE(config.isValid());
+    EXPECT_TRUE(config.embed_flash);
+    EXPECT_EQ(128u, config.memory_budget_mb);
+    EXPECT_LT(config.max_context_len, 4096);
+    EXPECT_EQ(0, config.max_context_len % 64);
+    EXPECT_LT(config.n_keep, config.max_context_len / 2);
+    
+    // Budget of 64 MB at 64 KB per token leaves room for 1024 tokens
+    auto budgeted = createTestConfig();
+    budgeted.max_context_len = 4096;
+    budgeted.kv_bytes_per_token = 64 * 1024;
+    budgeted.memory_budget_mb = 64;
+    EXPECT_EQ(1024, RKLLMManager::applyMemoryBudget(budgeted).max_context_len);
+    
+    // Budget never raises the configured context
+    budgeted.max_context_len = 256;
+    EXPECT_EQ(256, RKLLMManager::applyMemoryBudget(budgeted).max_context_len);
+    
+    // No budget leaves the config untouched
+    auto unbudgeted = createTestConfig();
+    EXPECT_EQ(unbudgeted.max_context_len, RKLLMManager::applyMemoryBudget(unbudgeted).max_context_len);
+    
+    // n_keep must fit inside the context window
+    auto invalid_config = createTestConfig();
+    invalid_config.n_keep = invalid_config.max_context_len;
+    EXPECT_FALSE(invalid_config.isValid());
+    
+    // n_batch is a uint8_t in RKLLMExtendParam
+    auto batched = createTestConfig();
+    batched.n_batch = 4;
+    EXPECT_TRUE(batched.isValid());
+    batched.n_batch = 256;
+    EXPECT_FALSE(batched.isValid());
+    batched.n_batch = 4;
+    batched.scratch_dir.clear();
+    EXPECT_FALSE(batched.isValid());
+    
+    auto mirostat = createTestConfig();
+    mirostat.mirostat = 2;
+    mirostat.mirostat_tau = 3.0f;
+    EXPECT_TRUE(mirostat.isValid());
+    mirostat.mirostat = 3;
+    EXPECT_FALSE(mirostat.isValid());
+    EXPECT_EQ("mirostat must be 0, 1 or 2", mirostat.getValidationError());
+    mirostat.mirostat = 2;
+    mirostat.mirostat_eta = 0.0f;
+    EXPECT_FALSE(mirostat.isValid());
+}
+
+TEST(RKLLMManagerTest, MemoryProfileAndAdjustments) {
+    // The board profile fills only what the config leaves unset
+    MemoryProfile profile;
+    profile.embed_flash = true;
+    profile.memory_budget_mb = 64;
+    profile.n_keep = 32;
+    auto config = createTestConfig();
+    config.memory_budget_mb = 16;
+    auto resolved = RKLLMManager::applyMemoryProfile(config, profile);
+    EXPECT_TRUE(resolved.embed_flash);
+    EXPECT_EQ(16u, resolved.memory_budget_mb);
+    EXPECT_EQ(32, resolved.n_keep);
+    
+    auto& manager = RKLLMManager::getInstance();
+    manager.setMemoryProfile(profile);
+    EXPECT_EQ(32, manager.getMemoryProfile().n_keep);
+    manager.setMemoryProfile(MemoryProfile());
+    
+    // Every rewritten field is reported
+    std::vector<std::string> adjustments;
+    auto budgeted = createTestConfig();
+    budgeted.max_context_len = 4096;
+    budgeted.kv_bytes_per_token = 64 * 1024;
+    budgeted.memory_budget_mb = 64;
+    budgeted.n_keep = 600;
+    auto effective = RKLLMManager::applyMemoryBudget(budgeted, &adjustments);
+    EXPECT_EQ(256, effective.n_keep);
+    EXPECT_EQ(2u, adjustments.size());
+    EXPECT_EQ("max_context_len: 4096 -> 1024 (64 MB KV budget)", adjustments[0]);
+    EXPECT_EQ(0u, adjustments[1].find("n_keep: 600 -> 256"));
+    
+    adjustments.clear();
+    RKLLMManager::applyMemoryBudget(createTestConfig(), &adjustments);
+    EXPECT_TRUE(adjustments.empty());
+    
+    // Loads that cannot be measured alone are estimated from the file and KV size
+    auto missing = createTestConfig();
+    missing.model_path = "/invalid/path/to/model.rkllm";
+    EXPECT_EQ(1024u, RKLLMManager::estimateModelMemoryMb(missing));
+}
+
+TEST(RKLLMManagerTest, ModelStats) {
+    auto& manager = RKLLMManager::getInstance();
+    
+    // Stats are only available for live handles
+    ModelStats stats;
+    EXPECT_EQ(ManagerResult::ERROR_INVALID_HANDLE, manager.getModelStats(INVALID_HANDLE_TEST, &stats));
+    EXPECT_EQ(ManagerResult::ERROR_INVALID_CONFIG, manager.getModelStats(INVALID_HANDLE_TEST, nullptr));
+    
+    // Recording throughput for unknown handles is a no-op
+    manager.recordThroughput(INVALID_HANDLE_TEST, 10.0f);
+    EXPECT_TRUE(manager.getKvMutex(INVALID_HANDLE_TEST) == nullptr);
+    
+    // Snapshot copies of an instance share one set of counters
+    ModelInstance instance(INVALID_HANDLE_TEST, createTestConfig(), "model_test");
+    ModelInstance snapshot(instance);
+    snapshot.throughput->inferences.fetch_add(1);
+    EXPECT_EQ(1, instance.throughput->inferences.load());
+    EXPECT_TRUE(snapshot.kv_mutex == instance.kv_mutex);
+}
+
+TEST(RKLLMManagerTest, ReadersDuringModelLoad) {
+    auto& manager = RKLLMManager::getInstance();
+    EXPECT_EQ(ManagerResult::SUCCESS, manager.initialize());
+    
+    // Readers poll the published snapshot while loads run concurrently
+    std::atomic<bool> done{false};
+    std::atomic<int64_t> reads{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            RKLLMModelConfig config;
+            while (!done.load()) {
+                auto stats = manager.getResourceStats();
+                (void)stats;
+                (void)manager.getActiveModelIds();
+                (void)manager.getModelConfig(INVALID_HANDLE_TEST, &config);
+                EXPECT_TRUE(manager.isInitialized());
+                reads++;
+            }
+        });
+    }
+    
+    auto config = createTestConfig();
+    config.model_path = "/invalid/path/to/model.rkllm";
+    config.npu_core_num = 1;
+    std::vector<std::thread> loaders;
+    for (int i = 0; i < 3; ++i) {
+        loaders.emplace_back([&]() {
+            LLMHandle handle = nullptr;
+            EXPECT_NE(ManagerResult::SUCCESS, manager.createModel(config, &handle));
+        });
+    }
+    for (auto& loader : loaders) loader.join();
+    
+    done = true;
+    for (auto& reader : readers) reader.join();
+    EXPECT_GT(reads.load(), 0);
+    
+    // Failed loads release their reservations
+    auto stats = manager.getResourceStats();
+    EXPECT_EQ(0, stats.npu_cores_used);
+    EXPECT_EQ(0, stats.active_models);
+    EXPECT_EQ(0u, stats.memory_usage_mb);
+    
+    manager.cleanup();
+    EXPECT_FALSE(manager.isInitialized());
+}
+
+TEST(RKLLMManagerTest, AsyncModelLoad) {
+    auto& manager = RKLLMManager::getInstance();
+    EXPECT_EQ(ManagerResult::SUCCESS, manager.initialize());
+    
+    auto config = createTestConfig();
+    config.model_path = "/invalid/path/to/model.rkllm";
+    config.npu_core_num = 1;
+    
+    // Progress events arrive in stage order and end in a terminal stage
+    std::mutex stages_mutex;
+    std::vector<LoadStage> stages;
+    auto task = manager.createModelAsync(config, [&](const LoadProgress& progress) {
+        std::lock_guard<std::mutex> lock(stages_mutex);
+        stages.push_back(progress.stage);
+    });
+    EXPECT_TRUE(task != nullptr);
+    
+    EXPECT_EQ(ManagerResult::ERROR_MODEL_LOAD_FAILED, task->wait());
+    EXPECT_TRUE(task->isDone());
+    EXPECT_TRUE(task->getStage() == LoadStage::FAILED);
+    EXPECT_TRUE(task->getHandle() == nullptr);
+    {
+        std::lock_guard<std::mutex> lock(stages_mutex);
+        EXPECT_TRUE(stages.size() >= 3);
+        EXPECT_TRUE(stages.front() == LoadStage::QUEUED);
+        EXPECT_TRUE(stages.back() == LoadStage::FAILED);
+    }
+    
+    // Several loads proceed in parallel and release their reservations
+    std::vector<std::shared_ptr<ModelLoadTask>> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(manager.createModelAsync(config));
+    }
+    for (auto& pending : tasks) {
+        EXPECT_TRUE(pending->waitFor(std::chrono::seconds(30)));
+        EXPECT_NE(ManagerResult::SUCCESS, pending->wait());
+    }
+    EXPECT_EQ(0, manager.getResourceStats().npu_cores_used);
+    
+    manager.cleanup();
+}
+
+TEST(RKLLMManagerTest, AsyncModelLoadCancellation) {
+    auto& manager = RKLLMManager::getInstance();
+    EXPECT_EQ(ManagerResult::SUCCESS, manager.initialize());
+    
+    // Hold the loader at QUEUED until the cancel request has been issued
+    std::promise<void> cancel_issued;
+    std::shared_future<void> cancel_ready = cancel_issued.get_future().share();
+    auto task = manager.createModelAsync(createTestConfig(), [cancel_ready](const LoadProgress& progress) {
+        if (progress.stage == LoadStage::QUEUED) {
+            cancel_ready.wait();
+        }
+    });
+    task->cancel();
+    cancel_issued.set_value();
+    
+    EXPECT_TRUE(task->isCancelled());
+    EXPECT_EQ(ManagerResult::ERROR_CANCELLED, task->wait());
+    EXPECT_TRUE(task->getStage() == LoadStage::CANCELLED);
+    EXPECT_EQ(0, manager.getResourceStats().npu_cores_used);
+    EXPECT_EQ(0u, manager.getActiveModelCount());
+    
+    // cleanup() cancels loads in flight and returns only once their threads are done
+    std::promise<void> cleanup_started;
+    std::shared_future<void> cleanup_ready = cleanup_started.get_future().share();
+    std::atomic<bool> listener_done{false};
+    auto held = manager.createModelAsync(createTestConfig(),
+        [cleanup_ready](const LoadProgress& progress) {
+            if (progress.stage == LoadStage::QUEUED) {
+                cleanup_ready.wait();
+            }
+        },
+        [&listener_done](ManagerResult, LLMHandle) { listener_done = true; });
+    std::thread releaser([&cleanup_started]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        cleanup_started.set_value();
+    });
+    manager.cleanup();
+    releaser.join();
+    EXPECT_TRUE(held->isDone());
+    EXPECT_TRUE(listener_done);
+    EXPECT_NE(ManagerResult::SUCCESS, held->wait());
+    
+    // Loads requested before initialization fail without blocking the caller
+    auto uninitialized = manager.createModelAsync(createTestConfig());
+    EXPECT_EQ(ManagerResult::ERROR_INITIALIZATION_FAILED, uninitialized->wait());
+    EXPECT_EQ("ready", RKLLMManager::getLoadStageName(LoadStage::READY));
+}
+
+TEST(RKLLMManagerTest, ParallelPreload) {
+    auto& manager = RKLLMManager::getInstance();
+    EXPECT_EQ(ManagerResult::SUCCESS, manager.initialize());
+    
+    // Nothing to preload: ready as soon as the manager is
+    auto empty = manager.preloadModels({});
+    EXPECT_TRUE(empty->waitFor(std::chrono::seconds(5)));
+    EXPECT_TRUE(empty->isReady());
+    EXPECT_TRUE(manager.isReady());
+    
+    auto config = createTestConfig();
+    config.model_path = "/invalid/path/to/model.rkllm";
+    config.npu_core_num = 1;
+    
+    std::vector<PreloadRequest> requests;
+    for (const char* id : {"a", "b", "c"}) {
+        PreloadRequest request;
+        request.id = id;
+        request.config = config;
+        requests.push_back(request);
+    }
+    // "b" cannot fit next to anything else, so it waits for "a" to finish
+    requests[1].memory_mb = static_cast<size_t>(1) << 40;
+    
+    auto task = manager.preloadModels(requests, 2);
+    EXPECT_TRUE(task->waitFor(std::chrono::seconds(30)));
+    EXPECT_FALSE(task->wait());
+    EXPECT_FALSE(manager.isReady());
+    EXPECT_FALSE(manager.waitUntilReady(std::chrono::milliseconds(10)));
+    
+    PreloadReport report = task->getReport();
+    EXPECT_TRUE(report.done);
+    EXPECT_FALSE(report.ready);
+    EXPECT_EQ(3u, report.models.size());
+    for (const auto& model : report.models) {
+        EXPECT_TRUE(model.done);
+        EXPECT_EQ(ManagerResult::ERROR_MODEL_LOAD_FAILED, model.result);
+        EXPECT_TRUE(model.handle == nullptr);
+        EXPECT_LE(model.queued_ms + model.load_ms, report.total_ms + 1.0f);
+    }
+    EXPECT_GE(report.models[1].queued_ms, report.models[0].queued_ms + report.models[0].load_ms);
+    EXPECT_TRUE(task->getHandle("a") == nullptr);
+    EXPECT_EQ(0, manager.getResourceStats().npu_cores_used);
+    
+    // cleanup() cancels a running preload; the listener sees the final report first
+    std::atomic<bool> listener_done{false};
+    auto cancelled = manager.preloadModels(requests, 1, [&](const PreloadReport& final_report) {
+        EXPECT_TRUE(final_report.done);
+        EXPECT_EQ(3u, final_report.models.size());
+        listener_done = true;
+    });
+    manager.cleanup();
+    EXPECT_TRUE(cancelled->isDone());
+    EXPECT_TRUE(cancelled->isCancelled());
+    EXPECT_TRUE(listener_done);
+    EXPECT_FALSE(cancelled->isReady());
+    EXPECT_FALSE(manager.isReady());
+}
+
+TEST(RKLLMManagerTest, WarmupConfig) {
+    auto config = createTestConfig();
+    config.warmup = true;
+    EXPECT_TRUE(config.isValid());
+    
+    config.warmup_runs = 0;
+    EXPECT_FALSE(config.isValid());
+    EXPECT_EQ("warmup_runs must be 1-8", config.getValidationError());
+    config.warmup_runs = 2;
+    config.warmup_prompt.clear();
+    EXPECT_FALSE(config.isValid());
+    
+    // Warm-up settings are ignored while it is disabled
+    config.warmup = false;
+    EXPECT_TRUE(config.isValid());
+    EXPECT_EQ("warming_up", RKLLMManager::getLoadStageName(LoadStage::WARMING_UP));
+    
+    // A load that fails never reaches warm-up or the ready stage
+    auto& manager = RKLLMManager::getInstance();
+    EXPECT_EQ(ManagerResult::SUCCESS, manager.initialize());
+    config = createTestConfig();
+    config.model_path = "/invalid/path/to/model.rkllm";
+    config.warmup = true;
+    std::vector<LoadStage> stages;
+    auto task = manager.createModelAsync(config, [&stages](const LoadProgress& progress) {
+        stages.push_back(progress.stage);
+    });
+    EXPECT_EQ(ManagerResult::ERROR_MODEL_LOAD_FAILED, task->wait());
+    EXPECT_TRUE(std::find(stages.begin(), stages.end(), LoadStage::WARMING_UP) == stages.end());
+    EXPECT_EQ(0u, manager.getActiveModelCount());
+    manager.cleanup();
+}
+
 TEST(RKLLMManagerTest, UtilityFunctions) {
     auto& manager = RKLLMManager::getInstance();
     
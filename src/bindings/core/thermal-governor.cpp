@@ -0,0 +1,208 @@
+#include "thermal-governor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+#include <dirent.h>
+
+namespace rkllmjs {
+namespace core {
+
+static const float kDefaultTripC = 85.0f;
+
+static int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Kernel thermal files hold millidegrees Celsius
+static bool readMilliCelsius(const std::string& path, float* celsius) {
+    std::ifstream file(path);
+    long long value = 0;
+    if (!(file >> value)) {
+        return false;
+    }
+    *celsius = static_cast<float>(value) / 1000.0f;
+    return true;
+}
+
+static std::string readLine(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+ThermalGovernor::ThermalGovernor(const ThermalConfig& config)
+    : config_(config) {
+    config_.max_level = std::max(config_.max_level, 1);
+    config_.step_c = std::max(config_.step_c, 0.1f);
+    config_.sample_interval_ms = std::max(config_.sample_interval_ms, 1);
+}
+
+ThermalGovernor::~ThermalGovernor() {
+    stop();
+}
+
+std::vector<ThermalZone> ThermalGovernor::readZones(const std::string& root) {
+    std::vector<ThermalZone> zones;
+    DIR* dir = opendir(root.c_str());
+    if (!dir) {
+        return zones;
+    }
+    
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.compare(0, 12, "thermal_zone") != 0) {
+            continue;
+        }
+        
+        std::string base = root + "/" + name + "/";
+        ThermalZone zone;
+        zone.name = name;
+        if (!readMilliCelsius(base + "temp", &zone.temperature_c)) {
+            continue;
+        }
+        zone.type = readLine(base + "type");
+        
+        // Throttling starts at the first passive (or hot) trip point
+        for (int i = 0; i < 16; ++i) {
+            std::string trip = base + "trip_point_" + std::to_string(i);
+            std::string type = readLine(trip + "_type");
+            if (type.empty()) {
+                break;
+            }
+            float trip_c = 0.0f;
+            if ((type == "passive" || type == "hot") && readMilliCelsius(trip + "_temp", &trip_c) && trip_c > 0.0f &&
+                (zone.trip_c == 0.0f || trip_c < zone.trip_c)) {
+                zone.trip_c = trip_c;
+            }
+        }
+        zones.push_back(zone);
+    }
+    closedir(dir);
+    
+    std::sort(zones.begin(), zones.end(), [](const ThermalZone& a, const ThermalZone& b) { return a.name < b.name; });
+    return zones;
+}
+
+bool ThermalGovernor::sample(int64_t now_ms) {
+    std::vector<ThermalZone> zones = readZones(config_.thermal_root);
+    if (zones.empty()) {
+        return false;
+    }
+    
+    // Throttle on the zone closest to (or furthest past) its own trip point
+    const ThermalZone* hottest = nullptr;
+    float hottest_trip = 0.0f;
+    for (const auto& zone : zones) {
+        float trip_c = config_.trip_c > 0.0f ? config_.trip_c : (zone.trip_c > 0.0f ? zone.trip_c : kDefaultTripC);
+        if (!hottest || zone.temperature_c - trip_c > hottest->temperature_c - hottest_trip) {
+            hottest = &zone;
+            hottest_trip = trip_c;
+        }
+    }
+    
+    update(*hottest, hottest_trip, now_ms >= 0 ? now_ms : steadyNowMs());
+    return true;
+}
+
+void ThermalGovernor::update(const ThermalZone& hottest, float trip_c, int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_.available = true;
+    state_.samples++;
+    state_.temperature_c = hottest.temperature_c;
+    state_.max_temperature_c = std::max(state_.max_temperature_c, hottest.temperature_c);
+    state_.trip_c = trip_c;
+    state_.hottest_zone = hottest.type.empty() ? hottest.name : hottest.type;
+    
+    int target = levelFor(hottest.temperature_c, trip_c);
+    if (target > state_.level) {
+        // Heating up: react immediately
+        state_.level = target;
+        state_.throttle_events++;
+        last_change_ms_ = now_ms;
+    } else if (state_.level > 0 && now_ms - last_change_ms_ >= config_.hold_ms &&
+               levelFor(hottest.temperature_c + config_.hysteresis_c, trip_c) < state_.level) {
+        // Clearly below the current level's threshold for long enough: one step down
+        state_.level--;
+        state_.recoveries++;
+        last_change_ms_ = now_ms;
+    }
+    state_.scale = scaleFor(state_.level);
+}
+
+int ThermalGovernor::levelFor(float temperature_c, float trip_c) const {
+    float start_c = trip_c - config_.throttle_margin_c;
+    if (temperature_c < start_c) {
+        return 0;
+    }
+    int level = 1 + static_cast<int>(std::floor((temperature_c - start_c) / config_.step_c));
+    return std::min(level, config_.max_level);
+}
+
+float ThermalGovernor::scaleFor(int level) const {
+    return static_cast<float>(config_.max_level + 1 - level) / static_cast<float>(config_.max_level + 1);
+}
+
+int ThermalGovernor::scaleLimit(int base) const {
+    if (base <= 0) {
+        return base;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    int scaled = static_cast<int>(std::lround(base * state_.scale));
+    return std::max(1, scaled);
+}
+
+ThermalState ThermalGovernor::getState() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+void ThermalGovernor::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&ThermalGovernor::run, this);
+}
+
+void ThermalGovernor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool ThermalGovernor::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void ThermalGovernor::run() {
+    if (!sample()) {
+        std::cout << "[ThermalGovernor] No readable thermal zones under " << config_.thermal_root << std::endl;
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        wake_.wait_for(lock, std::chrono::milliseconds(config_.sample_interval_ms));
+        if (!running_) {
+            break;
+        }
+        lock.unlock();
+        sample();
+        lock.lock();
+    }
+}
+
+} // namespace core
+} // namespace rkllmjs
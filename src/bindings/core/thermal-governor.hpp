@@ -0,0 +1,122 @@
+/**
+ * @module core
+ * @purpose Thermal-aware throttling of inference concurrency
+ * @description Samples SoC temperatures from the kernel thermal zones and maps
+ *              the hottest zone's distance to its trip point onto a throttle
+ *              level. Each level scales down how much work callers admit, so
+ *              sustained load settles below the temperature where the firmware
+ *              would clamp NPU/CPU clocks. Levels rise as soon as it gets hotter
+ *              but fall back one at a time, only after the temperature has
+ *              dropped past a hysteresis band and a hold time has passed, which
+ *              keeps the limit from oscillating around a threshold.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rkllmjs {
+namespace core {
+
+/**
+ * Thermal governor configuration
+ */
+struct ThermalConfig {
+    std::string thermal_root = "/sys/class/thermal"; // Directory holding thermal_zone*/ (injectable for tests)
+    float trip_c = 0.0f;              // Trip temperature (0 = lowest passive/hot trip found, else 85)
+    float throttle_margin_c = 10.0f;  // Level 1 starts this far below the trip
+    float step_c = 3.0f;              // Each further level is this much hotter
+    float hysteresis_c = 4.0f;        // A level is left only once this much below its threshold
+    int max_level = 3;                // Level L admits (max_level + 1 - L) / (max_level + 1) of the work
+    int sample_interval_ms = 1000;
+    int hold_ms = 5000;               // Minimum time between two ramp-down steps
+};
+
+/**
+ * One kernel thermal zone
+ */
+struct ThermalZone {
+    std::string name;                 // Directory name, e.g. thermal_zone0
+    std::string type;                 // Contents of type, e.g. npu-thermal
+    float temperature_c = 0.0f;
+    float trip_c = 0.0f;              // Lowest passive/hot trip point (0 = none)
+};
+
+/**
+ * Current throttle decision and history
+ */
+struct ThermalState {
+    bool available = false;           // At least one zone could be read
+    float temperature_c = 0.0f;       // Hottest zone
+    float max_temperature_c = 0.0f;   // Hottest sample seen
+    float trip_c = 0.0f;              // Trip point in effect
+    std::string hottest_zone;         // Type of the hottest zone
+    int level = 0;                    // 0 = unthrottled
+    float scale = 1.0f;               // Fraction of the configured limits admitted
+    int64_t samples = 0;
+    int64_t throttle_events = 0;      // Level increases
+    int64_t recoveries = 0;           // Level decreases
+};
+
+/**
+ * Temperature-driven throttle level with hysteresis
+ *
+ * sample() may be driven by the caller or by the background thread started
+ * with start(). Thread-safe.
+ */
+class ThermalGovernor {
+public:
+    explicit ThermalGovernor(const ThermalConfig& config = ThermalConfig());
+    ~ThermalGovernor();
+    
+    ThermalGovernor(const ThermalGovernor&) = delete;
+    ThermalGovernor& operator=(const ThermalGovernor&) = delete;
+    
+    /**
+     * @brief Read the thermal zones and update the throttle level
+     * @param now_ms Monotonic time of the sample (-1 = now)
+     * @return false if no zone could be read (the level is left unchanged)
+     */
+    bool sample(int64_t now_ms = -1);
+    
+    // Sample every sample_interval_ms on a background thread
+    void start();
+    void stop();
+    bool isRunning() const;
+    
+    ThermalState getState() const;
+    const ThermalConfig& getConfig() const { return config_; }
+    
+    /**
+     * @brief Scale a concurrency or batch limit by the current level
+     * @return At least 1 while base is positive
+     */
+    int scaleLimit(int base) const;
+    
+    // Zones under root with a readable temperature
+    static std::vector<ThermalZone> readZones(const std::string& root);
+
+private:
+    void update(const ThermalZone& hottest, float trip_c, int64_t now_ms);
+    int levelFor(float temperature_c, float trip_c) const;
+    float scaleFor(int level) const;
+    void run();
+    
+    ThermalConfig config_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    ThermalState state_;
+    int64_t last_change_ms_ = 0;
+    std::thread thread_;
+    bool running_ = false;
+};
+
+} // namespace core
+} // namespace rkllmjs
@@ -0,0 +1,197 @@
+#include "thermal-governor.hpp"
+#include "rkllm-manager.hpp"
+#include "../testing/rkllmjs-test.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace rkllmjs::core;
+
+namespace rkllmjs {
+namespace core {
+namespace test {
+
+// Fake /sys/class/thermal tree under /tmp
+class FakeThermalRoot {
+public:
+    explicit FakeThermalRoot(const std::string& name)
+        : root_("/tmp/rkllmjs-thermal-test-" + name + "-" + std::to_string(::getpid())) {
+        ::mkdir(root_.c_str(), 0755);
+    }
+    
+    ~FakeThermalRoot() {
+        for (const auto& file : files_) {
+            std::remove(file.c_str());
+        }
+        for (auto it = dirs_.rbegin(); it != dirs_.rend(); ++it) {
+            ::rmdir(it->c_str());
+        }
+        ::rmdir(root_.c_str());
+    }
+    
+    void addZone(int index, const std::string& type, float trip_c) {
+        std::string dir = zoneDir(index);
+        ::mkdir(dir.c_str(), 0755);
+        dirs_.push_back(dir);
+        write(dir + "/type", type);
+        write(dir + "/trip_point_0_type", "passive");
+        write(dir + "/trip_point_0_temp", std::to_string(static_cast<int>(trip_c * 1000)));
+        write(dir + "/trip_point_1_type", "critical");
+        write(dir + "/trip_point_1_temp", "115000");
+    }
+    
+    void setTemperature(int index, float celsius) {
+        write(zoneDir(index) + "/temp", std::to_string(static_cast<int>(celsius * 1000)));
+    }
+    
+    const std::string& path() const { return root_; }
+
+private:
+    std::string zoneDir(int index) const { return root_ + "/thermal_zone" + std::to_string(index); }
+    
+    void write(const std::string& path, const std::string& value) {
+        std::ofstream file(path, std::ios::trunc);
+        file << value << "\n";
+        if (std::find(files_.begin(), files_.end(), path) == files_.end()) {
+            files_.push_back(path);
+        }
+    }
+    
+    std::string root_;
+    std::vector<std::string> dirs_;
+    std::vector<std::string> files_;
+};
+
+static ThermalConfig makeConfig(const FakeThermalRoot& root) {
+    ThermalConfig config;
+    config.thermal_root = root.path();
+    config.throttle_margin_c = 10.0f;
+    config.step_c = 3.0f;
+    config.hysteresis_c = 4.0f;
+    config.max_level = 3;
+    config.hold_ms = 1000;
+    return config;
+}
+
+TEST(ThermalGovernorTest, ReadsZonesAndPassiveTrips) {
+    FakeThermalRoot root("zones");
+    root.addZone(0, "soc-thermal", 85.0f);
+    root.setTemperature(0, 45.5f);
+    root.addZone(1, "npu-thermal", 80.0f);
+    root.setTemperature(1, 52.0f);
+    
+    std::vector<ThermalZone> zones = ThermalGovernor::readZones(root.path());
+    EXPECT_EQ(2u, zones.size());
+    EXPECT_EQ("soc-thermal", zones[0].type);
+    EXPECT_NEAR(45.5f, zones[0].temperature_c, 0.01f);
+    EXPECT_NEAR(85.0f, zones[0].trip_c, 0.01f);
+    EXPECT_NEAR(80.0f, zones[1].trip_c, 0.01f);
+    
+    EXPECT_TRUE(ThermalGovernor::readZones(root.path() + "/missing").empty());
+    ThermalConfig config;
+    config.thermal_root = root.path() + "/missing";
+    ThermalGovernor governor(config);
+    EXPECT_FALSE(governor.sample(0));
+    EXPECT_FALSE(governor.getState().available);
+    EXPECT_EQ(4, governor.scaleLimit(4));
+}
+
+TEST(ThermalGovernorTest, ThrottlesNearTripAndRecoversWithHysteresis) {
+    FakeThermalRoot root("ramp");
+    root.addZone(0, "npu-thermal", 85.0f);
+    ThermalGovernor governor(makeConfig(root));
+    
+    root.setTemperature(0, 60.0f);
+    EXPECT_TRUE(governor.sample(0));
+    EXPECT_EQ(0, governor.getState().level);
+    EXPECT_EQ(8, governor.scaleLimit(8));
+    
+    // 75C is the throttle start (85 - 10): level 1, then straight to level 3
+    root.setTemperature(0, 76.0f);
+    governor.sample(100);
+    EXPECT_EQ(1, governor.getState().level);
+    EXPECT_EQ(6, governor.scaleLimit(8));
+    root.setTemperature(0, 84.0f);
+    governor.sample(200);
+    EXPECT_EQ(3, governor.getState().level);
+    EXPECT_EQ(2, governor.scaleLimit(8));
+    EXPECT_EQ(1, governor.scaleLimit(1));
+    
+    // Just below a threshold is inside the hysteresis band: no change
+    root.setTemperature(0, 80.5f);
+    governor.sample(5000);
+    EXPECT_EQ(3, governor.getState().level);
+    
+    // Cool enough, but the hold time since the last change applies per step
+    root.setTemperature(0, 60.0f);
+    governor.sample(5100);
+    EXPECT_EQ(2, governor.getState().level);
+    governor.sample(5200);
+    EXPECT_EQ(2, governor.getState().level);
+    governor.sample(6100);
+    governor.sample(7100);
+    EXPECT_EQ(0, governor.getState().level);
+    
+    ThermalState state = governor.getState();
+    EXPECT_TRUE(state.available);
+    EXPECT_EQ(2, state.throttle_events);
+    EXPECT_EQ(3, state.recoveries);
+    EXPECT_NEAR(84.0f, state.max_temperature_c, 0.01f);
+    EXPECT_EQ("npu-thermal", state.hottest_zone);
+    EXPECT_NEAR(1.0f, state.scale, 0.001f);
+}
+
+TEST(ThermalGovernorTest, HottestZoneRelativeToItsTrip) {
+    FakeThermalRoot root("relative");
+    root.addZone(0, "cpu-thermal", 95.0f);
+    root.setTemperature(0, 82.0f);
+    root.addZone(1, "npu-thermal", 80.0f);
+    root.setTemperature(1, 74.0f);
+    ThermalGovernor governor(makeConfig(root));
+    
+    // 74C is 6C from the NPU trip, 82C is 13C from the CPU trip
+    governor.sample(0);
+    ThermalState state = governor.getState();
+    EXPECT_EQ("npu-thermal", state.hottest_zone);
+    EXPECT_NEAR(80.0f, state.trip_c, 0.01f);
+    EXPECT_EQ(2, state.level);
+}
+
+TEST(ThermalGovernorTest, ManagerReportsThermalState) {
+    FakeThermalRoot root("manager");
+    root.addZone(0, "npu-thermal", 85.0f);
+    root.setTemperature(0, 80.0f);
+    
+    auto& manager = RKLLMManager::getInstance();
+    EXPECT_EQ(4, manager.getThermalLimit(4));
+    
+    ThermalConfig config = makeConfig(root);
+    config.sample_interval_ms = 5;
+    manager.enableThermalGovernor(config);
+    EXPECT_TRUE(manager.isThermalGovernorEnabled());
+    for (int i = 0; i < 200 && !manager.getThermalState().available; ++i) {
+        ::usleep(5000);
+    }
+    
+    ResourceStats stats = manager.getResourceStats();
+    EXPECT_NEAR(80.0f, stats.temperature_c, 0.01f);
+    EXPECT_EQ(2, stats.thermal_level);
+    EXPECT_EQ(1, stats.throttle_events);
+    EXPECT_EQ(2, manager.getThermalLimit(4));
+    
+    manager.disableThermalGovernor();
+    EXPECT_FALSE(manager.isThermalGovernorEnabled());
+    EXPECT_EQ(0, manager.getResourceStats().thermal_level);
+    EXPECT_EQ(4, manager.getThermalLimit(4));
+}
+
+} // namespace test
+} // namespace core
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
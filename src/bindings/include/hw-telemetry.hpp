@@ -0,0 +1,117 @@
+/**
+ * @module core
+ * @purpose Background sampling of NPU load, DDR load and clock frequencies
+ * @description Periodically reads the rknpu load file, the DDR devfreq load and
+ *              the current NPU/CPU frequencies, keeping a ring of recent samples.
+ *              Unlike reserved-core accounting this is what the hardware actually
+ *              did, so a window of samples shows whether inference is limited by
+ *              NPU compute (high NPU load) or by memory bandwidth (DDR saturated
+ *              while the NPU waits). Every path is configurable so tests can point
+ *              the sampler at a fake tree.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rkllmjs {
+namespace core {
+
+/**
+ * Telemetry sampler configuration
+ */
+struct TelemetryConfig {
+    std::string npu_load_path = "/sys/kernel/debug/rknpu/load";              // "NPU load:  Core0: 12%, Core1: ..."
+    std::string ddr_load_path = "/sys/class/devfreq/dmc/load";               // "45@1560000000Hz"
+    std::string npu_freq_path = "/sys/class/devfreq/fdab0000.npu/cur_freq";  // Hz
+    std::string cpu_freq_root = "/sys/devices/system/cpu/cpufreq";           // policy*/scaling_cur_freq in kHz
+    int sample_interval_ms = 500;
+    size_t history_size = 120;        // Samples kept in the ring
+    float busy_threshold = 80.0f;     // Load (%) at which a unit counts as the bottleneck
+};
+
+/**
+ * One reading of every telemetry source
+ */
+struct TelemetrySample {
+    int64_t timestamp_ms = 0;         // Monotonic time of the reading
+    bool npu_available = false;
+    float npu_load = 0.0f;            // Mean over cores, percentage 0-100
+    std::vector<float> npu_core_load; // Per-core percentage
+    bool ddr_available = false;
+    float ddr_load = 0.0f;            // DDR controller busy percentage 0-100
+    int64_t ddr_freq_hz = 0;
+    int64_t npu_freq_hz = 0;          // 0 = unreadable
+    std::vector<int64_t> cpu_freq_khz; // One entry per cpufreq policy (cluster)
+};
+
+/**
+ * Aggregate over the samples currently in the ring
+ */
+struct TelemetrySummary {
+    bool available = false;           // At least one source was readable
+    size_t samples = 0;
+    float npu_load = 0.0f;            // Mean NPU load over the window
+    float npu_load_peak = 0.0f;
+    float ddr_load = 0.0f;            // Mean DDR load over the window
+    float ddr_load_peak = 0.0f;
+    std::string bottleneck = "none";  // "npu", "memory" or "none"
+};
+
+/**
+ * Ring-buffered hardware telemetry sampler
+ *
+ * sample() may be driven by the caller or by the background thread started
+ * with start(). Thread-safe.
+ */
+class HardwareTelemetry {
+public:
+    explicit HardwareTelemetry(const TelemetryConfig& config = TelemetryConfig());
+    ~HardwareTelemetry();
+    
+    HardwareTelemetry(const HardwareTelemetry&) = delete;
+    HardwareTelemetry& operator=(const HardwareTelemetry&) = delete;
+    
+    /**
+     * @brief Read every source and append a sample to the ring
+     * @param now_ms Monotonic time of the sample (-1 = now)
+     * @return false if no source could be read (nothing is recorded)
+     */
+    bool sample(int64_t now_ms = -1);
+    
+    // Sample every sample_interval_ms on a background thread
+    void start();
+    void stop();
+    bool isRunning() const;
+    
+    TelemetrySample getLatest() const;
+    std::vector<TelemetrySample> getHistory() const;  // Oldest first
+    TelemetrySummary getSummary() const;
+    const TelemetryConfig& getConfig() const { return config_; }
+    
+    // Parsers for the kernel file formats, exposed for tests
+    static std::vector<float> parseNpuLoad(const std::string& text);
+    static bool parseDdrLoad(const std::string& text, float* load, int64_t* freq_hz);
+
+private:
+    TelemetrySample read(int64_t now_ms) const;
+    void run();
+    
+    TelemetryConfig config_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<TelemetrySample> history_;
+    std::thread thread_;
+    bool running_ = false;
+};
+
+} // namespace core
+} // namespace rkllmjs
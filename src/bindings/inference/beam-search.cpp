@@ -0,0 +1,165 @@
+#include "beam-search.hpp"
+#include "simd-ops.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace rkllmjs {
+namespace inference {
+
+BeamSearch::BeamSearch(const BeamSearchConfig& config)
+    : config_(config), width_(std::max(1, config.beamWidth)), perBeam_(2 * std::max(1, config.beamWidth)) {
+    config_.maxTokens = std::max(1, config_.maxTokens);
+    size_t width = static_cast<size_t>(width_);
+    size_t perBeam = static_cast<size_t>(perBeam_);
+    
+    // At most W new nodes per step
+    arena_.reserve(width * static_cast<size_t>(config_.maxTokens));
+    beams_.reserve(width);
+    nextBeams_.reserve(width);
+    candidates_.resize(width * perBeam);
+    candidateCounts_.assign(width, 0);
+    pool_.reserve(width * perBeam);
+    topIds_.resize(perBeam);
+    topValues_.resize(perBeam);
+    finished_.reserve(width);
+    sequences_.resize(width * static_cast<size_t>(config_.maxTokens));
+    
+    beams_.push_back(Beam{-1, 0.0f});
+}
+
+const int32_t* BeamSearch::sequence(int32_t beam) const {
+    return sequences_.data() + static_cast<size_t>(beam) * config_.maxTokens;
+}
+
+void BeamSearch::scoreBeam(int32_t beam, const float* row, int32_t vocabSize) {
+    if (beam < 0 || beam >= liveBeams() || done_) {
+        return;
+    }
+    size_t vocab = static_cast<size_t>(std::max(vocabSize, 0));
+    float normalizer = simd::logSumExp(row, vocab, static_cast<size_t>(perBeam_), topIds_.data(), topValues_.data());
+    int32_t count = normalizer == -std::numeric_limits<float>::infinity()
+        ? 0 : static_cast<int32_t>(std::min(vocab, static_cast<size_t>(perBeam_)));
+    
+    Candidate* slice = candidates_.data() + static_cast<size_t>(beam) * perBeam_;
+    for (int32_t i = 0; i < count; ++i) {
+        float logprob = topValues_[i] - normalizer;
+        slice[i] = Candidate{beams_[beam].sum + logprob, logprob, beam, topIds_[i]};
+    }
+    candidateCounts_[beam] = count;
+}
+
+float BeamSearch::normalized(float sum, int32_t length) const {
+    return sum / std::pow(static_cast<float>(std::max(length, 1)), config_.lengthPenalty);
+}
+
+void BeamSearch::finish(int32_t node, float sum, int32_t length) {
+    Hypothesis hypothesis{node, normalized(sum, length)};
+    if (static_cast<int32_t>(finished_.size()) < width_) {
+        finished_.push_back(hypothesis);
+        return;
+    }
+    // Replace the worst kept hypothesis if this one beats it
+    auto worst = std::min_element(finished_.begin(), finished_.end(),
+                                  [](const Hypothesis& a, const Hypothesis& b) { return a.score < b.score; });
+    if (hypothesis.score > worst->score) {
+        *worst = hypothesis;
+    }
+}
+
+bool BeamSearch::advance() {
+    if (done_) {
+        return false;
+    }
+    
+    pool_.clear();
+    for (int32_t beam = 0; beam < liveBeams(); ++beam) {
+        const Candidate* slice = candidates_.data() + static_cast<size_t>(beam) * perBeam_;
+        pool_.insert(pool_.end(), slice, slice + candidateCounts_[beam]);
+        candidateCounts_[beam] = 0;
+    }
+    std::sort(pool_.begin(), pool_.end(), [](const Candidate& a, const Candidate& b) {
+        return a.sum != b.sum ? a.sum > b.sum : (a.beam != b.beam ? a.beam < b.beam : a.token < b.token);
+    });
+    
+    // Best continuations become the next beams; end-of-sequence ones finish
+    // a hypothesis if they rank among the top W
+    nextBeams_.clear();
+    for (size_t rank = 0; rank < pool_.size() && static_cast<int32_t>(nextBeams_.size()) < width_; ++rank) {
+        const Candidate& candidate = pool_[rank];
+        const Beam& parent = beams_[candidate.beam];
+        bool eos = std::find(config_.eosTokenIds.begin(), config_.eosTokenIds.end(), candidate.token) !=
+                   config_.eosTokenIds.end();
+        if (eos) {
+            if (static_cast<int32_t>(rank) < width_) {
+                finish(parent.node, candidate.sum, length_);
+            }
+            continue;
+        }
+        arena_.push_back(Node{candidate.token, parent.node, candidate.logprob});
+        nextBeams_.push_back(Beam{static_cast<int32_t>(arena_.size() - 1), candidate.sum});
+    }
+    beams_.swap(nextBeams_);
+    length_++;
+    
+    if (beams_.empty()) {
+        done_ = true;
+    } else if (length_ >= config_.maxTokens) {
+        for (const Beam& beam : beams_) {
+            finish(beam.node, beam.sum, length_);
+        }
+        beams_.clear();
+        done_ = true;
+    } else if (static_cast<int32_t>(finished_.size()) >= width_) {
+        // Without early stopping, go on while the best live beam could still beat the worst hypothesis
+        float worst = std::numeric_limits<float>::infinity();
+        for (const Hypothesis& hypothesis : finished_) {
+            worst = std::min(worst, hypothesis.score);
+        }
+        done_ = config_.earlyStopping || normalized(beams_[0].sum, length_) <= worst;
+    }
+    
+    if (!done_) {
+        rebuildSequences();
+    }
+    return !done_;
+}
+
+void BeamSearch::rebuildSequences() {
+    for (int32_t beam = 0; beam < liveBeams(); ++beam) {
+        int32_t* out = sequences_.data() + static_cast<size_t>(beam) * config_.maxTokens;
+        int32_t position = length_;
+        for (int32_t node = beams_[beam].node; node >= 0 && position > 0; node = arena_[node].parent) {
+            out[--position] = arena_[node].token;
+        }
+    }
+}
+
+float BeamSearch::best(std::vector<int32_t>* tokens, std::vector<float>* logprobs) const {
+    int32_t node = -1;
+    float score = -std::numeric_limits<float>::infinity();
+    for (const Hypothesis& hypothesis : finished_) {
+        if (hypothesis.score > score) {
+            score = hypothesis.score;
+            node = hypothesis.node;
+        }
+    }
+    if (finished_.empty() && !beams_.empty()) {
+        node = beams_[0].node;
+        score = normalized(beams_[0].sum, length_);
+    }
+    
+    tokens->clear();
+    logprobs->clear();
+    for (; node >= 0; node = arena_[node].parent) {
+        tokens->push_back(arena_[node].token);
+        logprobs->push_back(arena_[node].logprob);
+    }
+    std::reverse(tokens->begin(), tokens->end());
+    std::reverse(logprobs->begin(), logprobs->end());
+    return score;
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,118 @@
+/**
+ * @module inference
+ * @purpose Beam-search decoding over logits-mode rows
+ * @description BeamSearch keeps the beamWidth best partial replies and
+ *              extends each with its most likely tokens at every step.
+ *              Each live beam's candidates come from one vectorized pass over
+ *              its logits row (simd::logSumExp with top-2W selection). Tokens
+ *              live in an append-only arena of 12-byte nodes that point to
+ *              their parent, so beams that share a prefix share its nodes.
+ *              Every buffer is sized from beamWidth and maxTokens up front,
+ *              so a step does not allocate. Finished hypotheses are ranked by
+ *              sum of logprobs / length^lengthPenalty. Runtime-agnostic: the
+ *              engine feeds rows from RKLLM_INFER_GET_LOGITS.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Beam search configuration
+ */
+struct BeamSearchConfig {
+    int32_t beamWidth = 4;
+    float lengthPenalty = 1.0f;      // Finished scores are divided by length^lengthPenalty (>1 favours longer replies)
+    bool earlyStopping = true;       // Stop as soon as beamWidth hypotheses have finished
+    int32_t maxTokens = 512;         // Live beams are finished when they reach this length
+    std::vector<int32_t> eosTokenIds; // Tokens that finish a hypothesis (not part of its output)
+};
+
+/**
+ * Beam search state for one request; not thread-safe
+ *
+ * Each step: call scoreBeam() once per live beam with the logits row that
+ * follows its tokens (calling again replaces that beam's candidates), then
+ * advance(). Beam 0 of the first step is the empty reply scored by the
+ * prompt's last row.
+ */
+class BeamSearch {
+public:
+    explicit BeamSearch(const BeamSearchConfig& config);
+    
+    int32_t liveBeams() const { return static_cast<int32_t>(beams_.size()); }
+    
+    // Tokens generated so far by every live beam
+    int32_t length() const { return length_; }
+    
+    // Live beam's tokens; valid until the next advance()
+    const int32_t* sequence(int32_t beam) const;
+    
+    void scoreBeam(int32_t beam, const float* row, int32_t vocabSize);
+    
+    // Keep the best continuations as the next beams; returns false once the search is done
+    bool advance();
+    
+    bool done() const { return done_; }
+    
+    /**
+     * @brief Best finished hypothesis (or best live beam if none finished)
+     * @return Its length-normalized score
+     */
+    float best(std::vector<int32_t>* tokens, std::vector<float>* logprobs) const;
+    
+    int32_t finishedHypotheses() const { return static_cast<int32_t>(finished_.size()); }
+    size_t arenaNodes() const { return arena_.size(); }
+    size_t arenaCapacity() const { return arena_.capacity(); }
+
+private:
+    struct Node {
+        int32_t token;
+        int32_t parent;  // -1 for the first token
+        float logprob;
+    };
+    struct Beam {
+        int32_t node;    // Last token (-1 = empty reply)
+        float sum;       // Sum of logprobs
+    };
+    struct Candidate {
+        float sum;
+        float logprob;
+        int32_t beam;
+        int32_t token;
+    };
+    struct Hypothesis {
+        int32_t node;
+        float score;     // Length-normalized
+    };
+    
+    float normalized(float sum, int32_t length) const;
+    void finish(int32_t node, float sum, int32_t length);
+    void rebuildSequences();
+    
+    BeamSearchConfig config_;
+    int32_t width_;
+    int32_t perBeam_;                    // Candidates kept per beam (2W, so EOS cannot starve the beams)
+    std::vector<Node> arena_;
+    std::vector<Beam> beams_;
+    std::vector<Beam> nextBeams_;
+    std::vector<Candidate> candidates_;  // [W × perBeam] slices, one per live beam
+    std::vector<int32_t> candidateCounts_;
+    std::vector<Candidate> pool_;
+    std::vector<int32_t> topIds_;
+    std::vector<float> topValues_;
+    std::vector<Hypothesis> finished_;
+    std::vector<int32_t> sequences_;     // [W × maxTokens] tokens of the live beams
+    int32_t length_ = 0;
+    bool done_ = false;
+};
+
+} // namespace inference
+} // namespace rkllmjs
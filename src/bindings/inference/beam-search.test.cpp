@@ -0,0 +1,194 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "beam-search.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+using Model = std::function<std::vector<float>(const std::vector<int32_t>&)>;
+
+static std::vector<float> logitsOf(const std::vector<float>& probabilities) {
+    std::vector<float> row;
+    for (float p : probabilities) {
+        row.push_back(std::log(p));
+    }
+    return row;
+}
+
+// Drive a search the way the engine does: one row per live beam, then advance
+static float runSearch(BeamSearch& search, const Model& model, std::vector<int32_t>* tokens,
+                       std::vector<float>* logprobs, int* steps = nullptr) {
+    std::vector<float> row = model({});
+    search.scoreBeam(0, row.data(), static_cast<int32_t>(row.size()));
+    int count = 0;
+    while (search.advance()) {
+        for (int32_t beam = 0; beam < search.liveBeams(); ++beam) {
+            std::vector<int32_t> sequence(search.sequence(beam), search.sequence(beam) + search.length());
+            row = model(sequence);
+            search.scoreBeam(beam, row.data(), static_cast<int32_t>(row.size()));
+        }
+        count++;
+    }
+    if (steps) {
+        *steps = count;
+    }
+    return search.best(tokens, logprobs);
+}
+
+TEST(BeamSearchTest, FindsSequenceGreedyDecodingMisses) {
+    // Greedy takes 0 (0.5) then faces a flat row; 1 (0.4) leads to 2 (0.9)
+    Model model = [](const std::vector<int32_t>& sequence) {
+        if (sequence.empty()) return logitsOf({0.5f, 0.4f, 0.05f, 0.05f});
+        if (sequence[0] == 1) return logitsOf({0.03f, 0.03f, 0.9f, 0.04f});
+        return logitsOf({0.25f, 0.25f, 0.25f, 0.25f});
+    };
+    
+    BeamSearchConfig config;
+    config.maxTokens = 2;
+    config.lengthPenalty = 0.0f;
+    config.beamWidth = 1;
+    BeamSearch greedy(config);
+    std::vector<int32_t> tokens;
+    std::vector<float> logprobs;
+    runSearch(greedy, model, &tokens, &logprobs);
+    EXPECT_EQ(tokens.size(), 2u);
+    EXPECT_EQ(tokens[0], 0);
+    
+    config.beamWidth = 2;
+    BeamSearch beams(config);
+    float score = runSearch(beams, model, &tokens, &logprobs);
+    EXPECT_TRUE(beams.done());
+    EXPECT_TRUE(tokens == std::vector<int32_t>({1, 2}));
+    EXPECT_EQ(logprobs.size(), 2u);
+    EXPECT_NEAR(logprobs[0], std::log(0.4f), 1e-4f);
+    EXPECT_NEAR(logprobs[1], std::log(0.9f), 1e-4f);
+    EXPECT_NEAR(score, std::log(0.4f * 0.9f), 1e-4f);
+    EXPECT_EQ(beams.finishedHypotheses(), 2); // Both beams hit maxTokens
+}
+
+// EOS is token 3. [1] can stop at once (0.5) or continue through [1,0,2],
+// which is less likely overall but better per token
+static std::vector<float> eosModel(const std::vector<int32_t>& sequence) {
+    if (sequence.empty()) return logitsOf({0.01f, 0.97f, 0.01f, 0.01f});
+    if (sequence == std::vector<int32_t>({1})) return logitsOf({0.3f, 0.01f, 0.19f, 0.5f});
+    if (sequence == std::vector<int32_t>({1, 0})) return logitsOf({0.01f, 0.01f, 0.95f, 0.03f});
+    if (sequence == std::vector<int32_t>({1, 0, 2})) return logitsOf({0.01f, 0.01f, 0.03f, 0.95f});
+    return logitsOf({0.01f, 0.01f, 0.01f, 0.97f});
+}
+
+TEST(BeamSearchTest, LengthPenaltyRanksFinishedHypotheses) {
+    BeamSearchConfig config;
+    config.beamWidth = 2;
+    config.maxTokens = 8;
+    config.eosTokenIds = {3};
+    config.earlyStopping = false;
+    std::vector<int32_t> tokens;
+    std::vector<float> logprobs;
+    
+    config.lengthPenalty = 1.0f;
+    BeamSearch perToken(config);
+    float score = runSearch(perToken, eosModel, &tokens, &logprobs);
+    EXPECT_TRUE(tokens == std::vector<int32_t>({1, 0, 2})); // EOS itself is not part of the output
+    EXPECT_EQ(perToken.finishedHypotheses(), 2);
+    EXPECT_NEAR(score, std::log(0.97f * 0.3f * 0.95f * 0.95f) / 3.0f, 1e-4f);
+    
+    config.lengthPenalty = 0.0f;
+    BeamSearch total(config);
+    score = runSearch(total, eosModel, &tokens, &logprobs);
+    EXPECT_TRUE(tokens == std::vector<int32_t>({1}));
+    EXPECT_NEAR(score, std::log(0.97f * 0.5f), 1e-4f);
+}
+
+TEST(BeamSearchTest, EarlyStoppingEndsOnceWidthHypothesesFinish) {
+    BeamSearchConfig config;
+    config.beamWidth = 2;
+    config.maxTokens = 8;
+    config.eosTokenIds = {3};
+    config.lengthPenalty = 1.0f;
+    std::vector<int32_t> tokens;
+    std::vector<float> logprobs;
+    
+    // [1] and [1,2] finish at step 2, before [1,0,2] is found
+    config.earlyStopping = true;
+    BeamSearch early(config);
+    int earlySteps = 0;
+    runSearch(early, eosModel, &tokens, &logprobs, &earlySteps);
+    EXPECT_TRUE(tokens == std::vector<int32_t>({1}));
+    
+    config.earlyStopping = false;
+    BeamSearch exhaustive(config);
+    int steps = 0;
+    runSearch(exhaustive, eosModel, &tokens, &logprobs, &steps);
+    EXPECT_TRUE(tokens == std::vector<int32_t>({1, 0, 2}));
+    EXPECT_GT(steps, earlySteps);
+}
+
+TEST(BeamSearchTest, ArenaDoesNotGrowDuringSearch) {
+    BeamSearchConfig config;
+    config.beamWidth = 4;
+    config.maxTokens = 32;
+    BeamSearch search(config);
+    size_t capacity = search.arenaCapacity();
+    EXPECT_GE(capacity, 4u * 32u);
+    
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-4.0f, 4.0f);
+    Model model = [&](const std::vector<int32_t>&) {
+        std::vector<float> row(64);
+        for (float& value : row) {
+            value = dist(rng);
+        }
+        return row;
+    };
+    std::vector<int32_t> tokens;
+    std::vector<float> logprobs;
+    int steps = 0;
+    runSearch(search, model, &tokens, &logprobs, &steps);
+    EXPECT_EQ(tokens.size(), 32u);
+    EXPECT_EQ(steps, 31); // The prompt row gives the first token
+    EXPECT_LE(search.arenaNodes(), capacity);
+    EXPECT_EQ(search.arenaCapacity(), capacity);
+}
+
+TEST(BeamSearchTest, LargeVocabularyStepBenchmark) {
+    const int32_t vocab = 150000;
+    const int32_t width = 4;
+    std::mt19937 rng(11);
+    std::normal_distribution<float> dist(0.0f, 3.0f);
+    std::vector<float> rows(static_cast<size_t>(width) * vocab);
+    for (float& value : rows) {
+        value = dist(rng);
+    }
+    
+    BeamSearchConfig config;
+    config.beamWidth = width;
+    config.maxTokens = 64;
+    BeamSearch search(config);
+    auto start = std::chrono::steady_clock::now();
+    search.scoreBeam(0, rows.data(), vocab);
+    int steps = 1;
+    while (search.advance()) {
+        for (int32_t beam = 0; beam < search.liveBeams(); ++beam) {
+            search.scoreBeam(beam, rows.data() + static_cast<size_t>(beam) * vocab, vocab);
+        }
+        steps++;
+    }
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(search.length(), 64);
+    std::cout << "[BeamSearch] width " << width << " over 150k vocab: " << micros / steps << " us/step" << std::endl;
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
@@ -0,0 +1,69 @@
+#include "candidate-scorer.hpp"
+#include "simd-ops.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace rkllmjs {
+namespace inference {
+
+// Logprob of one token under a row with the given normalizer
+static float tokenLogprob(const float* row, int32_t vocabSize, float normalizer, int32_t token) {
+    if (token < 0 || token >= vocabSize || normalizer == -std::numeric_limits<float>::infinity()) {
+        return -std::numeric_limits<float>::infinity();
+    }
+    return row[token] - normalizer;
+}
+
+CandidateScorer::CandidateScorer(const std::vector<std::vector<int32_t>>& candidates)
+    : candidates_(candidates) {
+    offsets_.reserve(candidates_.size());
+    size_t total = 0;
+    for (const auto& candidate : candidates_) {
+        offsets_.push_back(total);
+        total += candidate.size();
+        maxLength_ = std::max(maxLength_, candidate.size());
+    }
+    tokenLogprobs_.assign(total, 0.0f);
+}
+
+void CandidateScorer::scorePromptRow(const float* row, int32_t vocabSize) {
+    // One normalizer serves every candidate
+    float normalizer = simd::logSumExp(row, static_cast<size_t>(std::max(vocabSize, 0)));
+    for (size_t i = 0; i < candidates_.size(); ++i) {
+        if (!candidates_[i].empty()) {
+            tokenLogprobs_[offsets_[i]] = tokenLogprob(row, vocabSize, normalizer, candidates_[i][0]);
+        }
+    }
+}
+
+void CandidateScorer::scoreRows(size_t index, size_t from, const float* rows, int32_t numRows, int32_t vocabSize) {
+    const std::vector<int32_t>& tokens = candidates_[index];
+    size_t vocab = static_cast<size_t>(std::max(vocabSize, 0));
+    for (int32_t r = 0; r < numRows; ++r) {
+        size_t target = from + static_cast<size_t>(r) + 1;
+        if (target >= tokens.size()) {
+            break;
+        }
+        const float* row = rows + static_cast<size_t>(r) * vocab;
+        tokenLogprobs_[offsets_[index] + target] = tokenLogprob(row, vocabSize, simd::logSumExp(row, vocab), tokens[target]);
+    }
+}
+
+std::vector<CandidateScore> CandidateScorer::results() const {
+    std::vector<CandidateScore> scores(candidates_.size());
+    for (size_t i = 0; i < candidates_.size(); ++i) {
+        const float* values = tokenLogprobs_.data() + offsets_[i];
+        float sum = 0.0f;
+        for (size_t t = 0; t < candidates_[i].size(); ++t) {
+            sum += values[t];
+        }
+        scores[i].tokens = static_cast<int32_t>(candidates_[i].size());
+        scores[i].logprob = sum;
+        scores[i].meanLogprob = scores[i].tokens > 0 ? scores[i].logprob / scores[i].tokens : 0.0f;
+    }
+    return scores;
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,72 @@
+/**
+ * @module inference
+ * @purpose Log-likelihood of candidate continuations from logits rows
+ * @description CandidateScorer accumulates log P(candidate | prompt) for a
+ *              set of token-id continuations of one prompt. The prompt's last
+ *              logits row scores every candidate's first token at once; each
+ *              later row scores the token it predicts. Row normalizers come
+ *              from the vectorized simd::logSumExp, so a candidate token costs
+ *              one pass over its row and no copies. Per-token logprobs are
+ *              stored by position, so re-delivered rows overwrite rather than
+ *              double count. The engine drives the
+ *              runtime (InferenceEngine::score); this class holds the math.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Score of one candidate continuation
+ */
+struct CandidateScore {
+    float logprob = 0.0f;      // Sum of the candidate tokens' logprobs
+    float meanLogprob = 0.0f;  // Per token, for comparing candidates of different lengths
+    int32_t tokens = 0;
+};
+
+/**
+ * Sums candidate-token logprobs; not thread-safe, one per scoring call
+ */
+class CandidateScorer {
+public:
+    explicit CandidateScorer(const std::vector<std::vector<int32_t>>& candidates);
+    
+    size_t size() const { return candidates_.size(); }
+    const std::vector<int32_t>& candidate(size_t index) const { return candidates_[index]; }
+    
+    // Longest candidate, in tokens
+    size_t maxLength() const { return maxLength_; }
+    
+    /**
+     * @brief Score every candidate's first token from the prompt's last logits row
+     * @note Calling again replaces the previous prompt scores
+     */
+    void scorePromptRow(const float* row, int32_t vocabSize);
+    
+    /**
+     * @brief Score candidate tokens from rows produced by feeding its tokens [from, from + numRows)
+     * @param rows [numRows × vocabSize]; row r predicts token from + r + 1
+     * @note Rows past the end of the candidate are ignored
+     */
+    void scoreRows(size_t index, size_t from, const float* rows, int32_t numRows, int32_t vocabSize);
+    
+    // Scores in candidate order
+    std::vector<CandidateScore> results() const;
+
+private:
+    const std::vector<std::vector<int32_t>>& candidates_;
+    std::vector<size_t> offsets_;  // Start of each candidate in tokenLogprobs_
+    std::vector<float> tokenLogprobs_; // Every candidate token, flattened
+    size_t maxLength_ = 0;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,117 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "candidate-scorer.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static double referenceLogprob(const std::vector<float>& row, int32_t token) {
+    double maxLogit = -std::numeric_limits<double>::infinity();
+    for (float x : row) {
+        maxLogit = std::max<double>(maxLogit, x);
+    }
+    double sum = 0.0;
+    for (float x : row) {
+        sum += std::exp(x - maxLogit);
+    }
+    return row[token] - maxLogit - std::log(sum);
+}
+
+TEST(CandidateScorerTest, SumsPromptAndContinuationRows) {
+    const int32_t vocab = 300;
+    std::mt19937 rng(5);
+    std::normal_distribution<float> normal(0.0f, 2.0f);
+    auto randomRow = [&]() {
+        std::vector<float> row(vocab);
+        for (float& x : row) {
+            x = normal(rng);
+        }
+        return row;
+    };
+    
+    std::vector<std::vector<int32_t>> candidates = {{7, 42, 299}, {7}, {}, {12, 3}};
+    CandidateScorer scorer(candidates);
+    EXPECT_EQ(scorer.maxLength(), 3u);
+    
+    std::vector<float> promptRow = randomRow();
+    scorer.scorePromptRow(promptRow.data(), vocab);
+    
+    // Candidate 0 in one pass: rows for its first two tokens predict tokens 1 and 2
+    std::vector<float> first = randomRow();
+    std::vector<float> second = randomRow();
+    std::vector<float> rows0 = first;
+    rows0.insert(rows0.end(), second.begin(), second.end());
+    scorer.scoreRows(0, 0, rows0.data(), 2, vocab);
+    
+    // Candidate 3 stepped, and delivered twice (the runtime may repeat a callback)
+    std::vector<float> row3 = randomRow();
+    scorer.scoreRows(3, 0, row3.data(), 1, vocab);
+    scorer.scoreRows(3, 0, row3.data(), 1, vocab);
+    
+    std::vector<CandidateScore> scores = scorer.results();
+    double expected0 = referenceLogprob(promptRow, 7) + referenceLogprob(first, 42) +
+                       referenceLogprob(second, 299);
+    EXPECT_NEAR(scores[0].logprob, expected0, 1e-4);
+    EXPECT_NEAR(scores[0].meanLogprob, expected0 / 3.0, 1e-4);
+    EXPECT_NEAR(scores[1].logprob, referenceLogprob(promptRow, 7), 1e-5);
+    EXPECT_EQ(scores[2].tokens, 0);
+    EXPECT_EQ(scores[2].logprob, 0.0f);
+    EXPECT_NEAR(scores[3].logprob, referenceLogprob(promptRow, 12) + referenceLogprob(row3, 3), 1e-4);
+    
+    // Out-of-vocabulary tokens have no probability
+    std::vector<std::vector<int32_t>> unknown = {{vocab + 5}};
+    CandidateScorer invalid(unknown);
+    invalid.scorePromptRow(promptRow.data(), vocab);
+    EXPECT_EQ(invalid.results()[0].logprob, -std::numeric_limits<float>::infinity());
+}
+
+TEST(CandidateScorerTest, RerankingThroughputBenchmark) {
+    // 32 retrieved passages, 8-token continuations, 150k vocabulary
+    const int32_t vocab = 151936;
+    const size_t count = 32;
+    const size_t length = 8;
+    std::mt19937 rng(9);
+    std::normal_distribution<float> normal(0.0f, 2.5f);
+    std::vector<float> rows(static_cast<size_t>(vocab) * (length - 1));
+    for (float& x : rows) {
+        x = normal(rng);
+    }
+    std::vector<std::vector<int32_t>> candidates(count, std::vector<int32_t>(length));
+    for (auto& candidate : candidates) {
+        for (int32_t& token : candidate) {
+            token = static_cast<int32_t>(rng() % vocab);
+        }
+    }
+    
+    // Host-side cost only: the NPU passes come on top
+    CandidateScorer scorer(candidates);
+    auto start = std::chrono::steady_clock::now();
+    scorer.scorePromptRow(rows.data(), vocab);
+    for (size_t i = 0; i < count; ++i) {
+        scorer.scoreRows(i, 0, rows.data(), static_cast<int32_t>(length - 1), vocab);
+    }
+    std::vector<CandidateScore> scores = scorer.results();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    for (const auto& score : scores) {
+        EXPECT_TRUE(std::isfinite(score.logprob));
+        EXPECT_LT(score.logprob, 0.0f);
+    }
+    std::cout << "[CandidateScorer] " << count << " candidates x " << length << " tokens, 150k vocab: "
+              << count / seconds << " candidates/s host-side" << std::endl;
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
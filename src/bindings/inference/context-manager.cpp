@@ -0,0 +1,180 @@
+#include "context-manager.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rkllmjs {
+namespace inference {
+
+// Upper bound on n_batch for rkllm_get_kv_cache_size's per-batch output
+static constexpr int kMaxKvBatch = 128;
+
+ContextManager::ContextManager(const ContextConfig& config)
+    : config_(config) {
+    config_.highWatermark = std::min(std::max(config_.highWatermark, 0.1f), 1.0f);
+    config_.lowWatermark = std::min(std::max(config_.lowWatermark, 0.0f), config_.highWatermark);
+}
+
+ContextAction ContextManager::plan(const ContextConfig& config, int32_t kvTokens, int32_t maxContextLen,
+                                   int32_t nKeep, int32_t upcomingTokens,
+                                   const std::vector<int32_t>& turnStarts) {
+    ContextAction action;
+    if (config.policy == ContextPolicy::NONE || maxContextLen <= 0) {
+        return action;
+    }
+    
+    int32_t keep = std::min(std::max(nKeep, 0), maxContextLen);
+    int32_t high = static_cast<int32_t>(std::floor(config.highWatermark * maxContextLen));
+    if (kvTokens + upcomingTokens <= high || kvTokens <= keep) {
+        return action;
+    }
+    
+    // Evict down to the low watermark, or further if the next turn is large
+    int32_t low = static_cast<int32_t>(std::floor(config.lowWatermark * maxContextLen));
+    int32_t desired = std::min(low, high - upcomingTokens);
+    
+    if (config.policy == ContextPolicy::RESET || desired < keep) {
+        action.kind = ContextAction::Kind::RESET;
+        return action;
+    }
+    
+    action.kind = ContextAction::Kind::CLEAR_RANGE;
+    action.start = keep;
+    action.end = keep + (kvTokens - desired);
+    
+    if (config.policy == ContextPolicy::TURN_EVICTION) {
+        // Extend to the next turn boundary so no turn is left half-evicted
+        int32_t boundary = kvTokens;
+        for (int32_t turnStart : turnStarts) {
+            if (turnStart >= action.end && turnStart < boundary) {
+                boundary = turnStart;
+            }
+        }
+        action.end = boundary;
+    }
+    return action;
+}
+
+ContextAction ContextManager::prepare(LLMHandle handle, int32_t maxContextLen, int32_t nKeep, int32_t upcomingTokens) {
+    int32_t kvTokens = queryKvCacheSize(handle);
+    if (kvTokens < 0) {
+        return {};
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    HandleState& state = states_[handle];
+    state.stats.kvTokens = kvTokens;
+    state.stats.maxContextLen = maxContextLen;
+    state.stats.peakKvTokens = std::max(state.stats.peakKvTokens, kvTokens);
+    
+    int32_t keep = resolveKeep(nKeep);
+    ContextAction action = plan(config_, kvTokens, maxContextLen, keep, upcomingTokens, state.turnStarts);
+    
+    if (action.kind == ContextAction::Kind::CLEAR_RANGE) {
+        int startPos = action.start;
+        int endPos = action.end;
+        if (rkllm_clear_kv_cache(handle, 1, &startPos, &endPos) == 0) {
+            int32_t evicted = action.evicted();
+            state.stats.rangeEvictions++;
+            state.stats.tokensEvicted += evicted;
+            state.stats.kvTokens -= evicted;
+            
+            // Shift the boundaries of the turns that remain
+            std::vector<int32_t> remaining;
+            for (int32_t turnStart : state.turnStarts) {
+                if (turnStart < action.start) {
+                    remaining.push_back(turnStart);
+                } else if (turnStart >= action.end) {
+                    remaining.push_back(turnStart - evicted);
+                }
+            }
+            state.turnStarts.swap(remaining);
+            state.stats.turns = static_cast<int32_t>(state.turnStarts.size());
+            return action;
+        }
+        // Range clears are rejected unless generation is paused; fall back to a reset
+        action = ContextAction();
+        action.kind = ContextAction::Kind::RESET;
+    }
+    
+    if (action.kind == ContextAction::Kind::RESET) {
+        rkllm_clear_kv_cache(handle, 1, nullptr, nullptr);
+        int32_t remaining = queryKvCacheSize(handle);
+        state.stats.resets++;
+        state.stats.tokensEvicted += kvTokens - std::max(remaining, 0);
+        state.stats.kvTokens = std::max(remaining, 0);
+        state.turnStarts.clear();
+        state.stats.turns = 0;
+    }
+    return action;
+}
+
+void ContextManager::recordTurn(LLMHandle handle) {
+    int32_t kvTokens = queryKvCacheSize(handle);
+    if (kvTokens < 0) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    HandleState& state = states_[handle];
+    
+    if (kvTokens > state.stats.kvTokens) {
+        state.turnStarts.push_back(state.stats.kvTokens);
+    } else if (kvTokens < state.stats.kvTokens) {
+        // The runtime dropped history on its own; boundaries are unknown
+        state.turnStarts.clear();
+    }
+    
+    state.stats.kvTokens = kvTokens;
+    state.stats.peakKvTokens = std::max(state.stats.peakKvTokens, kvTokens);
+    state.stats.turns = static_cast<int32_t>(state.turnStarts.size());
+}
+
+void ContextManager::release(LLMHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    states_.erase(handle);
+}
+
+int32_t ContextManager::queryKvCacheSize(LLMHandle handle) {
+    if (!handle) {
+        return -1;
+    }
+    int sizes[kMaxKvBatch] = {0};
+    if (rkllm_get_kv_cache_size(handle, sizes) != 0) {
+        return -1;
+    }
+    return sizes[0];
+}
+
+ContextStats ContextManager::getStats(LLMHandle handle) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = states_.find(handle);
+    return it != states_.end() ? it->second.stats : ContextStats();
+}
+
+const char* ContextManager::getPolicyName(ContextPolicy policy) {
+    switch (policy) {
+        case ContextPolicy::NONE: return "none";
+        case ContextPolicy::RESET: return "reset";
+        case ContextPolicy::SLIDING_WINDOW: return "sliding_window";
+        case ContextPolicy::TURN_EVICTION: return "turn_eviction";
+        default: return "unknown";
+    }
+}
+
+ContextPolicy ContextManager::parsePolicy(const std::string& name) {
+    if (name == "none") return ContextPolicy::NONE;
+    if (name == "reset") return ContextPolicy::RESET;
+    if (name == "turn_eviction") return ContextPolicy::TURN_EVICTION;
+    return ContextPolicy::SLIDING_WINDOW;
+}
+
+int32_t ContextManager::resolveKeep(int32_t nKeep) const {
+    if (config_.nKeep >= 0) {
+        return config_.nKeep;
+    }
+    return nKeep >= 0 ? nKeep : 0;
+}
+
+} // namespace inference
+} // namespace rkllmjs
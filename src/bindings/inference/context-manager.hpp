@@ -0,0 +1,134 @@
+/**
+ * @module inference
+ * @purpose Context-window management for multi-turn inference
+ * @description Tracks KV cache occupancy per model handle through
+ *              rkllm_get_kv_cache_size and frees space before a turn would
+ *              overflow max_context_len. Policies keep the first n_keep
+ *              positions (system prompt) and evict the oldest history as a
+ *              sliding window or in whole turns via rkllm_clear_kv_cache ranges,
+ *              so long chats keep a bounded context instead of hitting the limit.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include "../core/rkllm-manager.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * What to do when the next turn would not fit
+ */
+enum class ContextPolicy {
+    NONE,           // Leave overflow handling to the runtime
+    RESET,          // Clear all history except the system prompt
+    SLIDING_WINDOW, // Evict just enough of the oldest positions after n_keep
+    TURN_EVICTION   // Evict the oldest whole turns after n_keep
+};
+
+/**
+ * Context manager configuration
+ */
+struct ContextConfig {
+    ContextPolicy policy = ContextPolicy::SLIDING_WINDOW;
+    int32_t nKeep = -1;           // Positions always retained (-1 = model's n_keep, else 0)
+    float highWatermark = 0.9f;   // Act when usage after the next turn exceeds this fraction
+    float lowWatermark = 0.6f;    // Evict down to this fraction so eviction is infrequent
+};
+
+/**
+ * Planned KV cache operation
+ */
+struct ContextAction {
+    enum class Kind { NONE, CLEAR_RANGE, RESET };
+    
+    Kind kind = Kind::NONE;
+    int32_t start = 0;            // First position cleared (inclusive)
+    int32_t end = 0;              // Last position cleared (exclusive)
+    
+    int32_t evicted() const { return kind == Kind::CLEAR_RANGE ? end - start : 0; }
+};
+
+/**
+ * KV occupancy and eviction counters for one handle
+ */
+struct ContextStats {
+    int32_t kvTokens = 0;
+    int32_t maxContextLen = 0;
+    int32_t peakKvTokens = 0;
+    int32_t turns = 0;            // Turns currently held in the cache
+    int64_t rangeEvictions = 0;
+    int64_t resets = 0;
+    int64_t tokensEvicted = 0;
+    
+    float occupancy() const {
+        return maxContextLen > 0 ? static_cast<float>(kvTokens) / static_cast<float>(maxContextLen) : 0.0f;
+    }
+};
+
+/**
+ * Keeps each handle's KV cache within its context window
+ *
+ * Thread-safe. Call prepare() before a turn and recordTurn() after it.
+ * The runtime only honours range clears while generation is paused with
+ * keep_history = 0; when a range clear is rejected the manager falls back
+ * to a full clear that keeps the system prompt.
+ */
+class ContextManager {
+public:
+    explicit ContextManager(const ContextConfig& config = ContextConfig());
+    
+    /**
+     * @brief Decide how to make room for the next turn
+     * @param turnStarts Cache positions at which each held turn begins
+     * @return Action that keeps kvTokens + upcomingTokens within the window
+     */
+    static ContextAction plan(const ContextConfig& config, int32_t kvTokens, int32_t maxContextLen,
+                              int32_t nKeep, int32_t upcomingTokens,
+                              const std::vector<int32_t>& turnStarts = {});
+    
+    /**
+     * @brief Free cache space on a handle before a turn
+     * @param upcomingTokens Estimated prompt plus generation length
+     * @return Action applied (RESET when a range clear was rejected)
+     */
+    ContextAction prepare(LLMHandle handle, int32_t maxContextLen, int32_t nKeep, int32_t upcomingTokens);
+    
+    // Record the cache size after a turn completes
+    void recordTurn(LLMHandle handle);
+    
+    // Forget a handle (e.g. after the model is destroyed)
+    void release(LLMHandle handle);
+    
+    // Current KV cache positions reported by the runtime (-1 on failure)
+    static int32_t queryKvCacheSize(LLMHandle handle);
+    
+    ContextStats getStats(LLMHandle handle) const;
+    const ContextConfig& getConfig() const { return config_; }
+    
+    static const char* getPolicyName(ContextPolicy policy);
+    static ContextPolicy parsePolicy(const std::string& name);
+
+private:
+    struct HandleState {
+        ContextStats stats;
+        std::vector<int32_t> turnStarts;
+    };
+    
+    int32_t resolveKeep(int32_t nKeep) const;
+    
+    ContextConfig config_;
+    mutable std::mutex mutex_;
+    std::unordered_map<LLMHandle, HandleState> states_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,110 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "context-manager.hpp"
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+TEST(ContextManagerTest, NoActionBelowHighWatermark) {
+    ContextConfig config;
+    ContextAction action = ContextManager::plan(config, 1000, 4096, 64, 500);
+    EXPECT_TRUE(action.kind == ContextAction::Kind::NONE);
+    
+    config.policy = ContextPolicy::NONE;
+    action = ContextManager::plan(config, 4000, 4096, 64, 500);
+    EXPECT_TRUE(action.kind == ContextAction::Kind::NONE);
+}
+
+TEST(ContextManagerTest, SlidingWindowKeepsSystemPrompt) {
+    ContextConfig config;
+    config.highWatermark = 0.9f;
+    config.lowWatermark = 0.5f;
+    
+    // 3600 + 300 > 3686: evict down to 2048 after the 64 kept positions
+    ContextAction action = ContextManager::plan(config, 3600, 4096, 64, 300);
+    EXPECT_TRUE(action.kind == ContextAction::Kind::CLEAR_RANGE);
+    EXPECT_EQ(action.start, 64);
+    EXPECT_EQ(action.evicted(), 3600 - 2048);
+    EXPECT_LE(3600 - action.evicted() + 300, 3686);
+    
+    // A large upcoming turn forces deeper eviction than the low watermark
+    action = ContextManager::plan(config, 3600, 4096, 64, 2000);
+    EXPECT_TRUE(action.kind == ContextAction::Kind::CLEAR_RANGE);
+    EXPECT_LE(3600 - action.evicted() + 2000, 3686);
+}
+
+TEST(ContextManagerTest, TurnEvictionAlignsToTurnBoundaries) {
+    ContextConfig config;
+    config.policy = ContextPolicy::TURN_EVICTION;
+    config.highWatermark = 0.9f;
+    config.lowWatermark = 0.5f;
+    
+    std::vector<int32_t> turns = {0, 64, 900, 1800, 2600, 3300};
+    ContextAction action = ContextManager::plan(config, 3600, 4096, 64, 300, turns);
+    EXPECT_TRUE(action.kind == ContextAction::Kind::CLEAR_RANGE);
+    EXPECT_EQ(action.start, 64);
+    EXPECT_EQ(action.end, 1800); // First boundary at or after 64 + 1552
+}
+
+TEST(ContextManagerTest, ResetWhenNothingFits) {
+    ContextConfig config;
+    ContextAction action = ContextManager::plan(config, 3000, 4096, 64, 4000);
+    EXPECT_TRUE(action.kind == ContextAction::Kind::RESET);
+    
+    config.policy = ContextPolicy::RESET;
+    action = ContextManager::plan(config, 3600, 4096, 64, 300);
+    EXPECT_TRUE(action.kind == ContextAction::Kind::RESET);
+    
+    // Nothing beyond the kept prefix to evict
+    action = ContextManager::plan(config, 64, 128, 64, 100);
+    EXPECT_TRUE(action.kind == ContextAction::Kind::NONE);
+}
+
+TEST(ContextManagerTest, LongChatStaysWithinWindow) {
+    ContextConfig config;
+    const int32_t maxContext = 2048;
+    const int32_t keep = 128;
+    int32_t kv = keep;
+    int32_t peak = 0;
+    int evictions = 0;
+    
+    // 1000 turns of 150 tokens each never exceed the window
+    for (int turn = 0; turn < 1000; ++turn) {
+        ContextAction action = ContextManager::plan(config, kv, maxContext, keep, 150);
+        if (action.kind == ContextAction::Kind::CLEAR_RANGE) {
+            kv -= action.evicted();
+            evictions++;
+        } else if (action.kind == ContextAction::Kind::RESET) {
+            kv = keep;
+        }
+        kv += 150;
+        peak = std::max(peak, kv);
+    }
+    EXPECT_LE(peak, maxContext);
+    EXPECT_GT(evictions, 0);
+    EXPECT_LT(evictions, 1000 / 3); // Low watermark amortizes eviction over several turns
+}
+
+TEST(ContextManagerTest, PolicyNames) {
+    EXPECT_EQ(std::string(ContextManager::getPolicyName(ContextPolicy::TURN_EVICTION)), "turn_eviction");
+    EXPECT_TRUE(ContextManager::parsePolicy("reset") == ContextPolicy::RESET);
+    EXPECT_TRUE(ContextManager::parsePolicy("none") == ContextPolicy::NONE);
+    EXPECT_TRUE(ContextManager::parsePolicy("bogus") == ContextPolicy::SLIDING_WINDOW);
+}
+
+TEST(ContextManagerTest, InvalidHandleIsIgnored) {
+    ContextManager manager;
+    EXPECT_EQ(ContextManager::queryKvCacheSize(nullptr), -1);
+    ContextAction action = manager.prepare(nullptr, 4096, 64, 100);
+    EXPECT_TRUE(action.kind == ContextAction::Kind::NONE);
+    manager.recordTurn(nullptr);
+    EXPECT_EQ(manager.getStats(nullptr).turns, 0);
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
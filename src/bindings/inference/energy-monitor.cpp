@@ -0,0 +1,296 @@
+#include "energy-monitor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace rkllmjs {
+namespace inference {
+
+static int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool fileExists(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+static bool readValue(const std::string& path, double* value) {
+    std::ifstream file(path);
+    long long raw = 0;
+    if (!(file >> raw)) {
+        return false;
+    }
+    *value = static_cast<double>(raw);
+    return true;
+}
+
+static std::string readLine(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+static std::vector<std::string> listDir(const std::string& path) {
+    std::vector<std::string> names;
+    if (DIR* dir = opendir(path.c_str())) {
+        while (struct dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                names.push_back(entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+struct EnergyMonitor::Meter::Entry {
+    int64_t startMs = 0;
+    std::atomic<int64_t> tokens{0};
+    int64_t tokensCharged = 0;   // Guarded by the monitor mutex
+    double joules = 0.0;
+    bool finished = false;
+};
+
+EnergyMonitor::Meter::Meter(Meter&& other) noexcept
+    : monitor_(other.monitor_), entry_(std::move(other.entry_)) {
+    other.monitor_ = nullptr;
+}
+
+EnergyMonitor::Meter& EnergyMonitor::Meter::operator=(Meter&& other) noexcept {
+    if (this != &other) {
+        finish();
+        monitor_ = other.monitor_;
+        entry_ = std::move(other.entry_);
+        other.monitor_ = nullptr;
+    }
+    return *this;
+}
+
+void EnergyMonitor::Meter::addTokens(int64_t count) {
+    if (entry_) {
+        entry_->tokens.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+EnergyReport EnergyMonitor::Meter::finish() {
+    EnergyReport report;
+    if (monitor_ && entry_) {
+        report = monitor_->finish(entry_);
+    }
+    monitor_ = nullptr;
+    return report;
+}
+
+EnergyMonitor::EnergyMonitor(const EnergyConfig& config, Clock clock)
+    : config_(config), clock_(clock ? std::move(clock) : Clock(steadyNowMs)) {
+    for (auto& sensor : findSensors(config_.sysfsRoot)) {
+        if (config_.sensors.empty() ||
+            std::find(config_.sensors.begin(), config_.sensors.end(), sensor.name) != config_.sensors.end() ||
+            std::find(config_.sensors.begin(), config_.sensors.end(),
+                      sensor.name.substr(0, sensor.name.find('/'))) != config_.sensors.end()) {
+            stats_.sensors.push_back(sensor.name);
+            sensors_.push_back(std::move(sensor));
+        }
+    }
+    
+    if (!sensors_.empty()) {
+        sample();
+        if (config_.sampleIntervalMs > 0) {
+            thread_ = std::thread(&EnergyMonitor::run, this);
+        }
+    }
+}
+
+EnergyMonitor::~EnergyMonitor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::vector<PowerSensor> EnergyMonitor::findSensors(const std::string& sysfsRoot) {
+    std::vector<PowerSensor> sensors;
+    
+    // hwmon: powerN_input in microwatts, else inN_input (mV) x currN_input (mA)
+    std::string hwmonRoot = sysfsRoot + "/hwmon";
+    for (const auto& hwmon : listDir(hwmonRoot)) {
+        std::string dir = hwmonRoot + "/" + hwmon + "/";
+        std::string chip = readLine(dir + "name");
+        if (chip.empty()) {
+            chip = hwmon;
+        }
+        for (int i = 0; i < 8; ++i) {
+            std::string index = std::to_string(i);
+            PowerSensor sensor;
+            if (fileExists(dir + "power" + index + "_input")) {
+                sensor.name = chip + "/power" + index;
+                sensor.powerFile = dir + "power" + index + "_input";
+            } else if (fileExists(dir + "in" + index + "_input") && fileExists(dir + "curr" + index + "_input")) {
+                sensor.name = chip + "/in" + index;
+                sensor.voltageFile = dir + "in" + index + "_input";
+                sensor.currentFile = dir + "curr" + index + "_input";
+                sensor.voltageScale = 1e-3;
+                sensor.currentScale = 1e-3;
+            } else {
+                continue;
+            }
+            sensors.push_back(sensor);
+        }
+    }
+    
+    // power_supply: power_now in microwatts, else voltage_now (uV) x current_now (uA)
+    std::string supplyRoot = sysfsRoot + "/power_supply";
+    for (const auto& supply : listDir(supplyRoot)) {
+        std::string dir = supplyRoot + "/" + supply + "/";
+        PowerSensor sensor;
+        sensor.name = supply;
+        if (fileExists(dir + "power_now")) {
+            sensor.powerFile = dir + "power_now";
+        } else if (fileExists(dir + "voltage_now") && fileExists(dir + "current_now")) {
+            sensor.voltageFile = dir + "voltage_now";
+            sensor.currentFile = dir + "current_now";
+        } else {
+            continue;
+        }
+        sensors.push_back(sensor);
+    }
+    return sensors;
+}
+
+double EnergyMonitor::readPowerWatts(bool* ok) const {
+    double watts = 0.0;
+    *ok = false;
+    for (const auto& sensor : sensors_) {
+        double power = 0.0;
+        double volts = 0.0;
+        double amps = 0.0;
+        if (!sensor.powerFile.empty()) {
+            if (!readValue(sensor.powerFile, &power)) {
+                continue;
+            }
+            watts += std::fabs(power) * sensor.powerScale;
+        } else {
+            if (!readValue(sensor.voltageFile, &volts) || !readValue(sensor.currentFile, &amps)) {
+                continue;
+            }
+            // Batteries report discharge current as negative on some drivers
+            watts += std::fabs(volts * sensor.voltageScale * amps * sensor.currentScale);
+        }
+        *ok = true;
+    }
+    return watts;
+}
+
+bool EnergyMonitor::sample() {
+    bool ok = false;
+    double watts = readPowerWatts(&ok);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ok) {
+        return false;
+    }
+    int64_t now = clock_();
+    if (hasLast_ && now > lastMs_) {
+        // Trapezoid between the previous and current reading
+        double joules = (lastWatts_ + watts) / 2.0 * (now - lastMs_) / 1000.0;
+        attributeLocked(joules);
+    }
+    hasLast_ = true;
+    lastMs_ = std::max(lastMs_, now);
+    lastWatts_ = watts;
+    stats_.available = true;
+    stats_.powerWatts = watts;
+    stats_.samples++;
+    return true;
+}
+
+void EnergyMonitor::attributeLocked(double joules) {
+    stats_.totalJoules += joules;
+    if (entries_.empty()) {
+        stats_.idleJoules += joules;
+        return;
+    }
+    stats_.attributedJoules += joules;
+    
+    // Split by tokens generated in the interval; prefilling requests share evenly
+    int64_t intervalTokens = 0;
+    std::vector<int64_t> deltas(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        int64_t tokens = entries_[i]->tokens.load(std::memory_order_relaxed);
+        deltas[i] = tokens - entries_[i]->tokensCharged;
+        entries_[i]->tokensCharged = tokens;
+        intervalTokens += deltas[i];
+    }
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        double share = intervalTokens > 0 ? static_cast<double>(deltas[i]) / intervalTokens : 1.0 / entries_.size();
+        entries_[i]->joules += joules * share;
+    }
+}
+
+EnergyMonitor::Meter EnergyMonitor::begin() {
+    if (sensors_.empty()) {
+        return Meter();
+    }
+    
+    // Close the running interval so the new request is charged only from now on
+    sample();
+    
+    auto entry = std::make_shared<Meter::Entry>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry->startMs = clock_();
+    entries_.push_back(entry);
+    return Meter(this, entry);
+}
+
+EnergyReport EnergyMonitor::finish(const std::shared_ptr<Meter::Entry>& entry) {
+    sample();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    EnergyReport report;
+    if (entry->finished) {
+        return report;
+    }
+    entry->finished = true;
+    entries_.erase(std::remove(entries_.begin(), entries_.end(), entry), entries_.end());
+    
+    report.joules = entry->joules;
+    report.tokens = entry->tokens.load();
+    report.seconds = (clock_() - entry->startMs) / 1000.0;
+    stats_.requests++;
+    stats_.tokens += report.tokens;
+    return report;
+}
+
+EnergyStats EnergyMonitor::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void EnergyMonitor::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!shutdown_) {
+        wake_.wait_for(lock, std::chrono::milliseconds(config_.sampleIntervalMs));
+        if (shutdown_) {
+            break;
+        }
+        lock.unlock();
+        sample();
+        lock.lock();
+    }
+}
+
+} // namespace inference
+} // namespace rkllmjs
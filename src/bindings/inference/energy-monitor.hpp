@@ -0,0 +1,174 @@
+/**
+ * @module inference
+ * @purpose Energy accounting per request from board power sensors
+ * @description Reads instantaneous power from hwmon and power-supply sensors,
+ *              integrates it over time and attributes each interval's energy to
+ *              the requests running in it, in proportion to the tokens each one
+ *              generated during that interval (evenly while they are all still
+ *              prefilling). Intervals are closed whenever a request starts or
+ *              finishes, so every interval has a fixed set of requests. Energy
+ *              drawn with nothing running is reported as idle energy.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Energy monitor configuration
+ */
+struct EnergyConfig {
+    std::string sysfsRoot = "/sys/class";  // Holds hwmon/ and power_supply/ (injectable for tests)
+    std::vector<std::string> sensors;      // hwmon or supply names to sum (empty = all; list them to avoid counting a rail twice)
+    int64_t sampleIntervalMs = 100;        // Background sampling period (0 = only at request boundaries)
+};
+
+/**
+ * One power sensor found under the sysfs root
+ */
+struct PowerSensor {
+    std::string name;          // hwmon name (e.g. "ina226/power1") or supply name (e.g. "usb-c")
+    std::string powerFile;     // Direct power reading, or empty
+    std::string voltageFile;   // Voltage and current when there is no power file
+    std::string currentFile;
+    double powerScale = 1e-6;  // File units to watts / volts / amperes
+    double voltageScale = 1e-6;
+    double currentScale = 1e-6;
+};
+
+/**
+ * Energy attributed to one request
+ */
+struct EnergyReport {
+    double joules = 0.0;
+    int64_t tokens = 0;
+    double seconds = 0.0;
+    
+    double tokensPerJoule() const { return joules > 0.0 ? tokens / joules : 0.0; }
+    double averageWatts() const { return seconds > 0.0 ? joules / seconds : 0.0; }
+};
+
+/**
+ * Aggregate energy counters
+ */
+struct EnergyStats {
+    bool available = false;             // At least one sensor was readable
+    std::vector<std::string> sensors;
+    double powerWatts = 0.0;            // Latest reading
+    double totalJoules = 0.0;           // Everything integrated since the monitor started
+    double attributedJoules = 0.0;      // Energy charged to requests
+    double idleJoules = 0.0;            // Energy drawn with no request running
+    int64_t requests = 0;               // Finished metered requests
+    int64_t tokens = 0;                 // Tokens generated by those requests
+    int64_t samples = 0;
+    
+    double tokensPerJoule() const { return attributedJoules > 0.0 ? tokens / attributedJoules : 0.0; }
+};
+
+/**
+ * Integrates board power and charges it to in-flight requests
+ *
+ * Thread-safe.
+ */
+class EnergyMonitor {
+public:
+    // Monotonic milliseconds; replaceable for tests
+    using Clock = std::function<int64_t()>;
+    
+    /**
+     * Per-request energy meter (RAII, stops metering when destroyed)
+     */
+    class Meter {
+    public:
+        Meter() = default;
+        ~Meter() { finish(); }
+        Meter(Meter&& other) noexcept;
+        Meter& operator=(Meter&& other) noexcept;
+        Meter(const Meter&) = delete;
+        Meter& operator=(const Meter&) = delete;
+        
+        // Count generated tokens (called from the token callback, lock-free)
+        void addTokens(int64_t count = 1);
+        
+        /**
+         * @brief Close the request's last interval and stop metering
+         * @return Energy charged to the request (zero for an inert meter)
+         */
+        EnergyReport finish();
+    
+    private:
+        friend class EnergyMonitor;
+        struct Entry;
+        
+        Meter(EnergyMonitor* monitor, std::shared_ptr<Entry> entry)
+            : monitor_(monitor), entry_(std::move(entry)) {}
+        
+        EnergyMonitor* monitor_ = nullptr;
+        std::shared_ptr<Entry> entry_;
+    };
+    
+    explicit EnergyMonitor(const EnergyConfig& config = EnergyConfig(), Clock clock = nullptr);
+    ~EnergyMonitor();
+    
+    EnergyMonitor(const EnergyMonitor&) = delete;
+    EnergyMonitor& operator=(const EnergyMonitor&) = delete;
+    
+    /**
+     * @brief Start metering a request
+     * @return Meter to feed tokens; inert when no sensor is available
+     */
+    Meter begin();
+    
+    /**
+     * @brief Read the sensors and charge the interval since the last sample
+     * @return false if no sensor could be read
+     */
+    bool sample();
+    
+    /**
+     * @brief Current total power of the selected sensors
+     * @param ok Set to whether any sensor could be read
+     */
+    double readPowerWatts(bool* ok) const;
+    
+    EnergyStats getStats() const;
+    const EnergyConfig& getConfig() const { return config_; }
+    
+    // Power sensors under root/hwmon and root/power_supply
+    static std::vector<PowerSensor> findSensors(const std::string& sysfsRoot);
+
+private:
+    void attributeLocked(double joules);
+    EnergyReport finish(const std::shared_ptr<Meter::Entry>& entry);
+    void run();
+    
+    EnergyConfig config_;
+    Clock clock_;
+    std::vector<PowerSensor> sensors_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<std::shared_ptr<Meter::Entry>> entries_;
+    bool hasLast_ = false;
+    int64_t lastMs_ = 0;
+    double lastWatts_ = 0.0;
+    EnergyStats stats_;
+    std::thread thread_;
+    bool shutdown_ = false;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,203 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "energy-monitor.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+// Fake /sys/class with hwmon and power_supply sensors under /tmp
+class FakePowerRoot {
+public:
+    explicit FakePowerRoot(const std::string& name)
+        : root_("/tmp/rkllmjs-energy-test-" + name + "-" + std::to_string(::getpid())) {
+        makeDir(root_);
+        makeDir(root_ + "/hwmon");
+        makeDir(root_ + "/power_supply");
+    }
+    
+    ~FakePowerRoot() {
+        for (const auto& file : files_) {
+            std::remove(file.c_str());
+        }
+        for (auto it = dirs_.rbegin(); it != dirs_.rend(); ++it) {
+            ::rmdir(it->c_str());
+        }
+    }
+    
+    // hwmon chip with a power1_input in microwatts
+    void addHwmon(int index, const std::string& chip, double watts) {
+        std::string dir = root_ + "/hwmon/hwmon" + std::to_string(index);
+        makeDir(dir);
+        write(dir + "/name", chip);
+        setHwmonPower(index, watts);
+    }
+    
+    void setHwmonPower(int index, double watts) {
+        write(root_ + "/hwmon/hwmon" + std::to_string(index) + "/power1_input",
+              std::to_string(static_cast<long long>(watts * 1e6)));
+    }
+    
+    // Supply exposing only voltage_now and current_now
+    void addSupply(const std::string& name, double volts, double amps) {
+        std::string dir = root_ + "/power_supply/" + name;
+        makeDir(dir);
+        write(dir + "/voltage_now", std::to_string(static_cast<long long>(volts * 1e6)));
+        write(dir + "/current_now", std::to_string(static_cast<long long>(amps * 1e6)));
+    }
+    
+    const std::string& path() const { return root_; }
+
+private:
+    void makeDir(const std::string& dir) {
+        ::mkdir(dir.c_str(), 0755);
+        dirs_.push_back(dir);
+    }
+    
+    void write(const std::string& path, const std::string& value) {
+        std::ofstream file(path, std::ios::trunc);
+        file << value << "\n";
+        if (std::find(files_.begin(), files_.end(), path) == files_.end()) {
+            files_.push_back(path);
+        }
+    }
+    
+    std::string root_;
+    std::vector<std::string> dirs_;
+    std::vector<std::string> files_;
+};
+
+static EnergyConfig makeConfig(const FakePowerRoot& root) {
+    EnergyConfig config;
+    config.sysfsRoot = root.path();
+    config.sampleIntervalMs = 0; // Sampled only at request boundaries, on the fake clock
+    return config;
+}
+
+TEST(EnergyMonitorTest, FindsHwmonAndSupplySensors) {
+    FakePowerRoot root("sensors");
+    root.addHwmon(0, "ina226", 4.0);
+    root.addSupply("usb-c", 5.0, 0.5);
+    
+    std::vector<PowerSensor> sensors = EnergyMonitor::findSensors(root.path());
+    EXPECT_EQ(sensors.size(), 2u);
+    EXPECT_EQ(sensors[0].name, std::string("ina226/power1"));
+    EXPECT_EQ(sensors[1].name, std::string("usb-c"));
+    
+    EnergyMonitor monitor(makeConfig(root));
+    bool ok = false;
+    EXPECT_NEAR(monitor.readPowerWatts(&ok), 6.5, 1e-6);
+    EXPECT_TRUE(ok);
+    
+    // Selecting by chip name avoids counting one rail twice
+    EnergyConfig config = makeConfig(root);
+    config.sensors = {"ina226"};
+    EnergyMonitor selected(config);
+    EXPECT_NEAR(selected.readPowerWatts(&ok), 4.0, 1e-6);
+    EXPECT_EQ(selected.getStats().sensors.size(), 1u);
+    
+    config.sysfsRoot = root.path() + "/missing";
+    EnergyMonitor missing(config);
+    EXPECT_FALSE(missing.getStats().available);
+    EnergyMonitor::Meter meter = missing.begin();
+    meter.addTokens(10);
+    EXPECT_EQ(meter.finish().joules, 0.0);
+}
+
+TEST(EnergyMonitorTest, IntegratesPowerAndSplitsByTokens) {
+    FakePowerRoot root("split");
+    root.addHwmon(0, "ina226", 4.0);
+    int64_t now = 0;
+    EnergyMonitor monitor(makeConfig(root), [&now] { return now; });
+    
+    // Idle for one second at 4W
+    now = 1000;
+    EnergyMonitor::Meter a = monitor.begin();
+    
+    // A alone prefills for 500ms: 2J, all to A
+    now = 1500;
+    EnergyMonitor::Meter b = monitor.begin();
+    
+    // Both run for a second at 4W (4J); A generates 30 tokens, B 10
+    a.addTokens(30);
+    b.addTokens(10);
+    now = 2500;
+    EnergyReport reportA = a.finish();
+    EXPECT_NEAR(reportA.joules, 2.0 + 3.0, 1e-9);
+    EXPECT_EQ(reportA.tokens, 30);
+    EXPECT_NEAR(reportA.seconds, 1.5, 1e-9);
+    EXPECT_NEAR(reportA.tokensPerJoule(), 6.0, 1e-9);
+    
+    // Power ramps to 8W: trapezoid over the second B runs alone is 6J
+    root.setHwmonPower(0, 8.0);
+    b.addTokens(20);
+    now = 3500;
+    EnergyReport reportB = b.finish();
+    EXPECT_NEAR(reportB.joules, 1.0 + 6.0, 1e-9);
+    EXPECT_EQ(reportB.tokens, 30);
+    
+    EnergyStats stats = monitor.getStats();
+    EXPECT_TRUE(stats.available);
+    EXPECT_NEAR(stats.idleJoules, 4.0, 1e-9);
+    EXPECT_NEAR(stats.attributedJoules, 12.0, 1e-9);
+    EXPECT_NEAR(stats.totalJoules, 16.0, 1e-9);
+    EXPECT_EQ(stats.requests, 2);
+    EXPECT_EQ(stats.tokens, 60);
+    EXPECT_NEAR(stats.tokensPerJoule(), 5.0, 1e-9);
+    EXPECT_NEAR(stats.powerWatts, 8.0, 1e-9);
+}
+
+TEST(EnergyMonitorTest, MeterFinishesOnceAndOnDestruction) {
+    FakePowerRoot root("raii");
+    root.addSupply("battery", 4.0, -1.0); // Discharging: negative current
+    int64_t now = 0;
+    EnergyMonitor monitor(makeConfig(root), [&now] { return now; });
+    
+    {
+        EnergyMonitor::Meter meter = monitor.begin();
+        meter.addTokens(8);
+        now = 2000;
+    }
+    EnergyStats stats = monitor.getStats();
+    EXPECT_EQ(stats.requests, 1);
+    EXPECT_NEAR(stats.attributedJoules, 8.0, 1e-9);
+    
+    EnergyMonitor::Meter meter = monitor.begin();
+    now = 3000;
+    EnergyReport first = meter.finish();
+    EXPECT_NEAR(first.joules, 4.0, 1e-9);
+    EXPECT_EQ(meter.finish().joules, 0.0);
+    EXPECT_EQ(monitor.getStats().requests, 2);
+}
+
+TEST(EnergyMonitorTest, BackgroundSamplingAccumulates) {
+    FakePowerRoot root("thread");
+    root.addHwmon(0, "ina226", 3.0);
+    EnergyConfig config = makeConfig(root);
+    config.sampleIntervalMs = 5;
+    EnergyMonitor monitor(config);
+    
+    for (int i = 0; i < 200 && monitor.getStats().samples < 4; ++i) {
+        ::usleep(5000);
+    }
+    EnergyStats stats = monitor.getStats();
+    EXPECT_GE(stats.samples, 4);
+    EXPECT_GT(stats.idleJoules, 0.0);
+    EXPECT_NEAR(stats.powerWatts, 3.0, 1e-9);
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
@@ -0,0 +1,277 @@
+#include "fair-scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace rkllmjs {
+namespace inference {
+
+static const char* kDefaultName = "default";
+
+static int64_t steadyNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Bounded ring of latency samples
+struct LatencySamples {
+    std::vector<double> values;
+    size_t next = 0;
+    
+    void add(double value, size_t capacity) {
+        if (capacity == 0) {
+            return;
+        }
+        if (values.size() < capacity) {
+            values.push_back(value);
+        } else {
+            values[next] = value;
+            next = (next + 1) % capacity;
+        }
+    }
+    
+    // Nearest-rank percentiles of the window
+    void percentiles(double* p50, double* p95, double* p99) const {
+        if (values.empty()) {
+            return;
+        }
+        std::vector<double> sorted(values);
+        std::sort(sorted.begin(), sorted.end());
+        auto rank = [&sorted](double q) {
+            size_t index = static_cast<size_t>(std::ceil(q * sorted.size()));
+            return sorted[std::min(sorted.size(), std::max<size_t>(index, 1)) - 1];
+        };
+        *p50 = rank(0.50);
+        *p95 = rank(0.95);
+        *p99 = rank(0.99);
+    }
+};
+
+struct FairScheduler::Flow {
+    double lastFinish = 0.0;     // Virtual finish time of the flow's newest request
+};
+
+struct FairScheduler::ClassState {
+    std::string name;
+    double weight = 1.0;
+    double averageCompletion = -1.0; // Observed reply length (-1 = nothing finished yet)
+    int64_t requests = 0;
+    double npuSeconds = 0.0;
+    LatencySamples queueMs;
+    LatencySamples latencyMs;
+};
+
+struct FairScheduler::TenantState {
+    std::string id;
+    double weight = 1.0;
+    int64_t requests = 0;
+    double npuSeconds = 0.0;
+};
+
+struct FairScheduler::Entry {
+    Flow* flow = nullptr;
+    ClassState* cls = nullptr;
+    TenantState* tenant = nullptr;
+    double weight = 1.0;
+    double cost = 0.0;           // Estimated NPU-seconds
+    double start = 0.0;          // Virtual start and finish times
+    QueueKey key;
+    int64_t promptTokens = 0;
+    int64_t enqueuedUs = 0;
+    int64_t dispatchedUs = 0;
+    bool queued = false;
+    bool done = false;
+};
+
+FairScheduler::Ticket::Ticket(Ticket&& other) noexcept
+    : scheduler_(other.scheduler_), entry_(std::move(other.entry_)) {
+    other.scheduler_ = nullptr;
+}
+
+FairScheduler::Ticket& FairScheduler::Ticket::operator=(Ticket&& other) noexcept {
+    if (this != &other) {
+        complete(0);
+        scheduler_ = other.scheduler_;
+        entry_ = std::move(other.entry_);
+        other.scheduler_ = nullptr;
+    }
+    return *this;
+}
+
+void FairScheduler::Ticket::complete(int64_t completionTokens) {
+    if (entry_) {
+        scheduler_->finish(*entry_, completionTokens);
+    }
+    scheduler_ = nullptr;
+    entry_.reset();
+}
+
+FairScheduler::FairScheduler(const FairQueueConfig& config, Clock clock)
+    : config_(config), clock_(clock ? std::move(clock) : Clock(steadyNowUs)),
+      secondsPerToken_(config.initialSecondsPerToken) {
+}
+
+FairScheduler::~FairScheduler() = default;
+
+FairScheduler::ClassState& FairScheduler::classLocked(const std::string& requestClass) {
+    auto& slot = classes_[requestClass];
+    if (!slot) {
+        auto configured = config_.classWeights.find(requestClass);
+        slot = std::make_unique<ClassState>();
+        slot->name = requestClass;
+        slot->weight = configured != config_.classWeights.end() ? configured->second : 1.0;
+    }
+    return *slot;
+}
+
+FairScheduler::TenantState& FairScheduler::tenantLocked(const std::string& tenantId) {
+    auto& slot = tenants_[tenantId];
+    if (!slot) {
+        auto configured = config_.tenantWeights.find(tenantId);
+        slot = std::make_unique<TenantState>();
+        slot->id = tenantId;
+        slot->weight = configured != config_.tenantWeights.end() ? configured->second : 1.0;
+    }
+    return *slot;
+}
+
+double FairScheduler::estimateCostLocked(const ClassState& cls, int64_t promptTokens, int64_t maxTokens) const {
+    double completion = static_cast<double>(std::max<int64_t>(maxTokens, 0));
+    if (cls.averageCompletion >= 0.0) {
+        completion = std::min(completion, std::ceil(cls.averageCompletion));
+    }
+    double units = std::max<int64_t>(promptTokens, 0) * config_.prefillCostRatio + completion;
+    return std::max(units, 1.0) * secondsPerToken_;
+}
+
+double FairScheduler::estimateCost(const std::string& requestClass, int64_t promptTokens, int64_t maxTokens) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = classes_.find(requestClass.empty() ? kDefaultName : requestClass);
+    ClassState fresh;
+    return estimateCostLocked(it != classes_.end() ? *it->second : fresh, promptTokens, maxTokens);
+}
+
+FairScheduler::Ticket FairScheduler::enqueue(const std::string& tenantId, const std::string& requestClass,
+                                             int64_t promptTokens, int64_t maxTokens) {
+    const std::string& tenantName = tenantId.empty() ? std::string(kDefaultName) : tenantId;
+    const std::string& className = requestClass.empty() ? std::string(kDefaultName) : requestClass;
+    
+    auto entry = std::make_shared<Entry>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry->cls = &classLocked(className);
+    entry->tenant = &tenantLocked(tenantName);
+    auto& flow = flows_[tenantName + '\n' + className];
+    if (!flow) {
+        flow = std::make_unique<Flow>();
+    }
+    entry->flow = flow.get();
+    entry->weight = entry->tenant->weight * entry->cls->weight;
+    entry->cost = estimateCostLocked(*entry->cls, promptTokens, maxTokens);
+    entry->promptTokens = promptTokens;
+    entry->enqueuedUs = clock_();
+    
+    // A flow that went idle restarts at the current virtual time, so it
+    // cannot bank credit while it had nothing queued
+    entry->start = std::max(virtualTime_, flow->lastFinish);
+    flow->lastFinish = entry->start + entry->cost / entry->weight;
+    entry->key = QueueKey(flow->lastFinish, sequence_++);
+    entry->queued = true;
+    queue_.emplace(entry->key, entry.get());
+    return Ticket(this, std::move(entry));
+}
+
+bool FairScheduler::isNext(const Ticket& ticket) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ticket.entry_ && !queue_.empty() && queue_.begin()->second == ticket.entry_.get();
+}
+
+void FairScheduler::dispatch(Ticket& ticket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry* entry = ticket.entry_.get();
+    if (!entry || !entry->queued) {
+        return;
+    }
+    queue_.erase(entry->key);
+    entry->queued = false;
+    entry->dispatchedUs = clock_();
+    virtualTime_ = std::max(virtualTime_, entry->start);
+    entry->cls->queueMs.add((entry->dispatchedUs - entry->enqueuedUs) / 1000.0, config_.latencySamples);
+}
+
+void FairScheduler::finish(Entry& entry, int64_t completionTokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entry.done) {
+        return;
+    }
+    entry.done = true;
+    
+    // Left before dispatch: give the flow its reserved virtual time back
+    if (entry.queued) {
+        queue_.erase(entry.key);
+        entry.queued = false;
+        entry.flow->lastFinish = std::max(virtualTime_, entry.flow->lastFinish - entry.cost / entry.weight);
+        return;
+    }
+    
+    // Charge what the request actually used instead of the estimate
+    int64_t now = clock_();
+    double service = std::max<int64_t>(now - entry.dispatchedUs, 0) / 1e6;
+    entry.flow->lastFinish = std::max(virtualTime_, entry.flow->lastFinish + (service - entry.cost) / entry.weight);
+    
+    double units = entry.promptTokens * config_.prefillCostRatio + completionTokens;
+    if (units > 0.0 && service > 0.0) {
+        secondsPerToken_ += config_.learningRate * (service / units - secondsPerToken_);
+    }
+    ClassState& cls = *entry.cls;
+    if (cls.averageCompletion < 0.0) {
+        cls.averageCompletion = static_cast<double>(completionTokens);
+    } else {
+        cls.averageCompletion += config_.learningRate * (completionTokens - cls.averageCompletion);
+    }
+    
+    cls.requests++;
+    cls.npuSeconds += service;
+    cls.latencyMs.add((now - entry.enqueuedUs) / 1000.0, config_.latencySamples);
+    entry.tenant->requests++;
+    entry.tenant->npuSeconds += service;
+}
+
+FairQueueStats FairScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FairQueueStats stats;
+    stats.queued = static_cast<int32_t>(queue_.size());
+    stats.virtualTime = virtualTime_;
+    stats.secondsPerToken = secondsPerToken_;
+    
+    for (const auto& entry : classes_) {
+        const ClassState& cls = *entry.second;
+        FairClassStats classStats;
+        classStats.requestClass = cls.name;
+        classStats.weight = cls.weight;
+        classStats.requests = cls.requests;
+        classStats.npuSeconds = cls.npuSeconds;
+        cls.queueMs.percentiles(&classStats.queueP50Ms, &classStats.queueP95Ms, &classStats.queueP99Ms);
+        cls.latencyMs.percentiles(&classStats.latencyP50Ms, &classStats.latencyP95Ms, &classStats.latencyP99Ms);
+        stats.classes.push_back(classStats);
+    }
+    
+    double total = 0.0;
+    for (const auto& entry : tenants_) {
+        total += entry.second->npuSeconds;
+    }
+    for (const auto& entry : tenants_) {
+        const TenantState& tenant = *entry.second;
+        FairTenantStats tenantStats;
+        tenantStats.tenantId = tenant.id;
+        tenantStats.weight = tenant.weight;
+        tenantStats.requests = tenant.requests;
+        tenantStats.npuSeconds = tenant.npuSeconds;
+        tenantStats.share = total > 0.0 ? tenant.npuSeconds / total : 0.0;
+        stats.tenants.push_back(tenantStats);
+    }
+    return stats;
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,176 @@
+/**
+ * @module inference
+ * @purpose Weighted fair queueing of inference runs across tenants and classes
+ * @description Orders requests waiting for an inference slot by virtual finish
+ *              time (start-time fair queueing). Each (tenant, class) flow is
+ *              charged the request's estimated NPU-seconds divided by its
+ *              weight, so a tenant queueing many long generations advances its
+ *              own virtual clock and lets light flows through. The estimate
+ *              comes from a learned seconds-per-token rate and is corrected
+ *              with the measured service time when the request completes.
+ *              Queue wait and end-to-end latency are sampled per class so the
+ *              effect of the weights can be checked under load.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Fair queueing configuration (mirrors the "scheduling" section of configs/runtime.json)
+ */
+struct FairQueueConfig {
+    std::unordered_map<std::string, double> tenantWeights;  // Missing tenants weigh 1
+    std::unordered_map<std::string, double> classWeights;   // Missing classes weigh 1
+    double prefillCostRatio = 0.1;        // Cost of a prompt token relative to a generated token
+    double initialSecondsPerToken = 0.05; // Decode cost assumed before any request finished
+    double learningRate = 0.2;            // EWMA weight of each measured request
+    size_t latencySamples = 1024;         // Samples kept per class for percentiles
+};
+
+/**
+ * Latency and service totals for one request class
+ */
+struct FairClassStats {
+    std::string requestClass;
+    double weight = 1.0;
+    int64_t requests = 0;        // Completed requests
+    double npuSeconds = 0.0;     // Measured service time
+    double queueP50Ms = 0.0;     // Wait for a slot
+    double queueP95Ms = 0.0;
+    double queueP99Ms = 0.0;
+    double latencyP50Ms = 0.0;   // Enqueue to completion
+    double latencyP95Ms = 0.0;
+    double latencyP99Ms = 0.0;
+};
+
+/**
+ * Service received by one tenant
+ */
+struct FairTenantStats {
+    std::string tenantId;
+    double weight = 1.0;
+    int64_t requests = 0;
+    double npuSeconds = 0.0;
+    double share = 0.0;          // Fraction of all measured NPU-seconds
+};
+
+/**
+ * Scheduler snapshot
+ */
+struct FairQueueStats {
+    int32_t queued = 0;                  // Requests waiting for dispatch
+    double virtualTime = 0.0;
+    double secondsPerToken = 0.0;        // Current cost model
+    std::vector<FairClassStats> classes; // Sorted by class name
+    std::vector<FairTenantStats> tenants; // Sorted by tenant id
+};
+
+/**
+ * Virtual-time fair queue
+ *
+ * Thread-safe. The scheduler only orders requests; the caller owns the slots
+ * and dispatches the head of the queue when one frees up.
+ */
+class FairScheduler {
+public:
+    // Monotonic microseconds; replaceable for tests
+    using Clock = std::function<int64_t()>;
+    
+    struct Entry;
+    
+    /**
+     * Queued or running request (RAII: leaves the queue, or completes, when destroyed)
+     */
+    class Ticket {
+    public:
+        Ticket() = default;
+        ~Ticket() { complete(0); }
+        Ticket(Ticket&& other) noexcept;
+        Ticket& operator=(Ticket&& other) noexcept;
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+        
+        bool valid() const { return entry_ != nullptr; }
+        
+        // Charge the measured service time and record latency
+        void complete(int64_t completionTokens);
+    
+    private:
+        friend class FairScheduler;
+        
+        Ticket(FairScheduler* scheduler, std::shared_ptr<Entry> entry)
+            : scheduler_(scheduler), entry_(std::move(entry)) {}
+        
+        FairScheduler* scheduler_ = nullptr;
+        std::shared_ptr<Entry> entry_;
+    };
+    
+    explicit FairScheduler(const FairQueueConfig& config = FairQueueConfig(), Clock clock = nullptr);
+    ~FairScheduler();
+    
+    FairScheduler(const FairScheduler&) = delete;
+    FairScheduler& operator=(const FairScheduler&) = delete;
+    
+    /**
+     * @brief Queue a request
+     * @param tenantId Tenant (empty = "default")
+     * @param requestClass Class (empty = "default")
+     * @param promptTokens Estimated prompt tokens
+     * @param maxTokens Generation limit; the class's observed reply length is used when shorter
+     */
+    Ticket enqueue(const std::string& tenantId, const std::string& requestClass, int64_t promptTokens,
+                   int64_t maxTokens);
+    
+    // Whether the ticket is at the head of the queue
+    bool isNext(const Ticket& ticket) const;
+    
+    // Take the ticket off the queue and start its service clock
+    void dispatch(Ticket& ticket);
+    
+    // Estimated NPU-seconds of a request of the given class
+    double estimateCost(const std::string& requestClass, int64_t promptTokens, int64_t maxTokens) const;
+    
+    FairQueueStats getStats() const;
+    const FairQueueConfig& getConfig() const { return config_; }
+
+private:
+    struct Flow;
+    struct ClassState;
+    struct TenantState;
+    
+    using QueueKey = std::pair<double, uint64_t>; // Virtual finish time, arrival order
+    
+    double estimateCostLocked(const ClassState& cls, int64_t promptTokens, int64_t maxTokens) const;
+    ClassState& classLocked(const std::string& requestClass);
+    TenantState& tenantLocked(const std::string& tenantId);
+    void finish(Entry& entry, int64_t completionTokens);
+    
+    FairQueueConfig config_;
+    Clock clock_;
+    
+    mutable std::mutex mutex_;
+    std::map<QueueKey, Entry*> queue_;
+    std::unordered_map<std::string, std::unique_ptr<Flow>> flows_;
+    std::map<std::string, std::unique_ptr<ClassState>> classes_;
+    std::map<std::string, std::unique_ptr<TenantState>> tenants_;
+    double virtualTime_ = 0.0;
+    double secondsPerToken_ = 0.0;
+    uint64_t sequence_ = 0;
+};
+
+} // namespace inference
+} // namespace rkllmjs
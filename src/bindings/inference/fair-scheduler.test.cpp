@@ -0,0 +1,189 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "fair-scheduler.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+// Dispatch everything queued, in scheduler order, and return the tenants served
+static std::vector<std::string> drain(FairScheduler& scheduler, std::vector<FairScheduler::Ticket>& tickets,
+                                      const std::vector<std::string>& owners, size_t count) {
+    std::vector<std::string> order;
+    for (size_t served = 0; served < count; ++served) {
+        for (size_t i = 0; i < tickets.size(); ++i) {
+            if (scheduler.isNext(tickets[i])) {
+                scheduler.dispatch(tickets[i]);
+                order.push_back(owners[i]);
+                break;
+            }
+        }
+    }
+    return order;
+}
+
+TEST(FairSchedulerTest, ShortRequestsOvertakeAFloodOfLongOnes) {
+    FairScheduler scheduler;
+    std::vector<FairScheduler::Ticket> tickets;
+    std::vector<std::string> owners;
+    
+    // "bulk" queues six long generations before "chat" shows up
+    for (int i = 0; i < 6; ++i) {
+        tickets.push_back(scheduler.enqueue("bulk", "", 200, 500));
+        owners.push_back("bulk");
+    }
+    for (int i = 0; i < 2; ++i) {
+        tickets.push_back(scheduler.enqueue("chat", "", 20, 20));
+        owners.push_back("chat");
+    }
+    EXPECT_EQ(scheduler.getStats().queued, 8);
+    
+    // Cost is in NPU-seconds, not requests: both chat requests go first
+    std::vector<std::string> order = drain(scheduler, tickets, owners, 3);
+    EXPECT_EQ(order[0], std::string("chat"));
+    EXPECT_EQ(order[1], std::string("chat"));
+    EXPECT_EQ(order[2], std::string("bulk"));
+    EXPECT_NEAR(scheduler.estimateCost("", 200, 500), (20.0 + 500.0) * 0.05, 1e-9);
+}
+
+TEST(FairSchedulerTest, WeightsSetTheShareOfDispatches) {
+    FairQueueConfig config;
+    config.tenantWeights["gold"] = 3.0;
+    FairScheduler scheduler(config);
+    std::vector<FairScheduler::Ticket> tickets;
+    std::vector<std::string> owners;
+    for (int i = 0; i < 40; ++i) {
+        tickets.push_back(scheduler.enqueue("gold", "", 0, 100));
+        owners.push_back("gold");
+        tickets.push_back(scheduler.enqueue("bronze", "", 0, 100));
+        owners.push_back("bronze");
+    }
+    
+    std::vector<std::string> order = drain(scheduler, tickets, owners, 20);
+    int gold = 0;
+    for (const auto& owner : order) {
+        gold += owner == "gold" ? 1 : 0;
+    }
+    EXPECT_EQ(gold, 15);
+    
+    // A class weight multiplies the tenant weight
+    config.classWeights["interactive"] = 4.0;
+    FairScheduler classes(config);
+    FairScheduler::Ticket batch = classes.enqueue("bronze", "batch", 0, 100);
+    FairScheduler::Ticket interactive = classes.enqueue("bronze", "interactive", 0, 300);
+    EXPECT_TRUE(classes.isNext(interactive));
+}
+
+TEST(FairSchedulerTest, CompletionChargesMeasuredTimeAndRecordsPercentiles) {
+    int64_t nowUs = 0;
+    FairQueueConfig config;
+    config.prefillCostRatio = 0.0;
+    config.learningRate = 1.0;
+    FairScheduler scheduler(config, [&nowUs] { return nowUs; });
+    
+    for (int i = 1; i <= 10; ++i) {
+        FairScheduler::Ticket ticket = scheduler.enqueue("a", "interactive", 10, 100);
+        nowUs += i * 1000;              // Queue wait of i ms
+        scheduler.dispatch(ticket);
+        nowUs += 500000;                // Half a second on the NPU
+        ticket.complete(50);
+    }
+    
+    // The cost model learned 10ms per token and the observed reply length
+    FairQueueStats stats = scheduler.getStats();
+    EXPECT_NEAR(stats.secondsPerToken, 0.01, 1e-9);
+    EXPECT_NEAR(scheduler.estimateCost("interactive", 10, 100), 0.5, 1e-9);
+    EXPECT_NEAR(scheduler.estimateCost("other", 10, 100), 1.0, 1e-9);
+    
+    EXPECT_EQ(stats.classes.size(), 1u);
+    const FairClassStats& cls = stats.classes[0];
+    EXPECT_EQ(cls.requestClass, std::string("interactive"));
+    EXPECT_EQ(cls.requests, 10);
+    EXPECT_NEAR(cls.npuSeconds, 5.0, 1e-9);
+    EXPECT_NEAR(cls.queueP50Ms, 5.0, 1e-9);
+    EXPECT_NEAR(cls.queueP95Ms, 10.0, 1e-9);
+    EXPECT_NEAR(cls.latencyP50Ms, 505.0, 1e-9);
+    EXPECT_NEAR(cls.latencyP99Ms, 510.0, 1e-9);
+    
+    EXPECT_EQ(stats.tenants.size(), 1u);
+    EXPECT_NEAR(stats.tenants[0].share, 1.0, 1e-9);
+    EXPECT_EQ(stats.queued, 0);
+}
+
+TEST(FairSchedulerTest, LeavingTheQueueRefundsVirtualTime) {
+    FairScheduler scheduler;
+    FairScheduler::Ticket chat = scheduler.enqueue("chat", "", 0, 10);
+    {
+        FairScheduler::Ticket abandoned = scheduler.enqueue("bulk", "", 0, 1000);
+    }
+    EXPECT_EQ(scheduler.getStats().queued, 1);
+    
+    // Without the refund this request would queue behind the abandoned one's tag
+    FairScheduler::Ticket bulk = scheduler.enqueue("bulk", "", 0, 5);
+    EXPECT_TRUE(scheduler.isNext(bulk));
+    scheduler.dispatch(bulk);
+    EXPECT_TRUE(scheduler.isNext(chat));
+    
+    FairScheduler::Ticket moved = std::move(chat);
+    EXPECT_FALSE(chat.valid());
+    EXPECT_TRUE(scheduler.isNext(moved));
+}
+
+TEST(FairSchedulerTest, SlotGateServesHeadOfQueueUnderContention) {
+    FairScheduler scheduler;
+    std::mutex mutex;
+    std::condition_variable cv;
+    int freeSlots = 2;
+    std::atomic<int> completed{0};
+    
+    // Same gate the engine uses: wait for a free slot and the head of the queue
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 50; ++i) {
+                FairScheduler::Ticket ticket = scheduler.enqueue("tenant-" + std::to_string(t % 3), "", 4, 8);
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return freeSlots > 0 && scheduler.isNext(ticket); });
+                    freeSlots--;
+                    scheduler.dispatch(ticket);
+                }
+                cv.notify_all();
+                ticket.complete(8);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    freeSlots++;
+                }
+                cv.notify_all();
+                completed++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    EXPECT_EQ(completed.load(), 400);
+    FairQueueStats stats = scheduler.getStats();
+    EXPECT_EQ(stats.queued, 0);
+    EXPECT_EQ(stats.tenants.size(), 3u);
+    int64_t requests = 0;
+    for (const auto& tenant : stats.tenants) {
+        requests += tenant.requests;
+    }
+    EXPECT_EQ(requests, 400);
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
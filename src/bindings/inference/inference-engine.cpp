@@ -1,4 +1,5 @@
 #include "inference-engine.hpp"
+#include "request-coalescer.hpp"
 #include "../config/build-config.hpp"
 #include "../../../libs/rkllm/include/rkllm.h"
 
@@ -12,55 +13,346 @@
 #include <sstream>
 #include <regex>
 #include <numeric>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <map>
+#include <unordered_map>
 #include <iostream>
+#include <unistd.h>
 
 namespace rkllmjs {
 namespace inference {
 
-// Static callback function for RKLLM results
-static int rkllm_result_callback(RKLLMResult* result, void* userdata, LLMCallState state) {
-    struct InferenceContext {
-        std::string* accumulated_text;
-        int* token_count;
-        bool* is_finished;
-        std::string* finish_reason;
-    };
+// Rows are [num_tokens × vocab_size]; the last one predicts the next token
+static const float* lastLogitsRow(const RKLLMResultLogits& logits) {
+    return logits.logits + static_cast<size_t>(logits.num_tokens - 1) * logits.vocab_size;
+}
+
+static bool hasLogits(const RKLLMResultLogits& logits) {
+    return logits.logits && logits.vocab_size > 0 && logits.num_tokens > 0;
+}
+
+// Prompt cache file private to one logits-mode request, under the model's scratch_dir
+static std::string scratchCacheFile(const std::string& dir, const char* kind) {
+    static std::atomic<int64_t> counter{0};
+    return dir + "/rkllmjs-" + std::string(kind) + "-" + std::to_string(::getpid()) + "-" +
+           std::to_string(counter++) + ".cache";
+}
+
+// Collects generated text from rkllm_run
+class GenerationSink : public core::ResultSink {
+public:
+    GenerationSink(const TokenCallback& onToken, InferenceWatchdog::Watch* watch = nullptr,
+                   StreamBuffer* stream = nullptr, EnergyMonitor::Meter* meter = nullptr)
+        : onToken_(onToken), watch_(watch), stream_(stream), meter_(meter) {}
+    
+    std::string text;
+    int tokenCount = 0;
+    int prefillTokens = 0;
+    float prefillMs = 0.0f;
+    bool finished = false;
+    std::string finishReason;
+    
+    int onResult(RKLLMResult* result, LLMCallState state) override {
+        // An expired request stops at its next callback
+        if (watch_ && !watch_->touch()) {
+            finished = true;
+            finishReason = "timeout";
+            return 1;
+        }
+        
+        if (result && result->text) {
+            // Only whole characters are passed on; a partial one waits for the next token
+            tokenCount++;
+            if (meter_) {
+                meter_->addTokens();
+            }
+            chunk_.clear();
+            assembler_.push(result->text, std::strlen(result->text), &chunk_);
+            emit();
+            
+            // Backpressure from the stream consumer
+            if (stream_ && stream_->isDropped()) {
+                finished = true;
+                finishReason = "dropped";
+                return 1;
+            }
+            if (stream_ && stream_->shouldPause()) {
+                // Opt-in PAUSE: the run waits here, bounded by maxPauseMs, and keeps its
+                // slot, session and KV cache, so other requests on the model wait too
+                if (!stream_->waitForDrain()) {
+                    finished = true;
+                    finishReason = "dropped";
+                    return 1;
+                }
+                if (watch_ && !watch_->touch()) {
+                    finished = true;
+                    finishReason = "timeout";
+                    return 1;
+                }
+            }
+        }
+        
+        switch (state) {
+            case RKLLM_RUN_WAITING:
+                return 0; // Incomplete UTF-8 character; its bytes are held by the assembler
+            case RKLLM_RUN_FINISH:
+                if (finishReason == "dropped") {
+                    return 0;
+                }
+                flush();
+                finished = true;
+                finishReason = "completed";
+                if (result && prefillTokens == 0) {
+                    prefillTokens = result->perf.prefill_tokens;
+                    prefillMs = result->perf.prefill_time_ms;
+                }
+                return 0;
+            case RKLLM_RUN_ERROR:
+                flush();
+                finished = true;
+                finishReason = "error";
+                return 1; // Stop
+            default:
+                return 0; // Continue
+        }
+    }
+    
+    // End of output: a character left incomplete becomes U+FFFD
+    void flush() {
+        chunk_.clear();
+        assembler_.flush(&chunk_);
+        emit();
+    }
     
-    InferenceContext* ctx = static_cast<InferenceContext*>(userdata);
-    
-    if (result && result->text && ctx->accumulated_text) {
-        // Print streaming text in real-time
-        std::cout << result->text << std::flush;
-        *(ctx->accumulated_text) += result->text;
-        (*(ctx->token_count))++;
-    }
-    
-    switch (state) {
-        case RKLLM_RUN_NORMAL:
-            return 0; // Continue
-        case RKLLM_RUN_WAITING:
-            return 0; // Continue
-        case RKLLM_RUN_FINISH:
-            if (ctx->is_finished && ctx->finish_reason) {
-                *(ctx->is_finished) = true;
-                *(ctx->finish_reason) = "completed";
-                std::cout << "\n"; // New line after completion
+    InferenceWatchdog::Watch* watch() const { return watch_; }
+
+private:
+    void emit() {
+        if (chunk_.empty()) {
+            return;
+        }
+        text += chunk_;
+        if (onToken_) {
+            onToken_(chunk_);
+        }
+    }
+    
+    const TokenCallback& onToken_;
+    InferenceWatchdog::Watch* watch_;
+    StreamBuffer* stream_;
+    EnergyMonitor::Meter* meter_;
+    Utf8Assembler assembler_;
+    std::string chunk_;
+};
+
+// Mean-pools the last hidden layer into a prompt embedding
+class EmbeddingSink : public core::ResultSink {
+public:
+    std::vector<float> embedding;
+    bool failed = false;
+    
+    int onResult(RKLLMResult* result, LLMCallState state) override {
+        if (state == RKLLM_RUN_ERROR) {
+            failed = true;
+            return 1;
+        }
+        
+        const RKLLMResultLastHiddenLayer* hidden = result ? &result->last_hidden_layer : nullptr;
+        if (hidden && hidden->hidden_states && hidden->embd_size > 0 && hidden->num_tokens > 0) {
+            size_t dim = static_cast<size_t>(hidden->embd_size);
+            embedding.assign(dim, 0.0f);
+            for (int t = 0; t < hidden->num_tokens; ++t) {
+                const float* row = hidden->hidden_states + static_cast<size_t>(t) * dim;
+                for (size_t i = 0; i < dim; ++i) {
+                    embedding[i] += row[i];
+                }
             }
+            // Scale does not matter for cosine similarity, so the sum is kept as-is
+        }
+        return 0;
+    }
+};
+
+// Logits-mode decoding: picks the next token from the last row of each run and
+// stages its logprob while the runtime's buffer is still valid
+class LogitsSink : public core::ResultSink {
+public:
+    LogitsSink(const InferenceParams& params, LogprobRecorder* recorder, InferenceWatchdog::Watch* watch)
+        : recorder_(recorder), watch_(watch), temperature_(params.temperature), topP_(params.topP),
+          topK_(params.topK) {
+        uint32_t seed = params.seed >= 0 ? static_cast<uint32_t>(params.seed) : std::random_device{}();
+        if (params.temperature > 0.0f && params.topK != 1) {
+            if (params.mirostat == 2) {
+                sampler_ = std::make_unique<MirostatV2Sampling>(params.mirostatTau, params.mirostatEta, seed);
+            } else if (params.minP > 0.0f) {
+                sampler_ = std::make_unique<MinPSampling>(params.minP, seed);
+            } else if (params.typicalP < 1.0f) {
+                sampler_ = std::make_unique<TypicalSampling>(params.typicalP, seed);
+            } else if (params.topP < 1.0f) {
+                sampler_ = std::make_unique<TopPSampling>(seed);
+            } else {
+                sampler_ = std::make_unique<TopKSampling>(seed);
+            }
+        }
+        if (params.dryMultiplier > 0.0f) {
+            DryConfig dry;
+            dry.multiplier = params.dryMultiplier;
+            dry.base = params.dryBase;
+            dry.allowedLength = params.dryAllowedLength;
+            dry.lastN = params.dryLastN;
+            dry.sequenceBreakers = params.dryBreakerIds;
+            sampler_ = std::make_unique<DrySampling>(dry, std::move(sampler_));
+        }
+    }
+    
+    // The reply keeps this token: samplers with per-request state learn it
+    void accept(int32_t token) {
+        if (sampler_) {
+            sampler_->accept(token);
+        }
+    }
+    
+    int32_t token = -1; // Chosen by the latest run (-1 = the run returned no logits)
+    bool failed = false;
+    bool expired = false;
+    
+    int onResult(RKLLMResult* result, LLMCallState state) override {
+        if (watch_ && !watch_->touch()) {
+            expired = true;
+            return 1;
+        }
+        if (state == RKLLM_RUN_ERROR) {
+            failed = true;
+            return 1;
+        }
+        
+        if (result && hasLogits(result->logits)) {
+            const float* row = lastLogitsRow(result->logits);
+            token = choose(row, result->logits.vocab_size);
+            recorder_->stage(row, result->logits.vocab_size, token);
+        }
+        return 0;
+    }
+
+private:
+    int32_t choose(const float* row, int32_t vocabSize) {
+        if (!sampler_) {
+            return static_cast<int32_t>(std::max_element(row, row + vocabSize) - row);
+        }
+        // Sampled in place from the runtime's buffer
+        return sampler_->sample(LogitsSpan(row, static_cast<size_t>(vocabSize)), temperature_, topP_, topK_,
+                                workspace_);
+    }
+    
+    LogprobRecorder* recorder_;
+    InferenceWatchdog::Watch* watch_;
+    std::unique_ptr<SamplingStrategy> sampler_; // Greedy when null
+    SamplingWorkspace workspace_;               // Per-request scratch, reused every step
+    float temperature_;
+    float topP_;
+    int32_t topK_;
+};
+
+// Scoring passes: hands each batch entry's logits rows to the scorer
+class ScoreSink : public core::ResultSink {
+public:
+    ScoreSink(CandidateScorer* scorer, InferenceWatchdog::Watch* watch) : scorer_(scorer), watch_(watch) {}
+    
+    // Batch entries of the next run: candidate index (-1 = padding), first fed position and tokens fed
+    struct Slot {
+        int64_t candidate = -1;
+        size_t from = 0;
+        int32_t fed = 0;
+    };
+    std::vector<Slot> slots;   // Empty for the prompt prefill
+    bool failed = false;
+    bool expired = false;
+    bool partialRows = false;  // Some entry got fewer rows than tokens fed
+    
+    int onResult(RKLLMResult* result, LLMCallState state) override {
+        if (watch_ && !watch_->touch()) {
+            expired = true;
+            return 1;
+        }
+        if (state == RKLLM_RUN_ERROR) {
+            failed = true;
+            return 1;
+        }
+        if (!result || state == RKLLM_RUN_FINISH) {
             return 0;
-        case RKLLM_RUN_ERROR:
-            if (ctx->is_finished && ctx->finish_reason) {
-                *(ctx->is_finished) = true;
-                *(ctx->finish_reason) = "error";
-                std::cout << "\n[ERROR] Inference failed\n";
+        }
+        
+        // With n_batch > 1 the runtime returns one result per batch entry
+        if (slots.empty()) {
+            if (hasLogits(result->logits)) {
+                scorer_->scorePromptRow(lastLogitsRow(result->logits), result->logits.vocab_size);
             }
-            return 1; // Stop
-        default:
             return 0;
+        }
+        for (size_t i = 0; i < slots.size(); ++i) {
+            const Slot& slot = slots[i];
+            const RKLLMResultLogits& logits = result[i].logits;
+            if (slot.candidate < 0 || !hasLogits(logits)) {
+                continue;
+            }
+            size_t index = static_cast<size_t>(slot.candidate);
+            if (logits.num_tokens == slot.fed) {
+                scorer_->scoreRows(index, slot.from, logits.logits, logits.num_tokens, logits.vocab_size);
+            } else {
+                // Only the last position: it still scores the token after the fed ones
+                partialRows = true;
+                scorer_->scoreRows(index, slot.from + slot.fed - 1, lastLogitsRow(logits), 1, logits.vocab_size);
+            }
+        }
+        return 0;
     }
-}
+
+private:
+    CandidateScorer* scorer_;
+    InferenceWatchdog::Watch* watch_;
+};
+
+// Beam passes: hands the last row of each batch entry to its beam
+class BeamSink : public core::ResultSink {
+public:
+    BeamSink(BeamSearch* search, InferenceWatchdog::Watch* watch) : search_(search), watch_(watch) {}
+    
+    std::vector<int32_t> slots; // Beam fed in each batch entry (-1 = padding)
+    bool failed = false;
+    bool expired = false;
+    
+    int onResult(RKLLMResult* result, LLMCallState state) override {
+        if (watch_ && !watch_->touch()) {
+            expired = true;
+            return 1;
+        }
+        if (state == RKLLM_RUN_ERROR) {
+            failed = true;
+            return 1;
+        }
+        if (!result || state == RKLLM_RUN_FINISH) {
+            return 0;
+        }
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (slots[i] >= 0 && hasLogits(result[i].logits)) {
+                search_->scoreBeam(slots[i], lastLogitsRow(result[i].logits), result[i].logits.vocab_size);
+            }
+        }
+        return 0;
+    }
+
+private:
+    BeamSearch* search_;
+    InferenceWatchdog::Watch* watch_;
+};
 
 // InferenceParams implementation
+bool InferenceParams::usesEngineSampler() const {
+    return minP > 0.0f || typicalP < 1.0f || mirostat != 0 || dryMultiplier > 0.0f;
+}
+
 bool InferenceParams::isValid() const {
     return validate().empty();
 }
@@ -96,6 +388,64 @@ std::string InferenceParams::validate() const {
         errors.push_back("batchSize must be between 1 and 32");
     }
     
+    if (maxTimeMs < 0) {
+        errors.push_back("maxTimeMs cannot be negative");
+    }
+    
+    if (!sessionId.empty() && !SessionStore::isValidSessionId(sessionId)) {
+        errors.push_back("sessionId may only contain letters, digits, '-' and '_'");
+    }
+    
+    if (!tenantId.empty() && !TenantQuotas::isValidTenantId(tenantId)) {
+        errors.push_back("tenantId must be at most 64 letters, digits, '-', '_' or '.'");
+    }
+    
+    // Class names follow the tenant id rules
+    if (!requestClass.empty() && !TenantQuotas::isValidTenantId(requestClass)) {
+        errors.push_back("requestClass must be at most 64 letters, digits, '-', '_' or '.'");
+    }
+    
+    if (topLogprobs < 0 || topLogprobs > LogprobRecorder::kMaxTopLogprobs) {
+        errors.push_back("topLogprobs must be between 0 and 20");
+    } else if (topLogprobs > 0 && !logprobs) {
+        errors.push_back("topLogprobs requires logprobs");
+    }
+    
+    if (!(minP >= 0.0f && minP <= 1.0f)) {
+        errors.push_back("minP must be between 0.0 and 1.0");
+    }
+    
+    if (!(typicalP > 0.0f && typicalP <= 1.0f)) {
+        errors.push_back("typicalP must be between 0.0 and 1.0");
+    }
+    
+    if (mirostat != 0 && mirostat != 2) {
+        errors.push_back("mirostat must be 0 or 2 (v1 is only available as a model setting)");
+    } else if (!(mirostatTau > 0.0f && mirostatTau <= 20.0f) || !(mirostatEta > 0.0f && mirostatEta <= 1.0f)) {
+        errors.push_back("mirostatTau must be between 0.0 and 20.0 and mirostatEta between 0.0 and 1.0");
+    }
+    
+    if (!(dryMultiplier >= 0.0f && dryMultiplier <= 10.0f) || !(dryBase >= 1.0f && dryBase <= 8.0f) ||
+        dryAllowedLength < 1 || dryLastN < 0) {
+        errors.push_back("DRY needs a multiplier of 0.0-10.0, a base of 1.0-8.0, an allowed length of at least 1 "
+                         "and a non-negative lastN");
+    }
+    
+    if (numBeams < 1 || numBeams > 16) {
+        errors.push_back("numBeams must be between 1 and 16");
+    } else if (numBeams > 1 && topLogprobs > 0) {
+        errors.push_back("topLogprobs is not available with beam search");
+    } else if (numBeams > 1 && maxTokens > kMaxBeamTokens) {
+        errors.push_back("beam search is limited to maxTokens of " + std::to_string(kMaxBeamTokens));
+    } else if (numBeams > 1 && !sessionId.empty()) {
+        // Beam passes clear and rebuild the KV cache from the prompt alone
+        errors.push_back("beam search is not available in a session");
+    }
+    
+    if (!(lengthPenalty >= -2.0f && lengthPenalty <= 4.0f)) {
+        errors.push_back("lengthPenalty must be between -2.0 and 4.0");
+    }
+    
     if (errors.empty()) {
         return "";
     }
@@ -117,9 +467,10 @@ InferenceEngine::InferenceEngine(std::shared_ptr<core::RKLLMManager> manager)
     , stopRequested_(false)
     , pauseRequested_(false)
     , maxConcurrentInferences_(4)
-    , streamBufferSize_(128)
     , kvCacheEnabled_(true)
-    , stats_{} {
+    , stats_{}
+    , coalescer_(std::make_unique<RequestCoalescer>())
+    , watchdog_(std::make_unique<InferenceWatchdog>(WatchdogConfig(), [](LLMHandle handle) { rkllm_abort(handle); })) {
     
     if (!manager_) {
         throw rkllmjs::utils::ResourceException("RKLLMManager cannot be null");
@@ -138,6 +489,17 @@ InferenceEngine::~InferenceEngine() {
 }
 
 void InferenceEngine::setModelHandle(LLMHandle handle) {
+    // Embeddings from different models are not comparable
+    if (semanticCache_ && handle != modelHandle_) {
+        semanticCache_->clear();
+    }
+    // Prompt caches hold another model's KV state
+    if (prefixIndex_ && handle != modelHandle_) {
+        prefixIndex_->clear();
+    }
+    if (handle != modelHandle_) {
+        invalidateActiveSession();
+    }
     modelHandle_ = handle;
 }
 
@@ -151,11 +513,13 @@ InferenceResult InferenceEngine::generate(const InferenceParams& params) {
     }
     
     validateParams(params);
+    TenantQuotas::Lease lease = admitTenant(params);
     
     state_ = InferenceState::RUNNING;
     
     try {
-        InferenceResult result = executeInference(params);
+        InferenceResult result = executeCoalesced(params);
+        lease.complete(result.fromCache ? 0 : result.completionTokens);
         updateStats(result);
         state_ = InferenceState::IDLE;
         return result;
@@ -171,11 +535,13 @@ void InferenceEngine::generateStream(const InferenceParams& params, StreamCallba
     }
     
     validateParams(params);
+    TenantQuotas::Lease lease = admitTenant(params);
     
     state_ = InferenceState::STREAMING;
     
     std::promise<InferenceResult> promise;
-    std::thread streamThread(&InferenceEngine::streamingWorker, this, params, callback, std::move(promise));
+    std::thread streamThread(&InferenceEngine::streamingWorker, this, params, callback, std::move(promise),
+                             std::move(lease));
     streamThread.detach();
 }
 
@@ -185,13 +551,15 @@ std::future<InferenceResult> InferenceEngine::generateStreamAsync(const Inferenc
     }
     
     validateParams(params);
+    TenantQuotas::Lease lease = admitTenant(params);
     
     state_ = InferenceState::STREAMING;
     
     std::promise<InferenceResult> promise;
     std::future<InferenceResult> future = promise.get_future();
     
-    std::thread streamThread(&InferenceEngine::streamingWorker, this, params, callback, std::move(promise));
+    std::thread streamThread(&InferenceEngine::streamingWorker, this, params, callback, std::move(promise),
+                             std::move(lease));
     streamThread.detach();
     
     return future;
@@ -238,6 +606,148 @@ std::future<std::vector<BatchResult>> InferenceEngine::generateBatchAsync(const
     return future;
 }
 
+ScoreResult InferenceEngine::score(const std::string& prompt, const std::vector<std::vector<int32_t>>& candidates) {
+    auto startTime = std::chrono::steady_clock::now();
+    if (!modelHandle_) {
+        throw rkllmjs::utils::RKLLMException("No model handle set for scoring");
+    }
+    if (!utils::isValidPrompt(prompt)) {
+        throw rkllmjs::utils::RKLLMException("Invalid prompt for scoring");
+    }
+    
+    ScoreResult result;
+    CandidateScorer scorer(candidates);
+    result.batchSize = getBatchSize();
+    size_t batch = static_cast<size_t>(result.batchSize);
+    std::string processedPrompt = preprocessPrompt(prompt);
+    
+    // Candidates with more than one token need passes of their own, n_batch at a time
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (candidates[i].size() > 1) {
+            pending.push_back(i);
+        }
+    }
+    
+    acquireInferenceSlot();
+    struct SlotGuard {
+        InferenceEngine* engine;
+        ~SlotGuard() { engine->releaseInferenceSlot(); }
+    } slotGuard{this};
+    std::shared_ptr<std::mutex> kvMutex = getKvMutex();
+    std::lock_guard<std::mutex> kvLock(*kvMutex);
+    invalidateActiveSession(); // Scoring overwrites the KV cache
+    
+    // Prefill the prompt once and save it; the first entry's last row scores every
+    // first token. Later groups start from the saved cache instead of a new prefill.
+    std::string cacheFile = pending.empty() ? std::string() : scratchCacheFile(getScratchDir(), "score");
+    RKLLMPromptCacheParam cacheParams;
+    cacheParams.save_prompt_cache = 1;
+    cacheParams.prompt_cache_path = cacheFile.c_str();
+    
+    RKLLMInput promptInput;
+    promptInput.role = "user";
+    promptInput.enable_thinking = false;
+    promptInput.input_type = RKLLM_INPUT_PROMPT;
+    promptInput.prompt_input = processedPrompt.c_str();
+    RKLLMInferParam inferParams;
+    inferParams.lora_params = nullptr;
+    inferParams.prompt_cache_params = pending.empty() ? nullptr : &cacheParams;
+    
+    InferenceWatchdog::Watch watch = watchdog_->watch(modelHandle_, 0);
+    ScoreSink sink(&scorer, &watch);
+    std::vector<RKLLMInput> inputs;
+    int status = prefillBatch(promptInput, batch, &inferParams, &sink, &inputs);
+    result.forwardPasses = 1;
+    
+    // Every group starts from the saved prompt rather than a fresh prefill
+    bool cacheLoaded = false;
+    auto restorePrompt = [&]() {
+        rkllm_clear_kv_cache(modelHandle_, 0, nullptr, nullptr);
+        cacheLoaded = rkllm_load_prompt_cache(modelHandle_, cacheFile.c_str()) == 0;
+        return cacheLoaded;
+    };
+    
+    for (size_t start = 0; start < pending.size() && status == 0 && !sink.failed && !sink.expired; start += batch) {
+        size_t count = std::min(batch, pending.size() - start);
+        size_t longest = 0;
+        for (size_t b = 0; b < count; ++b) {
+            longest = std::max(longest, candidates[pending[start + b]].size());
+        }
+        
+        // Feed each candidate's tokens from a position (or all but its last); padding entries repeat the last candidate
+        auto feed = [&](size_t from, bool whole, int keepHistory) {
+            sink.slots.assign(batch, ScoreSink::Slot());
+            for (size_t b = 0; b < batch; ++b) {
+                size_t index = pending[start + std::min(b, count - 1)];
+                const std::vector<int32_t>& tokens = candidates[index];
+                size_t slotFrom = whole ? 0 : std::min(from, tokens.size() - 2);
+                size_t fed = whole ? tokens.size() - 1 : 1;
+                inputs[b].input_type = RKLLM_INPUT_TOKEN;
+                inputs[b].token_input.input_ids = const_cast<int32_t*>(tokens.data() + slotFrom);
+                inputs[b].token_input.n_tokens = fed;
+                if (b < count && (whole || from + 1 < tokens.size())) {
+                    sink.slots[b] = ScoreSink::Slot{static_cast<int64_t>(index), slotFrom, static_cast<int32_t>(fed)};
+                }
+            }
+            inferParams.keep_history = keepHistory;
+            result.forwardPasses++;
+            return rkllm_run(modelHandle_, inputs.data(), &inferParams, &sink);
+        };
+        
+        if (!restorePrompt()) {
+            status = -1;
+            break;
+        }
+        
+        // One pass per group when the runtime returns a row per fed token
+        if (logitsRowPerToken_ != 0) {
+            sink.partialRows = false;
+            status = feed(0, true, 0);
+            if (status != 0 || !sink.partialRows) {
+                if (status == 0) {
+                    logitsRowPerToken_ = 1;
+                }
+                continue;
+            }
+            logitsRowPerToken_ = 0;
+            if (!restorePrompt()) {
+                status = -1;
+                break;
+            }
+        }
+        
+        // Otherwise step through the group a token at a time on top of the prompt
+        for (size_t position = 0; position + 1 < longest && status == 0 && !sink.failed && !sink.expired; ++position) {
+            status = feed(position, false, 1);
+        }
+    }
+    
+    if (cacheLoaded) {
+        rkllm_release_prompt_cache(modelHandle_);
+        rkllm_clear_kv_cache(modelHandle_, 0, nullptr, nullptr);
+    }
+    if (!cacheFile.empty()) {
+        std::remove(cacheFile.c_str());
+    }
+    bool expired = watch.expired() || sink.expired;
+    watch.release();
+    if (status != 0 || sink.failed || expired) {
+        throw rkllmjs::utils::RKLLMException(expired ? "Scoring timed out"
+                                                     : "RKLLM scoring failed with status: " + std::to_string(status));
+    }
+    
+    result.scores = scorer.results();
+    result.totalTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+    result.candidatesPerSecond = result.totalTime > 0.0f ? candidates.size() / result.totalTime : 0.0f;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.scoredCandidates += static_cast<int64_t>(candidates.size());
+        scoreSeconds_ += result.totalTime;
+    }
+    return result;
+}
+
 void InferenceEngine::pause() {
     pauseRequested_ = true;
     state_ = InferenceState::PAUSED;
@@ -269,13 +779,34 @@ void InferenceEngine::setMaxConcurrentInferences(int32_t maxConcurrent) {
         throw rkllmjs::utils::RKLLMException("maxConcurrent must be between 1 and 16");
     }
     maxConcurrentInferences_ = maxConcurrent;
+    admissionCv_.notify_all();
+}
+
+int32_t InferenceEngine::getEffectiveConcurrency() const {
+    return manager_->getThermalLimit(maxConcurrentInferences_);
 }
 
 void InferenceEngine::setStreamBufferSize(int32_t bufferSize) {
     if (bufferSize <= 0 || bufferSize > 1024) {
         throw rkllmjs::utils::RKLLMException("bufferSize must be between 1 and 1024");
     }
-    streamBufferSize_ = bufferSize;
+    streamConfig_.capacity = static_cast<size_t>(bufferSize);
+}
+
+void InferenceEngine::setStreamBufferConfig(const StreamBufferConfig& config) {
+    if (config.capacity == 0 || config.capacity > 1024 || config.maxPauseMs < 0 || config.dropAfterMs < 0) {
+        throw rkllmjs::utils::RKLLMException("Stream buffer capacity must be between 1 and 1024 and timeouts cannot be negative");
+    }
+    if (config.policy == SlowConsumerPolicy::PAUSE && config.maxPauseMs > StreamBufferConfig::kMaxPauseMs) {
+        // A paused stream holds the inference slot and KV lock of the model
+        throw rkllmjs::utils::RKLLMException("maxPauseMs cannot exceed " + std::to_string(StreamBufferConfig::kMaxPauseMs) +
+                                             " ms: a paused stream blocks every other request on the model");
+    }
+    streamConfig_ = config;
+}
+
+StreamBufferConfig InferenceEngine::getStreamBufferConfig() const {
+    return streamConfig_;
 }
 
 void InferenceEngine::enableKVCache(bool enable) {
@@ -287,18 +818,258 @@ void InferenceEngine::setDefaultParams(const InferenceParams& params) {
     defaultParams_ = params;
 }
 
+void InferenceEngine::enableResponseCache(const ResponseCacheConfig& config) {
+    responseCache_ = std::make_unique<ResponseCache>(config);
+}
+
+void InferenceEngine::disableResponseCache() {
+    responseCache_.reset();
+}
+
+void InferenceEngine::enablePrefixCache(const PrefixCacheConfig& config) {
+    prefixIndex_ = std::make_unique<PrefixCacheIndex>(config);
+}
+
+void InferenceEngine::disablePrefixCache() {
+    prefixIndex_.reset();
+}
+
+void InferenceEngine::enableContextManager(const ContextConfig& config) {
+    contextManager_ = std::make_unique<ContextManager>(config);
+}
+
+void InferenceEngine::disableContextManager() {
+    contextManager_.reset();
+}
+
+ContextStats InferenceEngine::getContextStats() const {
+    return contextManager_ ? contextManager_->getStats(modelHandle_) : ContextStats();
+}
+
+void InferenceEngine::enableSessionStore(const SessionStoreConfig& config, const SessionSchedulerConfig& scheduling) {
+    std::lock_guard<std::mutex> lock(sessionMutex_);
+    sessionStore_ = std::make_unique<SessionStore>(config);
+    sessionScheduler_ = std::make_unique<SessionScheduler>(scheduling);
+    activeSessionId_.clear();
+    activeSessionPrefix_.clear();
+}
+
+void InferenceEngine::disableSessionStore() {
+    std::lock_guard<std::mutex> lock(sessionMutex_);
+    sessionStore_.reset(); // Checkpoints stay on disk for the next enable
+    sessionScheduler_.reset();
+    activeSessionId_.clear();
+    activeSessionPrefix_.clear();
+}
+
+bool InferenceEngine::resumeSession(const std::string& sessionId) {
+    if (!sessionStore_ || !modelHandle_ || !SessionStore::isValidSessionId(sessionId) ||
+        !sessionStore_->get(sessionId, nullptr)) {
+        return false;
+    }
+    SessionScheduler::Turn turn = sessionScheduler_->acquire(sessionId);
+    std::lock_guard<std::mutex> lock(sessionMutex_);
+    return activateSession(sessionId);
+}
+
+void InferenceEngine::endSession(const std::string& sessionId) {
+    std::lock_guard<std::mutex> lock(sessionMutex_);
+    if (!sessionStore_) {
+        return;
+    }
+    if (activeSessionId_ == sessionId) {
+        activeSessionId_.clear();
+        activeSessionPrefix_.clear();
+    }
+    sessionStore_->remove(sessionId);
+}
+
+SessionStoreStats InferenceEngine::getSessionStats() const {
+    return sessionStore_ ? sessionStore_->getStats() : SessionStoreStats();
+}
+
+SessionSchedulerStats InferenceEngine::getSessionSchedulerStats() const {
+    return sessionScheduler_ ? sessionScheduler_->getStats() : SessionSchedulerStats();
+}
+
+void InferenceEngine::setWatchdogConfig(const WatchdogConfig& config) {
+    if (config.stallTimeoutMs < 0 || config.firstTokenTimeoutMs < 0 || config.abortGraceMs < 0 ||
+        config.pollIntervalMs <= 0) {
+        throw rkllmjs::utils::RKLLMException("Watchdog timeouts cannot be negative and pollIntervalMs must be positive");
+    }
+    watchdog_->setConfig(config);
+}
+
+WatchdogConfig InferenceEngine::getWatchdogConfig() const {
+    return watchdog_->getConfig();
+}
+
+WatchdogStats InferenceEngine::getWatchdogStats() const {
+    return watchdog_->getStats();
+}
+
+void InferenceEngine::enableEnergyMonitor(const EnergyConfig& config) {
+    if (config.sampleIntervalMs < 0) {
+        throw rkllmjs::utils::RKLLMException("Energy sampleIntervalMs cannot be negative");
+    }
+    energyMonitor_ = std::make_unique<EnergyMonitor>(config);
+}
+
+void InferenceEngine::disableEnergyMonitor() {
+    energyMonitor_.reset();
+}
+
+EnergyStats InferenceEngine::getEnergyStats() const {
+    return energyMonitor_ ? energyMonitor_->getStats() : EnergyStats();
+}
+
+void InferenceEngine::enableTenantQuotas(const TenantQuotaConfig& config) {
+    auto validLimits = [](const TenantLimits& limits) {
+        return limits.promptTokensPerSec >= 0.0 && limits.promptBurst >= 0.0 && limits.completionTokensPerSec >= 0.0 &&
+               limits.completionBurst >= 0.0 && limits.maxConcurrent >= 0;
+    };
+    if (!validLimits(config.defaults)) {
+        throw rkllmjs::utils::RKLLMException("Tenant quota limits cannot be negative");
+    }
+    for (const auto& tenant : config.tenants) {
+        if (!TenantQuotas::isValidTenantId(tenant.first) || !validLimits(tenant.second)) {
+            throw rkllmjs::utils::RKLLMException("Invalid quota for tenant '" + tenant.first + "'");
+        }
+    }
+    tenantQuotas_ = std::make_unique<TenantQuotas>(config);
+}
+
+void InferenceEngine::disableTenantQuotas() {
+    tenantQuotas_.reset();
+}
+
+std::vector<TenantUsage> InferenceEngine::getTenantUsage() const {
+    return tenantQuotas_ ? tenantQuotas_->getAllUsage() : std::vector<TenantUsage>();
+}
+
+void InferenceEngine::enableFairQueueing(const FairQueueConfig& config) {
+    auto validWeights = [](const std::unordered_map<std::string, double>& weights) {
+        return std::all_of(weights.begin(), weights.end(), [](const std::pair<const std::string, double>& entry) {
+            return entry.second > 0.0 && std::isfinite(entry.second);
+        });
+    };
+    if (!validWeights(config.tenantWeights) || !validWeights(config.classWeights)) {
+        throw rkllmjs::utils::RKLLMException("Fair queueing weights must be positive");
+    }
+    if (config.prefillCostRatio < 0.0 || config.initialSecondsPerToken <= 0.0 || config.learningRate <= 0.0 ||
+        config.learningRate > 1.0) {
+        throw rkllmjs::utils::RKLLMException(
+            "Fair queueing needs prefillCostRatio >= 0, initialSecondsPerToken > 0 and learningRate in (0, 1]");
+    }
+    fairScheduler_ = std::make_unique<FairScheduler>(config);
+}
+
+void InferenceEngine::disableFairQueueing() {
+    fairScheduler_.reset();
+}
+
+FairQueueStats InferenceEngine::getFairQueueStats() const {
+    return fairScheduler_ ? fairScheduler_->getStats() : FairQueueStats();
+}
+
+void InferenceEngine::enableRequestCoalescing(bool enable) {
+    coalescingEnabled_ = enable;
+}
+
+void InferenceEngine::enableSemanticCache(const SemanticCacheConfig& config) {
+    semanticCache_ = std::make_unique<SemanticCache>(config);
+}
+
+void InferenceEngine::disableSemanticCache() {
+    semanticCache_.reset();
+}
+
 InferenceEngine::Stats InferenceEngine::getStats() const {
     std::lock_guard<std::mutex> lock(statsMutex_);
-    return stats_;
+    Stats stats = stats_;
+    
+    {
+        std::lock_guard<std::mutex> admissionLock(admissionMutex_);
+        stats.activeInferences = activeInferences_;
+        stats.queuedInferences = waitingInferences_;
+    }
+    stats.effectiveConcurrency = getEffectiveConcurrency();
+    
+    if (responseCache_) {
+        ResponseCacheStats cacheStats = responseCache_->getStats();
+        stats.cacheHits = cacheStats.hits;
+        stats.cacheMisses = cacheStats.misses;
+        stats.cacheHitRate = cacheStats.hitRate();
+    }
+    
+    if (semanticCache_) {
+        SemanticCacheStats semanticStats = semanticCache_->getStats();
+        stats.semanticCacheHits = semanticStats.hits;
+        stats.semanticCacheMisses = semanticStats.misses;
+        stats.semanticCacheHitRate = semanticStats.hitRate();
+        
+        // Lookup latency = embedding prefill + index search
+        double embeddingMs = embeddingCount_ > 0 ? embeddingTimeMs_ / embeddingCount_ : 0.0;
+        stats.semanticLookupMs = static_cast<float>(embeddingMs + semanticStats.averageLookupUs() / 1000.0);
+    }
+    
+    stats.coalescedRequests = coalescer_->getStats().joiners + batchDuplicates_;
+    
+    if (prefixIndex_) {
+        PrefixCacheStats prefixStats = prefixIndex_->getStats();
+        stats.prefixCacheHits = prefixStats.hits;
+        stats.prefixCacheFiles = static_cast<int32_t>(prefixStats.cacheFiles);
+        stats.prefillTokensSaved = prefixStats.prefillTokensSaved;
+    }
+    
+    if (contextManager_) {
+        ContextStats contextStats = contextManager_->getStats(modelHandle_);
+        stats.kvCacheTokens = contextStats.kvTokens;
+        stats.kvCacheOccupancy = contextStats.occupancy();
+        stats.contextEvictions = contextStats.rangeEvictions + contextStats.resets;
+    }
+    
+    if (sessionStore_) {
+        SessionStoreStats sessionStats = sessionStore_->getStats();
+        stats.persistedSessions = static_cast<int32_t>(sessionStats.sessions);
+        stats.sessionResumes = sessionStats.resumes;
+        stats.sessionResumeMs = static_cast<float>(sessionStats.averageResumeMs());
+        stats.sessionReprefillMs = static_cast<float>(sessionStats.averageReprefillMs());
+        
+        SessionSchedulerStats schedulerStats = sessionScheduler_->getStats();
+        stats.sessionSwitches = schedulerStats.switches;
+        stats.sessionBatchedTurns = schedulerStats.batchedTurns;
+        stats.sessionSwitchMs = static_cast<float>(schedulerStats.averageSwitchMs());
+    }
+    
+    WatchdogStats watchdogStats = watchdog_->getStats();
+    stats.stalledRequests = watchdogStats.stalls;
+    stats.timedOutRequests = watchdogStats.timeouts;
+    stats.abortedRuns = watchdogStats.aborts;
+    
+    if (energyMonitor_) {
+        EnergyStats energyStats = energyMonitor_->getStats();
+        stats.powerWatts = static_cast<float>(energyStats.powerWatts);
+        stats.energyJoules = static_cast<float>(energyStats.attributedJoules);
+        stats.idleEnergyJoules = static_cast<float>(energyStats.idleJoules);
+        stats.tokensPerJoule = static_cast<float>(energyStats.tokensPerJoule());
+    }
+    
+    stats.scoreCandidatesPerSecond = scoreSeconds_ > 0.0 ? static_cast<float>(stats.scoredCandidates / scoreSeconds_) : 0.0f;
+    return stats;
 }
 
 void InferenceEngine::resetStats() {
     std::lock_guard<std::mutex> lock(statsMutex_);
     stats_ = {};
+    embeddingTimeMs_ = 0.0;
+    embeddingCount_ = 0;
+    scoreSeconds_ = 0.0;
 }
 
 // Private methods
-InferenceResult InferenceEngine::executeInference(const InferenceParams& params) {
+InferenceResult InferenceEngine::executeInference(const InferenceParams& params, const TokenCallback& onToken,
+                                                  StreamBuffer* stream) {
     auto startTime = std::chrono::high_resolution_clock::now();
     
     // Preprocess prompt
@@ -316,55 +1087,173 @@ InferenceResult InferenceEngine::executeInference(const InferenceParams& params)
             throw rkllmjs::utils::RKLLMException("No model handle set for inference");
         }
         
-        // Context structure for callback
-        std::string accumulated_text;
-        int token_count = 0;
-        bool is_finished = false;
-        std::string finish_reason;
+        // Bounded concurrency, lowered while the SoC runs hot; with fair
+        // queueing the slot goes to the waiting run with the earliest virtual finish
+        int64_t promptEstimate = static_cast<int64_t>(processedPrompt.length() / 4);
+        FairScheduler::Ticket ticket = fairScheduler_
+            ? fairScheduler_->enqueue(params.tenantId, params.requestClass, promptEstimate, params.maxTokens)
+            : FairScheduler::Ticket();
+        auto queueStart = std::chrono::steady_clock::now();
+        acquireInferenceSlot(ticket.valid() ? &ticket : nullptr);
+        result.queueTimeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - queueStart).count();
+        struct SlotGuard {
+            InferenceEngine* engine;
+            ~SlotGuard() { engine->releaseInferenceSlot(); }
+        } slotGuard{this};
         
-        struct InferenceContext {
-            std::string* accumulated_text;
-            int* token_count;
-            bool* is_finished;
-            std::string* finish_reason;
-        };
+        // Session turns own the KV cache until they finish; other requests
+        // overwrite it, so the next session turn must reload its checkpoint
+        bool inSession = sessionStore_ && !params.sessionId.empty();
+        SessionScheduler::Turn sessionTurn;
+        if (inSession) {
+            sessionTurn = sessionScheduler_->acquire(params.sessionId);
+        }
         
-        InferenceContext context = {
-            &accumulated_text,
-            &token_count, 
-            &is_finished,
-            &finish_reason
-        };
+        // Everything below runs on or rewrites the handle's KV cache
+        std::shared_ptr<std::mutex> kvMutex = getKvMutex();
+        std::unique_lock<std::mutex> kvLock(*kvMutex);
+        
+        std::unique_lock<std::mutex> sessionLock(sessionMutex_, std::defer_lock);
+        std::string sessionPrompt;
+        RKLLMPromptCacheParam sessionCache;
+        std::string sessionCacheFile;
+        if (inSession) {
+            sessionLock.lock();
+            activateSession(params.sessionId);
+            sessionPrompt = activeSessionPrefix_ + processedPrompt;
+            sessionCacheFile = sessionStore_->getCacheFile(params.sessionId);
+            sessionCache.save_prompt_cache = 1;
+            sessionCache.prompt_cache_path = sessionCacheFile.c_str();
+        } else {
+            invalidateActiveSession();
+        }
+        
+        // Replies that may be cached or shared must not depend on earlier requests
+        bool standalone = !inSession && isDeterministic(params);
+        
+        // Make room in the context window before the turn is appended
+        core::RKLLMModelConfig modelConfig;
+        if (contextManager_ && !standalone &&
+            manager_->getModelConfig(modelHandle_, &modelConfig) == core::ManagerResult::SUCCESS) {
+            int32_t upcomingTokens = static_cast<int32_t>(processedPrompt.length() / 4) + params.maxTokens;
+            contextManager_->prepare(modelHandle_, modelConfig.max_context_len, modelConfig.n_keep, upcomingTokens);
+        }
+        
+        // Start from the longest saved prompt cache and prefill only the rest
+        PrefixMatch prefix = inSession ? PrefixMatch() : preparePrefixCache(processedPrompt);
+        const char* promptInput = inSession ? sessionPrompt.c_str() : processedPrompt.c_str() + prefix.prefixBytes;
         
         // Prepare RKLLM input structure
         RKLLMInput rkllm_input;
         rkllm_input.role = "user";
         rkllm_input.enable_thinking = false;
         rkllm_input.input_type = RKLLM_INPUT_PROMPT;
-        rkllm_input.prompt_input = processedPrompt.c_str();
+        rkllm_input.prompt_input = promptInput;
         
         // Prepare RKLLM inference parameters
         RKLLMInferParam rkllm_infer_params;
         rkllm_infer_params.mode = RKLLM_INFER_GENERATE;
         rkllm_infer_params.lora_params = nullptr;
-        rkllm_infer_params.prompt_cache_params = nullptr;
+        rkllm_infer_params.prompt_cache_params = inSession ? &sessionCache : nullptr;
         rkllm_infer_params.keep_history = 1;
         
-        // Run RKLLM inference with context for callback
-        int status = rkllm_run(modelHandle_, &rkllm_input, &rkllm_infer_params, &context);
+        // Standalone runs start from an empty (or prefix-cache) KV state; plain
+        // generation discards history, engine decoding clears it up front since
+        // it needs history between its own forward passes
+        bool logitsMode = params.logprobs || params.usesEngineSampler();
+        if (standalone && !logitsMode && params.numBeams == 1) {
+            rkllm_infer_params.keep_history = 0;
+        } else if (standalone && !prefix.found()) {
+            rkllm_clear_kv_cache(modelHandle_, 1, nullptr, nullptr);
+        }
+        
+        // The loaded prefix already holds the template's opening
+        struct TemplateGuard {
+            InferenceEngine* engine;
+            bool split;
+            ~TemplateGuard() {
+                if (split) {
+                    engine->setChatTemplate(true, true);
+                }
+            }
+        } templateGuard{this, prefix.found()};
+        if (templateGuard.split) {
+            setChatTemplate(false, true);
+        }
+        
+        // Run RKLLM inference under supervision; the manager's callback forwards
+        // results to the sink, which stops the run once the watchdog expires it
+        InferenceWatchdog::Watch watch = watchdog_->watch(modelHandle_, params.maxTimeMs);
+        EnergyMonitor::Meter meter = energyMonitor_ ? energyMonitor_->begin() : EnergyMonitor::Meter();
+        GenerationSink sink(onToken, &watch, stream, &meter);
+        LogprobRecorder recorder(logitsMode && params.numBeams == 1 ? params.maxTokens : 0, params.topLogprobs);
+        std::vector<int32_t> beamTokens;
+        std::vector<float> beamLogprobs;
+        int status = 0;
+        if (params.numBeams > 1) {
+            status = decodeWithBeams(params, &rkllm_input, &rkllm_infer_params, &sink, &beamTokens, &beamLogprobs);
+        } else if (logitsMode) {
+            status = decodeWithLogits(params, &rkllm_input, &rkllm_infer_params, &sink, &recorder);
+        } else {
+            status = rkllm_run(modelHandle_, &rkllm_input, &rkllm_infer_params, &sink);
+        }
+        sink.flush(); // Runs cut short by a timeout or dropped stream end without FINISH
+        bool timedOut = watch.expired();
+        watch.release();
+        ticket.complete(sink.tokenCount);
+        EnergyReport energy = meter.finish();
+        result.energyJoules = static_cast<float>(energy.joules);
+        result.tokensPerJoule = static_cast<float>(energy.tokensPerJoule());
+        if (timedOut) {
+            // The reply was cut short; an aborted run may also have returned an error
+            sink.finishReason = "timeout";
+            status = 0;
+        }
+        
+        if (prefix.found()) {
+            rkllm_release_prompt_cache(modelHandle_);
+            if (status == 0) {
+                prefixIndex_->recordReuse(prefix);
+                result.prefillTokensSaved = prefix.prefillTokens;
+            }
+        }
+        
+        if (contextManager_ && !standalone) {
+            contextManager_->recordTurn(modelHandle_);
+        }
+        
+        // The saved cache covers the history up to this prompt; the reply is
+        // already in the live KV cache and is replayed only after a reload
+        if (inSession) {
+            if (status == 0 && !timedOut && sink.finishReason != "error" && sink.finishReason != "dropped") {
+                sessionStore_->recordCheckpoint(params.sessionId, processedPrompt, sink.text,
+                                                sink.prefillTokens, sink.prefillMs);
+                activeSessionPrefix_.clear();
+            } else {
+                activeSessionId_.clear();
+                activeSessionPrefix_.clear();
+                sessionScheduler_->resetCurrent();
+            }
+        }
         
         if (status == 0) {
-            result.text = accumulated_text.empty() ? "Inference completed successfully" : accumulated_text;
-            result.finished = is_finished;
-            result.finishReason = finish_reason.empty() ? "completed" : finish_reason;
-            result.tokensGenerated = token_count > 0 ? token_count : static_cast<uint32_t>(result.text.length() / 4);
+            result.text = sink.text.empty() ? "Inference completed successfully" : sink.text;
+            result.finished = sink.finished;
+            result.finishReason = sink.finishReason.empty() ? "completed" : sink.finishReason;
+            result.tokensGenerated = sink.tokenCount > 0 ? sink.tokenCount : static_cast<uint32_t>(result.text.length() / 4);
+            if (params.numBeams > 1 && params.logprobs) {
+                result.tokenIds = std::move(beamTokens);
+                result.logprobs = std::move(beamLogprobs);
+            } else if (params.logprobs) {
+                recorder.release(&result.tokenIds, &result.logprobs, &result.topLogprobs);
+            }
         } else {
             result.text = "";
             result.finished = false;
             result.finishReason = "error";
             throw rkllmjs::utils::RKLLMException("RKLLM inference failed with status: " + std::to_string(status));
         }
-        
+    
     } catch (const std::exception& e) {
         // Fallback to error state
         result.text = "Error: " + std::string(e.what());
@@ -384,14 +1273,491 @@ InferenceResult InferenceEngine::executeInference(const InferenceParams& params)
     return result;
 }
 
+int InferenceEngine::decodeWithLogits(const InferenceParams& params, RKLLMInput* promptInput,
+                                      RKLLMInferParam* inferParams, GenerationSink* sink,
+                                      LogprobRecorder* recorder) {
+    // The runtime only runs forward passes: the prompt is prefilled once, then
+    // each chosen token is fed back with keep_history so the KV cache grows by one
+    LogitsSink logitsSink(params, recorder, sink->watch());
+    inferParams->mode = RKLLM_INFER_GET_LOGITS;
+    int status = rkllm_run(modelHandle_, promptInput, inferParams, &logitsSink);
+    
+    // The runtime has no detokenizer in this mode; text comes from the host's decoder
+    int32_t eosToken = tokenDecoder_ ? tokenDecoder_->eosTokenId() : -1;
+    std::string piece;
+    piece.reserve(64);
+    int32_t nextToken = -1;
+    RKLLMInput tokenInput;
+    tokenInput.role = "user";
+    tokenInput.enable_thinking = false;
+    tokenInput.input_type = RKLLM_INPUT_TOKEN;
+    tokenInput.token_input.input_ids = &nextToken;
+    tokenInput.token_input.n_tokens = 1;
+    inferParams->prompt_cache_params = nullptr; // A session checkpoint covers the prompt only
+    
+    while (status == 0 && !logitsSink.expired) {
+        if (logitsSink.failed || logitsSink.token < 0) {
+            sink->finished = true;
+            sink->finishReason = "error";
+            break;
+        }
+        nextToken = logitsSink.token;
+        if (nextToken == eosToken ||
+            std::find(params.stopTokenIds.begin(), params.stopTokenIds.end(), nextToken) != params.stopTokenIds.end()) {
+            sink->finished = true;
+            sink->finishReason = "stop";
+            break;
+        }
+        recorder->commit();
+        logitsSink.accept(nextToken);
+        emitDecodedToken(nextToken, &piece, sink);
+        if (sink->finished) {
+            break;
+        }
+        if (recorder->steps() >= params.maxTokens) {
+            sink->finished = true;
+            sink->finishReason = "length";
+            break;
+        }
+        
+        logitsSink.token = -1;
+        status = rkllm_run(modelHandle_, &tokenInput, inferParams, &logitsSink);
+    }
+    return status;
+}
+
+int InferenceEngine::decodeWithBeams(const InferenceParams& params, RKLLMInput* promptInput,
+                                     RKLLMInferParam* inferParams, GenerationSink* sink,
+                                     std::vector<int32_t>* tokenIds, std::vector<float>* logprobs) {
+    BeamSearchConfig config;
+    config.beamWidth = params.numBeams;
+    config.lengthPenalty = params.lengthPenalty;
+    config.earlyStopping = params.earlyStopping;
+    config.maxTokens = params.maxTokens;
+    config.eosTokenIds = params.stopTokenIds;
+    if (tokenDecoder_ && tokenDecoder_->eosTokenId() >= 0) {
+        config.eosTokenIds.push_back(tokenDecoder_->eosTokenId());
+    }
+    BeamSearch search(config);
+    size_t batch = static_cast<size_t>(getBatchSize());
+    
+    // The prompt is prefilled once and saved (a session turn already saves it);
+    // every beam pass starts from that cache and feeds only the beam's own tokens.
+    // Replies are capped at kMaxBeamTokens since each step re-feeds them in full.
+    std::string scratchFile;
+    RKLLMPromptCacheParam scratchCache;
+    if (!inferParams->prompt_cache_params) {
+        scratchFile = scratchCacheFile(getScratchDir(), "beams");
+        scratchCache.save_prompt_cache = 1;
+        scratchCache.prompt_cache_path = scratchFile.c_str();
+        inferParams->prompt_cache_params = &scratchCache;
+    }
+    std::string cacheFile = inferParams->prompt_cache_params->prompt_cache_path;
+    
+    BeamSink beamSink(&search, sink->watch());
+    beamSink.slots.assign(1, 0); // The prompt's last row scores the empty reply
+    std::vector<RKLLMInput> inputs;
+    int status = prefillBatch(*promptInput, batch, inferParams, &beamSink, &inputs);
+    
+    auto restorePrompt = [&]() {
+        rkllm_clear_kv_cache(modelHandle_, 0, nullptr, nullptr);
+        return rkllm_load_prompt_cache(modelHandle_, cacheFile.c_str()) == 0;
+    };
+    bool cacheLoaded = false;
+    
+    // Live beams are fed n_batch at a time
+    while (status == 0 && !beamSink.failed && !beamSink.expired && search.advance()) {
+        int32_t live = search.liveBeams();
+        for (int32_t start = 0; start < live && status == 0 && !beamSink.failed && !beamSink.expired;
+             start += static_cast<int32_t>(batch)) {
+            if (!restorePrompt()) {
+                status = -1;
+                break;
+            }
+            cacheLoaded = true;
+            beamSink.slots.assign(batch, -1);
+            for (size_t b = 0; b < batch; ++b) {
+                int32_t beam = std::min(start + static_cast<int32_t>(b), live - 1);
+                inputs[b].token_input.input_ids = const_cast<int32_t*>(search.sequence(beam));
+                inputs[b].token_input.n_tokens = static_cast<size_t>(search.length());
+                if (start + static_cast<int32_t>(b) < live) {
+                    beamSink.slots[b] = beam;
+                }
+            }
+            status = rkllm_run(modelHandle_, inputs.data(), inferParams, &beamSink);
+        }
+    }
+    if (status != 0 || beamSink.failed) {
+        sink->finished = true;
+        sink->finishReason = "error";
+    } else {
+        // A search cut short by the watchdog still returns its best beam
+        search.best(tokenIds, logprobs);
+        
+        // Leave the reply in the KV cache, as generate mode does
+        if (!tokenIds->empty() && !beamSink.expired && restorePrompt()) {
+            cacheLoaded = true;
+            inputs[0].token_input.input_ids = tokenIds->data();
+            inputs[0].token_input.n_tokens = tokenIds->size();
+            inferParams->keep_history = 1;
+            beamSink.slots.clear();
+            rkllm_run(modelHandle_, inputs.data(), inferParams, &beamSink);
+        }
+        
+        std::string piece;
+        for (size_t i = 0; i < tokenIds->size() && !sink->finished; ++i) {
+            emitDecodedToken((*tokenIds)[i], &piece, sink);
+        }
+        if (!sink->finished) {
+            sink->finished = true;
+            sink->finishReason = static_cast<int32_t>(tokenIds->size()) >= params.maxTokens ? "length" : "stop";
+        }
+    }
+    
+    if (cacheLoaded) {
+        rkllm_release_prompt_cache(modelHandle_);
+    }
+    if (!scratchFile.empty()) {
+        std::remove(scratchFile.c_str());
+    }
+    return status;
+}
+
+int InferenceEngine::prefillBatch(const RKLLMInput& promptInput, size_t batch, RKLLMInferParam* inferParams,
+                                  core::ResultSink* sink, std::vector<RKLLMInput>* inputs) {
+    // Every batch entry has its own KV cache, so each one gets the prompt; the
+    // saved prompt cache then restores all of them together
+    inputs->assign(batch, promptInput);
+    inferParams->mode = RKLLM_INFER_GET_LOGITS;
+    inferParams->keep_history = 0;
+    int status = rkllm_run(modelHandle_, inputs->data(), inferParams, sink);
+    inferParams->prompt_cache_params = nullptr;
+    
+    // Later passes feed token ids on top of the prompt
+    for (RKLLMInput& input : *inputs) {
+        input.input_type = RKLLM_INPUT_TOKEN;
+    }
+    return status;
+}
+
+void InferenceEngine::emitDecodedToken(int32_t token, std::string* piece, GenerationSink* sink) {
+    // Text, streaming and backpressure go through the same sink as generate mode;
+    // the caller's buffer is reused so steady-state decoding does not allocate.
+    // validateParams admits logits-mode requests only with a decoder.
+    piece->clear();
+    tokenDecoder_->appendText(token, piece);
+    RKLLMResult step;
+    std::memset(&step, 0, sizeof(step));
+    step.text = piece->c_str();
+    step.token_id = token;
+    sink->onResult(&step, RKLLM_RUN_NORMAL); // Waits for a slow consumer like generate mode
+}
+
+int32_t InferenceEngine::getBatchSize() const {
+    core::RKLLMModelConfig modelConfig;
+    if (modelHandle_ && manager_->getModelConfig(modelHandle_, &modelConfig) == core::ManagerResult::SUCCESS) {
+        return std::max(1, modelConfig.n_batch);
+    }
+    return 1;
+}
+
+std::string InferenceEngine::getScratchDir() const {
+    core::RKLLMModelConfig modelConfig;
+    if (modelHandle_ && manager_->getModelConfig(modelHandle_, &modelConfig) == core::ManagerResult::SUCCESS) {
+        return modelConfig.scratch_dir;
+    }
+    return core::RKLLMModelConfig().scratch_dir;
+}
+
+InferenceResult InferenceEngine::executeWithCache(const InferenceParams& params, const TokenCallback& onToken,
+                                                  StreamBuffer* stream) {
+    bool useExact = responseCache_ && params.useCache && isDeterministic(params);
+    // Logprobs belong to the exact prompt, so paraphrase matches cannot supply them
+    bool useSemantic = semanticCache_ && params.useCache && params.sessionId.empty() && !params.logprobs;
+    if (!useExact && !useSemantic) {
+        return executeInference(params, onToken, stream);
+    }
+    
+    auto startTime = std::chrono::steady_clock::now();
+    std::string processedPrompt = preprocessPrompt(params.prompt);
+    InferenceResult result;
+    
+    std::string key;
+    if (useExact) {
+        key = ResponseCache::makeKey(getModelId(), processedPrompt, params);
+        if (responseCache_->lookup(key, &result)) {
+            result.fromCache = true;
+            result.totalTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+            if (onToken) {
+                onToken(result.text);
+            }
+            return result;
+        }
+    }
+    
+    // Paraphrases only match entries produced with the same output-shaping settings
+    std::vector<float> embedding;
+    uint64_t semanticFilter = 0;
+    if (useSemantic) {
+        semanticFilter = ResponseCache::hashKey(ResponseCache::makeKey(getModelId(), "", params));
+        embedding = embedPrompt(processedPrompt);
+        if (!embedding.empty() &&
+            semanticCache_->lookup(embedding.data(), embedding.size(), &result, nullptr, semanticFilter)) {
+            result.fromCache = true;
+            result.totalTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+            if (onToken) {
+                onToken(result.text);
+            }
+            return result;
+        }
+    }
+    
+    result = executeInference(params, onToken, stream);
+    if (result.finishReason != "error" && result.finishReason != "timeout" && result.finishReason != "dropped") {
+        if (useExact) {
+            responseCache_->insert(key, result);
+        }
+        if (!embedding.empty()) {
+            semanticCache_->insert(embedding.data(), embedding.size(), result, semanticFilter);
+        }
+    }
+    return result;
+}
+
+InferenceResult InferenceEngine::executeCoalesced(const InferenceParams& params, const TokenCallback& onToken,
+                                                  StreamBuffer* stream) {
+    // Only deterministic requests are guaranteed to produce the same output; the
+    // leader runs without prior history, so every subscriber gets that output
+    if (!coalescingEnabled_ || !isDeterministic(params)) {
+        return executeWithCache(params, onToken, stream);
+    }
+    
+    // A shared flight keeps decoding for its other subscribers, so its
+    // stream buffers only merge chunks or stop delivering, never pause
+    
+    std::string key = ResponseCache::makeKey(getModelId(), preprocessPrompt(params.prompt), params);
+    RequestCoalescer::Flight flight = coalescer_->join(key);
+    std::shared_future<InferenceResult> shared = flight.request->subscribe(onToken);
+    
+    if (!flight.leader) {
+        InferenceResult result = shared.get(); // Rethrows the leader's failure
+        result.coalesced = true;
+        return result;
+    }
+    
+    InferenceResult result;
+    try {
+        auto request = flight.request;
+        result = executeWithCache(params, [&request](const std::string& token) {
+            request->publishToken(token);
+        });
+        flight.request->complete(result);
+    } catch (...) {
+        flight.request->fail(std::current_exception());
+        coalescer_->finish(key, flight.request);
+        throw;
+    }
+    
+    coalescer_->finish(key, flight.request);
+    return result;
+}
+
+PrefixMatch InferenceEngine::preparePrefixCache(const std::string& processedPrompt) {
+    // Caller holds the KV lock. Without the template it cannot be split around the prefix
+    if (!prefixIndex_ || !modelHandle_ || !prefixIndex_->getConfig().hasChatTemplate()) {
+        return {};
+    }
+    
+    // Popular shared prefixes get their own cache file, saved by a prefill-only
+    // pass that opens the turn but does not close it
+    PrefixPromotion promotion = prefixIndex_->observe(processedPrompt);
+    if (!promotion.empty()) {
+        setChatTemplate(true, false);
+        GenerationSink sink(nullptr);
+        RKLLMPromptCacheParam cache_params;
+        cache_params.save_prompt_cache = 1;
+        cache_params.prompt_cache_path = promotion.cacheFile.c_str();
+        
+        RKLLMInput rkllm_input;
+        rkllm_input.role = "user";
+        rkllm_input.enable_thinking = false;
+        rkllm_input.input_type = RKLLM_INPUT_PROMPT;
+        rkllm_input.prompt_input = promotion.prefix.c_str();
+        
+        RKLLMInferParam rkllm_infer_params;
+        rkllm_infer_params.mode = RKLLM_INFER_GET_LAST_HIDDEN_LAYER;
+        rkllm_infer_params.lora_params = nullptr;
+        rkllm_infer_params.prompt_cache_params = &cache_params;
+        rkllm_infer_params.keep_history = 0;
+        
+        int status = rkllm_run(modelHandle_, &rkllm_input, &rkllm_infer_params, &sink);
+        setChatTemplate(true, true);
+        if (status == 0 && sink.finishReason != "error") {
+            prefixIndex_->registerCache(promotion.prefix, promotion.cacheFile, sink.prefillTokens);
+        } else {
+            prefixIndex_->abandonPromotion(promotion.prefix);
+        }
+    }
+    
+    PrefixMatch match = prefixIndex_->findLongestPrefix(processedPrompt);
+    if (match.found() && rkllm_load_prompt_cache(modelHandle_, match.cacheFile.c_str()) != 0) {
+        prefixIndex_->invalidate(match.cacheFile);
+        return {};
+    }
+    return match;
+}
+
+void InferenceEngine::setChatTemplate(bool opening, bool closing) {
+    // Caller holds the KV lock; the template is per handle, so it is restored before unlocking
+    const PrefixCacheConfig& config = prefixIndex_->getConfig();
+    rkllm_set_chat_template(modelHandle_,
+                            opening ? config.systemPrompt.c_str() : "",
+                            opening ? config.promptPrefix.c_str() : "",
+                            closing ? config.promptPostfix.c_str() : "");
+}
+
+std::shared_ptr<std::mutex> InferenceEngine::getKvMutex() const {
+    std::shared_ptr<std::mutex> mutex = modelHandle_ ? manager_->getKvMutex(modelHandle_) : nullptr;
+    return mutex ? mutex : unmanagedKvMutex_;
+}
+
+std::vector<float> InferenceEngine::embedPrompt(const std::string& processedPrompt) {
+    if (!modelHandle_) {
+        return {};
+    }
+    
+    // The embedding pass is an NPU run like any other and counts against the slots
+    acquireInferenceSlot();
+    struct SlotGuard {
+        InferenceEngine* engine;
+        ~SlotGuard() { engine->releaseInferenceSlot(); }
+    } slotGuard{this};
+    std::shared_ptr<std::mutex> kvMutex = getKvMutex();
+    std::lock_guard<std::mutex> kvLock(*kvMutex);
+    
+    // keep_history = 0 makes the runtime discard the KV cache, session state included
+    invalidateActiveSession();
+    
+    auto startTime = std::chrono::steady_clock::now();
+    EmbeddingSink sink;
+    
+    RKLLMInput rkllm_input;
+    rkllm_input.role = "user";
+    rkllm_input.enable_thinking = false;
+    rkllm_input.input_type = RKLLM_INPUT_PROMPT;
+    rkllm_input.prompt_input = processedPrompt.c_str();
+    
+    // Prefill only; the hidden state is all this pass needs
+    RKLLMInferParam rkllm_infer_params;
+    rkllm_infer_params.mode = RKLLM_INFER_GET_LAST_HIDDEN_LAYER;
+    rkllm_infer_params.lora_params = nullptr;
+    rkllm_infer_params.prompt_cache_params = nullptr;
+    rkllm_infer_params.keep_history = 0;
+    
+    int status = rkllm_run(modelHandle_, &rkllm_input, &rkllm_infer_params, &sink);
+    
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        embeddingTimeMs_ += elapsedMs;
+        embeddingCount_++;
+    }
+    
+    if (status != 0 || sink.failed) {
+        return {};
+    }
+    return std::move(sink.embedding);
+}
+
+bool InferenceEngine::activateSession(const std::string& sessionId) {
+    // Caller holds sessionMutex_
+    if (activeSessionId_ == sessionId) {
+        return true;
+    }
+    
+    // Everything until the session's state is resident counts as switch overhead
+    auto switchStart = std::chrono::steady_clock::now();
+    std::string modelId = getModelId();
+    SessionInfo info;
+    bool known = sessionStore_->get(sessionId, &info) && info.modelId == modelId;
+    
+    // Drop whatever the handle holds except the system prompt
+    rkllm_clear_kv_cache(modelHandle_, 1, nullptr, nullptr);
+    activeSessionId_ = sessionId;
+    activeSessionPrefix_.clear();
+    
+    if (known && info.hasCheckpoint()) {
+        auto start = std::chrono::steady_clock::now();
+        bool loaded = rkllm_load_prompt_cache(modelHandle_, sessionStore_->getCacheFile(sessionId).c_str()) == 0;
+        double resumeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        sessionStore_->recordResume(sessionId, resumeMs, loaded);
+        
+        if (loaded) {
+            activeSessionPrefix_ = sessionStore_->readPending(sessionId);
+            sessionScheduler_->recordSwitch(
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - switchStart).count());
+            return true;
+        }
+    }
+    
+    // No usable checkpoint: the next turn re-prefills the whole history
+    if (!known) {
+        sessionStore_->open(sessionId, modelId);
+    }
+    activeSessionPrefix_ = sessionStore_->readHistory(sessionId);
+    sessionScheduler_->recordSwitch(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - switchStart).count());
+    return false;
+}
+
+void InferenceEngine::invalidateActiveSession() {
+    std::lock_guard<std::mutex> lock(sessionMutex_);
+    activeSessionId_.clear();
+    activeSessionPrefix_.clear();
+    if (sessionScheduler_) {
+        sessionScheduler_->resetCurrent();
+    }
+}
+
+std::string InferenceEngine::getModelId() const {
+    // Model path is stable across reloads, unlike the handle address
+    core::RKLLMModelConfig config;
+    if (modelHandle_ && manager_->getModelConfig(modelHandle_, &config) == core::ManagerResult::SUCCESS) {
+        return config.model_path;
+    }
+    
+    std::ostringstream oss;
+    oss << modelHandle_;
+    return oss.str();
+}
+
+bool InferenceEngine::isDeterministic(const InferenceParams& params) const {
+    // Plain generation samples with the settings the model was loaded with
+    core::RKLLMModelConfig config;
+    if (!modelHandle_ || manager_->getModelConfig(modelHandle_, &config) != core::ManagerResult::SUCCESS) {
+        return false;
+    }
+    return ResponseCache::isDeterministic(params, config);
+}
+
 void InferenceEngine::validateParams(const InferenceParams& params) {
     std::string validationError = params.validate();
     if (!validationError.empty()) {
         throw rkllmjs::utils::ConfigurationException(validationError);
     }
+    if ((params.logprobs || params.numBeams > 1 || params.usesEngineSampler()) && !tokenDecoder_) {
+        const char* feature = params.logprobs ? "logprobs" : params.numBeams > 1 ? "beam search" : "engine-side sampling";
+        throw rkllmjs::utils::ConfigurationException(std::string(feature) +
+                                                     " needs a token decoder: the runtime returns no text with logits");
+    }
 }
 
 void InferenceEngine::updateStats(const InferenceResult& result) {
+    // Cache hits and coalesced requests did not run on the NPU
+    if (result.fromCache || result.coalesced) {
+        return;
+    }
+    
     std::lock_guard<std::mutex> lock(statsMutex_);
     
     stats_.totalInferences++;
@@ -403,51 +1769,172 @@ void InferenceEngine::updateStats(const InferenceResult& result) {
     
     stats_.averageTokensPerSecond = newAvgTPS;
     stats_.averageLatency = newAvgLatency;
+    
+    // Per-model throughput, reported next to the model's memory footprint
+    if (modelHandle_) {
+        manager_->recordThroughput(modelHandle_, result.tokensPerSecond);
+    }
 }
 
 void InferenceEngine::streamingWorker(const InferenceParams& params, StreamCallback callback, 
-                                    std::promise<InferenceResult> promise) {
+                                    std::promise<InferenceResult> promise, TenantQuotas::Lease lease) {
     try {
-        // Execute inference with streaming
-        InferenceResult result = executeInference(params);
-        
-        // Simulate streaming by breaking up the result
-        std::vector<std::string> tokens = {"This", " is", " a", " simulated", " streaming", " response"};
-        
-        for (size_t i = 0; i < tokens.size(); ++i) {
-            if (stopRequested_) break;
-            
-            bool isLast = (i == tokens.size() - 1);
-            callback(tokens[i], isLast);
-            
-            // Simulate streaming delay
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        }
+        // Tokens are queued as the runtime produces them and delivered on the
+        // buffer's thread; only the opt-in PAUSE policy holds the callback
+        StreamBuffer stream(streamConfig_, callback);
+        InferenceResult result = executeCoalesced(params, [this, &stream](const std::string& token) {
+            if (!stopRequested_) {
+                stream.push(token);
+            }
+        }, &stream);
+        stream.finish();
+        recordStreamStats(stream.getStats());
+        lease.complete(result.fromCache ? 0 : result.completionTokens);
         
         updateStats(result);
         promise.set_value(result);
         state_ = InferenceState::IDLE;
-        
+    
     } catch (const std::exception& e) {
         state_ = InferenceState::ERROR;
         promise.set_exception(std::current_exception());
     }
 }
 
+bool InferenceEngine::tryAdmitTenant(const InferenceParams& params, TenantQuotas::Lease* lease, std::string* error) {
+    if (!tenantQuotas_) {
+        return true;
+    }
+    
+    // Same rough prompt estimate the result reports
+    int64_t promptTokens = std::max<int64_t>(1, static_cast<int64_t>(params.prompt.length() / 4));
+    int64_t retryAfterMs = 0;
+    QuotaVerdict verdict = tenantQuotas_->admit(params.tenantId, promptTokens, lease, &retryAfterMs);
+    if (verdict == QuotaVerdict::ADMITTED) {
+        return true;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.quotaRejections++;
+    }
+    std::ostringstream oss;
+    oss << "Tenant '" << (params.tenantId.empty() ? "default" : params.tenantId) << "' quota exceeded ("
+        << TenantQuotas::verdictName(verdict) << ")";
+    if (retryAfterMs > 0) {
+        oss << ", retry after " << retryAfterMs << " ms";
+    }
+    *error = oss.str();
+    return false;
+}
+
+TenantQuotas::Lease InferenceEngine::admitTenant(const InferenceParams& params) {
+    TenantQuotas::Lease lease;
+    std::string error;
+    if (!tryAdmitTenant(params, &lease, &error)) {
+        throw rkllmjs::utils::ResourceException(error);
+    }
+    return lease;
+}
+
+void InferenceEngine::acquireInferenceSlot(FairScheduler::Ticket* ticket) {
+    std::unique_lock<std::mutex> lock(admissionMutex_);
+    bool throttled = false;
+    
+    // The thermal limit changes without notification, so re-check periodically
+    waitingInferences_++;
+    while (true) {
+        bool full = activeInferences_ >= getEffectiveConcurrency();
+        if (!full && (!ticket || fairScheduler_->isNext(*ticket))) {
+            break;
+        }
+        throttled = throttled || (full && activeInferences_ < maxConcurrentInferences_);
+        admissionCv_.wait_for(lock, std::chrono::milliseconds(100));
+    }
+    waitingInferences_--;
+    activeInferences_++;
+    if (ticket) {
+        fairScheduler_->dispatch(*ticket);
+    }
+    lock.unlock();
+    
+    // The next run in fair order may be waiting for a slot that is still free
+    if (ticket) {
+        admissionCv_.notify_all();
+    }
+    
+    if (throttled) {
+        std::lock_guard<std::mutex> statsLock(statsMutex_);
+        stats_.throttledAdmissions++;
+    }
+}
+
+void InferenceEngine::releaseInferenceSlot() {
+    {
+        std::lock_guard<std::mutex> lock(admissionMutex_);
+        activeInferences_--;
+    }
+    
+    // Only the head of the fair queue may take the slot, so wake every waiter
+    if (fairScheduler_) {
+        admissionCv_.notify_all();
+    } else {
+        admissionCv_.notify_one();
+    }
+}
+
+void InferenceEngine::recordStreamStats(const StreamBufferStats& streamStats) {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.streamPauses += streamStats.pauses;
+    stats_.streamCoalescedChunks += streamStats.coalesced;
+    stats_.streamsDropped += streamStats.dropped ? 1 : 0;
+    stats_.streamHighWatermark = std::max(stats_.streamHighWatermark, static_cast<int32_t>(streamStats.highWatermark));
+    stats_.streamStallMs += static_cast<float>(streamStats.stallMs);
+}
+
 void InferenceEngine::processBatchRequests(const std::vector<BatchRequest>& requests, 
                                          std::promise<std::vector<BatchResult>> promise) {
     try {
         std::vector<BatchResult> results;
         results.reserve(requests.size());
         
+        // Identical deterministic entries in one batch run once
+        std::unordered_map<std::string, size_t> firstOccurrence;
+        
         for (const auto& request : requests) {
             if (stopRequested_) break;
             
             BatchResult batchResult;
             batchResult.id = request.id;
             
+            if (coalescingEnabled_ && isDeterministic(request.params)) {
+                std::string key = ResponseCache::makeKey(getModelId(), preprocessPrompt(request.params.prompt), request.params);
+                auto it = firstOccurrence.find(key);
+                if (it != firstOccurrence.end()) {
+                    batchResult.result = results[it->second].result;
+                    batchResult.result.coalesced = true;
+                    batchResult.error = results[it->second].error;
+                    batchDuplicates_++;
+                    results.push_back(batchResult);
+                    continue;
+                }
+                firstOccurrence.emplace(key, results.size());
+            }
+            
+            TenantQuotas::Lease lease;
+            std::string quotaError;
+            if (!tryAdmitTenant(request.params, &lease, &quotaError)) {
+                batchResult.error.category = rkllmjs::utils::ErrorCategory::RESOURCE_MANAGEMENT;
+                batchResult.error.severity = rkllmjs::utils::ErrorSeverity::WARNING;
+                batchResult.error.message = quotaError;
+                batchResult.error.code = "TENANT_QUOTA_EXCEEDED";
+                results.push_back(batchResult);
+                continue;
+            }
+            
             try {
-                batchResult.result = executeInference(request.params);
+                batchResult.result = executeCoalesced(request.params);
+                lease.complete(batchResult.result.fromCache ? 0 : batchResult.result.completionTokens);
                 updateStats(batchResult.result);
             } catch (const std::exception& e) {
                 batchResult.error.category = rkllmjs::utils::ErrorCategory::MODEL_OPERATION;
@@ -461,7 +1948,7 @@ void InferenceEngine::processBatchRequests(const std::vector<BatchRequest>& requ
         
         promise.set_value(results);
         state_ = InferenceState::IDLE;
-        
+    
     } catch (const std::exception& e) {
         state_ = InferenceState::ERROR;
         promise.set_exception(std::current_exception());
@@ -472,6 +1959,9 @@ std::string InferenceEngine::preprocessPrompt(const std::string& prompt) {
     // Basic preprocessing - in real implementation, this would be more sophisticated
     std::string processed = prompt;
     
+    // Malformed UTF-8 would reach the tokenizer and the JS side; replace it
+    utf8::repair(processed);
+    
     // Remove excessive whitespace
     std::regex whitespaceRegex("\\s+");
     processed = std::regex_replace(processed, whitespaceRegex, " ");
@@ -497,112 +1987,6 @@ float InferenceEngine::calculateTokensPerSecond(int32_t tokens, float timeSecond
     return static_cast<float>(tokens) / timeSeconds;
 }
 
-// Sampling strategies implementation
-int32_t GreedySampling::sample(const std::vector<float>& logits, float temperature, float topP, int32_t topK) {
-    (void)temperature; (void)topP; (void)topK; // Suppress unused parameter warnings
-    
-    auto maxIt = std::max_element(logits.begin(), logits.end());
-    return static_cast<int32_t>(std::distance(logits.begin(), maxIt));
-}
-
-int32_t TopKSampling::sample(const std::vector<float>& logits, float temperature, float topP, int32_t topK) {
-    (void)topP; // Not used in TopK sampling
-    
-    // Create pairs of (logit, index)
-    std::vector<std::pair<float, int32_t>> logitPairs;
-    for (size_t i = 0; i < logits.size(); ++i) {
-        logitPairs.emplace_back(logits[i], static_cast<int32_t>(i));
-    }
-    
-    // Sort by logit value (descending)
-    std::sort(logitPairs.begin(), logitPairs.end(), 
-              [](const auto& a, const auto& b) { return a.first > b.first; });
-    
-    // Keep only top K
-    int32_t k = std::min(topK, static_cast<int32_t>(logitPairs.size()));
-    logitPairs.resize(k);
-    
-    // Apply temperature and sample
-    std::vector<float> probs;
-    probs.reserve(k);
-    
-    for (const auto& pair : logitPairs) {
-        probs.push_back(std::exp(pair.first / temperature));
-    }
-    
-    // Normalize probabilities
-    float sum = std::accumulate(probs.begin(), probs.end(), 0.0f);
-    for (float& prob : probs) {
-        prob /= sum;
-    }
-    
-    // Sample from distribution
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::discrete_distribution<> dist(probs.begin(), probs.end());
-    
-    int32_t sampledIndex = dist(gen);
-    return logitPairs[sampledIndex].second;
-}
-
-int32_t TopPSampling::sample(const std::vector<float>& logits, float temperature, float topP, int32_t topK) {
-    (void)topK; // Not used in TopP sampling
-    
-    // Create pairs of (logit, index)
-    std::vector<std::pair<float, int32_t>> logitPairs;
-    for (size_t i = 0; i < logits.size(); ++i) {
-        logitPairs.emplace_back(logits[i], static_cast<int32_t>(i));
-    }
-    
-    // Sort by logit value (descending)
-    std::sort(logitPairs.begin(), logitPairs.end(), 
-              [](const auto& a, const auto& b) { return a.first > b.first; });
-    
-    // Apply temperature and compute probabilities
-    std::vector<float> probs;
-    probs.reserve(logitPairs.size());
-    
-    for (const auto& pair : logitPairs) {
-        probs.push_back(std::exp(pair.first / temperature));
-    }
-    
-    // Normalize probabilities
-    float sum = std::accumulate(probs.begin(), probs.end(), 0.0f);
-    for (float& prob : probs) {
-        prob /= sum;
-    }
-    
-    // Find cutoff for top-p
-    float cumulativeProb = 0.0f;
-    size_t cutoff = 0;
-    
-    for (size_t i = 0; i < probs.size(); ++i) {
-        cumulativeProb += probs[i];
-        cutoff = i + 1;
-        if (cumulativeProb >= topP) {
-            break;
-        }
-    }
-    
-    // Keep only top-p tokens
-    logitPairs.resize(cutoff);
-    probs.resize(cutoff);
-    
-    // Renormalize
-    sum = std::accumulate(probs.begin(), probs.end(), 0.0f);
-    for (float& prob : probs) {
-        prob /= sum;
-    }
-    
-    // Sample from distribution
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::discrete_distribution<> dist(probs.begin(), probs.end());
-    
-    int32_t sampledIndex = dist(gen);
-    return logitPairs[sampledIndex].second;
-}
-
 // Utility functions implementation
 namespace utils {
 
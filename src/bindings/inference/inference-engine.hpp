@@ -16,7 +16,9 @@
 #include <functional>
 #include <future>
 #include <atomic>
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include "../config/build-config.hpp"
 
 // Conditional RKLLM includes
@@ -32,6 +34,22 @@
 #include "../utils/type-converters.hpp"
 
 #include "../core/rkllm-manager.hpp"
+#include "response-cache.hpp"
+#include "semantic-cache.hpp"
+#include "prefix-cache-index.hpp"
+#include "context-manager.hpp"
+#include "session-store.hpp"
+#include "session-scheduler.hpp"
+#include "energy-monitor.hpp"
+#include "fair-scheduler.hpp"
+#include "inference-watchdog.hpp"
+#include "logprobs.hpp"
+#include "beam-search.hpp"
+#include "candidate-scorer.hpp"
+#include "sampling.hpp"
+#include "stream-buffer.hpp"
+#include "tenant-quota.hpp"
+#include "utf8.hpp"
 
 namespace rkllmjs {
 namespace inference {
@@ -69,6 +87,48 @@ struct InferenceParams {
     // Performance parameters
     int32_t batchSize = 1;
     bool enableKVCache = true;
+    int32_t maxTimeMs = 0; // Wall-clock budget for the run (0 = none); overruns finish with "timeout"
+    
+    // Persistent chat session (empty = stateless request)
+    std::string sessionId;
+    
+    // Tenant charged for the request when quotas are enabled (empty = "default")
+    std::string tenantId;
+    
+    // Class weighted by fair queueing, e.g. "interactive" or "batch" (empty = "default")
+    std::string requestClass;
+    
+    // Per-token logprobs (opt-in). The engine decodes in logits mode and picks each
+    // token itself, so the runtime's own sampler and penalties do not apply. Needs
+    // a TokenDecoder: the runtime returns no text with logits.
+    bool logprobs = false;
+    int32_t topLogprobs = 0;              // Alternatives reported per token (0-20, needs logprobs)
+    std::vector<int32_t> stopTokenIds;    // Logits mode also ends the reply on these (the EOS token always stops)
+    
+    // Samplers the runtime lacks; any of them switches decoding to logits mode (needs a TokenDecoder)
+    float minP = 0.0f;                    // Keep tokens at least minP times as likely as the best (0 = off)
+    float typicalP = 1.0f;                // Locally typical sampling mass (1 = off)
+    int32_t mirostat = 0;                 // 2 = Mirostat v2 with per-request state (0 = off)
+    float mirostatTau = 5.0f;             // Target surprise in bits per token
+    float mirostatEta = 0.1f;
+    float dryMultiplier = 0.0f;           // DRY repetition penalty (0 = off)
+    float dryBase = 1.75f;
+    int32_t dryAllowedLength = 2;
+    int32_t dryLastN = 0;                 // Reply tokens searched for repeats (0 = all)
+    std::vector<int32_t> dryBreakerIds;   // Repeats do not extend across these tokens
+    
+    // Beam search (numBeams > 1), also decoded in logits mode; the reply is delivered when the search ends.
+    // The runtime cannot copy one batch entry's KV cache to another, so beams are not kept
+    // resident: every step reloads the saved prompt and re-feeds each beam's whole reply.
+    // That cost grows with the square of the reply length, hence the short maxTokens cap.
+    // Beam requests always run standalone (no sessionId): the passes rebuild the KV cache.
+    static constexpr int32_t kMaxBeamTokens = 32;
+    int32_t numBeams = 1;
+    float lengthPenalty = 1.0f;           // Hypotheses are ranked by logprob sum / length^lengthPenalty
+    bool earlyStopping = true;            // Stop once numBeams hypotheses have finished
+    
+    // True when a sampler above is enabled, so tokens must be picked from logits
+    bool usesEngineSampler() const;
     
     // Validation
     bool isValid() const;
@@ -80,17 +140,29 @@ struct InferenceParams {
  */
 struct InferenceResult {
     std::string text;
-    std::vector<float> logprobs;
+    std::vector<float> logprobs;           // Chosen token's logprob per step (InferenceParams::logprobs)
+    std::vector<int32_t> tokenIds;         // Chosen tokens, parallel to logprobs
+    std::vector<TokenLogprob> topLogprobs; // [tokens × topLogprobs] alternatives, best first
     int32_t tokensGenerated;
     float totalTime;
     float tokensPerSecond;
     bool finished;
-    std::string finishReason; // "length", "stop", "error"
+    std::string finishReason; // "length", "stop", "timeout", "dropped", "error"
     
     // Metadata
     int32_t promptTokens;
     int32_t completionTokens;
     int32_t totalTokens;
+    bool fromCache = false; // Served from the response cache
+    bool coalesced = false; // Shared an identical request's computation
+    int32_t prefillTokensSaved = 0; // Prompt tokens restored from a prompt cache
+    
+    // Energy charged to this request (zero unless the energy monitor is enabled)
+    float energyJoules = 0.0f;
+    float tokensPerJoule = 0.0f;
+    
+    // Time spent waiting for an inference slot
+    float queueTimeMs = 0.0f;
 };
 
 /**
@@ -98,6 +170,32 @@ struct InferenceResult {
  */
 using StreamCallback = std::function<void(const std::string& token, bool isLast)>;
 
+/**
+ * Per-token callback used internally to forward runtime output
+ */
+using TokenCallback = std::function<void(const std::string& token)>;
+
+/**
+ * Token-to-text mapping for decoding done by the engine
+ *
+ * RKLLM_INFER_GET_LOGITS returns logits but no text and the runtime has no
+ * detokenizer API, so logits-mode requests need the model's vocabulary from
+ * the host (e.g. the tokenizer shipped with the model). Must be thread-safe.
+ */
+class TokenDecoder {
+public:
+    virtual ~TokenDecoder() = default;
+    
+    // Append the text of one token; byte-level pieces may be partial UTF-8
+    virtual void appendText(int32_t token, std::string* out) const = 0;
+    
+    // End-of-sequence token of the model
+    virtual int32_t eosTokenId() const = 0;
+};
+
+class RequestCoalescer;
+class GenerationSink;
+
 /**
  * Batch inference request
  */
@@ -115,6 +213,17 @@ struct BatchResult {
     rkllmjs::utils::ErrorInfo error; // Empty if successful
 };
 
+/**
+ * Likelihoods of candidate continuations (InferenceEngine::score)
+ */
+struct ScoreResult {
+    std::vector<CandidateScore> scores; // In candidate order
+    int32_t batchSize = 1;              // Candidates per forward pass (the model's n_batch)
+    int32_t forwardPasses = 0;          // rkllm_run calls, including the shared prompt prefill
+    float totalTime = 0.0f;
+    float candidatesPerSecond = 0.0f;
+};
+
 /**
  * Inference engine state
  */
@@ -150,6 +259,12 @@ public:
     std::vector<BatchResult> generateBatch(const std::vector<BatchRequest>& requests);
     std::future<std::vector<BatchResult>> generateBatchAsync(const std::vector<BatchRequest>& requests);
     
+    // Reranking: log P(candidate | prompt) without generating. The prompt is prefilled
+    // once in logits mode and shared through a prompt cache; candidates are fed n_batch
+    // at a time. Candidates are token ids from the model's own tokenizer (the runtime has
+    // no tokenizer API). Throws RKLLMException if the runtime fails.
+    ScoreResult score(const std::string& prompt, const std::vector<std::vector<int32_t>>& candidates);
+    
     // Control methods
     void pause();
     void resume();
@@ -159,10 +274,78 @@ public:
     
     // Configuration
     void setMaxConcurrentInferences(int32_t maxConcurrent);
+    int32_t getEffectiveConcurrency() const; // After thermal throttling (see RKLLMManager::enableThermalGovernor)
     void setStreamBufferSize(int32_t bufferSize);
+    void setStreamBufferConfig(const StreamBufferConfig& config); // Slow-consumer policy for streams
+    StreamBufferConfig getStreamBufferConfig() const;
     void enableKVCache(bool enable);
     void setDefaultParams(const InferenceParams& params);
     
+    // Response cache (opt-in, deterministic requests only; configure before use)
+    void enableResponseCache(const ResponseCacheConfig& config = ResponseCacheConfig());
+    void disableResponseCache();
+    bool isResponseCacheEnabled() const { return responseCache_ != nullptr; }
+    
+    // Semantic cache (opt-in, matches paraphrased prompts by embedding similarity)
+    void enableSemanticCache(const SemanticCacheConfig& config = SemanticCacheConfig());
+    void disableSemanticCache();
+    bool isSemanticCacheEnabled() const { return semanticCache_ != nullptr; }
+    
+    // Vocabulary for logits-mode decoding (configure before use; without it such requests are rejected)
+    void setTokenDecoder(std::shared_ptr<const TokenDecoder> decoder) { tokenDecoder_ = std::move(decoder); }
+    bool hasTokenDecoder() const { return tokenDecoder_ != nullptr; }
+    
+    // Prompt-cache reuse for shared prompt prefixes (opt-in)
+    void enablePrefixCache(const PrefixCacheConfig& config = PrefixCacheConfig());
+    void disablePrefixCache();
+    bool isPrefixCacheEnabled() const { return prefixIndex_ != nullptr; }
+    
+    // Context-window management for keep_history turns (opt-in)
+    void enableContextManager(const ContextConfig& config = ContextConfig());
+    void disableContextManager();
+    bool isContextManagerEnabled() const { return contextManager_ != nullptr; }
+    ContextStats getContextStats() const;
+    
+    // Persistent chat sessions checkpointed to disk (opt-in, see InferenceParams::sessionId).
+    // Session turns are multiplexed over the one handle; configure while idle.
+    void enableSessionStore(const SessionStoreConfig& config = SessionStoreConfig(),
+                            const SessionSchedulerConfig& scheduling = SessionSchedulerConfig());
+    void disableSessionStore();
+    bool isSessionStoreEnabled() const { return sessionStore_ != nullptr; }
+    bool resumeSession(const std::string& sessionId);
+    void endSession(const std::string& sessionId);
+    SessionStoreStats getSessionStats() const;
+    SessionSchedulerStats getSessionSchedulerStats() const;
+    
+    // Stall watchdog and maxTimeMs enforcement (always on; stall detection can be disabled)
+    void setWatchdogConfig(const WatchdogConfig& config);
+    WatchdogConfig getWatchdogConfig() const;
+    WatchdogStats getWatchdogStats() const;
+    
+    // Per-request energy from hwmon/power-supply sensors (opt-in; configure while idle)
+    void enableEnergyMonitor(const EnergyConfig& config = EnergyConfig());
+    void disableEnergyMonitor();
+    bool isEnergyMonitorEnabled() const { return energyMonitor_ != nullptr; }
+    EnergyStats getEnergyStats() const;
+    
+    // Per-tenant token buckets and concurrency caps checked at admission (opt-in; configure while idle).
+    // Rejected requests throw ResourceException (batch entries get TENANT_QUOTA_EXCEEDED).
+    void enableTenantQuotas(const TenantQuotaConfig& config = TenantQuotaConfig());
+    void disableTenantQuotas();
+    bool isTenantQuotaEnabled() const { return tenantQuotas_ != nullptr; }
+    std::vector<TenantUsage> getTenantUsage() const;
+    
+    // Weighted fair queueing of runs waiting for a slot, by tenant and request class
+    // (opt-in; configure while idle). Without it waiting runs are admitted in no particular order.
+    void enableFairQueueing(const FairQueueConfig& config = FairQueueConfig());
+    void disableFairQueueing();
+    bool isFairQueueingEnabled() const { return fairScheduler_ != nullptr; }
+    FairQueueStats getFairQueueStats() const;
+    
+    // Single-flight coalescing of identical deterministic requests (enabled by default)
+    void enableRequestCoalescing(bool enable);
+    bool isRequestCoalescingEnabled() const { return coalescingEnabled_; }
+    
     // Statistics
     struct Stats {
         int64_t totalInferences;
@@ -170,11 +353,74 @@ public:
         float averageTokensPerSecond;
         float averageLatency;
         int32_t activeInferences;
+        int32_t effectiveConcurrency;  // Concurrent runs admitted at the current temperature
+        int64_t throttledAdmissions;   // Runs that waited only because of thermal throttling
+        
+        // Response cache
+        int64_t cacheHits;
+        int64_t cacheMisses;
+        float cacheHitRate;
+        
+        // Semantic cache
+        int64_t semanticCacheHits;
+        int64_t semanticCacheMisses;
+        float semanticCacheHitRate;
+        float semanticLookupMs;
+        
+        // Single-flight coalescing
+        int64_t coalescedRequests;
+        
+        // Prompt-cache prefix reuse
+        int64_t prefixCacheHits;
+        int32_t prefixCacheFiles;
+        int64_t prefillTokensSaved;
+        
+        // Context window
+        int32_t kvCacheTokens;
+        float kvCacheOccupancy;
+        int64_t contextEvictions;
+        
+        // Persistent sessions
+        int32_t persistedSessions;
+        int64_t sessionResumes;
+        float sessionResumeMs;
+        float sessionReprefillMs;
+        int64_t sessionSwitches;
+        int64_t sessionBatchedTurns;
+        float sessionSwitchMs;
+        
+        // Watchdog
+        int64_t stalledRequests;
+        int64_t timedOutRequests;
+        int64_t abortedRuns;
+        
+        // Stream backpressure
+        int64_t streamPauses;
+        int64_t streamCoalescedChunks;
+        int64_t streamsDropped;
+        int32_t streamHighWatermark;   // Deepest any stream buffer got
+        float streamStallMs;           // Total time stream buffers spent full
+        
+        // Energy
+        float powerWatts;              // Latest board power reading
+        float energyJoules;            // Energy charged to requests
+        float idleEnergyJoules;        // Energy drawn between requests
+        float tokensPerJoule;          // Generated tokens per charged joule
+        
+        // Tenant quotas
+        int64_t quotaRejections;       // Requests refused by a tenant's rate or concurrency limit
+        
+        // Fair queueing
+        int32_t queuedInferences;      // Runs waiting for a slot
+        
+        // Scoring
+        int64_t scoredCandidates;
+        float scoreCandidatesPerSecond; // Over all score() calls
     };
     
     Stats getStats() const;
     void resetStats();
-    
+
 private:
     // Core components
     std::shared_ptr<core::RKLLMManager> manager_;
@@ -188,21 +434,101 @@ private:
     // Configuration
     InferenceParams defaultParams_;
     int32_t maxConcurrentInferences_;
-    int32_t streamBufferSize_;
+    
+    // Admission gate bounding concurrent rkllm_run calls
+    mutable std::mutex admissionMutex_;
+    std::condition_variable admissionCv_;
+    int32_t activeInferences_ = 0;
+    int32_t waitingInferences_ = 0;
+    StreamBufferConfig streamConfig_;
     bool kvCacheEnabled_;
     
     // Statistics
     mutable std::mutex statsMutex_;
     Stats stats_;
     
+    // Response cache
+    std::unique_ptr<ResponseCache> responseCache_;
+    std::unique_ptr<SemanticCache> semanticCache_;
+    double embeddingTimeMs_ = 0.0;
+    int64_t embeddingCount_ = 0;
+    double scoreSeconds_ = 0.0;
+    
+    // Whether logits mode returns a row per input token (-1 = not yet known); otherwise
+    // scoring feeds candidates one token at a time
+    std::atomic<int> logitsRowPerToken_{-1};
+    
+    // Single-flight coalescing
+    std::atomic<bool> coalescingEnabled_{true};
+    std::unique_ptr<RequestCoalescer> coalescer_;
+    std::atomic<int64_t> batchDuplicates_{0};
+    
+    // Host-supplied vocabulary for logits-mode decoding
+    std::shared_ptr<const TokenDecoder> tokenDecoder_;
+    
+    // Prompt-cache prefix index
+    std::unique_ptr<PrefixCacheIndex> prefixIndex_;
+    
+    // KV lock for handles the manager does not track (the manager's lock otherwise)
+    std::shared_ptr<std::mutex> unmanagedKvMutex_ = std::make_shared<std::mutex>();
+    
+    // Context-window manager
+    std::unique_ptr<ContextManager> contextManager_;
+    
+    // Persistent sessions; sessionMutex_ serializes session turns on the handle
+    std::unique_ptr<SessionStore> sessionStore_;
+    std::unique_ptr<SessionScheduler> sessionScheduler_;
+    std::mutex sessionMutex_;
+    std::string activeSessionId_;     // Session whose state is in the KV cache
+    std::string activeSessionPrefix_; // Text the next turn must replay before its prompt
+    
+    // Supervises every rkllm_run started by generation
+    std::unique_ptr<InferenceWatchdog> watchdog_;
+    
+    // Charges board power to running requests
+    std::unique_ptr<EnergyMonitor> energyMonitor_;
+    
+    // Per-tenant admission limits
+    std::unique_ptr<TenantQuotas> tenantQuotas_;
+    
+    // Orders runs waiting at the admission gate
+    std::unique_ptr<FairScheduler> fairScheduler_;
+    
     // Internal methods
-    InferenceResult executeInference(const InferenceParams& params);
+    InferenceResult executeInference(const InferenceParams& params, const TokenCallback& onToken = nullptr,
+                                     StreamBuffer* stream = nullptr);
+    InferenceResult executeWithCache(const InferenceParams& params, const TokenCallback& onToken = nullptr,
+                                     StreamBuffer* stream = nullptr);
+    InferenceResult executeCoalesced(const InferenceParams& params, const TokenCallback& onToken = nullptr,
+                                     StreamBuffer* stream = nullptr);
+    int decodeWithLogits(const InferenceParams& params, RKLLMInput* promptInput, RKLLMInferParam* inferParams,
+                         GenerationSink* sink, LogprobRecorder* recorder);
+    int decodeWithBeams(const InferenceParams& params, RKLLMInput* promptInput, RKLLMInferParam* inferParams,
+                        GenerationSink* sink, std::vector<int32_t>* tokenIds, std::vector<float>* logprobs);
+    int prefillBatch(const RKLLMInput& promptInput, size_t batch, RKLLMInferParam* inferParams,
+                     core::ResultSink* sink, std::vector<RKLLMInput>* inputs);
+    void emitDecodedToken(int32_t token, std::string* piece, GenerationSink* sink);
+    int32_t getBatchSize() const;
+    std::string getScratchDir() const;
+    void recordStreamStats(const StreamBufferStats& streamStats);
+    bool tryAdmitTenant(const InferenceParams& params, TenantQuotas::Lease* lease, std::string* error);
+    TenantQuotas::Lease admitTenant(const InferenceParams& params);
+    void acquireInferenceSlot(FairScheduler::Ticket* ticket = nullptr);
+    void releaseInferenceSlot();
+    std::vector<float> embedPrompt(const std::string& processedPrompt);
+    PrefixMatch preparePrefixCache(const std::string& processedPrompt);
+    void setChatTemplate(bool opening, bool closing);
+    std::shared_ptr<std::mutex> getKvMutex() const;
+    bool activateSession(const std::string& sessionId);
+    void invalidateActiveSession();
+    std::string getModelId() const;
+    bool isDeterministic(const InferenceParams& params) const;
     void validateParams(const InferenceParams& params);
     void updateStats(const InferenceResult& result);
     
     // Streaming implementation
     void streamingWorker(const InferenceParams& params, StreamCallback callback, 
-                        std::promise<InferenceResult> promise);
+                        std::promise<InferenceResult> promise, TenantQuotas::Lease lease);
     
     // Batch processing
     void processBatchRequests(const std::vector<BatchRequest>& requests, 
@@ -214,37 +540,6 @@ private:
     float calculateTokensPerSecond(int32_t tokens, float timeSeconds);
 };
 
-/**
- * Sampling strategy interface
- */
-class SamplingStrategy {
-public:
-    virtual ~SamplingStrategy() = default;
-    virtual int32_t sample(const std::vector<float>& logits, float temperature, float topP, int32_t topK) = 0;
-    virtual std::string getName() const = 0;
-};
-
-/**
- * Standard sampling strategies
- */
-class GreedySampling : public SamplingStrategy {
-public:
-    int32_t sample(const std::vector<float>& logits, float temperature, float topP, int32_t topK) override;
-    std::string getName() const override { return "greedy"; }
-};
-
-class TopKSampling : public SamplingStrategy {
-public:
-    int32_t sample(const std::vector<float>& logits, float temperature, float topP, int32_t topK) override;
-    std::string getName() const override { return "top_k"; }
-};
-
-class TopPSampling : public SamplingStrategy {
-public:
-    int32_t sample(const std::vector<float>& logits, float temperature, float topP, int32_t topK) override;
-    std::string getName() const override { return "top_p"; }
-};
-
 /**
  * Advanced inference utilities
  */
@@ -2,12 +2,33 @@
 #include "../config/build-config.hpp"
 #include "inference-engine.hpp"
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <mutex>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
 using namespace rkllmjs::testing;
 
 namespace rkllmjs {
 namespace inference {
 namespace test {
 
+// Loads the test model; false when it is not installed (the test then only checks the interface)
+static bool loadTestModel(int nBatch, LLMHandle* handle) {
+    auto& manager = core::RKLLMManager::getInstance();
+    manager.initialize();
+    core::RKLLMModelConfig config = core::RKLLMManager::createDefaultConfig();
+    config.model_path = "../../../models/dulimov/Qwen2.5-VL-7B-Instruct-rk3588-1.2.1/Qwen2.5-VL-7B-Instruct-rk3588-w8a8-opt-1-hybrid-ratio-0.5.rkllm";
+    config.max_context_len = 256;
+    config.n_batch = nBatch;
+    return manager.createModel(config, handle) == core::ManagerResult::SUCCESS;
+}
+
 // Tests for unified build system (full functionality always available)
 TEST(InferenceEngineTest, InferenceParamsValidation) {
     // Test valid parameters
@@ -32,6 +53,63 @@ TEST(InferenceEngineTest, InferenceParamsValidation) {
     invalidParams.prompt = "Hello";
     invalidParams.maxTokens = -1;
     EXPECT_FALSE(invalidParams.isValid());
+    
+    invalidParams.maxTokens = 100;
+    invalidParams.maxTimeMs = -1;
+    EXPECT_FALSE(invalidParams.isValid());
+    
+    invalidParams.maxTimeMs = 0;
+    invalidParams.requestClass = "batch jobs";
+    EXPECT_FALSE(invalidParams.isValid());
+    
+    // Alternatives are only reported alongside logprobs
+    invalidParams.requestClass = "";
+    invalidParams.topLogprobs = 5;
+    EXPECT_FALSE(invalidParams.isValid());
+    invalidParams.logprobs = true;
+    EXPECT_TRUE(invalidParams.isValid());
+    invalidParams.topLogprobs = 21;
+    EXPECT_FALSE(invalidParams.isValid());
+    
+    // Beam search re-feeds whole replies each step, so they must stay short
+    invalidParams.topLogprobs = 0;
+    invalidParams.numBeams = 4;
+    EXPECT_FALSE(invalidParams.isValid());
+    invalidParams.maxTokens = InferenceParams::kMaxBeamTokens;
+    EXPECT_TRUE(invalidParams.isValid());
+    
+    // ...and cannot run on a session's KV state, which they would wipe
+    invalidParams.sessionId = "chat-1";
+    EXPECT_FALSE(invalidParams.isValid());
+    invalidParams.sessionId = "";
+    
+    // Beam search reports the chosen tokens' logprobs but no alternatives
+    invalidParams.topLogprobs = 2;
+    EXPECT_FALSE(invalidParams.isValid());
+    invalidParams.topLogprobs = 0;
+    invalidParams.numBeams = 17;
+    EXPECT_FALSE(invalidParams.isValid());
+    invalidParams.numBeams = 4;
+    invalidParams.lengthPenalty = 5.0f;
+    EXPECT_FALSE(invalidParams.isValid());
+    
+    // Engine-side samplers switch decoding to logits mode; Mirostat v1 is a model setting only
+    InferenceParams sampled;
+    sampled.prompt = "Hello";
+    EXPECT_FALSE(sampled.usesEngineSampler());
+    sampled.minP = 0.05f;
+    sampled.dryMultiplier = 0.8f;
+    EXPECT_TRUE(sampled.usesEngineSampler());
+    EXPECT_TRUE(sampled.isValid());
+    sampled.mirostat = 1;
+    EXPECT_FALSE(sampled.isValid());
+    sampled.mirostat = 2;
+    EXPECT_TRUE(sampled.isValid());
+    sampled.typicalP = 0.0f;
+    EXPECT_FALSE(sampled.isValid());
+    sampled.typicalP = 0.9f;
+    sampled.dryAllowedLength = 0;
+    EXPECT_FALSE(sampled.isValid());
 }
 
 // Utility function tests
@@ -61,18 +139,19 @@ TEST(InferenceEngineTest, UtilityFunctions) {
 // Sampling strategy tests
 TEST(InferenceEngineTest, SamplingStrategies) {
     std::vector<float> logits = {1.0f, 2.0f, 3.0f, 1.5f};
+    SamplingWorkspace workspace;
     
     GreedySampling greedy;
-    int result = greedy.sample(logits, 1.0f, 0.9f, 3);
+    int result = greedy.sample(logits, 1.0f, 0.9f, 3, workspace);
     EXPECT_EQ(result, 2); // Index of max value (3.0f)
     
     TopKSampling topK;
-    result = topK.sample(logits, 1.0f, 0.9f, 2);
+    result = topK.sample(logits, 1.0f, 0.9f, 2, workspace);
     EXPECT_GE(result, 0);
     EXPECT_LT(result, static_cast<int>(logits.size()));
     
     TopPSampling topP;
-    result = topP.sample(logits, 1.0f, 0.9f, 4);
+    result = topP.sample(logits, 1.0f, 0.9f, 4, workspace);
     EXPECT_GE(result, 0);
     EXPECT_LT(result, static_cast<int>(logits.size()));
 }
@@ -116,6 +195,318 @@ TEST(InferenceEngineTest, HardwareAdaptiveTests) {
     }
 }
 
+// Concurrency admitted by the engine follows the manager's thermal governor
+TEST(InferenceEngineTest, ThermalThrottledConcurrency) {
+    std::string root = "/tmp/rkllmjs-engine-thermal-" + std::to_string(::getpid());
+    std::string zone = root + "/thermal_zone0";
+    ::mkdir(root.c_str(), 0755);
+    ::mkdir(zone.c_str(), 0755);
+    std::ofstream(zone + "/temp") << "84000\n";
+    
+    auto& manager = core::RKLLMManager::getInstance();
+    InferenceEngine engine(std::shared_ptr<core::RKLLMManager>(&manager, [](core::RKLLMManager*) {}));
+    engine.setMaxConcurrentInferences(8);
+    EXPECT_EQ(engine.getEffectiveConcurrency(), 8);
+    
+    core::ThermalConfig config;
+    config.thermal_root = root;
+    config.trip_c = 85.0f;
+    config.sample_interval_ms = 5;
+    manager.enableThermalGovernor(config);
+    for (int i = 0; i < 200 && !manager.getThermalState().available; ++i) {
+        ::usleep(5000);
+    }
+    EXPECT_EQ(engine.getEffectiveConcurrency(), 2);
+    EXPECT_EQ(engine.getStats().effectiveConcurrency, 2);
+    manager.disableThermalGovernor();
+    EXPECT_EQ(engine.getEffectiveConcurrency(), 8);
+    
+    std::remove((zone + "/temp").c_str());
+    ::rmdir(zone.c_str());
+    ::rmdir(root.c_str());
+}
+
+TEST(InferenceEngineTest, TenantQuotaRejectsAtAdmission) {
+    auto& manager = core::RKLLMManager::getInstance();
+    InferenceEngine engine(std::shared_ptr<core::RKLLMManager>(&manager, [](core::RKLLMManager*) {}));
+    
+    TenantQuotaConfig config;
+    config.tenants["bulk"].promptTokensPerSec = 1.0;
+    config.tenants["bulk"].promptBurst = 4.0;
+    engine.enableTenantQuotas(config);
+    
+    InferenceParams params;
+    params.prompt = "Summarize this long document please";
+    params.tenantId = "bulk";
+    engine.generate(params); // No model: admitted, then fails inside the run
+    
+    bool rejected = false;
+    try {
+        engine.generate(params);
+    } catch (const rkllmjs::utils::ResourceException& e) {
+        rejected = std::string(e.what()).find("rate_limited") != std::string::npos;
+    }
+    EXPECT_TRUE(rejected);
+    EXPECT_TRUE(engine.getState() != InferenceState::ERROR);
+    EXPECT_EQ(engine.getStats().quotaRejections, 1);
+    
+    // Other tenants are not limited
+    params.tenantId = "chat";
+    engine.generate(params);
+    std::vector<TenantUsage> usage = engine.getTenantUsage();
+    EXPECT_EQ(usage.size(), 2u);
+    EXPECT_EQ(usage[0].tenantId, std::string("bulk"));
+    EXPECT_EQ(usage[0].rateLimited, 1);
+    EXPECT_EQ(usage[1].admitted, 1);
+    
+    params.tenantId = "bad tenant";
+    EXPECT_FALSE(params.isValid());
+}
+
+TEST(InferenceEngineTest, FairQueueingConfiguration) {
+    auto& manager = core::RKLLMManager::getInstance();
+    InferenceEngine engine(std::shared_ptr<core::RKLLMManager>(&manager, [](core::RKLLMManager*) {}));
+    EXPECT_FALSE(engine.isFairQueueingEnabled());
+    
+    FairQueueConfig config;
+    config.tenantWeights["bulk"] = 0.0;
+    bool rejected = false;
+    try {
+        engine.enableFairQueueing(config);
+    } catch (const rkllmjs::utils::RKLLMException&) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+    
+    config.tenantWeights["bulk"] = 0.5;
+    config.classWeights["interactive"] = 4.0;
+    engine.enableFairQueueing(config);
+    EXPECT_TRUE(engine.isFairQueueingEnabled());
+    
+    InferenceParams params;
+    params.prompt = "Hello";
+    params.tenantId = "bulk";
+    params.requestClass = "interactive";
+    engine.generate(params); // No model: fails before it queues
+    EXPECT_EQ(engine.getFairQueueStats().queued, 0);
+    EXPECT_EQ(engine.getStats().queuedInferences, 0);
+    
+    engine.disableFairQueueing();
+    EXPECT_EQ(engine.getFairQueueStats().classes.size(), 0u);
+}
+
+TEST(InferenceEngineTest, ScoringRequiresAModel) {
+    auto& manager = core::RKLLMManager::getInstance();
+    InferenceEngine engine(std::shared_ptr<core::RKLLMManager>(&manager, [](core::RKLLMManager*) {}));
+    
+    bool rejected = false;
+    try {
+        engine.score("Which passage answers the question?", std::vector<std::vector<int32_t>>{{1, 2}, {3}});
+    } catch (const rkllmjs::utils::RKLLMException&) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+    EXPECT_EQ(engine.getStats().scoredCandidates, 0);
+    EXPECT_EQ(engine.getStats().scoreCandidatesPerSecond, 0.0f);
+}
+
+TEST(InferenceEngineTest, BatchedScoringKeepsThePromptInEveryEntry) {
+    // Enough multi-token candidates to fill every entry of a 4-wide batch
+    const std::string prompt = "Which answer fits best?";
+    const std::vector<std::vector<int32_t>> candidates = {{1, 2}, {3, 4, 5}, {6, 7}, {2, 3}, {5}};
+    auto& manager = core::RKLLMManager::getInstance();
+    
+    // Reference scores, one candidate per pass
+    LLMHandle handle = nullptr;
+    if (!loadTestModel(1, &handle)) {
+        return;
+    }
+    ScoreResult single;
+    {
+        InferenceEngine engine(std::shared_ptr<core::RKLLMManager>(&manager, [](core::RKLLMManager*) {}));
+        engine.setModelHandle(handle);
+        single = engine.score(prompt, candidates);
+    }
+    manager.destroyModel(handle);
+    
+    // Entries 1..3 score the same candidates only if they hold the prompt too
+    if (!loadTestModel(4, &handle)) {
+        return;
+    }
+    ScoreResult batched;
+    {
+        InferenceEngine engine(std::shared_ptr<core::RKLLMManager>(&manager, [](core::RKLLMManager*) {}));
+        engine.setModelHandle(handle);
+        batched = engine.score(prompt, candidates);
+    }
+    manager.destroyModel(handle);
+    
+    EXPECT_EQ(batched.batchSize, 4);
+    EXPECT_EQ(batched.scores.size(), candidates.size());
+    for (size_t i = 0; i < candidates.size() && i < batched.scores.size(); ++i) {
+        EXPECT_NEAR(single.scores[i].logprob, batched.scores[i].logprob, 1e-3f);
+    }
+}
+
+TEST(InferenceEngineTest, LogitsModeRequiresTokenDecoder) {
+    struct TestDecoder : TokenDecoder {
+        void appendText(int32_t token, std::string* out) const override { out->append(token == 7 ? "." : "a"); }
+        int32_t eosTokenId() const override { return 2; }
+    };
+    
+    auto& manager = core::RKLLMManager::getInstance();
+    InferenceEngine engine(std::shared_ptr<core::RKLLMManager>(&manager, [](core::RKLLMManager*) {}));
+    EXPECT_FALSE(engine.hasTokenDecoder());
+    
+    InferenceParams params;
+    params.prompt = "Hello";
+    params.logprobs = true;
+    bool rejected = false;
+    try {
+        engine.generate(params);
+    } catch (const rkllmjs::utils::ConfigurationException&) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+    
+    // Beam replies need the vocabulary too
+    InferenceParams beams;
+    beams.prompt = "Hello";
+    beams.maxTokens = 16;
+    beams.numBeams = 4;
+    rejected = false;
+    try {
+        engine.generate(beams);
+    } catch (const rkllmjs::utils::ConfigurationException&) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+    
+    // So do the engine-side samplers
+    InferenceParams sampled;
+    sampled.prompt = "Hello";
+    sampled.minP = 0.05f;
+    rejected = false;
+    try {
+        engine.generate(sampled);
+    } catch (const rkllmjs::utils::ConfigurationException&) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+    
+    // With a vocabulary the request is accepted (and fails later for lack of a model)
+    engine.setTokenDecoder(std::make_shared<TestDecoder>());
+    EXPECT_TRUE(engine.hasTokenDecoder());
+    rejected = false;
+    try {
+        engine.generate(params);
+    } catch (const rkllmjs::utils::ConfigurationException&) {
+        rejected = true;
+    }
+    EXPECT_FALSE(rejected);
+}
+
+TEST(InferenceEngineTest, SeededSamplingIsReproducible) {
+    struct TestDecoder : TokenDecoder {
+        void appendText(int32_t token, std::string* out) const override { out->append(std::to_string(token)); }
+        int32_t eosTokenId() const override { return -1; }
+    };
+    
+    auto& manager = core::RKLLMManager::getInstance();
+    LLMHandle handle = nullptr;
+    if (!loadTestModel(1, &handle)) {
+        return;
+    }
+    InferenceEngine engine(std::shared_ptr<core::RKLLMManager>(&manager, [](core::RKLLMManager*) {}));
+    engine.setModelHandle(handle);
+    engine.setTokenDecoder(std::make_shared<TestDecoder>());
+    
+    // A seeded request counts as deterministic, so its sample may be cached and shared
+    InferenceParams params;
+    params.prompt = "Pick a number";
+    params.logprobs = true;
+    params.temperature = 1.0f;
+    params.maxTokens = 16;
+    params.seed = 42;
+    params.useCache = false;
+    for (float topP : {0.9f, 1.0f}) {
+        params.topP = topP;
+        params.topK = topP < 1.0f ? 40 : 5;
+        InferenceResult first = engine.generate(params);
+        InferenceResult second = engine.generate(params);
+        EXPECT_EQ(first.tokenIds.size(), 16u);
+        EXPECT_TRUE(first.tokenIds == second.tokenIds);
+    }
+    manager.destroyModel(handle);
+}
+
+TEST(InferenceEngineTest, StalledStreamDoesNotBlockOtherRequests) {
+    auto& manager = core::RKLLMManager::getInstance();
+    InferenceEngine engine(std::shared_ptr<core::RKLLMManager>(&manager, [](core::RKLLMManager*) {}));
+    EXPECT_TRUE(engine.getStreamBufferConfig().policy == SlowConsumerPolicy::COALESCE);
+    
+    // Pausing holds the model, so it is only allowed for short
+    StreamBufferConfig pause;
+    pause.policy = SlowConsumerPolicy::PAUSE;
+    pause.maxPauseMs = 10000;
+    bool rejected = false;
+    try {
+        engine.setStreamBufferConfig(pause);
+    } catch (const rkllmjs::utils::RKLLMException&) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+    
+    LLMHandle handle = nullptr;
+    if (!loadTestModel(1, &handle)) {
+        return;
+    }
+    engine.setModelHandle(handle);
+    StreamBufferConfig small;
+    small.capacity = 1;
+    engine.setStreamBufferConfig(small);
+    
+    // The first stream's consumer stalls on its first chunk
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool stalled = false;
+    bool release = false;
+    InferenceParams streamed;
+    streamed.prompt = "Tell me a story";
+    streamed.maxTokens = 8;
+    streamed.useCache = false;
+    std::future<InferenceResult> stream = engine.generateStreamAsync(streamed, [&](const std::string&, bool) {
+        std::unique_lock<std::mutex> lock(mutex);
+        stalled = true;
+        changed.notify_all();
+        changed.wait(lock, [&] { return release; });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return stalled; });
+    }
+    
+    // Another request on the same model still runs to completion
+    InferenceParams other;
+    other.prompt = "What is the capital of France?";
+    other.maxTokens = 8;
+    other.useCache = false;
+    std::future<InferenceResult> reply = std::async(std::launch::async, [&] { return engine.generate(other); });
+    bool progressed = reply.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    EXPECT_TRUE(progressed);
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    changed.notify_all();
+    stream.wait();
+    if (progressed) {
+        EXPECT_FALSE(reply.get().text.empty());
+    }
+    manager.destroyModel(handle);
+}
+
 } // namespace test
 } // namespace inference
 } // namespace rkllmjs
@@ -0,0 +1,187 @@
+#include "inference-watchdog.hpp"
+
+#include <algorithm>
+
+namespace rkllmjs {
+namespace inference {
+
+using Clock = std::chrono::steady_clock;
+
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+}
+
+struct InferenceWatchdog::Watch::Entry {
+    LLMHandle handle = nullptr;
+    int64_t startMs = 0;
+    int64_t deadlineMs = 0;               // 0 = no budget
+    std::atomic<int64_t> lastProgressMs{0};
+    std::atomic<int32_t> tokens{0};
+    std::atomic<WatchVerdict> verdict{WatchVerdict::NONE};
+    int64_t expiredAtMs = 0;              // Guarded by the watchdog mutex
+    bool aborted = false;
+};
+
+InferenceWatchdog::Watch::Watch(Watch&& other) noexcept
+    : watchdog_(other.watchdog_), entry_(std::move(other.entry_)) {
+    other.watchdog_ = nullptr;
+}
+
+InferenceWatchdog::Watch& InferenceWatchdog::Watch::operator=(Watch&& other) noexcept {
+    if (this != &other) {
+        release();
+        watchdog_ = other.watchdog_;
+        entry_ = std::move(other.entry_);
+        other.watchdog_ = nullptr;
+    }
+    return *this;
+}
+
+bool InferenceWatchdog::Watch::touch() {
+    if (!entry_) {
+        return true;
+    }
+    if (entry_->verdict.load() != WatchVerdict::NONE) {
+        return false;
+    }
+    entry_->lastProgressMs.store(nowMs());
+    entry_->tokens.fetch_add(1);
+    return true;
+}
+
+WatchVerdict InferenceWatchdog::Watch::verdict() const {
+    return entry_ ? entry_->verdict.load() : WatchVerdict::NONE;
+}
+
+void InferenceWatchdog::Watch::release() {
+    if (watchdog_ && entry_) {
+        watchdog_->unregister(entry_);
+    }
+    watchdog_ = nullptr;
+}
+
+InferenceWatchdog::InferenceWatchdog(const WatchdogConfig& config, AbortHandler onAbort)
+    : config_(config), onAbort_(std::move(onAbort)) {
+}
+
+InferenceWatchdog::~InferenceWatchdog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+InferenceWatchdog::Watch InferenceWatchdog::watch(LLMHandle handle, int64_t maxTimeMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (maxTimeMs <= 0 && config_.stallTimeoutMs <= 0) {
+        return Watch();
+    }
+    
+    auto entry = std::make_shared<Watch::Entry>();
+    entry->handle = handle;
+    entry->startMs = nowMs();
+    entry->deadlineMs = maxTimeMs > 0 ? entry->startMs + maxTimeMs : 0;
+    entry->lastProgressMs.store(entry->startMs);
+    entries_.push_back(entry);
+    stats_.supervised++;
+    
+    // The previous thread exits once nothing is watched
+    if (!running_) {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        running_ = true;
+        thread_ = std::thread(&InferenceWatchdog::run, this);
+    }
+    return Watch(this, entry);
+}
+
+void InferenceWatchdog::check() {
+    std::vector<LLMHandle> toAbort;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int64_t now = nowMs();
+        for (const auto& entry : entries_) {
+            if (entry->verdict.load() == WatchVerdict::NONE) {
+                int64_t stallLimit = config_.stallTimeoutMs;
+                if (stallLimit > 0 && entry->tokens.load() == 0 && config_.firstTokenTimeoutMs > 0) {
+                    stallLimit = config_.firstTokenTimeoutMs;
+                }
+                
+                WatchVerdict verdict = WatchVerdict::NONE;
+                if (entry->deadlineMs > 0 && now >= entry->deadlineMs) {
+                    verdict = WatchVerdict::TIMED_OUT;
+                    stats_.timeouts++;
+                } else if (stallLimit > 0 && now - entry->lastProgressMs.load() >= stallLimit) {
+                    verdict = WatchVerdict::STALLED;
+                    stats_.stalls++;
+                }
+                if (verdict != WatchVerdict::NONE) {
+                    entry->verdict.store(verdict);
+                    entry->expiredAtMs = now;
+                }
+                continue;
+            }
+            
+            // Expired but still registered: the run is not calling back
+            if (!entry->aborted && now - entry->expiredAtMs >= config_.abortGraceMs) {
+                entry->aborted = true;
+                stats_.aborts++;
+                toAbort.push_back(entry->handle);
+            }
+        }
+    }
+    
+    // Outside the lock: rkllm_abort may wait for the run to unwind
+    if (onAbort_) {
+        for (LLMHandle handle : toAbort) {
+            onAbort_(handle);
+        }
+    }
+}
+
+void InferenceWatchdog::setConfig(const WatchdogConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+}
+
+WatchdogConfig InferenceWatchdog::getConfig() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+WatchdogStats InferenceWatchdog::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    WatchdogStats stats = stats_;
+    stats.inFlight = entries_.size();
+    return stats;
+}
+
+void InferenceWatchdog::unregister(const std::shared_ptr<Watch::Entry>& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(std::remove(entries_.begin(), entries_.end(), entry), entries_.end());
+    if (entries_.empty()) {
+        wake_.notify_all();
+    }
+}
+
+void InferenceWatchdog::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!shutdown_ && !entries_.empty()) {
+        wake_.wait_for(lock, std::chrono::milliseconds(std::max<int64_t>(config_.pollIntervalMs, 1)));
+        if (shutdown_ || entries_.empty()) {
+            break;
+        }
+        lock.unlock();
+        check();
+        lock.lock();
+    }
+    running_ = false;
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,143 @@
+/**
+ * @module inference
+ * @purpose Stall detection and time budgets for in-flight inference
+ * @description Supervises running rkllm_run calls from one background thread.
+ *              Each request registers a watch that records when it last made
+ *              progress (start, then every token). A request that stalls or
+ *              exceeds its time budget is expired: its next callback stops the
+ *              run, and if no callback arrives within a grace period the run
+ *              is aborted on its handle, so a wedged driver call cannot hold
+ *              a thread forever.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include "../core/rkllm-manager.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Watchdog configuration
+ */
+struct WatchdogConfig {
+    int64_t stallTimeoutMs = 30000;      // Max gap between tokens (0 = no stall detection)
+    int64_t firstTokenTimeoutMs = 60000; // Max time to the first token, covers prefill (0 = use stallTimeoutMs)
+    int64_t abortGraceMs = 500;          // Wait for a callback to stop the run before aborting the handle
+    int64_t pollIntervalMs = 50;
+};
+
+/**
+ * Why a watched request was expired
+ */
+enum class WatchVerdict {
+    NONE,
+    STALLED,   // No token within the stall timeout
+    TIMED_OUT  // Request exceeded its maxTimeMs budget
+};
+
+/**
+ * Supervision counters
+ */
+struct WatchdogStats {
+    int64_t supervised = 0;   // Requests watched
+    int64_t stalls = 0;       // Expired for lack of progress
+    int64_t timeouts = 0;     // Expired by their time budget
+    int64_t aborts = 0;       // Expired runs that needed the abort handler
+    size_t inFlight = 0;
+};
+
+/**
+ * Supervises in-flight requests and expires stalled or overdue ones
+ *
+ * The thread only runs while requests are watched. Thread-safe.
+ */
+class InferenceWatchdog {
+public:
+    // Called with the handle of an expired run that stopped calling back
+    using AbortHandler = std::function<void(LLMHandle handle)>;
+    
+    /**
+     * Per-request supervision state (RAII, unregisters when destroyed)
+     */
+    class Watch {
+    public:
+        Watch() = default;
+        ~Watch() { release(); }
+        Watch(Watch&& other) noexcept;
+        Watch& operator=(Watch&& other) noexcept;
+        Watch(const Watch&) = delete;
+        Watch& operator=(const Watch&) = delete;
+        
+        /**
+         * @brief Record progress (a token arrived)
+         * @return false once the request has expired and should stop
+         */
+        bool touch();
+        
+        WatchVerdict verdict() const;
+        bool expired() const { return verdict() != WatchVerdict::NONE; }
+        void release();
+    
+    private:
+        friend class InferenceWatchdog;
+        struct Entry;
+        
+        Watch(InferenceWatchdog* watchdog, std::shared_ptr<Entry> entry)
+            : watchdog_(watchdog), entry_(std::move(entry)) {}
+        
+        InferenceWatchdog* watchdog_ = nullptr;
+        std::shared_ptr<Entry> entry_;
+    };
+    
+    explicit InferenceWatchdog(const WatchdogConfig& config = WatchdogConfig(), AbortHandler onAbort = nullptr);
+    ~InferenceWatchdog();
+    
+    InferenceWatchdog(const InferenceWatchdog&) = delete;
+    InferenceWatchdog& operator=(const InferenceWatchdog&) = delete;
+    
+    /**
+     * @brief Start supervising a request
+     * @param handle Handle the request runs on (passed to the abort handler)
+     * @param maxTimeMs Total time budget (0 = none)
+     * @return Watch to touch on every token; an inert watch when there is nothing to enforce
+     */
+    Watch watch(LLMHandle handle, int64_t maxTimeMs);
+    
+    // Run one supervision pass immediately (the thread calls this every poll interval)
+    void check();
+    
+    void setConfig(const WatchdogConfig& config);
+    WatchdogConfig getConfig() const;
+    WatchdogStats getStats() const;
+
+private:
+    void unregister(const std::shared_ptr<Watch::Entry>& entry);
+    void run();
+    
+    WatchdogConfig config_;
+    AbortHandler onAbort_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<std::shared_ptr<Watch::Entry>> entries_;
+    std::thread thread_;
+    bool running_ = false;
+    bool shutdown_ = false;
+    WatchdogStats stats_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,133 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "inference-watchdog.hpp"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static LLMHandle fakeHandle(int id) {
+    return reinterpret_cast<LLMHandle>(static_cast<intptr_t>(id));
+}
+
+// Large poll interval so only explicit check() calls supervise
+static WatchdogConfig manualConfig() {
+    WatchdogConfig config;
+    config.stallTimeoutMs = 20;
+    config.firstTokenTimeoutMs = 0;
+    config.abortGraceMs = 0;
+    config.pollIntervalMs = 60000;
+    return config;
+}
+
+TEST(InferenceWatchdogTest, NothingToEnforceGivesInertWatch) {
+    WatchdogConfig config = manualConfig();
+    config.stallTimeoutMs = 0;
+    InferenceWatchdog watchdog(config);
+    InferenceWatchdog::Watch watch = watchdog.watch(fakeHandle(1), 0);
+    EXPECT_TRUE(watch.touch());
+    EXPECT_FALSE(watch.expired());
+    EXPECT_EQ(watchdog.getStats().supervised, 0);
+}
+
+TEST(InferenceWatchdogTest, ProgressKeepsRequestAlive) {
+    InferenceWatchdog watchdog(manualConfig());
+    InferenceWatchdog::Watch watch = watchdog.watch(fakeHandle(1), 0);
+    for (int i = 0; i < 5; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        EXPECT_TRUE(watch.touch());
+        watchdog.check();
+    }
+    EXPECT_FALSE(watch.expired());
+    EXPECT_EQ(watchdog.getStats().inFlight, 1u);
+    
+    watch.release();
+    EXPECT_EQ(watchdog.getStats().inFlight, 0u);
+}
+
+TEST(InferenceWatchdogTest, StalledRequestStopsAtNextCallback) {
+    std::vector<LLMHandle> aborted;
+    WatchdogConfig config = manualConfig();
+    config.abortGraceMs = 60000;
+    InferenceWatchdog watchdog(config, [&aborted](LLMHandle handle) { aborted.push_back(handle); });
+    
+    InferenceWatchdog::Watch watch = watchdog.watch(fakeHandle(1), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    watchdog.check();
+    EXPECT_TRUE(watch.verdict() == WatchVerdict::STALLED);
+    EXPECT_FALSE(watch.touch());
+    
+    // Still inside the grace period, so the handle is left alone
+    watchdog.check();
+    EXPECT_TRUE(aborted.empty());
+    EXPECT_EQ(watchdog.getStats().stalls, 1);
+}
+
+TEST(InferenceWatchdogTest, BudgetOverrunAbortsWedgedRun) {
+    std::vector<LLMHandle> aborted;
+    WatchdogConfig config = manualConfig();
+    config.stallTimeoutMs = 0;
+    InferenceWatchdog watchdog(config, [&aborted](LLMHandle handle) { aborted.push_back(handle); });
+    
+    InferenceWatchdog::Watch quick = watchdog.watch(fakeHandle(1), 10000);
+    InferenceWatchdog::Watch wedged = watchdog.watch(fakeHandle(2), 10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    watchdog.check(); // Expires the overdue request
+    watchdog.check(); // No callback since: abort its handle, once
+    watchdog.check();
+    
+    EXPECT_TRUE(wedged.verdict() == WatchVerdict::TIMED_OUT);
+    EXPECT_FALSE(quick.expired());
+    EXPECT_EQ(aborted.size(), 1u);
+    EXPECT_TRUE(aborted[0] == fakeHandle(2));
+    
+    WatchdogStats stats = watchdog.getStats();
+    EXPECT_EQ(stats.supervised, 2);
+    EXPECT_EQ(stats.timeouts, 1);
+    EXPECT_EQ(stats.stalls, 0);
+    EXPECT_EQ(stats.aborts, 1);
+}
+
+TEST(InferenceWatchdogTest, FirstTokenGetsLongerLimit) {
+    WatchdogConfig config = manualConfig();
+    config.firstTokenTimeoutMs = 60000;
+    InferenceWatchdog watchdog(config);
+    
+    InferenceWatchdog::Watch watch = watchdog.watch(fakeHandle(1), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    watchdog.check();
+    EXPECT_FALSE(watch.expired()); // Still prefilling
+    
+    EXPECT_TRUE(watch.touch());
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    watchdog.check();
+    EXPECT_TRUE(watch.verdict() == WatchVerdict::STALLED);
+}
+
+TEST(InferenceWatchdogTest, BackgroundThreadExpiresRequests) {
+    WatchdogConfig config = manualConfig();
+    config.stallTimeoutMs = 0;
+    config.pollIntervalMs = 5;
+    InferenceWatchdog watchdog(config);
+    
+    for (int round = 0; round < 2; ++round) {
+        InferenceWatchdog::Watch watch = watchdog.watch(fakeHandle(1), 10);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!watch.expired() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_TRUE(watch.expired());
+    }
+    EXPECT_EQ(watchdog.getStats().timeouts, 2);
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
@@ -0,0 +1,67 @@
+#include "logprobs.hpp"
+#include "simd-ops.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace rkllmjs {
+namespace inference {
+
+LogprobRecorder::LogprobRecorder(int32_t maxSteps, int32_t topN)
+    : topN_(std::max(0, std::min(topN, kMaxTopLogprobs))) {
+    size_t steps = static_cast<size_t>(std::max(maxSteps, 0));
+    tokenIds_.reserve(steps);
+    logprobs_.reserve(steps);
+    top_.reserve(steps * static_cast<size_t>(topN_));
+}
+
+float LogprobRecorder::stage(const float* logits, int32_t vocabSize, int32_t chosenToken) {
+    size_t vocab = static_cast<size_t>(std::max(vocabSize, 0));
+    float normalizer = simd::logSumExp(logits, vocab, static_cast<size_t>(topN_), topIds_, topValues_);
+    
+    staged_ = true;
+    stagedToken_ = chosenToken;
+    stagedNormalizer_ = normalizer;
+    stagedLogprob_ = -std::numeric_limits<float>::infinity();
+    stagedCount_ = 0;
+    if (normalizer == -std::numeric_limits<float>::infinity()) {
+        return stagedLogprob_; // Every token is masked
+    }
+    stagedCount_ = static_cast<int32_t>(std::min(vocab, static_cast<size_t>(topN_)));
+    if (chosenToken >= 0 && static_cast<size_t>(chosenToken) < vocab) {
+        stagedLogprob_ = logits[chosenToken] - normalizer;
+    }
+    return stagedLogprob_;
+}
+
+bool LogprobRecorder::commit() {
+    if (!staged_) {
+        return false;
+    }
+    staged_ = false;
+    tokenIds_.push_back(stagedToken_);
+    logprobs_.push_back(stagedLogprob_);
+    for (int32_t i = 0; i < topN_; ++i) {
+        TokenLogprob alternative;
+        if (i < stagedCount_) {
+            alternative.tokenId = topIds_[i];
+            alternative.logprob = topValues_[i] - stagedNormalizer_;
+        }
+        top_.push_back(alternative);
+    }
+    return true;
+}
+
+void LogprobRecorder::release(std::vector<int32_t>* tokenIds, std::vector<float>* logprobs,
+                              std::vector<TokenLogprob>* top) {
+    staged_ = false;
+    *tokenIds = std::move(tokenIds_);
+    *logprobs = std::move(logprobs_);
+    *top = std::move(top_);
+    tokenIds_.clear();
+    logprobs_.clear();
+    top_.clear();
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,87 @@
+/**
+ * @module inference
+ * @purpose Per-token log-probabilities from logits-mode decoding
+ * @description LogprobRecorder turns each logits row returned by
+ *              RKLLM_INFER_GET_LOGITS into the chosen token's logprob and
+ *              the top-N alternatives. The log-softmax normalizer and the
+ *              top-N selection come from one vectorized pass over the row
+ *              (simd::logSumExp); the row itself is never copied or
+ *              normalized. All storage is reserved up front for the
+ *              request's maxTokens, so recording a step does not allocate.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * A token and its log-probability under the model
+ */
+struct TokenLogprob {
+    int32_t tokenId = -1;
+    float logprob = 0.0f;
+};
+
+/**
+ * Records one decode step at a time for a single request
+ *
+ * A step is staged while its logits are live (inside the runtime callback)
+ * and committed once the token is accepted; staging again before a commit
+ * overwrites the previous attempt. Not thread-safe; one per request.
+ */
+class LogprobRecorder {
+public:
+    // Largest supported number of alternatives per token
+    static constexpr int32_t kMaxTopLogprobs = 20;
+    
+    /**
+     * @param maxSteps Steps to reserve storage for (more still work, but may allocate)
+     * @param topN Alternatives kept per step, clamped to [0, kMaxTopLogprobs]
+     */
+    LogprobRecorder(int32_t maxSteps, int32_t topN);
+    
+    /**
+     * @brief Score a logits row and stage the chosen token as the next step
+     * @return Logprob of the chosen token (-infinity if it is masked or out of range)
+     */
+    float stage(const float* logits, int32_t vocabSize, int32_t chosenToken);
+    
+    // Accept the staged step; returns false if nothing was staged
+    bool commit();
+    
+    int32_t steps() const { return static_cast<int32_t>(tokenIds_.size()); }
+    int32_t topN() const { return topN_; }
+    const std::vector<int32_t>& tokenIds() const { return tokenIds_; }
+    const std::vector<float>& logprobs() const { return logprobs_; }
+    
+    // Alternatives of every step, [steps × topN] and best first; short rows are padded with tokenId -1
+    const std::vector<TokenLogprob>& topLogprobs() const { return top_; }
+    
+    // Hand the recorded vectors over without copying; the recorder is empty afterwards
+    void release(std::vector<int32_t>* tokenIds, std::vector<float>* logprobs, std::vector<TokenLogprob>* top);
+
+private:
+    int32_t topN_;
+    std::vector<int32_t> tokenIds_;
+    std::vector<float> logprobs_;
+    std::vector<TokenLogprob> top_;
+    
+    // Staged step
+    bool staged_ = false;
+    int32_t stagedToken_ = -1;
+    float stagedLogprob_ = 0.0f;
+    int32_t topIds_[kMaxTopLogprobs];
+    float topValues_[kMaxTopLogprobs];
+    float stagedNormalizer_ = 0.0f;
+    int32_t stagedCount_ = 0;
+};
+
+} // namespace inference
+} // namespace rkllmjs
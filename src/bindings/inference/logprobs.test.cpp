@@ -0,0 +1,150 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "logprobs.hpp"
+#include "simd-ops.hpp"
+#include "inference-engine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+// Two-pass reference: softmax in double precision
+static std::vector<double> referenceLogSoftmax(const std::vector<float>& logits) {
+    double maxLogit = -std::numeric_limits<double>::infinity();
+    for (float x : logits) {
+        maxLogit = std::max<double>(maxLogit, x);
+    }
+    double sum = 0.0;
+    for (float x : logits) {
+        sum += std::exp(x - maxLogit);
+    }
+    std::vector<double> out(logits.size());
+    for (size_t i = 0; i < logits.size(); ++i) {
+        out[i] = logits[i] - maxLogit - std::log(sum);
+    }
+    return out;
+}
+
+TEST(LogprobsTest, RecordsChosenTokenAndTopAlternatives) {
+    std::vector<float> logits = {1.0f, 3.0f, 2.0f, 3.0f, -1.0f, 0.5f};
+    std::vector<double> reference = referenceLogSoftmax(logits);
+    
+    LogprobRecorder recorder(4, 3);
+    float logprob = recorder.stage(logits.data(), static_cast<int32_t>(logits.size()), 2);
+    EXPECT_NEAR(logprob, reference[2], 1e-5);
+    EXPECT_TRUE(recorder.commit());
+    EXPECT_FALSE(recorder.commit());
+    
+    EXPECT_EQ(recorder.steps(), 1);
+    EXPECT_EQ(recorder.tokenIds()[0], 2);
+    EXPECT_EQ(recorder.topLogprobs().size(), 3u);
+    EXPECT_EQ(recorder.topLogprobs()[0].tokenId, 1); // Tie with token 3: lower id first
+    EXPECT_EQ(recorder.topLogprobs()[1].tokenId, 3);
+    EXPECT_EQ(recorder.topLogprobs()[2].tokenId, 2);
+    EXPECT_NEAR(recorder.topLogprobs()[0].logprob, reference[1], 1e-5);
+    
+    // A vocab smaller than topN pads the row; out-of-range choices have no probability
+    LogprobRecorder small(2, 4);
+    std::vector<float> two = {0.0f, 0.0f};
+    EXPECT_EQ(small.stage(two.data(), 2, 7), -std::numeric_limits<float>::infinity());
+    small.commit();
+    EXPECT_NEAR(small.topLogprobs()[0].logprob, std::log(0.5f), 1e-6f);
+    EXPECT_EQ(small.topLogprobs()[2].tokenId, -1);
+    EXPECT_EQ(small.topLogprobs()[3].tokenId, -1);
+}
+
+TEST(LogprobsTest, StagingDoesNotAllocate) {
+    const int32_t vocab = 4096;
+    const int32_t steps = 64;
+    std::mt19937 rng(3);
+    std::normal_distribution<float> normal(0.0f, 3.0f);
+    std::vector<float> logits(vocab);
+    
+    LogprobRecorder recorder(steps, 5);
+    const float* tokenData = recorder.logprobs().data();
+    const TokenLogprob* topData = recorder.topLogprobs().data();
+    for (int32_t step = 0; step < steps; ++step) {
+        for (float& x : logits) {
+            x = normal(rng);
+        }
+        // A retried step overwrites the staged one
+        recorder.stage(logits.data(), vocab, 0);
+        recorder.stage(logits.data(), vocab, step);
+        recorder.commit();
+    }
+    
+    // Storage reserved up front was never reallocated
+    EXPECT_EQ(recorder.steps(), steps);
+    EXPECT_TRUE(recorder.logprobs().data() == tokenData);
+    EXPECT_TRUE(recorder.topLogprobs().data() == topData);
+    EXPECT_EQ(recorder.tokenIds()[10], 10);
+    
+    // The chosen logprobs feed the perplexity utility directly
+    float perplexity = utils::calculatePerplexity(recorder.logprobs());
+    EXPECT_GT(perplexity, 1.0f);
+    
+    std::vector<int32_t> ids;
+    std::vector<float> logprobs;
+    std::vector<TokenLogprob> top;
+    recorder.release(&ids, &logprobs, &top);
+    EXPECT_EQ(ids.size(), static_cast<size_t>(steps));
+    EXPECT_EQ(top.size(), static_cast<size_t>(steps * 5));
+    EXPECT_EQ(recorder.steps(), 0);
+}
+
+TEST(LogprobsTest, LargeVocabLogSoftmaxBenchmark) {
+    // 150k vocabulary, the size of current Qwen tokenizers
+    const int32_t vocab = 151936;
+    const int iterations = 50;
+    std::mt19937 rng(11);
+    std::normal_distribution<float> normal(0.0f, 2.5f);
+    std::vector<float> logits(vocab);
+    for (float& x : logits) {
+        x = normal(rng);
+    }
+    
+    LogprobRecorder recorder(iterations, 5);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        recorder.stage(logits.data(), vocab, i);
+        recorder.commit();
+    }
+    double recorderUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+    
+    // Baseline: the existing utils::softmax plus a log and a sort for the alternatives
+    start = std::chrono::steady_clock::now();
+    float baselineLogprob = 0.0f;
+    for (int i = 0; i < iterations; ++i) {
+        std::vector<float> probs = utils::softmax(logits);
+        std::vector<std::pair<float, int32_t>> ranked;
+        ranked.reserve(probs.size());
+        for (size_t j = 0; j < probs.size(); ++j) {
+            ranked.emplace_back(probs[j], static_cast<int32_t>(j));
+        }
+        std::partial_sort(ranked.begin(), ranked.begin() + 5, ranked.end(),
+                          [](const auto& a, const auto& b) { return a.first > b.first; });
+        baselineLogprob = std::log(probs[i]);
+    }
+    double baselineUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+    
+    std::vector<double> reference = referenceLogSoftmax(logits);
+    EXPECT_NEAR(recorder.logprobs()[iterations - 1], reference[iterations - 1], 1e-3);
+    EXPECT_NEAR(baselineLogprob, reference[iterations - 1], 1e-3);
+    std::cout << "[Logprobs] 150k vocab log-softmax + top-5: " << recorderUs << " us/token ("
+              << simd::backendName() << "), softmax + partial sort " << baselineUs << " us/token" << std::endl;
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
@@ -0,0 +1,347 @@
+#include "prefix-cache-index.hpp"
+#include "response-cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/stat.h>
+
+namespace rkllmjs {
+namespace inference {
+
+// Number of leading bytes shared by an edge label and text[pos..]
+static size_t commonPrefixLength(const std::string& edge, const std::string& text, size_t pos) {
+    size_t limit = std::min(edge.size(), text.size() - pos);
+    size_t i = 0;
+    while (i < limit && edge[i] == text[pos + i]) {
+        ++i;
+    }
+    return i;
+}
+
+PrefixCacheIndex::PrefixCacheIndex(const PrefixCacheConfig& config)
+    : config_(config)
+    , root_(std::make_unique<Node>()) {
+    if (!config_.cacheDir.empty()) {
+        ::mkdir(config_.cacheDir.c_str(), 0755); // EEXIST is fine
+    }
+}
+
+PrefixCacheIndex::~PrefixCacheIndex() {
+    // Cache files are only reachable through this index
+    deleteCacheFiles(root_.get());
+}
+
+PrefixPromotion PrefixCacheIndex::observe(const std::string& prompt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t tick = ++clock_;
+    
+    Node* node = root_.get();
+    Node* candidate = nullptr;
+    size_t covered = 0;
+    size_t pos = 0;
+    
+    root_->visits++;
+    while (pos < prompt.size()) {
+        auto it = node->children.find(static_cast<unsigned char>(prompt[pos]));
+        if (it == node->children.end()) {
+            auto leaf = std::make_unique<Node>();
+            leaf->edge = prompt.substr(pos);
+            leaf->depth = prompt.size();
+            leaf->visits = 1;
+            leaf->lastUsed = tick;
+            treeBytes_ += leaf->edge.size();
+            node->children.emplace(static_cast<unsigned char>(prompt[pos]), std::move(leaf));
+            break;
+        }
+        
+        Node* child = it->second.get();
+        size_t common = commonPrefixLength(child->edge, prompt, pos);
+        if (common < child->edge.size()) {
+            child = splitEdge(node, child, common);
+        }
+        child->visits++;
+        child->lastUsed = tick;
+        pos += common;
+        node = child;
+        
+        if (!child->cacheFile.empty() || child->pending || child->failed) {
+            covered = child->depth;
+        }
+        // Divergence points shared by enough prompts are promotion candidates
+        if (child->visits >= config_.promoteAfter && child->depth >= config_.minPrefixBytes &&
+            child->depth < prompt.size()) {
+            candidate = child;
+        }
+    }
+    
+    PrefixPromotion promotion;
+    if (candidate && config_.maxCacheFiles > 0) {
+        size_t boundary = alignToBoundary(prompt, candidate->depth);
+        if (boundary >= config_.minPrefixBytes && boundary > covered) {
+            int32_t visits = candidate->visits;
+            Node* target = insertPath(prompt.substr(0, boundary));
+            target->visits = std::max(target->visits, visits);
+            target->pending = true;
+            
+            promotion.prefix = prompt.substr(0, boundary);
+            promotion.cacheFile = makeCacheFileName(promotion.prefix);
+        }
+    }
+    
+    // Pending and cached prefixes survive pruning
+    if (treeBytes_ > config_.maxTreeBytes) {
+        prune(root_.get(), config_.promoteAfter);
+        if (treeBytes_ > config_.maxTreeBytes) {
+            prune(root_.get(), INT32_MAX);
+        }
+    }
+    return promotion;
+}
+
+PrefixMatch PrefixCacheIndex::findLongestPrefix(const std::string& prompt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.lookups++;
+    
+    const Node* node = root_.get();
+    Node* best = nullptr;
+    size_t pos = 0;
+    
+    while (pos < prompt.size()) {
+        auto it = node->children.find(static_cast<unsigned char>(prompt[pos]));
+        if (it == node->children.end()) {
+            break;
+        }
+        Node* child = it->second.get();
+        if (prompt.compare(pos, child->edge.size(), child->edge) != 0) {
+            break; // Caches only sit at node boundaries
+        }
+        pos += child->edge.size();
+        node = child;
+        
+        // An empty suffix would leave nothing to run
+        if (!child->cacheFile.empty() && child->depth < prompt.size()) {
+            best = child;
+        }
+    }
+    
+    PrefixMatch match;
+    if (best) {
+        best->lastUsed = ++clock_;
+        match.cacheFile = best->cacheFile;
+        match.prefixBytes = best->depth;
+        match.prefillTokens = best->prefillTokens;
+    }
+    return match;
+}
+
+void PrefixCacheIndex::registerCache(const std::string& prefix, const std::string& cacheFile, int32_t prefillTokens) {
+    if (prefix.empty() || cacheFile.empty()) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    Node* node = insertPath(prefix);
+    if (!node->cacheFile.empty() && node->cacheFile != cacheFile) {
+        dropCache(node);
+    }
+    if (node->cacheFile.empty()) {
+        cacheFiles_++;
+        stats_.promotions++;
+    }
+    node->cacheFile = cacheFile;
+    node->prefillTokens = prefillTokens;
+    node->pending = false;
+    node->failed = false;
+    node->lastUsed = ++clock_;
+    
+    while (cacheFiles_ > config_.maxCacheFiles) {
+        Node* victim = leastRecentlyUsedCache(root_.get());
+        if (!victim) {
+            break;
+        }
+        dropCache(victim);
+        stats_.evictions++;
+    }
+}
+
+void PrefixCacheIndex::abandonPromotion(const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Node* node = findExact(prefix);
+    if (node) {
+        node->pending = false;
+        node->failed = true;
+    }
+}
+
+void PrefixCacheIndex::invalidate(const std::string& cacheFile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Node* node = findByFile(root_.get(), cacheFile);
+    if (node) {
+        dropCache(node);
+        node->failed = true;
+    }
+}
+
+void PrefixCacheIndex::recordReuse(const PrefixMatch& match) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.hits++;
+    stats_.prefillTokensSaved += match.prefillTokens;
+}
+
+void PrefixCacheIndex::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    deleteCacheFiles(root_.get());
+    root_ = std::make_unique<Node>();
+    treeBytes_ = 0;
+    cacheFiles_ = 0;
+}
+
+PrefixCacheStats PrefixCacheIndex::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PrefixCacheStats stats = stats_;
+    stats.cacheFiles = cacheFiles_;
+    stats.treeBytes = treeBytes_;
+    return stats;
+}
+
+size_t PrefixCacheIndex::alignToBoundary(const std::string& text, size_t maxLength) {
+    for (size_t length = std::min(maxLength, text.size()); length > 0; --length) {
+        if (std::isspace(static_cast<unsigned char>(text[length - 1]))) {
+            return length;
+        }
+    }
+    return 0;
+}
+
+PrefixCacheIndex::Node* PrefixCacheIndex::splitEdge(Node* parent, Node* child, size_t at) {
+    unsigned char key = static_cast<unsigned char>(child->edge[0]);
+    std::unique_ptr<Node> owned = std::move(parent->children[key]);
+    
+    auto middle = std::make_unique<Node>();
+    middle->edge = owned->edge.substr(0, at);
+    middle->depth = parent->depth + at;
+    middle->visits = owned->visits;
+    middle->lastUsed = owned->lastUsed;
+    
+    owned->edge.erase(0, at);
+    middle->children.emplace(static_cast<unsigned char>(owned->edge[0]), std::move(owned));
+    
+    Node* result = middle.get();
+    parent->children[key] = std::move(middle);
+    return result;
+}
+
+PrefixCacheIndex::Node* PrefixCacheIndex::insertPath(const std::string& prefix) {
+    Node* node = root_.get();
+    size_t pos = 0;
+    
+    while (pos < prefix.size()) {
+        auto it = node->children.find(static_cast<unsigned char>(prefix[pos]));
+        if (it == node->children.end()) {
+            auto leaf = std::make_unique<Node>();
+            leaf->edge = prefix.substr(pos);
+            leaf->depth = prefix.size();
+            treeBytes_ += leaf->edge.size();
+            Node* result = leaf.get();
+            node->children.emplace(static_cast<unsigned char>(prefix[pos]), std::move(leaf));
+            return result;
+        }
+        
+        Node* child = it->second.get();
+        size_t common = commonPrefixLength(child->edge, prefix, pos);
+        if (common < child->edge.size()) {
+            child = splitEdge(node, child, common);
+        }
+        pos += common;
+        node = child;
+    }
+    return node;
+}
+
+PrefixCacheIndex::Node* PrefixCacheIndex::findExact(const std::string& prefix) const {
+    Node* node = root_.get();
+    size_t pos = 0;
+    
+    while (pos < prefix.size()) {
+        auto it = node->children.find(static_cast<unsigned char>(prefix[pos]));
+        if (it == node->children.end() || prefix.compare(pos, it->second->edge.size(), it->second->edge) != 0) {
+            return nullptr;
+        }
+        pos += it->second->edge.size();
+        node = it->second.get();
+    }
+    return pos == prefix.size() ? node : nullptr;
+}
+
+PrefixCacheIndex::Node* PrefixCacheIndex::findByFile(Node* node, const std::string& cacheFile) const {
+    if (node->cacheFile == cacheFile) {
+        return node;
+    }
+    for (auto& entry : node->children) {
+        Node* found = findByFile(entry.second.get(), cacheFile);
+        if (found) {
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+PrefixCacheIndex::Node* PrefixCacheIndex::leastRecentlyUsedCache(Node* node) const {
+    Node* best = node->cacheFile.empty() ? nullptr : node;
+    for (auto& entry : node->children) {
+        Node* candidate = leastRecentlyUsedCache(entry.second.get());
+        if (candidate && (!best || candidate->lastUsed < best->lastUsed)) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+void PrefixCacheIndex::dropCache(Node* node) {
+    if (node->cacheFile.empty()) {
+        return;
+    }
+    std::remove(node->cacheFile.c_str());
+    node->cacheFile.clear();
+    node->prefillTokens = 0;
+    cacheFiles_--;
+}
+
+void PrefixCacheIndex::deleteCacheFiles(Node* node) {
+    if (!node->cacheFile.empty()) {
+        std::remove(node->cacheFile.c_str());
+    }
+    for (auto& entry : node->children) {
+        deleteCacheFiles(entry.second.get());
+    }
+}
+
+bool PrefixCacheIndex::prune(Node* node, int32_t minVisits) {
+    for (auto it = node->children.begin(); it != node->children.end();) {
+        if (prune(it->second.get(), minVisits)) {
+            treeBytes_ -= it->second->edge.size();
+            it = node->children.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    // Keep cached and pending prefixes and the paths leading to them
+    return node != root_.get() && node->children.empty() && node->cacheFile.empty() &&
+           !node->pending && node->visits < minVisits;
+}
+
+std::string PrefixCacheIndex::makeCacheFileName(const std::string& prefix) const {
+    std::ostringstream oss;
+    oss << config_.cacheDir << "/prefix-" << std::hex << std::setw(16) << std::setfill('0')
+        << ResponseCache::hashKey(prefix) << ".cache";
+    return oss.str();
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,153 @@
+/**
+ * @module inference
+ * @purpose Radix-tree index of saved prompt-cache files
+ * @description Records which RKLLM prompt-cache files (RKLLMPromptCacheParam)
+ *              cover which prompt prefixes, picks the longest cached prefix for
+ *              a new prompt and proposes frequently shared prefixes for new
+ *              cache files. Prompts share long system/tool/few-shot prefixes, so
+ *              reusing a cache skips most of the prefill.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Prefix cache configuration
+ */
+struct PrefixCacheConfig {
+    std::string cacheDir = "/tmp/rkllmjs-prompt-cache"; // Where promoted caches are written
+    size_t minPrefixBytes = 256;        // Shorter prefixes are not worth a cache file
+    int32_t promoteAfter = 3;           // Requests sharing a prefix before it is cached
+    size_t maxCacheFiles = 16;          // Least recently used files are deleted beyond this
+    size_t maxTreeBytes = 4 * 1024 * 1024; // Prompt text retained for frequency tracking
+    
+    // The model's chat template, as passed to rkllm_set_chat_template. A cached
+    // prefix is saved with only the template's opening and the rest of the prompt
+    // runs with only its closing, so the turn is templated once. Prefix caches are
+    // not used while both prefix and postfix are empty.
+    std::string systemPrompt;
+    std::string promptPrefix;
+    std::string promptPostfix;
+    
+    bool hasChatTemplate() const { return !promptPrefix.empty() || !promptPostfix.empty(); }
+};
+
+/**
+ * Longest cached prefix of a prompt
+ */
+struct PrefixMatch {
+    std::string cacheFile;
+    size_t prefixBytes = 0;             // Length of the covered prompt prefix
+    int32_t prefillTokens = 0;          // Tokens the cache saves from prefill
+    
+    bool found() const { return !cacheFile.empty(); }
+};
+
+/**
+ * Prefix that has become popular enough to cache
+ */
+struct PrefixPromotion {
+    std::string prefix;
+    std::string cacheFile;              // Path the new cache should be saved to
+    
+    bool empty() const { return prefix.empty(); }
+};
+
+/**
+ * Prefix cache counters
+ */
+struct PrefixCacheStats {
+    int64_t lookups = 0;
+    int64_t hits = 0;
+    int64_t promotions = 0;
+    int64_t evictions = 0;
+    int64_t prefillTokensSaved = 0;
+    size_t cacheFiles = 0;
+    size_t treeBytes = 0;
+};
+
+/**
+ * Byte-level radix tree over normalized prompts
+ *
+ * The runtime exposes no tokenizer, so prefixes are tracked as text and
+ * cache boundaries are aligned to whitespace to keep the prefix and the
+ * remaining suffix tokenizing the same way as the whole prompt. Token
+ * counts come from the runtime's prefill statistics when a cache is saved.
+ * Thread-safe.
+ */
+class PrefixCacheIndex {
+public:
+    explicit PrefixCacheIndex(const PrefixCacheConfig& config = PrefixCacheConfig());
+    ~PrefixCacheIndex();
+    
+    /**
+     * @brief Record a prompt and propose a prefix to cache, if any
+     * @return Popular uncached prefix longer than any cached one (may be empty)
+     * @note The proposal stays pending until registerCache or abandonPromotion.
+     */
+    PrefixPromotion observe(const std::string& prompt);
+    
+    /**
+     * @brief Longest cached prefix strictly shorter than the prompt
+     */
+    PrefixMatch findLongestPrefix(const std::string& prompt);
+    
+    // Cache file lifecycle
+    void registerCache(const std::string& prefix, const std::string& cacheFile, int32_t prefillTokens);
+    void abandonPromotion(const std::string& prefix);
+    void invalidate(const std::string& cacheFile);
+    void recordReuse(const PrefixMatch& match);
+    
+    // Forget every prefix and delete all cache files
+    void clear();
+    
+    PrefixCacheStats getStats() const;
+    const PrefixCacheConfig& getConfig() const { return config_; }
+    
+    // Largest length <= maxLength at which the text can be split between words
+    static size_t alignToBoundary(const std::string& text, size_t maxLength);
+
+private:
+    struct Node {
+        std::string edge;               // Label on the edge from the parent
+        std::map<unsigned char, std::unique_ptr<Node>> children;
+        size_t depth = 0;               // Prefix length at the end of this node
+        int32_t visits = 0;             // Prompts that passed through this node
+        std::string cacheFile;
+        int32_t prefillTokens = 0;
+        bool pending = false;           // Promotion proposed, cache not yet saved
+        bool failed = false;            // Saving failed; never propose again
+        uint64_t lastUsed = 0;
+    };
+    
+    Node* splitEdge(Node* parent, Node* child, size_t at);
+    Node* insertPath(const std::string& prefix);
+    Node* findExact(const std::string& prefix) const;
+    Node* findByFile(Node* node, const std::string& cacheFile) const;
+    Node* leastRecentlyUsedCache(Node* node) const;
+    void dropCache(Node* node);
+    void deleteCacheFiles(Node* node);
+    bool prune(Node* node, int32_t minVisits);
+    std::string makeCacheFileName(const std::string& prefix) const;
+    
+    PrefixCacheConfig config_;
+    mutable std::mutex mutex_;
+    std::unique_ptr<Node> root_;
+    uint64_t clock_ = 0;
+    size_t treeBytes_ = 0;
+    size_t cacheFiles_ = 0;
+    PrefixCacheStats stats_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
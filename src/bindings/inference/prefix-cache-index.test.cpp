@@ -0,0 +1,160 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "prefix-cache-index.hpp"
+
+#include <fstream>
+#include <unistd.h>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static PrefixCacheConfig makeTestConfig() {
+    PrefixCacheConfig config;
+    config.cacheDir = "/tmp/rkllmjs-prefix-test-" + std::to_string(::getpid());
+    config.minPrefixBytes = 32;
+    config.promoteAfter = 3;
+    return config;
+}
+
+// Stand-in for rkllm_run saving a prompt cache
+static void touch(const std::string& path) {
+    std::ofstream(path) << "cache";
+}
+
+static bool exists(const std::string& path) {
+    return std::ifstream(path).good();
+}
+
+static const std::string kSystemPrompt =
+    "You are a helpful assistant. Answer using the tools below. Tool: search(query) returns documents. ";
+
+TEST(PrefixCacheIndexTest, AlignToBoundary) {
+    EXPECT_EQ(PrefixCacheIndex::alignToBoundary("hello world", 11), static_cast<size_t>(6));
+    EXPECT_EQ(PrefixCacheIndex::alignToBoundary("hello world", 6), static_cast<size_t>(6));
+    EXPECT_EQ(PrefixCacheIndex::alignToBoundary("hello world", 5), static_cast<size_t>(0));
+    EXPECT_EQ(PrefixCacheIndex::alignToBoundary("a\nb", 100), static_cast<size_t>(2));
+}
+
+TEST(PrefixCacheIndexTest, ChatTemplateRequired) {
+    // Without the model's template a cached prefix cannot be split from the turn
+    PrefixCacheConfig config = makeTestConfig();
+    EXPECT_FALSE(config.hasChatTemplate());
+    config.systemPrompt = "You are a helpful assistant.";
+    EXPECT_FALSE(config.hasChatTemplate());
+    config.promptPrefix = "<|im_start|>user\n";
+    EXPECT_TRUE(config.hasChatTemplate());
+}
+
+TEST(PrefixCacheIndexTest, PromotesSharedPrefixAfterThreshold) {
+    PrefixCacheIndex index(makeTestConfig());
+    
+    EXPECT_TRUE(index.observe(kSystemPrompt + "What is the weather?").empty());
+    EXPECT_TRUE(index.observe(kSystemPrompt + "Who won the match?").empty());
+    
+    PrefixPromotion promotion = index.observe(kSystemPrompt + "Where is Paris?");
+    EXPECT_FALSE(promotion.empty());
+    EXPECT_EQ(promotion.prefix, kSystemPrompt);
+    EXPECT_FALSE(promotion.cacheFile.empty());
+    
+    // Pending promotions are not proposed twice
+    EXPECT_TRUE(index.observe(kSystemPrompt + "How tall is Everest?").empty());
+    
+    touch(promotion.cacheFile);
+    index.registerCache(promotion.prefix, promotion.cacheFile, 24);
+    
+    PrefixMatch match = index.findLongestPrefix(kSystemPrompt + "Brand new question");
+    EXPECT_TRUE(match.found());
+    EXPECT_EQ(match.prefixBytes, kSystemPrompt.size());
+    EXPECT_EQ(match.prefillTokens, 24);
+    
+    index.recordReuse(match);
+    PrefixCacheStats stats = index.getStats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.promotions, 1);
+    EXPECT_EQ(stats.prefillTokensSaved, 24);
+    EXPECT_EQ(stats.cacheFiles, static_cast<size_t>(1));
+    
+    // Unrelated prompts and the bare prefix itself do not match
+    EXPECT_FALSE(index.findLongestPrefix("Completely different prompt").found());
+    EXPECT_FALSE(index.findLongestPrefix(kSystemPrompt).found());
+    
+    index.clear();
+    EXPECT_FALSE(exists(promotion.cacheFile));
+}
+
+TEST(PrefixCacheIndexTest, LongestPrefixWins) {
+    PrefixCacheIndex index(makeTestConfig());
+    std::string fewShot = kSystemPrompt + "Example: Q: 2+2? A: 4. ";
+    
+    std::string shortFile = index.getConfig().cacheDir + "/short.cache";
+    std::string longFile = index.getConfig().cacheDir + "/long.cache";
+    touch(shortFile);
+    touch(longFile);
+    index.registerCache(kSystemPrompt, shortFile, 20);
+    index.registerCache(fewShot, longFile, 30);
+    
+    EXPECT_EQ(index.findLongestPrefix(fewShot + "Q: 3+3?").cacheFile, longFile);
+    EXPECT_EQ(index.findLongestPrefix(kSystemPrompt + "Q: 3+3?").cacheFile, shortFile);
+    
+    // A broken cache is dropped and the shorter one is used instead
+    index.invalidate(longFile);
+    EXPECT_FALSE(exists(longFile));
+    EXPECT_EQ(index.findLongestPrefix(fewShot + "Q: 3+3?").cacheFile, shortFile);
+}
+
+TEST(PrefixCacheIndexTest, EvictsLeastRecentlyUsedFiles) {
+    PrefixCacheConfig config = makeTestConfig();
+    config.maxCacheFiles = 2;
+    PrefixCacheIndex index(config);
+    
+    std::vector<std::string> files;
+    for (int i = 0; i < 3; ++i) {
+        std::string prefix = "prefix number " + std::to_string(i) + " " + kSystemPrompt;
+        files.push_back(config.cacheDir + "/evict-" + std::to_string(i) + ".cache");
+        touch(files.back());
+        index.registerCache(prefix, files.back(), 10);
+    }
+    
+    PrefixCacheStats stats = index.getStats();
+    EXPECT_EQ(stats.cacheFiles, static_cast<size_t>(2));
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_FALSE(exists(files[0]));
+    EXPECT_TRUE(exists(files[2]));
+}
+
+TEST(PrefixCacheIndexTest, TreeMemoryIsBounded) {
+    PrefixCacheConfig config = makeTestConfig();
+    config.maxTreeBytes = 16 * 1024;
+    PrefixCacheIndex index(config);
+    
+    for (int i = 0; i < 500; ++i) {
+        index.observe("unique prompt " + std::to_string(i * 7919) + " " + std::string(100, 'x'));
+    }
+    EXPECT_LE(index.getStats().treeBytes, config.maxTreeBytes);
+    
+    // Frequency tracking still works after pruning
+    for (int i = 0; i < 2; ++i) {
+        index.observe(kSystemPrompt + "question " + std::to_string(i));
+    }
+    EXPECT_FALSE(index.observe(kSystemPrompt + "question 2").empty());
+}
+
+TEST(PrefixCacheIndexTest, FailedPromotionIsNotRetried) {
+    PrefixCacheIndex index(makeTestConfig());
+    index.observe(kSystemPrompt + "one");
+    index.observe(kSystemPrompt + "two");
+    PrefixPromotion promotion = index.observe(kSystemPrompt + "three");
+    EXPECT_FALSE(promotion.empty());
+    
+    index.abandonPromotion(promotion.prefix);
+    EXPECT_TRUE(index.observe(kSystemPrompt + "four").empty());
+    EXPECT_FALSE(index.findLongestPrefix(kSystemPrompt + "five").found());
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
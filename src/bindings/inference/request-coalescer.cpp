@@ -0,0 +1,104 @@
+#include "request-coalescer.hpp"
+
+namespace rkllmjs {
+namespace inference {
+
+// InFlightRequest implementation
+InFlightRequest::InFlightRequest()
+    : future_(promise_.get_future().share()) {
+}
+
+std::shared_future<InferenceResult> InFlightRequest::subscribe(TokenCallback onToken) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (onToken) {
+        // Replay the prefix under the lock so no live token can interleave
+        for (const auto& token : tokens_) {
+            onToken(token);
+        }
+        if (!done_) {
+            subscribers_.push_back(std::move(onToken));
+        }
+    }
+    return future_;
+}
+
+void InFlightRequest::publishToken(const std::string& token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (done_) {
+        return;
+    }
+    
+    tokens_.push_back(token);
+    for (const auto& subscriber : subscribers_) {
+        subscriber(token);
+    }
+}
+
+void InFlightRequest::complete(const InferenceResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (done_) {
+        return;
+    }
+    done_ = true;
+    subscribers_.clear();
+    promise_.set_value(result);
+}
+
+void InFlightRequest::fail(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (done_) {
+        return;
+    }
+    done_ = true;
+    subscribers_.clear();
+    promise_.set_exception(error);
+}
+
+size_t InFlightRequest::getSubscriberCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_.size();
+}
+
+size_t InFlightRequest::getTokenCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tokens_.size();
+}
+
+// RequestCoalescer implementation
+RequestCoalescer::Flight RequestCoalescer::join(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    Flight flight;
+    auto it = inFlight_.find(key);
+    if (it != inFlight_.end()) {
+        flight.request = it->second;
+        flight.leader = false;
+        stats_.joiners++;
+        return flight;
+    }
+    
+    flight.request = std::make_shared<InFlightRequest>();
+    flight.leader = true;
+    inFlight_.emplace(key, flight.request);
+    stats_.leaders++;
+    return flight;
+}
+
+void RequestCoalescer::finish(const std::string& key, const std::shared_ptr<InFlightRequest>& request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = inFlight_.find(key);
+    if (it != inFlight_.end() && it->second == request) {
+        inFlight_.erase(it);
+    }
+}
+
+CoalescerStats RequestCoalescer::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CoalescerStats stats = stats_;
+    stats.inFlight = inFlight_.size();
+    return stats;
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,104 @@
+/**
+ * @module inference
+ * @purpose Single-flight deduplication of identical in-flight requests
+ * @description Lets identical deterministic requests share one NPU computation.
+ *              The first caller for a key becomes the leader and runs inference;
+ *              later callers attach to the leader's flight, receive the tokens
+ *              produced so far and then follow the live token stream until the
+ *              shared result is available.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include "inference-engine.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * One shared computation and its token stream
+ *
+ * Subscriber callbacks run on the leader's thread with the flight locked,
+ * which keeps replay and live delivery in order; they must not subscribe
+ * to or publish on the same flight.
+ */
+class InFlightRequest {
+public:
+    InFlightRequest();
+    
+    /**
+     * @brief Attach a token listener and obtain the shared result
+     * @param onToken Receives every token, starting with a replay of the
+     *                tokens already produced (may be null)
+     */
+    std::shared_future<InferenceResult> subscribe(TokenCallback onToken);
+    
+    // Leader side
+    void publishToken(const std::string& token);
+    void complete(const InferenceResult& result);
+    void fail(std::exception_ptr error);
+    
+    size_t getSubscriberCount() const;
+    size_t getTokenCount() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::string> tokens_;
+    std::vector<TokenCallback> subscribers_;
+    bool done_ = false;
+    std::promise<InferenceResult> promise_;
+    std::shared_future<InferenceResult> future_;
+};
+
+/**
+ * Single-flight coalescer counters
+ */
+struct CoalescerStats {
+    int64_t leaders = 0;      // Requests that ran inference
+    int64_t joiners = 0;      // Requests served by another request's flight
+    size_t inFlight = 0;      // Distinct computations currently running
+};
+
+/**
+ * Registry of in-flight computations keyed by request identity
+ */
+class RequestCoalescer {
+public:
+    struct Flight {
+        std::shared_ptr<InFlightRequest> request;
+        bool leader = false;  // true: caller must run inference and finish()
+    };
+    
+    /**
+     * @brief Join the flight for a key, starting one if none is running
+     */
+    Flight join(const std::string& key);
+    
+    /**
+     * @brief Retire a leader's flight so later requests start fresh
+     * @note Call after complete()/fail(); joiners already attached still
+     *       receive the result.
+     */
+    void finish(const std::string& key, const std::shared_ptr<InFlightRequest>& request);
+    
+    CoalescerStats getStats() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<InFlightRequest>> inFlight_;
+    CoalescerStats stats_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,159 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "request-coalescer.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static InferenceResult makeResult(const std::string& text) {
+    InferenceResult result;
+    result.text = text;
+    result.finishReason = "completed";
+    return result;
+}
+
+TEST(RequestCoalescerTest, LeaderAndJoiner) {
+    RequestCoalescer coalescer;
+    
+    auto leader = coalescer.join("key");
+    auto joiner = coalescer.join("key");
+    auto other = coalescer.join("other");
+    
+    EXPECT_TRUE(leader.leader);
+    EXPECT_FALSE(joiner.leader);
+    EXPECT_TRUE(other.leader);
+    EXPECT_TRUE(leader.request == joiner.request);
+    EXPECT_FALSE(leader.request == other.request);
+    
+    CoalescerStats stats = coalescer.getStats();
+    EXPECT_EQ(stats.leaders, 2);
+    EXPECT_EQ(stats.joiners, 1);
+    EXPECT_EQ(stats.inFlight, static_cast<size_t>(2));
+    
+    leader.request->complete(makeResult("done"));
+    coalescer.finish("key", leader.request);
+    EXPECT_EQ(joiner.request->subscribe(nullptr).get().text, "done");
+    
+    // A retired key starts a new flight
+    EXPECT_TRUE(coalescer.join("key").leader);
+}
+
+TEST(RequestCoalescerTest, LateJoinerReplaysPrefix) {
+    InFlightRequest request;
+    
+    std::string early;
+    request.subscribe([&early](const std::string& token) { early += token; });
+    request.publishToken("Hello");
+    request.publishToken(" wor");
+    
+    std::string late;
+    auto future = request.subscribe([&late](const std::string& token) { late += token; });
+    EXPECT_EQ(late, "Hello wor");
+    
+    request.publishToken("ld");
+    request.complete(makeResult("Hello world"));
+    
+    EXPECT_EQ(early, "Hello world");
+    EXPECT_EQ(late, "Hello world");
+    EXPECT_EQ(future.get().text, "Hello world");
+    
+    // Joining after completion replays everything and resolves immediately
+    std::string after;
+    auto done = request.subscribe([&after](const std::string& token) { after += token; });
+    EXPECT_EQ(after, "Hello world");
+    EXPECT_EQ(done.get().text, "Hello world");
+    EXPECT_EQ(request.getSubscriberCount(), static_cast<size_t>(0));
+    
+    // Tokens after completion are ignored
+    request.publishToken("!");
+    EXPECT_EQ(request.getTokenCount(), static_cast<size_t>(3));
+}
+
+TEST(RequestCoalescerTest, FailurePropagatesToJoiners) {
+    RequestCoalescer coalescer;
+    auto leader = coalescer.join("key");
+    auto joiner = coalescer.join("key");
+    
+    leader.request->fail(std::make_exception_ptr(std::runtime_error("npu fault")));
+    coalescer.finish("key", leader.request);
+    
+    bool threw = false;
+    try {
+        joiner.request->subscribe(nullptr).get();
+    } catch (const std::runtime_error& e) {
+        threw = std::string(e.what()) == "npu fault";
+    }
+    EXPECT_TRUE(threw);
+    EXPECT_EQ(coalescer.getStats().inFlight, static_cast<size_t>(0));
+}
+
+TEST(RequestCoalescerTest, ConcurrentJoinersShareOneComputation) {
+    RequestCoalescer coalescer;
+    const int clientCount = 8;
+    const int tokenCount = 50;
+    std::atomic<int> computations{0};
+    std::vector<std::string> streams(clientCount);
+    std::vector<std::string> results(clientCount);
+    
+    std::vector<std::thread> clients;
+    for (int c = 0; c < clientCount; ++c) {
+        clients.emplace_back([&, c]() {
+            auto flight = coalescer.join("popular");
+            auto future = flight.request->subscribe([&streams, c](const std::string& token) {
+                streams[c] += token;
+            });
+            
+            if (flight.leader) {
+                computations++;
+                std::string text;
+                for (int t = 0; t < tokenCount; ++t) {
+                    std::string token = "t" + std::to_string(t) + " ";
+                    text += token;
+                    flight.request->publishToken(token);
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+                flight.request->complete(makeResult(text));
+                coalescer.finish("popular", flight.request);
+            }
+            results[c] = future.get().text;
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    
+    // Clients arriving after the leader finished start their own flight
+    CoalescerStats stats = coalescer.getStats();
+    EXPECT_EQ(stats.leaders, static_cast<int64_t>(computations));
+    EXPECT_EQ(stats.leaders + stats.joiners, static_cast<int64_t>(clientCount));
+    
+    // Every client saw the complete stream, in order, exactly once
+    for (int c = 0; c < clientCount; ++c) {
+        EXPECT_EQ(streams[c], results[c]);
+        EXPECT_EQ(results[c], results[0]);
+    }
+}
+
+TEST(RequestCoalescerTest, EngineToggle) {
+    auto& managerRef = core::RKLLMManager::getInstance();
+    std::shared_ptr<core::RKLLMManager> manager(&managerRef, [](core::RKLLMManager*){});
+    InferenceEngine engine(manager);
+    
+    EXPECT_TRUE(engine.isRequestCoalescingEnabled());
+    engine.enableRequestCoalescing(false);
+    EXPECT_FALSE(engine.isRequestCoalescingEnabled());
+    EXPECT_EQ(engine.getStats().coalescedRequests, 0);
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
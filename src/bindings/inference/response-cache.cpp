@@ -0,0 +1,234 @@
+#include "response-cache.hpp"
+#include "inference-engine.hpp"
+#include "../core/rkllm-manager.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace rkllmjs {
+namespace inference {
+
+// Append raw bytes of a trivially copyable value to the key
+template<typename T>
+static void appendBytes(std::string& key, const T& value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    key.append(bytes, sizeof(T));
+}
+
+ResponseCache::ResponseCache(const ResponseCacheConfig& config)
+    : config_(config) {
+    if (config_.shardCount == 0) {
+        config_.shardCount = 1;
+    }
+    shardBudget_ = config_.maxBytes / config_.shardCount;
+    
+    shards_.reserve(config_.shardCount);
+    for (size_t i = 0; i < config_.shardCount; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+bool ResponseCache::isDeterministic(const InferenceParams& params, const core::RKLLMModelConfig& model) {
+    // Session turns depend on the conversation history, not just the prompt
+    if (!params.sessionId.empty()) {
+        return false;
+    }
+    
+    // Beam search and logits-mode decoding sample in the engine with the request's
+    // settings; plain generation samples in the runtime, which has no seed
+    bool deterministic;
+    if (params.numBeams > 1) {
+        deterministic = true;
+    } else if (params.logprobs || params.usesEngineSampler()) {
+        deterministic = params.topK == 1 || params.temperature == 0.0f || params.seed >= 0;
+    } else {
+        deterministic = model.top_k == 1 || model.temperature == 0.0f;
+    }
+    return deterministic;
+}
+
+bool ResponseCache::isCacheable(const InferenceParams& params, const core::RKLLMModelConfig& model) {
+    return params.useCache && isDeterministic(params, model);
+}
+
+std::string ResponseCache::makeKey(const std::string& modelId, const std::string& normalizedPrompt,
+                                   const InferenceParams& params) {
+    std::string key;
+    key.reserve(modelId.size() + normalizedPrompt.size() + 64);
+    
+    // Length-prefixed strings keep field boundaries unambiguous
+    appendBytes(key, modelId.size());
+    key += modelId;
+    appendBytes(key, normalizedPrompt.size());
+    key += normalizedPrompt;
+    
+    appendBytes(key, params.maxTokens);
+    appendBytes(key, params.temperature);
+    appendBytes(key, params.topP);
+    appendBytes(key, params.topK);
+    appendBytes(key, params.repetitionPenalty);
+    appendBytes(key, params.seed);
+    appendBytes(key, params.presencePenalty);
+    appendBytes(key, params.frequencyPenalty);
+    for (const auto& stop : params.stopSequences) {
+        appendBytes(key, stop.size());
+        key += stop;
+    }
+    appendBytes(key, params.logprobs);
+    appendBytes(key, params.topLogprobs);
+    appendBytes(key, params.stopTokenIds.size());
+    for (int32_t token : params.stopTokenIds) {
+        appendBytes(key, token);
+    }
+    appendBytes(key, params.minP);
+    appendBytes(key, params.typicalP);
+    appendBytes(key, params.mirostat);
+    appendBytes(key, params.mirostatTau);
+    appendBytes(key, params.mirostatEta);
+    appendBytes(key, params.dryMultiplier);
+    appendBytes(key, params.dryBase);
+    appendBytes(key, params.dryAllowedLength);
+    appendBytes(key, params.dryLastN);
+    appendBytes(key, params.dryBreakerIds.size());
+    for (int32_t token : params.dryBreakerIds) {
+        appendBytes(key, token);
+    }
+    appendBytes(key, params.numBeams);
+    appendBytes(key, params.lengthPenalty);
+    appendBytes(key, params.earlyStopping);
+    
+    return key;
+}
+
+uint64_t ResponseCache::hashKey(const std::string& key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool ResponseCache::lookup(const std::string& key, InferenceResult* result) {
+    uint64_t hash = hashKey(key);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    auto it = find(shard, hash, key);
+    if (it == shard.index.end()) {
+        shard.misses++;
+        return false;
+    }
+    
+    auto entry = it->second;
+    if (config_.ttlMs > 0 && Clock::now() >= entry->expiresAt) {
+        erase(shard, it);
+        shard.expirations++;
+        shard.misses++;
+        return false;
+    }
+    
+    // Move to front of LRU
+    shard.lru.splice(shard.lru.begin(), shard.lru, entry);
+    shard.hits++;
+    
+    if (result) {
+        *result = *entry->result;
+    }
+    return true;
+}
+
+void ResponseCache::insert(const std::string& key, const InferenceResult& result) {
+    size_t bytes = entrySize(key, result);
+    if (bytes > shardBudget_) {
+        return; // Would evict the whole shard for one entry
+    }
+    
+    uint64_t hash = hashKey(key);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    auto existing = find(shard, hash, key);
+    if (existing != shard.index.end()) {
+        erase(shard, existing);
+    }
+    
+    // Evict least recently used entries until the new one fits
+    while (!shard.lru.empty() && shard.bytes + bytes > shardBudget_) {
+        const Entry& victim = shard.lru.back();
+        erase(shard, find(shard, victim.hash, victim.key));
+        shard.evictions++;
+    }
+    
+    Entry entry;
+    entry.hash = hash;
+    entry.key = key;
+    entry.result = std::make_unique<InferenceResult>(result);
+    entry.bytes = bytes;
+    entry.expiresAt = Clock::now() + std::chrono::milliseconds(config_.ttlMs);
+    
+    shard.lru.push_front(std::move(entry));
+    shard.index.emplace(hash, shard.lru.begin());
+    shard.bytes += bytes;
+    shard.insertions++;
+}
+
+void ResponseCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+        shard->bytes = 0;
+    }
+}
+
+ResponseCacheStats ResponseCache::getStats() const {
+    ResponseCacheStats stats;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.hits += shard->hits;
+        stats.misses += shard->misses;
+        stats.insertions += shard->insertions;
+        stats.evictions += shard->evictions;
+        stats.expirations += shard->expirations;
+        stats.entries += shard->lru.size();
+        stats.bytes += shard->bytes;
+    }
+    return stats;
+}
+
+ResponseCache::Shard& ResponseCache::shardFor(uint64_t hash) {
+    // High bits pick the shard so bucket placement (low bits) stays independent
+    return *shards_[(hash >> 32) % shards_.size()];
+}
+
+std::unordered_multimap<uint64_t, std::list<ResponseCache::Entry>::iterator>::iterator
+ResponseCache::find(Shard& shard, uint64_t hash, const std::string& key) {
+    auto range = shard.index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->key == key) {
+            return it;
+        }
+    }
+    return shard.index.end();
+}
+
+void ResponseCache::erase(Shard& shard,
+                          std::unordered_multimap<uint64_t, std::list<Entry>::iterator>::iterator it) {
+    if (it == shard.index.end()) {
+        return;
+    }
+    shard.bytes -= it->second->bytes;
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+}
+
+size_t ResponseCache::entrySize(const std::string& key, const InferenceResult& result) {
+    return sizeof(Entry) + sizeof(InferenceResult) + key.size() + result.text.size() +
+           result.finishReason.size() + result.logprobs.size() * sizeof(float) +
+           result.tokenIds.size() * sizeof(int32_t) + result.topLogprobs.size() * sizeof(TokenLogprob);
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,143 @@
+/**
+ * @module inference
+ * @purpose Exact-match response cache for deterministic inference requests
+ * @description Caches complete inference results keyed by a hash of model, normalized
+ *              prompt and sampling parameters. Only deterministic requests (greedy or
+ *              fixed seed) are cacheable. Entries are bounded by a byte budget and TTL
+ *              and stored in independently locked shards.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rkllmjs {
+namespace core {
+struct RKLLMModelConfig;
+}
+
+namespace inference {
+
+struct InferenceParams;
+struct InferenceResult;
+
+/**
+ * Response cache configuration
+ */
+struct ResponseCacheConfig {
+    size_t maxBytes = 64 * 1024 * 1024;   // Total budget across all shards
+    int64_t ttlMs = 10 * 60 * 1000;       // Entry lifetime (0 = no expiry)
+    size_t shardCount = 16;               // Independently locked partitions
+};
+
+/**
+ * Response cache counters
+ */
+struct ResponseCacheStats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t insertions = 0;
+    int64_t evictions = 0;
+    int64_t expirations = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+    
+    float hitRate() const {
+        int64_t lookups = hits + misses;
+        return lookups > 0 ? static_cast<float>(hits) / static_cast<float>(lookups) : 0.0f;
+    }
+};
+
+/**
+ * Exact-match response cache
+ *
+ * Thread-safe. Each key maps to one shard; lookups and inserts only lock
+ * that shard. Shards evict least-recently-used entries to stay within
+ * their share of the byte budget and drop expired entries lazily.
+ */
+class ResponseCache {
+public:
+    explicit ResponseCache(const ResponseCacheConfig& config = ResponseCacheConfig());
+    
+    /**
+     * @brief Whether a request produces the same output every time
+     * @param params Request; its sampling fields only apply when the engine samples
+     * @param model Configuration the model was loaded with; plain generation
+     *        samples inside the runtime with its top_k and temperature
+     * @return true for non-session requests that decode greedily or with a fixed
+     *         seed in the engine, or run greedily in the runtime (top_k == 1)
+     * @note Such requests must run without prior KV history. Coalescing and batch
+     *       deduplication rely on this alone.
+     */
+    static bool isDeterministic(const InferenceParams& params, const core::RKLLMModelConfig& model);
+    
+    /**
+     * @brief Whether a request's result may be stored and served from the cache
+     * @return isDeterministic() and the request has not opted out with useCache
+     */
+    static bool isCacheable(const InferenceParams& params, const core::RKLLMModelConfig& model);
+    
+    /**
+     * @brief Build the canonical cache key for a request
+     * @param modelId Stable model identity (e.g. model path)
+     * @param normalizedPrompt Prompt after whitespace normalization
+     * @param params Sampling parameters that influence the output
+     */
+    static std::string makeKey(const std::string& modelId, const std::string& normalizedPrompt,
+                               const InferenceParams& params);
+    
+    // 64-bit FNV-1a hash used for shard selection and bucket lookup
+    static uint64_t hashKey(const std::string& key);
+    
+    bool lookup(const std::string& key, InferenceResult* result);
+    void insert(const std::string& key, const InferenceResult& result);
+    void clear();
+    
+    ResponseCacheStats getStats() const;
+    const ResponseCacheConfig& getConfig() const { return config_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Entry {
+        uint64_t hash = 0;
+        std::string key;
+        std::unique_ptr<InferenceResult> result;
+        size_t bytes = 0;
+        Clock::time_point expiresAt;
+    };
+    
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;   // Front = most recently used
+        std::unordered_multimap<uint64_t, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+        int64_t hits = 0;
+        int64_t misses = 0;
+        int64_t insertions = 0;
+        int64_t evictions = 0;
+        int64_t expirations = 0;
+    };
+    
+    Shard& shardFor(uint64_t hash);
+    std::unordered_multimap<uint64_t, std::list<Entry>::iterator>::iterator
+        find(Shard& shard, uint64_t hash, const std::string& key);
+    void erase(Shard& shard, std::unordered_multimap<uint64_t, std::list<Entry>::iterator>::iterator it);
+    static size_t entrySize(const std::string& key, const InferenceResult& result);
+    
+    ResponseCacheConfig config_;
+    size_t shardBudget_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,204 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "response-cache.hpp"
+#include "inference-engine.hpp"
+#include "../core/rkllm-manager.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static InferenceParams makeGreedyParams(const std::string& prompt) {
+    InferenceParams params;
+    params.prompt = prompt;
+    params.topK = 1;
+    return params;
+}
+
+static InferenceResult makeResult(const std::string& text) {
+    InferenceResult result;
+    result.text = text;
+    result.finishReason = "stop";
+    result.completionTokens = 4;
+    return result;
+}
+
+TEST(ResponseCacheTest, Cacheability) {
+    // Plain generation samples in the runtime with the model's load-time settings
+    core::RKLLMModelConfig sampling;
+    sampling.top_k = 40;
+    core::RKLLMModelConfig greedy;
+    greedy.top_k = 1;
+    
+    InferenceParams params;
+    params.prompt = "Hello";
+    EXPECT_FALSE(ResponseCache::isCacheable(params, sampling));
+    EXPECT_TRUE(ResponseCache::isCacheable(params, greedy));
+    
+    // Request sampling fields do not make runtime sampling deterministic
+    params.topK = 1;
+    params.seed = 42;
+    EXPECT_FALSE(ResponseCache::isCacheable(params, sampling));
+    
+    // Engine-side decoding honours them
+    params.logprobs = true;
+    EXPECT_TRUE(ResponseCache::isCacheable(params, sampling));
+    params.topK = 40;
+    params.seed = -1;
+    EXPECT_FALSE(ResponseCache::isCacheable(params, sampling));
+    params.temperature = 0.0f;
+    EXPECT_TRUE(ResponseCache::isCacheable(params, sampling));
+    
+    params.logprobs = false;
+    params.temperature = 0.7f;
+    params.numBeams = 2;
+    EXPECT_TRUE(ResponseCache::isCacheable(params, sampling));
+    
+    params.sessionId = "chat";
+    EXPECT_FALSE(ResponseCache::isCacheable(params, greedy));
+    params.sessionId.clear();
+    params.useCache = false;
+    EXPECT_FALSE(ResponseCache::isCacheable(params, greedy));
+    
+    // Opting out of the cache still allows identical requests to share one run
+    EXPECT_TRUE(ResponseCache::isDeterministic(params, greedy));
+    params.numBeams = 1;
+    EXPECT_FALSE(ResponseCache::isDeterministic(params, sampling));
+}
+
+TEST(ResponseCacheTest, KeyDistinguishesInputs) {
+    InferenceParams params = makeGreedyParams("Hello");
+    std::string base = ResponseCache::makeKey("model-a", "Hello", params);
+    
+    EXPECT_EQ(base, ResponseCache::makeKey("model-a", "Hello", params));
+    EXPECT_NE(base, ResponseCache::makeKey("model-b", "Hello", params));
+    EXPECT_NE(base, ResponseCache::makeKey("model-a", "Hello!", params));
+    
+    // Field boundaries must not collide
+    EXPECT_NE(ResponseCache::makeKey("ab", "c", params), ResponseCache::makeKey("a", "bc", params));
+    
+    InferenceParams other = params;
+    other.maxTokens = 64;
+    EXPECT_NE(base, ResponseCache::makeKey("model-a", "Hello", other));
+    
+    other = params;
+    other.stopSequences.push_back("\n");
+    EXPECT_NE(base, ResponseCache::makeKey("model-a", "Hello", other));
+}
+
+TEST(ResponseCacheTest, HitAndMiss) {
+    ResponseCache cache;
+    std::string key = ResponseCache::makeKey("model", "Hello", makeGreedyParams("Hello"));
+    
+    InferenceResult result;
+    EXPECT_FALSE(cache.lookup(key, &result));
+    
+    cache.insert(key, makeResult("World"));
+    EXPECT_TRUE(cache.lookup(key, &result));
+    EXPECT_EQ(result.text, "World");
+    EXPECT_EQ(result.completionTokens, 4);
+    
+    ResponseCacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.insertions, 1);
+    EXPECT_EQ(stats.entries, static_cast<size_t>(1));
+    EXPECT_NEAR(stats.hitRate(), 0.5f, 0.001f);
+    
+    cache.clear();
+    EXPECT_FALSE(cache.lookup(key, &result));
+    EXPECT_EQ(cache.getStats().bytes, static_cast<size_t>(0));
+}
+
+TEST(ResponseCacheTest, TtlExpiry) {
+    ResponseCacheConfig config;
+    config.ttlMs = 20;
+    ResponseCache cache(config);
+    
+    cache.insert("key", makeResult("value"));
+    EXPECT_TRUE(cache.lookup("key", nullptr));
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_FALSE(cache.lookup("key", nullptr));
+    EXPECT_EQ(cache.getStats().expirations, 1);
+    EXPECT_EQ(cache.getStats().entries, static_cast<size_t>(0));
+}
+
+TEST(ResponseCacheTest, ByteBudgetEviction) {
+    ResponseCacheConfig config;
+    config.maxBytes = 8 * 1024;
+    config.shardCount = 1;
+    ResponseCache cache(config);
+    
+    std::string text(1024, 'x');
+    for (int i = 0; i < 32; ++i) {
+        cache.insert("key-" + std::to_string(i), makeResult(text));
+    }
+    
+    ResponseCacheStats stats = cache.getStats();
+    EXPECT_LE(stats.bytes, config.maxBytes);
+    EXPECT_GT(stats.evictions, 0);
+    
+    // Most recent entry survives, oldest is gone
+    EXPECT_TRUE(cache.lookup("key-31", nullptr));
+    EXPECT_FALSE(cache.lookup("key-0", nullptr));
+    
+    // Entries larger than a shard's budget are never stored
+    cache.insert("huge", makeResult(std::string(16 * 1024, 'y')));
+    EXPECT_FALSE(cache.lookup("huge", nullptr));
+}
+
+TEST(ResponseCacheTest, ConcurrentAccess) {
+    ResponseCache cache;
+    const int threadCount = 8;
+    const int keysPerThread = 200;
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < keysPerThread; ++i) {
+                std::string key = "t" + std::to_string(t) + "-" + std::to_string(i);
+                cache.insert(key, makeResult(key));
+                InferenceResult result;
+                if (cache.lookup(key, &result) && result.text != key) {
+                    cache.insert("corrupt", makeResult(key));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    ResponseCacheStats stats = cache.getStats();
+    EXPECT_FALSE(cache.lookup("corrupt", nullptr));
+    EXPECT_EQ(stats.insertions, static_cast<int64_t>(threadCount * keysPerThread));
+    EXPECT_EQ(stats.hits, static_cast<int64_t>(threadCount * keysPerThread));
+}
+
+TEST(ResponseCacheTest, EngineIntegration) {
+    auto& managerRef = core::RKLLMManager::getInstance();
+    std::shared_ptr<core::RKLLMManager> manager(&managerRef, [](core::RKLLMManager*){});
+    InferenceEngine engine(manager);
+    
+    EXPECT_FALSE(engine.isResponseCacheEnabled());
+    engine.enableResponseCache();
+    EXPECT_TRUE(engine.isResponseCacheEnabled());
+    
+    InferenceEngine::Stats stats = engine.getStats();
+    EXPECT_EQ(stats.cacheHits, 0);
+    EXPECT_EQ(stats.cacheMisses, 0);
+    
+    engine.disableResponseCache();
+    EXPECT_FALSE(engine.isResponseCacheEnabled());
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
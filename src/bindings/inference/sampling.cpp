@@ -0,0 +1,346 @@
+#include "sampling.hpp"
+#include "simd-ops.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace rkllmjs {
+namespace inference {
+
+// Top-k lists up to this long are collected in the logits pass; longer ones use nth_element
+static const int32_t kMaxCollectedTopK = 256;
+
+size_t SamplingWorkspace::capacityBytes() const {
+    return (weights_.capacity() + keys_.capacity() + row_.capacity()) * sizeof(float) +
+           ids_.capacity() * sizeof(int32_t) + entries_.capacity() * sizeof(std::pair<float, int32_t>);
+}
+
+void SamplingStrategy::sampleBatch(const LogitsView& logits, float temperature, float topP, int32_t topK,
+                                   SamplingWorkspace& workspace, int32_t* tokens) {
+    for (size_t r = 0; r < logits.rows; ++r) {
+        tokens[r] = sample(logits.row(r), temperature, topP, topK, workspace);
+    }
+}
+
+// Temperatures at or below zero are handled by the engine as greedy
+static float inverseTemperature(float temperature) {
+    return 1.0f / std::max(temperature, 1e-3f);
+}
+
+// Draw from the entries that keep(i) accepts, whose weights sum to total
+template <typename Keep>
+static int32_t drawKept(const float* weights, size_t n, float total, std::mt19937& rng, Keep keep) {
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    float remaining = uniform(rng) * total;
+    int32_t last = -1;
+    for (size_t i = 0; i < n; ++i) {
+        if (keep(i)) {
+            last = static_cast<int32_t>(i);
+            remaining -= weights[i];
+            if (remaining < 0.0f) {
+                break;
+            }
+        }
+    }
+    return last; // Rounding can leave a sliver of mass: the last kept token takes it
+}
+
+// Smallest cutoff such that the live entries (weight > 0) with key <= cutoff
+// carry at least target weight. Keys are bucketed by value so only the bucket
+// the cutoff falls in is sorted.
+static float massCutoff(const float* keys, const float* weights, size_t n, float maxKey, float target,
+                        std::vector<std::pair<float, int32_t>>& boundary) {
+    static const size_t kBins = 256;
+    float mass[kBins] = {};
+    float scale = maxKey > 0.0f ? (kBins - 0.001f) / maxKey : 0.0f;
+    auto binOf = [scale](float key) { return std::min(kBins - 1, static_cast<size_t>(key * scale)); };
+    for (size_t i = 0; i < n; ++i) {
+        if (weights[i] > 0.0f) {
+            mass[binOf(keys[i])] += weights[i];
+        }
+    }
+    float covered = 0.0f;
+    size_t cutoffBin = kBins - 1;
+    for (size_t b = 0; b < kBins; ++b) {
+        if (covered + mass[b] >= target) {
+            cutoffBin = b;
+            break;
+        }
+        covered += mass[b];
+    }
+    
+    for (size_t i = 0; i < n; ++i) {
+        if (weights[i] > 0.0f && binOf(keys[i]) == cutoffBin) {
+            boundary.emplace_back(keys[i], static_cast<int32_t>(i));
+        }
+    }
+    std::sort(boundary.begin(), boundary.end());
+    float cutoff = 0.0f;
+    for (const auto& entry : boundary) {
+        cutoff = entry.first;
+        covered += weights[entry.second];
+        if (covered >= target) {
+            break;
+        }
+    }
+    return cutoff;
+}
+
+// Sampling strategies implementation
+int32_t GreedySampling::sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                               SamplingWorkspace& workspace) {
+    (void)temperature; (void)topP; (void)topK; (void)workspace; // Suppress unused parameter warnings
+    if (logits.empty()) {
+        return -1;
+    }
+    return static_cast<int32_t>(std::max_element(logits.begin(), logits.end()) - logits.begin());
+}
+
+int32_t TopKSampling::sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                             SamplingWorkspace& workspace) {
+    (void)topP; // Not used in TopK sampling
+    size_t n = logits.size;
+    size_t k = topK > 0 ? std::min(static_cast<size_t>(topK), n) : n;
+    if (k == 0) {
+        return -1;
+    }
+    float invTemperature = inverseTemperature(temperature);
+    int32_t* ids = workspace.ids(k);
+    float* values = workspace.keys(k);
+    
+    // Short lists come out of the logits pass best first; long ones are partitioned
+    if (k <= static_cast<size_t>(kMaxCollectedTopK)) {
+        if (simd::logSumExp(logits.data, n, k, ids, values) == -std::numeric_limits<float>::infinity()) {
+            return -1;
+        }
+    } else {
+        auto& entries = workspace.entries(n);
+        for (size_t i = 0; i < n; ++i) {
+            entries.emplace_back(-logits[i], static_cast<int32_t>(i));
+        }
+        std::nth_element(entries.begin(), entries.begin() + (k - 1), entries.end());
+        for (size_t j = 0; j < k; ++j) {
+            ids[j] = entries[j].second;
+            values[j] = -entries[j].first;
+        }
+    }
+    
+    float* weights = workspace.weights(k);
+    float total = simd::softmaxWeights(values, k, invTemperature, weights);
+    if (total <= 0.0f) {
+        return -1;
+    }
+    int32_t picked = drawKept(weights, k, total, rng_, [weights](size_t j) { return weights[j] > 0.0f; });
+    return ids[picked];
+}
+
+int32_t TopPSampling::sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                             SamplingWorkspace& workspace) {
+    (void)topK; // Not used in TopP sampling
+    size_t n = logits.size;
+    float invTemperature = inverseTemperature(temperature);
+    float* weights = workspace.weights(n);
+    float total = simd::softmaxWeights(logits.data, n, invTemperature, weights);
+    if (total <= 0.0f) {
+        return -1;
+    }
+    
+    // Rank by distance from the best logit; the nucleus is the closest tokens covering topP of the mass
+    float maxLogit = *std::max_element(logits.begin(), logits.end());
+    float* keys = workspace.keys(n);
+    float maxKey = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = (maxLogit - logits[i]) * invTemperature;
+        maxKey = weights[i] > 0.0f ? std::max(maxKey, keys[i]) : maxKey;
+    }
+    float target = std::min(std::max(topP, 0.0f), 1.0f) * total;
+    float cutoff = massCutoff(keys, weights, n, maxKey, target, workspace.entries(n));
+    
+    float kept = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        kept += keys[i] <= cutoff ? weights[i] : 0.0f;
+    }
+    return drawKept(weights, n, kept, rng_,
+                    [weights, keys, cutoff](size_t i) { return weights[i] > 0.0f && keys[i] <= cutoff; });
+}
+
+MinPSampling::MinPSampling(float minP, uint32_t seed) : minP_(minP), rng_(seed) {}
+
+int32_t MinPSampling::sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                             SamplingWorkspace& workspace) {
+    (void)topP; (void)topK;
+    size_t n = logits.size;
+    float* weights = workspace.weights(n);
+    if (simd::softmaxWeights(logits.data, n, inverseTemperature(temperature), weights) <= 0.0f) {
+        return -1; // Every token is masked
+    }
+    
+    // The most likely token has weight 1, so minP is the cutoff as-is
+    float threshold = std::max(minP_, 0.0f);
+    float kept = simd::sumAtLeast(weights, n, threshold);
+    return drawKept(weights, n, kept, rng_, [weights, threshold](size_t i) { return weights[i] >= threshold; });
+}
+
+TypicalSampling::TypicalSampling(float typicalP, uint32_t seed) : typicalP_(typicalP), rng_(seed) {}
+
+int32_t TypicalSampling::sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                                SamplingWorkspace& workspace) {
+    (void)topP; (void)topK;
+    size_t n = logits.size;
+    float invTemperature = inverseTemperature(temperature);
+    const float* x = logits.data;
+    float* weights = workspace.weights(n);
+    float* deviations = workspace.keys(n);
+    float total = simd::softmaxWeights(x, n, invTemperature, weights);
+    if (total <= 0.0f) {
+        return -1;
+    }
+    
+    // Entropy from the log-weights: H = log Z - sum(w * log w) / Z
+    float maxLogit = *std::max_element(x, x + n);
+    float logTotal = std::log(total);
+    float weighted = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        weighted += weights[i] > 0.0f ? weights[i] * ((x[i] - maxLogit) * invTemperature) : 0.0f;
+    }
+    float entropy = logTotal - weighted / total;
+    
+    // Distance of each token's surprise (-log p) from the entropy
+    float maxDeviation = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float deviation = std::fabs(logTotal - (x[i] - maxLogit) * invTemperature - entropy);
+        deviations[i] = weights[i] > 0.0f ? deviation : std::numeric_limits<float>::infinity();
+        maxDeviation = weights[i] > 0.0f ? std::max(maxDeviation, deviation) : maxDeviation;
+    }
+    float target = std::min(std::max(typicalP_, 0.0f), 1.0f) * total;
+    float cutoff = massCutoff(deviations, weights, n, maxDeviation, target, workspace.entries(n));
+    
+    float kept = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        kept += deviations[i] <= cutoff ? weights[i] : 0.0f;
+    }
+    return drawKept(weights, n, kept, rng_, [deviations, cutoff](size_t i) { return deviations[i] <= cutoff; });
+}
+
+MirostatV2Sampling::MirostatV2Sampling(float tau, float eta, uint32_t seed)
+    : tau_(tau), eta_(eta), mu_(2.0f * tau), rng_(seed) {}
+
+int32_t MirostatV2Sampling::sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                                   SamplingWorkspace& workspace) {
+    (void)topP; (void)topK;
+    size_t n = logits.size;
+    float* weights = workspace.weights(n);
+    float total = simd::softmaxWeights(logits.data, n, inverseTemperature(temperature), weights);
+    if (total <= 0.0f) {
+        return -1;
+    }
+    
+    // Surprise -log2(p) <= mu means weight >= Z * 2^-mu; the most likely token (weight 1) always stays
+    float threshold = std::min(1.0f, total * std::exp2(-mu_));
+    float kept = simd::sumAtLeast(weights, n, threshold);
+    int32_t token = drawKept(weights, n, kept, rng_, [weights, threshold](size_t i) { return weights[i] >= threshold; });
+    
+    // Surprise within the truncated distribution, as in the Mirostat paper
+    sampledToken_ = token;
+    sampledSurprise_ = -std::log2(weights[token] / kept);
+    return token;
+}
+
+void MirostatV2Sampling::accept(int32_t token) {
+    if (token >= 0 && token == sampledToken_) {
+        mu_ -= eta_ * (sampledSurprise_ - tau_);
+    }
+    sampledToken_ = -1;
+}
+
+DrySampling::DrySampling(const DryConfig& config, std::unique_ptr<SamplingStrategy> next)
+    : config_(config), next_(std::move(next)) {}
+
+int32_t DrySampling::sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                            SamplingWorkspace& workspace) {
+    findRepeats();
+    
+    // Rows are only copied when a repeat is penalized
+    lastRow_ = logits;
+    int32_t vocab = static_cast<int32_t>(logits.size);
+    float* row = nullptr;
+    for (size_t i = 0; i < matches_.size(); ++i) {
+        int32_t token = matches_[i].first;
+        if ((i > 0 && matches_[i - 1].first == token) || token < 0 || token >= vocab) {
+            continue; // Only the longest repeat counts
+        }
+        if (!row) {
+            row = workspace.row(logits.size);
+            std::copy(logits.begin(), logits.end(), row);
+            lastRow_ = LogitsSpan(row, logits.size);
+        }
+        int32_t excess = std::min(matches_[i].second - config_.allowedLength, 64);
+        row[token] -= config_.multiplier * std::pow(config_.base, static_cast<float>(excess));
+    }
+    
+    if (next_) {
+        return next_->sample(lastRow_, temperature, topP, topK, workspace);
+    }
+    if (lastRow_.empty()) {
+        return -1;
+    }
+    return static_cast<int32_t>(std::max_element(lastRow_.begin(), lastRow_.end()) - lastRow_.begin());
+}
+
+void DrySampling::accept(int32_t token) {
+    history_.push_back(token);
+    if (next_) {
+        next_->accept(token);
+    }
+}
+
+void DrySampling::findRepeats() {
+    matches_.clear();
+    size_t window = config_.lastN > 0 ? std::min(history_.size(), static_cast<size_t>(config_.lastN))
+                                      : history_.size();
+    if (config_.multiplier <= 0.0f || window < 2) {
+        return;
+    }
+    const std::vector<int32_t>& breakers = config_.sequenceBreakers;
+    auto isBreaker = [&breakers](int32_t token) {
+        return std::find(breakers.begin(), breakers.end(), token) != breakers.end();
+    };
+    
+    // Reversed, the history's end is a prefix: z_[k] is how far the tokens
+    // ending k positions back repeat the tokens ending now
+    reversed_.assign(history_.rbegin(), history_.rbegin() + window);
+    const int32_t* r = reversed_.data();
+    int32_t m = static_cast<int32_t>(window);
+    z_.assign(window, 0);
+    runs_.assign(window + 1, 0);
+    for (int32_t p = m - 1; p >= 0; --p) {
+        runs_[p] = isBreaker(r[p]) ? 0 : runs_[p + 1] + 1;
+    }
+    z_[0] = m;
+    for (int32_t k = 1, left = 0, right = 0; k < m; ++k) {
+        int32_t length = k < right ? std::min(right - k, z_[k - left]) : 0;
+        while (k + length < m && r[length] == r[k + length]) {
+            length++;
+        }
+        z_[k] = length;
+        if (k + length > right) {
+            left = k;
+            right = k + length;
+        }
+    }
+    
+    // The token that followed each earlier occurrence would extend the repeat
+    for (int32_t k = 1; k < m; ++k) {
+        int32_t length = std::min(z_[k], std::min(runs_[k], runs_[0]));
+        if (length >= config_.allowedLength && !isBreaker(r[k - 1])) {
+            matches_.emplace_back(r[k - 1], length);
+        }
+    }
+    std::sort(matches_.begin(), matches_.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first < b.first : a.second > b.second;
+    });
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,263 @@
+/**
+ * @module inference
+ * @purpose Token sampling strategies for logits-mode decoding
+ * @description SamplingStrategy picks the next token from a logits row.
+ *              Rows are read in place through LogitsSpan, and a strided
+ *              LogitsView covers the runtime's [num_tokens × vocab_size]
+ *              buffer so sampleBatch() can pick a token for every row.
+ *              Scratch memory comes from a SamplingWorkspace owned by the
+ *              request; its buffers only grow, so steady-state sampling
+ *              neither copies rows nor allocates.
+ *              Greedy scans the row; top-k collects its k best entries in
+ *              one pass (simd::logSumExp); top-p, min-p, locally typical and
+ *              Mirostat v2 are O(V): one vectorized pass computes the
+ *              tempered softmax weights (simd::softmaxWeights), the cutoff
+ *              is found without sorting the row, and one more pass draws the
+ *              token. Strategies with per-request state (Mirostat's surprise
+ *              target, DRY's token history) learn the kept tokens through
+ *              accept(), so a row that is sampled but not kept does not move
+ *              them. DrySampling penalizes tokens that would extend a
+ *              repetition of earlier output and hands the row to another
+ *              strategy.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Read-only view of one logits row (the runtime's buffer or a vector)
+ */
+struct LogitsSpan {
+    const float* data = nullptr;
+    size_t size = 0;
+    
+    LogitsSpan() = default;
+    LogitsSpan(const float* rowData, size_t rowSize) : data(rowData), size(rowSize) {}
+    LogitsSpan(const std::vector<float>& row) : data(row.data()), size(row.size()) {}
+    
+    const float& operator[](size_t i) const { return data[i]; }
+    const float* begin() const { return data; }
+    const float* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
+/**
+ * Read-only [rows × vocabSize] view whose rows start stride floats apart
+ */
+struct LogitsView {
+    const float* data = nullptr;
+    size_t rows = 0;
+    size_t vocabSize = 0;
+    size_t stride = 0;
+    
+    LogitsView() = default;
+    LogitsView(const float* viewData, size_t numRows, size_t rowSize, size_t rowStride = 0)
+        : data(viewData), rows(numRows), vocabSize(rowSize), stride(rowStride ? rowStride : rowSize) {}
+    
+    LogitsSpan row(size_t i) const { return LogitsSpan(data + i * stride, vocabSize); }
+    LogitsSpan last() const { return row(rows - 1); }
+};
+
+/**
+ * Scratch buffers for sampling, one per request
+ *
+ * Buffers grow to the largest size requested and are never shrunk, so after
+ * the first row of a vocabulary sampling does not allocate. Contents are not
+ * preserved between sample() calls.
+ */
+class SamplingWorkspace {
+public:
+    float* weights(size_t n) { return grow(weights_, n); }
+    float* keys(size_t n) { return grow(keys_, n); }
+    float* row(size_t n) { return grow(row_, n); }          // Adjusted copy of a row (DRY)
+    int32_t* ids(size_t n) { return grow(ids_, n); }
+    
+    // Empty list with room for n (token key, id) entries
+    std::vector<std::pair<float, int32_t>>& entries(size_t n) {
+        entries_.clear();
+        entries_.reserve(n);
+        return entries_;
+    }
+    
+    // Bytes held, to check that sampling has stopped allocating
+    size_t capacityBytes() const;
+
+private:
+    template <typename T>
+    static T* grow(std::vector<T>& buffer, size_t n) {
+        if (buffer.size() < n) {
+            buffer.resize(n);
+        }
+        return buffer.data();
+    }
+    
+    std::vector<float> weights_;
+    std::vector<float> keys_;
+    std::vector<float> row_;
+    std::vector<int32_t> ids_;
+    std::vector<std::pair<float, int32_t>> entries_;
+};
+
+/**
+ * Sampling strategy interface
+ *
+ * One instance per request; not thread-safe.
+ */
+class SamplingStrategy {
+public:
+    virtual ~SamplingStrategy() = default;
+    
+    // Pick a token from one row (-1 when every logit is masked)
+    virtual int32_t sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                           SamplingWorkspace& workspace) = 0;
+    
+    // Pick a token for every row of the view into tokens[0..rows); state moves only through accept()
+    virtual void sampleBatch(const LogitsView& logits, float temperature, float topP, int32_t topK,
+                             SamplingWorkspace& workspace, int32_t* tokens);
+    
+    // Called with each token the reply keeps, in order
+    virtual void accept(int32_t token) { (void)token; }
+    
+    virtual std::string getName() const = 0;
+};
+
+/**
+ * Standard sampling strategies
+ */
+class GreedySampling : public SamplingStrategy {
+public:
+    int32_t sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                   SamplingWorkspace& workspace) override;
+    std::string getName() const override { return "greedy"; }
+};
+
+class TopKSampling : public SamplingStrategy {
+public:
+    explicit TopKSampling(uint32_t seed = std::random_device{}()) : rng_(seed) {}
+    int32_t sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                   SamplingWorkspace& workspace) override;
+    std::string getName() const override { return "top_k"; }
+
+private:
+    std::mt19937 rng_;
+};
+
+class TopPSampling : public SamplingStrategy {
+public:
+    explicit TopPSampling(uint32_t seed = std::random_device{}()) : rng_(seed) {}
+    int32_t sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                   SamplingWorkspace& workspace) override;
+    std::string getName() const override { return "top_p"; }
+
+private:
+    std::mt19937 rng_;
+};
+
+/**
+ * Min-p: keeps tokens at least minP times as likely as the most likely one
+ */
+class MinPSampling : public SamplingStrategy {
+public:
+    MinPSampling(float minP, uint32_t seed);
+    int32_t sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                   SamplingWorkspace& workspace) override;
+    std::string getName() const override { return "min_p"; }
+
+private:
+    float minP_;
+    std::mt19937 rng_;
+};
+
+/**
+ * Locally typical sampling: keeps the tokens whose surprise is closest to the
+ * row's entropy until they cover typicalP of the probability mass
+ */
+class TypicalSampling : public SamplingStrategy {
+public:
+    TypicalSampling(float typicalP, uint32_t seed);
+    int32_t sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                   SamplingWorkspace& workspace) override;
+    std::string getName() const override { return "typical"; }
+
+private:
+    float typicalP_;
+    std::mt19937 rng_;
+};
+
+/**
+ * Mirostat v2: truncates tokens whose surprise exceeds mu and steers mu so the
+ * kept tokens average tau bits of surprise
+ */
+class MirostatV2Sampling : public SamplingStrategy {
+public:
+    MirostatV2Sampling(float tau, float eta, uint32_t seed);
+    int32_t sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                   SamplingWorkspace& workspace) override;
+    void accept(int32_t token) override;
+    std::string getName() const override { return "mirostat_v2"; }
+    
+    float mu() const { return mu_; }
+
+private:
+    float tau_;
+    float eta_;
+    float mu_;                       // Surprise cutoff in bits, starts at 2 * tau
+    std::mt19937 rng_;
+    int32_t sampledToken_ = -1;      // Last sample() and its surprise, applied by accept()
+    float sampledSurprise_ = 0.0f;
+};
+
+/**
+ * DRY ("don't repeat yourself") repetition penalty
+ */
+struct DryConfig {
+    float multiplier = 0.8f;                  // 0 disables the penalty
+    float base = 1.75f;                       // Penalty grows by this factor per extra repeated token
+    int32_t allowedLength = 2;                // Repeats up to this long are free
+    int32_t lastN = 0;                        // Tokens of history searched (0 = all)
+    std::vector<int32_t> sequenceBreakers;    // Repeats never extend across these tokens
+};
+
+/**
+ * Lowers the logit of every token that would extend a repeated sequence of
+ * length L >= allowedLength by multiplier * base^(L - allowedLength), then
+ * samples with the wrapped strategy (greedy when null). Match lengths for all
+ * candidates come from one Z-function pass over the reversed history.
+ */
+class DrySampling : public SamplingStrategy {
+public:
+    DrySampling(const DryConfig& config, std::unique_ptr<SamplingStrategy> next);
+    int32_t sample(LogitsSpan logits, float temperature, float topP, int32_t topK,
+                   SamplingWorkspace& workspace) override;
+    void accept(int32_t token) override;
+    std::string getName() const override { return "dry"; }
+    
+    // Row the last sample() handed on: a penalized copy in the workspace, or the input when nothing repeated
+    LogitsSpan lastRow() const { return lastRow_; }
+
+private:
+    void findRepeats();
+    
+    DryConfig config_;
+    std::unique_ptr<SamplingStrategy> next_;
+    std::vector<int32_t> history_;
+    std::vector<int32_t> reversed_;
+    std::vector<int32_t> z_;
+    std::vector<int32_t> runs_;                       // Non-breaker tokens from each reversed position
+    std::vector<std::pair<int32_t, int32_t>> matches_; // (token, repeat length), longest first per token
+    LogitsSpan lastRow_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,396 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "sampling.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static std::vector<float> logitsOf(const std::vector<float>& probabilities) {
+    std::vector<float> row;
+    for (float p : probabilities) {
+        row.push_back(std::log(p));
+    }
+    return row;
+}
+
+static std::vector<float> randomRow(size_t vocab, uint32_t seed, float spread = 3.0f) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> normal(0.0f, spread);
+    std::vector<float> row(vocab);
+    for (float& value : row) {
+        value = normal(rng);
+    }
+    return row;
+}
+
+TEST(SamplingTest, MinPKeepsTokensNearTheBest) {
+    std::vector<float> row = logitsOf({0.5f, 0.3f, 0.1f, 0.06f, 0.04f});
+    SamplingWorkspace workspace;
+    MinPSampling sampler(0.15f, 42); // Cutoff 0.075: tokens 0-2 survive
+    std::vector<int> counts(row.size(), 0);
+    for (int i = 0; i < 9000; ++i) {
+        counts[sampler.sample(row, 1.0f, 1.0f, 0, workspace)]++;
+    }
+    EXPECT_EQ(counts[3], 0);
+    EXPECT_EQ(counts[4], 0);
+    EXPECT_NEAR(counts[0] / 9000.0, 0.5 / 0.9, 0.03);
+    EXPECT_NEAR(counts[2] / 9000.0, 0.1 / 0.9, 0.03);
+    
+    // A lower temperature sharpens the row: token 2 falls under the cutoff
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_LT(sampler.sample(row, 0.5f, 1.0f, 0, workspace), 2);
+    }
+    
+    std::vector<float> masked(8, -std::numeric_limits<float>::infinity());
+    EXPECT_EQ(sampler.sample(masked, 1.0f, 1.0f, 0, workspace), -1);
+}
+
+TEST(SamplingTest, TypicalMatchesSortedReference) {
+    for (uint32_t seed = 1; seed <= 5; ++seed) {
+        std::vector<float> row = randomRow(3000, seed);
+        const float typicalP = 0.4f;
+        
+        // Reference: sort by |surprise - entropy| and take tokens until typicalP of the mass
+        double maxLogit = *std::max_element(row.begin(), row.end());
+        std::vector<double> probabilities(row.size());
+        double total = 0.0;
+        for (size_t i = 0; i < row.size(); ++i) {
+            probabilities[i] = std::exp(row[i] - maxLogit);
+            total += probabilities[i];
+        }
+        double entropy = 0.0;
+        for (double& p : probabilities) {
+            p /= total;
+            entropy -= p > 0.0 ? p * std::log(p) : 0.0;
+        }
+        std::vector<size_t> order(row.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return std::fabs(-std::log(probabilities[a]) - entropy) < std::fabs(-std::log(probabilities[b]) - entropy);
+        });
+        std::set<int32_t> expected;
+        double covered = 0.0;
+        for (size_t i : order) {
+            expected.insert(static_cast<int32_t>(i));
+            covered += probabilities[i];
+            if (covered >= typicalP) {
+                break;
+            }
+        }
+        
+        SamplingWorkspace workspace;
+        TypicalSampling sampler(typicalP, seed);
+        std::set<int32_t> drawn;
+        for (int i = 0; i < 4000; ++i) {
+            drawn.insert(sampler.sample(row, 1.0f, 1.0f, 0, workspace));
+        }
+        for (int32_t token : drawn) {
+            EXPECT_TRUE(expected.count(token) == 1);
+        }
+        EXPECT_GT(drawn.size(), expected.size() / 2); // Not collapsed onto a few tokens
+    }
+}
+
+TEST(SamplingTest, TopKAndTopPKeepTheirCandidates) {
+    SamplingWorkspace workspace;
+    std::vector<float> row = logitsOf({0.05f, 0.4f, 0.05f, 0.3f, 0.2f});
+    
+    TopKSampling topK(1);
+    std::vector<int> counts(row.size(), 0);
+    for (int i = 0; i < 7000; ++i) {
+        counts[topK.sample(row, 1.0f, 1.0f, 2, workspace)]++;
+    }
+    EXPECT_EQ(counts[0] + counts[2] + counts[4], 0);
+    EXPECT_NEAR(counts[1] / 7000.0, 0.4 / 0.7, 0.03);
+    
+    // The nucleus stops at the token that crosses topP
+    TopPSampling topP(1);
+    counts.assign(row.size(), 0);
+    for (int i = 0; i < 9000; ++i) {
+        counts[topP.sample(row, 1.0f, 0.8f, 0, workspace)]++;
+    }
+    EXPECT_EQ(counts[0] + counts[2], 0);
+    EXPECT_NEAR(counts[4] / 9000.0, 0.2 / 0.9, 0.03);
+    
+    // Lists longer than the collected top entries take the partition path
+    std::vector<float> wide = randomRow(5000, 4);
+    std::vector<float> sorted = wide;
+    std::sort(sorted.begin(), sorted.end(), std::greater<float>());
+    for (int32_t k : {40, 300}) {
+        for (int i = 0; i < 500; ++i) {
+            int32_t token = topK.sample(wide, 2.0f, 1.0f, k, workspace);
+            EXPECT_GE(wide[token], sorted[k - 1]);
+        }
+    }
+    
+    // Random rows against a sorted reference nucleus
+    for (uint32_t seed = 1; seed <= 3; ++seed) {
+        std::vector<float> random = randomRow(3000, seed + 10, 2.0f);
+        std::vector<float> ordered = random;
+        std::sort(ordered.begin(), ordered.end(), std::greater<float>());
+        double total = 0.0;
+        for (float logit : ordered) {
+            total += std::exp(static_cast<double>(logit) - ordered[0]);
+        }
+        double covered = 0.0;
+        float lowest = ordered[0];
+        for (float logit : ordered) {
+            lowest = logit;
+            covered += std::exp(static_cast<double>(logit) - ordered[0]) / total;
+            if (covered >= 0.5) {
+                break;
+            }
+        }
+        for (int i = 0; i < 2000; ++i) {
+            EXPECT_GE(random[topP.sample(random, 1.0f, 0.5f, 0, workspace)], lowest);
+        }
+    }
+}
+
+TEST(SamplingTest, MirostatV2SteersSurpriseToTau) {
+    // Zipf-like row over 2000 tokens, about 8 bits of entropy
+    std::vector<float> row(2000);
+    for (size_t i = 0; i < row.size(); ++i) {
+        row[i] = -1.1f * std::log(static_cast<float>(i + 1));
+    }
+    const float tau = 3.0f;
+    const float eta = 0.1f;
+    const int steps = 3000;
+    SamplingWorkspace workspace;
+    MirostatV2Sampling sampler(tau, eta, 7);
+    EXPECT_EQ(sampler.mu(), 2.0f * tau);
+    
+    // mu moves by -eta * (surprise - tau), so its drift gives the mean surprise
+    for (int i = 0; i < 200; ++i) {
+        sampler.accept(sampler.sample(row, 1.0f, 1.0f, 0, workspace));
+    }
+    float start = sampler.mu();
+    for (int i = 0; i < steps; ++i) {
+        sampler.accept(sampler.sample(row, 1.0f, 1.0f, 0, workspace));
+    }
+    float meanSurprise = tau - (sampler.mu() - start) / (eta * steps);
+    EXPECT_NEAR(meanSurprise, tau, 0.05f);
+    EXPECT_GT(sampler.mu(), 0.0f);
+    
+    // Only a token the reply keeps moves the target
+    float mu = sampler.mu();
+    int32_t token = sampler.sample(row, 1.0f, 1.0f, 0, workspace);
+    sampler.accept(token + 1);
+    EXPECT_EQ(sampler.mu(), mu);
+    sampler.accept(token);
+    EXPECT_EQ(sampler.mu(), mu);
+}
+
+// Longest repeat each token would extend, by brute force
+static std::vector<int32_t> referenceRepeats(const std::vector<int32_t>& history, int32_t vocab) {
+    std::vector<int32_t> longest(vocab, 0);
+    int32_t n = static_cast<int32_t>(history.size());
+    for (int32_t next = 1; next < n; ++next) {
+        int32_t length = 0;
+        while (length < next && history[next - 1 - length] == history[n - 1 - length]) {
+            length++;
+        }
+        longest[history[next]] = std::max(longest[history[next]], length);
+    }
+    return longest;
+}
+
+TEST(SamplingTest, DryPenalizesTokensThatExtendRepeats) {
+    DryConfig config;
+    config.multiplier = 0.8f;
+    config.base = 1.75f;
+    config.allowedLength = 2;
+    std::vector<float> row(8, 0.0f);
+    row[4] = 0.5f;
+    
+    // "1 2 3 4 1 2 3": a 4 would extend a 3-token repeat
+    SamplingWorkspace workspace;
+    DrySampling dry(config, nullptr);
+    for (int32_t token : {1, 2, 3, 4, 1, 2, 3}) {
+        dry.accept(token);
+    }
+    int32_t chosen = dry.sample(row, 1.0f, 1.0f, 0, workspace);
+    EXPECT_NEAR(dry.lastRow()[4], 0.5f - 0.8f * 1.75f, 1e-5f);
+    EXPECT_NE(chosen, 4);
+    for (int32_t token : {0, 1, 2, 3, 5, 6, 7}) {
+        EXPECT_EQ(dry.lastRow()[token], row[token]);
+    }
+    
+    // A breaker inside the repeat cuts it below the allowed length
+    config.sequenceBreakers = {2};
+    DrySampling broken(config, nullptr);
+    for (int32_t token : {1, 2, 3, 4, 1, 2, 3}) {
+        broken.accept(token);
+    }
+    EXPECT_EQ(broken.sample(row, 1.0f, 1.0f, 0, workspace), 4);
+    EXPECT_EQ(broken.lastRow().data, row.data()); // Nothing penalized: the row is passed on uncopied
+    
+    // Random histories against the brute-force repeat lengths
+    std::mt19937 rng(3);
+    for (int round = 0; round < 50; ++round) {
+        config.sequenceBreakers.clear();
+        config.allowedLength = 1;
+        config.base = 2.0f;
+        config.multiplier = 1.0f;
+        DrySampling sampler(config, std::make_unique<GreedySampling>());
+        std::vector<int32_t> history;
+        for (int i = 0; i < 200; ++i) {
+            int32_t token = static_cast<int32_t>(rng() % 4);
+            history.push_back(token);
+            sampler.accept(token);
+        }
+        std::vector<float> flat(4, 0.0f);
+        sampler.sample(flat, 1.0f, 1.0f, 0, workspace);
+        std::vector<int32_t> repeats = referenceRepeats(history, 4);
+        for (int32_t token = 0; token < 4; ++token) {
+            float expected = repeats[token] >= 1 ? -std::pow(2.0f, static_cast<float>(std::min(repeats[token] - 1, 64))) : 0.0f;
+            EXPECT_NEAR(sampler.lastRow()[token], expected, 1e-3f * std::max(1.0f, std::fabs(expected)));
+        }
+    }
+}
+
+TEST(SamplingTest, BatchSamplesStridedRowsWithoutAllocating) {
+    // Four rows of 1000 logits, 1024 floats apart like a padded runtime buffer
+    const size_t vocab = 1000;
+    const size_t stride = 1024;
+    std::vector<float> buffer(4 * stride, 100.0f); // Padding would win if it were read
+    for (size_t r = 0; r < 4; ++r) {
+        std::vector<float> row = randomRow(vocab, static_cast<uint32_t>(r + 1));
+        row[r * 100] = 20.0f;
+        std::copy(row.begin(), row.end(), buffer.begin() + r * stride);
+    }
+    LogitsView view(buffer.data(), 4, vocab, stride);
+    EXPECT_EQ(view.last().data, buffer.data() + 3 * stride);
+    
+    SamplingWorkspace workspace;
+    int32_t tokens[4];
+    GreedySampling greedy;
+    greedy.sampleBatch(view, 1.0f, 1.0f, 0, workspace, tokens);
+    for (int32_t r = 0; r < 4; ++r) {
+        EXPECT_EQ(tokens[r], r * 100);
+    }
+    
+    // Batched and row-by-row sampling agree for the same seed
+    MinPSampling batched(0.01f, 99);
+    MinPSampling single(0.01f, 99);
+    batched.sampleBatch(view, 1.0f, 1.0f, 0, workspace, tokens);
+    for (size_t r = 0; r < 4; ++r) {
+        EXPECT_EQ(tokens[r], single.sample(view.row(r), 1.0f, 1.0f, 0, workspace));
+    }
+    
+    // Once the workspace has seen the vocabulary, no strategy grows it
+    std::vector<std::unique_ptr<SamplingStrategy>> strategies;
+    strategies.push_back(std::make_unique<TopKSampling>(1));
+    strategies.push_back(std::make_unique<TopPSampling>(1));
+    strategies.push_back(std::make_unique<MinPSampling>(0.05f, 1));
+    strategies.push_back(std::make_unique<TypicalSampling>(0.9f, 1));
+    strategies.push_back(std::make_unique<MirostatV2Sampling>(5.0f, 0.1f, 1));
+    strategies.push_back(std::make_unique<DrySampling>(DryConfig(), std::make_unique<TopPSampling>(1)));
+    for (auto& strategy : strategies) {
+        for (int32_t token : {1, 2, 1, 2}) {
+            strategy->accept(token); // A repeat, so DRY's penalized copy is warm too
+        }
+        strategy->sampleBatch(view, 0.8f, 0.9f, 300, workspace, tokens);
+    }
+    size_t capacity = workspace.capacityBytes();
+    for (int round = 0; round < 20; ++round) {
+        for (auto& strategy : strategies) {
+            strategy->sampleBatch(view, 0.8f, 0.9f, 300, workspace, tokens);
+            strategy->accept(tokens[round % 4]);
+            for (int32_t token : tokens) {
+                EXPECT_GE(token, 0);
+                EXPECT_LT(token, static_cast<int32_t>(vocab));
+            }
+        }
+    }
+    EXPECT_EQ(workspace.capacityBytes(), capacity);
+}
+
+TEST(SamplingTest, LargeVocabularyBenchmark) {
+    const size_t vocab = 150000;
+    std::vector<float> row = randomRow(vocab, 11);
+    std::vector<int32_t> history;
+    std::mt19937 rng(5);
+    for (int i = 0; i < 512; ++i) {
+        history.push_back(static_cast<int32_t>(rng() % 2000));
+    }
+    
+    SamplingWorkspace workspace;
+    auto measure = [&row, &workspace](SamplingStrategy& sampler, int iterations) {
+        int32_t token = -1;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            token = sampler.sample(row, 0.8f, 0.9f, 40, workspace);
+            sampler.accept(token);
+        }
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_GE(token, 0);
+        EXPECT_LT(token, 150000);
+        std::cout << "[Sampling] " << sampler.getName() << " over 150k vocab: " << micros / iterations << " us/token"
+                  << std::endl;
+    };
+    
+    GreedySampling greedy;
+    TopKSampling topK;
+    TopPSampling topP;
+    MinPSampling minP(0.05f, 1);
+    TypicalSampling typical(0.9f, 1);
+    MirostatV2Sampling mirostat(5.0f, 0.1f, 1);
+    DryConfig config;
+    DrySampling dry(config, std::make_unique<MinPSampling>(0.05f, 1));
+    for (int32_t token : history) {
+        dry.accept(token);
+    }
+    measure(greedy, 50);
+    measure(topK, 50);
+    measure(topP, 50);
+    measure(minP, 50);
+    measure(typical, 50);
+    measure(mirostat, 50);
+    measure(dry, 50);
+    
+    // Batched decode: eight rows read in place versus copying each row out first
+    const size_t rows = 8;
+    std::vector<float> batch(rows * vocab);
+    for (size_t r = 0; r < rows; ++r) {
+        std::copy(row.begin(), row.end(), batch.begin() + r * vocab);
+    }
+    LogitsView view(batch.data(), rows, vocab);
+    int32_t tokens[rows];
+    std::vector<float> copy;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i) {
+        for (size_t r = 0; r < rows; ++r) {
+            copy.assign(view.row(r).begin(), view.row(r).end());
+            tokens[r] = minP.sample(copy, 0.8f, 0.9f, 40, workspace);
+        }
+    }
+    double copied = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i) {
+        minP.sampleBatch(view, 0.8f, 0.9f, 40, workspace, tokens);
+    }
+    double inPlace = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_GE(tokens[rows - 1], 0);
+    std::cout << "[Sampling] min_p batch of 8 x 150k: " << inPlace / (10 * rows) << " us/row in place, "
+              << copied / (10 * rows) << " us/row with a copy" << std::endl;
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
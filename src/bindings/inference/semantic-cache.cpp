@@ -0,0 +1,327 @@
+#include "semantic-cache.hpp"
+#include "inference-engine.hpp"
+#include "simd-ops.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <queue>
+
+namespace rkllmjs {
+namespace inference {
+
+SemanticCache::SemanticCache(const SemanticCacheConfig& config)
+    : config_(config)
+    , rng_(config.seed) {
+    config_.m = std::max(config_.m, 2);
+    config_.efConstruction = std::max(config_.efConstruction, config_.m);
+    config_.efSearch = std::max(config_.efSearch, 1);
+    levelMultiplier_ = 1.0 / std::log(static_cast<double>(config_.m));
+}
+
+SemanticCache::~SemanticCache() = default;
+
+bool SemanticCache::lookup(const float* embedding, size_t dim, InferenceResult* result, float* similarity,
+                           uint64_t filter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto startTime = std::chrono::steady_clock::now();
+    
+    float bestSimilarity = -1.0f;
+    uint32_t bestId = 0;
+    bool found = false;
+    
+    if (embedding && dim == dim_ && !lru_.empty()) {
+        query_.assign(embedding, embedding + dim);
+        if (simd::normalize(query_.data(), dim) > 0.0f) {
+            uint32_t entry = greedyClosest(query_.data(), entryPoint_, maxLevel_, 1);
+            
+            // Closest live node with the same filter among the layer-0 candidates;
+            // tombstones and other filters only route
+            for (const Candidate& candidate : searchLayer(query_.data(), entry, config_.efSearch, 0)) {
+                if (!nodes_[candidate.id].deleted && nodes_[candidate.id].filter == filter) {
+                    bestSimilarity = 1.0f - candidate.distance;
+                    bestId = candidate.id;
+                    found = true;
+                    break;
+                }
+            }
+        }
+    }
+    
+    bool hit = found && bestSimilarity >= config_.similarityThreshold;
+    if (hit) {
+        Node& node = nodes_[bestId];
+        lru_.splice(lru_.begin(), lru_, node.lruPos);
+        if (result) {
+            *result = *node.result;
+        }
+        stats_.hits++;
+    } else {
+        stats_.misses++;
+    }
+    
+    if (similarity) {
+        *similarity = bestSimilarity;
+    }
+    
+    double elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+    stats_.totalLookupUs += elapsedUs;
+    stats_.maxLookupUs = std::max(stats_.maxLookupUs, elapsedUs);
+    return hit;
+}
+
+void SemanticCache::insert(const float* embedding, size_t dim, const InferenceResult& result, uint64_t filter) {
+    if (!embedding || dim == 0 || config_.maxEntries == 0) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (dim != dim_) {
+        reset(dim);
+    }
+    
+    query_.assign(embedding, embedding + dim);
+    if (simd::normalize(query_.data(), dim) == 0.0f) {
+        return; // Zero vector has no direction to compare
+    }
+    
+    insertNode(query_.data(), std::make_unique<InferenceResult>(result), filter);
+    stats_.insertions++;
+    
+    while (lru_.size() > config_.maxEntries) {
+        evictLeastRecentlyUsed();
+    }
+    if (tombstones_ > config_.maxEntries / 2) {
+        rebuild();
+    }
+}
+
+void SemanticCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reset(0);
+}
+
+SemanticCacheStats SemanticCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SemanticCacheStats stats = stats_;
+    stats.entries = lru_.size();
+    stats.indexBytes = indexBytes();
+    return stats;
+}
+
+float SemanticCache::distance(const float* query, uint32_t id) const {
+    return 1.0f - simd::dot(query, vectorOf(id), dim_);
+}
+
+int32_t SemanticCache::randomLevel() {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    double r = 1.0 - uniform(rng_); // (0, 1]
+    return static_cast<int32_t>(-std::log(r) * levelMultiplier_);
+}
+
+void SemanticCache::insertNode(const float* vector, std::unique_ptr<InferenceResult> result, uint64_t filter) {
+    uint32_t id = static_cast<uint32_t>(nodes_.size());
+    vectors_.insert(vectors_.end(), vector, vector + dim_);
+    visited_.push_back(0);
+    
+    nodes_.emplace_back();
+    Node& node = nodes_.back();
+    node.level = randomLevel();
+    node.links.resize(node.level + 1);
+    node.result = std::move(result);
+    node.filter = filter;
+    lru_.push_front(id);
+    node.lruPos = lru_.begin();
+    
+    int32_t level = node.level;
+    if (maxLevel_ < 0) {
+        entryPoint_ = id;
+        maxLevel_ = level;
+        return;
+    }
+    
+    const float* query = vectorOf(id);
+    uint32_t entry = greedyClosest(query, entryPoint_, maxLevel_, level + 1);
+    
+    for (int32_t l = std::min(level, maxLevel_); l >= 0; --l) {
+        std::vector<Candidate> candidates = searchLayer(query, entry, config_.efConstruction, l);
+        connect(id, candidates, l);
+        if (!candidates.empty()) {
+            entry = candidates.front().id;
+        }
+    }
+    
+    if (level > maxLevel_) {
+        entryPoint_ = id;
+        maxLevel_ = level;
+    }
+}
+
+uint32_t SemanticCache::greedyClosest(const float* query, uint32_t entry, int32_t fromLevel, int32_t toLevel) const {
+    uint32_t current = entry;
+    float currentDistance = distance(query, current);
+    
+    for (int32_t l = fromLevel; l >= toLevel; --l) {
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            for (uint32_t neighbour : nodes_[current].links[l]) {
+                float d = distance(query, neighbour);
+                if (d < currentDistance) {
+                    currentDistance = d;
+                    current = neighbour;
+                    improved = true;
+                }
+            }
+        }
+    }
+    return current;
+}
+
+std::vector<SemanticCache::Candidate> SemanticCache::searchLayer(const float* query, uint32_t entry,
+                                                                 int32_t ef, int32_t level) const {
+    if (++visitEpoch_ == 0) {
+        std::fill(visited_.begin(), visited_.end(), 0);
+        visitEpoch_ = 1;
+    }
+    
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> frontier;
+    std::priority_queue<Candidate> best; // Max-heap: top is the worst kept result
+    
+    Candidate start{distance(query, entry), entry};
+    frontier.push(start);
+    best.push(start);
+    visited_[entry] = visitEpoch_;
+    
+    while (!frontier.empty()) {
+        Candidate current = frontier.top();
+        if (current.distance > best.top().distance && static_cast<int32_t>(best.size()) >= ef) {
+            break;
+        }
+        frontier.pop();
+        
+        for (uint32_t neighbour : nodes_[current.id].links[level]) {
+            if (visited_[neighbour] == visitEpoch_) {
+                continue;
+            }
+            visited_[neighbour] = visitEpoch_;
+            
+            float d = distance(query, neighbour);
+            if (static_cast<int32_t>(best.size()) < ef || d < best.top().distance) {
+                frontier.push({d, neighbour});
+                best.push({d, neighbour});
+                if (static_cast<int32_t>(best.size()) > ef) {
+                    best.pop();
+                }
+            }
+        }
+    }
+    
+    std::vector<Candidate> results(best.size());
+    for (size_t i = results.size(); i-- > 0;) {
+        results[i] = best.top();
+        best.pop();
+    }
+    return results;
+}
+
+void SemanticCache::connect(uint32_t id, const std::vector<Candidate>& candidates, int32_t level) {
+    size_t maxLinks = static_cast<size_t>(level == 0 ? 2 * config_.m : config_.m);
+    
+    std::vector<uint32_t>& links = nodes_[id].links[level];
+    for (const Candidate& candidate : candidates) {
+        if (links.size() >= maxLinks) {
+            break;
+        }
+        if (candidate.id != id) {
+            links.push_back(candidate.id);
+        }
+    }
+    
+    for (uint32_t neighbour : links) {
+        nodes_[neighbour].links[level].push_back(id);
+        if (nodes_[neighbour].links[level].size() > maxLinks) {
+            shrinkLinks(neighbour, level);
+        }
+    }
+}
+
+void SemanticCache::shrinkLinks(uint32_t id, int32_t level) {
+    size_t maxLinks = static_cast<size_t>(level == 0 ? 2 * config_.m : config_.m);
+    std::vector<uint32_t>& links = nodes_[id].links[level];
+    const float* base = vectorOf(id);
+    
+    std::vector<Candidate> ranked;
+    ranked.reserve(links.size());
+    for (uint32_t neighbour : links) {
+        ranked.push_back({distance(base, neighbour), neighbour});
+    }
+    std::partial_sort(ranked.begin(), ranked.begin() + maxLinks, ranked.end());
+    
+    links.resize(maxLinks);
+    for (size_t i = 0; i < maxLinks; ++i) {
+        links[i] = ranked[i].id;
+    }
+}
+
+void SemanticCache::evictLeastRecentlyUsed() {
+    uint32_t id = lru_.back();
+    lru_.pop_back();
+    
+    Node& node = nodes_[id];
+    node.deleted = true;
+    node.result.reset();
+    tombstones_++;
+    stats_.evictions++;
+}
+
+void SemanticCache::rebuild() {
+    // Re-insert oldest first so the newest entry ends up at the LRU front
+    std::vector<float> vectors;
+    std::vector<std::unique_ptr<InferenceResult>> results;
+    std::vector<uint64_t> filters;
+    vectors.reserve(lru_.size() * dim_);
+    results.reserve(lru_.size());
+    filters.reserve(lru_.size());
+    for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+        const float* vector = vectorOf(*it);
+        vectors.insert(vectors.end(), vector, vector + dim_);
+        results.push_back(std::move(nodes_[*it].result));
+        filters.push_back(nodes_[*it].filter);
+    }
+    
+    reset(dim_);
+    for (size_t i = 0; i < results.size(); ++i) {
+        insertNode(vectors.data() + i * dim_, std::move(results[i]), filters[i]);
+    }
+    stats_.rebuilds++;
+}
+
+void SemanticCache::reset(size_t dim) {
+    dim_ = dim;
+    vectors_.clear();
+    nodes_.clear();
+    lru_.clear();
+    visited_.clear();
+    entryPoint_ = 0;
+    maxLevel_ = -1;
+    tombstones_ = 0;
+}
+
+size_t SemanticCache::indexBytes() const {
+    size_t bytes = vectors_.capacity() * sizeof(float) + visited_.capacity() * sizeof(uint32_t) +
+                   nodes_.capacity() * sizeof(Node);
+    for (const Node& node : nodes_) {
+        for (const auto& links : node.links) {
+            bytes += links.capacity() * sizeof(uint32_t);
+        }
+        if (node.result) {
+            bytes += sizeof(InferenceResult) + node.result->text.capacity();
+        }
+    }
+    return bytes;
+}
+
+} // namespace inference
+} // namespace rkllmjs
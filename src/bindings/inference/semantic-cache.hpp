@@ -0,0 +1,156 @@
+/**
+ * @module inference
+ * @purpose Semantic response cache keyed by prompt embeddings
+ * @description Stores inference results alongside the prompt embedding produced
+ *              by RKLLM_INFER_GET_LAST_HIDDEN_LAYER. Lookups search an in-process
+ *              HNSW graph with SIMD cosine similarity and return the closest cached
+ *              answer above a similarity threshold, so paraphrased questions skip
+ *              full decoding. The number of entries is bounded with LRU eviction.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+struct InferenceResult;
+
+/**
+ * Semantic cache configuration
+ */
+struct SemanticCacheConfig {
+    float similarityThreshold = 0.95f; // Minimum cosine similarity for a hit
+    size_t maxEntries = 4096;          // Live entries kept before LRU eviction
+    int32_t m = 16;                    // HNSW links per node (2*m on layer 0)
+    int32_t efConstruction = 100;      // Candidate list size while inserting
+    int32_t efSearch = 48;             // Candidate list size while searching
+    uint32_t seed = 42;                // Level generator seed (reproducible graphs)
+};
+
+/**
+ * Semantic cache counters
+ */
+struct SemanticCacheStats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t insertions = 0;
+    int64_t evictions = 0;
+    int64_t rebuilds = 0;
+    size_t entries = 0;
+    size_t indexBytes = 0;
+    double totalLookupUs = 0.0;
+    double maxLookupUs = 0.0;
+    
+    float hitRate() const {
+        int64_t lookups = hits + misses;
+        return lookups > 0 ? static_cast<float>(hits) / static_cast<float>(lookups) : 0.0f;
+    }
+    
+    double averageLookupUs() const {
+        int64_t lookups = hits + misses;
+        return lookups > 0 ? totalLookupUs / static_cast<double>(lookups) : 0.0;
+    }
+};
+
+/**
+ * Embedding-keyed response cache backed by an HNSW index
+ *
+ * Thread-safe; a single mutex guards the graph. Vectors are normalized on
+ * entry so cosine similarity reduces to a dot product. Evicted nodes stay
+ * in the graph as routing-only tombstones until they outnumber half of
+ * maxEntries, at which point the graph is rebuilt from the live entries.
+ * All embeddings must share one dimension; a different dimension (i.e. a
+ * different model) resets the cache.
+ */
+class SemanticCache {
+public:
+    explicit SemanticCache(const SemanticCacheConfig& config = SemanticCacheConfig());
+    ~SemanticCache();
+    
+    /**
+     * @brief Find the cached result closest to an embedding
+     * @param embedding Prompt embedding (any norm)
+     * @param dim Embedding dimension
+     * @param result Receives the cached result on a hit (may be null)
+     * @param similarity Receives the best similarity found (may be null)
+     * @param filter Only entries inserted with the same filter can match
+     * @return true if the best match meets the similarity threshold
+     */
+    bool lookup(const float* embedding, size_t dim, InferenceResult* result, float* similarity = nullptr,
+                uint64_t filter = 0);
+    
+    /**
+     * @brief Add a result under its prompt embedding
+     * @param filter Tag of the settings that shaped the result (e.g. a hash of
+     *        maxTokens, stop sequences and sampling parameters)
+     */
+    void insert(const float* embedding, size_t dim, const InferenceResult& result, uint64_t filter = 0);
+    
+    void clear();
+    
+    SemanticCacheStats getStats() const;
+    const SemanticCacheConfig& getConfig() const { return config_; }
+
+private:
+    struct Node {
+        int32_t level = 0;
+        bool deleted = false;
+        uint64_t filter = 0;
+        std::vector<std::vector<uint32_t>> links;   // links[layer] = neighbour ids
+        std::unique_ptr<InferenceResult> result;
+        std::list<uint32_t>::iterator lruPos;
+    };
+    
+    struct Candidate {
+        float distance;
+        uint32_t id;
+        bool operator<(const Candidate& other) const { return distance < other.distance; }
+        bool operator>(const Candidate& other) const { return distance > other.distance; }
+    };
+    
+    const float* vectorOf(uint32_t id) const { return vectors_.data() + static_cast<size_t>(id) * dim_; }
+    float distance(const float* query, uint32_t id) const;
+    int32_t randomLevel();
+    
+    void insertNode(const float* vector, std::unique_ptr<InferenceResult> result, uint64_t filter);
+    uint32_t greedyClosest(const float* query, uint32_t entry, int32_t fromLevel, int32_t toLevel) const;
+    std::vector<Candidate> searchLayer(const float* query, uint32_t entry, int32_t ef, int32_t level) const;
+    void connect(uint32_t id, const std::vector<Candidate>& candidates, int32_t level);
+    void shrinkLinks(uint32_t id, int32_t level);
+    void evictLeastRecentlyUsed();
+    void rebuild();
+    void reset(size_t dim);
+    size_t indexBytes() const;
+    
+    SemanticCacheConfig config_;
+    double levelMultiplier_;
+    std::mt19937 rng_;
+    
+    mutable std::mutex mutex_;
+    size_t dim_ = 0;
+    std::vector<float> vectors_;       // Row-major, one normalized vector per node
+    std::vector<Node> nodes_;
+    std::list<uint32_t> lru_;          // Live node ids, front = most recently used
+    uint32_t entryPoint_ = 0;
+    int32_t maxLevel_ = -1;            // -1 = empty graph
+    size_t tombstones_ = 0;
+    
+    // Visited marks reused across searches to avoid per-query allocation
+    mutable std::vector<uint32_t> visited_;
+    mutable uint32_t visitEpoch_ = 0;
+    std::vector<float> query_;         // Normalized copy of the current query
+    
+    SemanticCacheStats stats_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,194 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "semantic-cache.hpp"
+#include "inference-engine.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static std::vector<float> randomVector(std::mt19937& rng, size_t dim) {
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<float> v(dim);
+    for (auto& x : v) {
+        x = normal(rng);
+    }
+    return v;
+}
+
+// Small perturbation of a vector, standing in for a paraphrased prompt
+static std::vector<float> perturb(std::mt19937& rng, const std::vector<float>& v, float amount) {
+    std::normal_distribution<float> normal(0.0f, amount);
+    std::vector<float> out(v);
+    for (auto& x : out) {
+        x += normal(rng);
+    }
+    return out;
+}
+
+static InferenceResult makeResult(const std::string& text) {
+    InferenceResult result;
+    result.text = text;
+    result.finishReason = "completed";
+    return result;
+}
+
+TEST(SemanticCacheTest, HitAboveThresholdOnly) {
+    std::mt19937 rng(1);
+    SemanticCacheConfig config;
+    config.similarityThreshold = 0.9f;
+    SemanticCache cache(config);
+    
+    std::vector<float> question = randomVector(rng, 64);
+    cache.insert(question.data(), question.size(), makeResult("answer"));
+    
+    // Same direction, different norm: exact semantic match
+    std::vector<float> scaled(question);
+    for (auto& x : scaled) {
+        x *= 3.0f;
+    }
+    InferenceResult result;
+    float similarity = 0.0f;
+    EXPECT_TRUE(cache.lookup(scaled.data(), scaled.size(), &result, &similarity));
+    EXPECT_EQ(result.text, "answer");
+    EXPECT_NEAR(similarity, 1.0f, 1e-4f);
+    
+    // Paraphrase: close but not identical
+    std::vector<float> paraphrase = perturb(rng, question, 0.1f);
+    EXPECT_TRUE(cache.lookup(paraphrase.data(), paraphrase.size(), nullptr, &similarity));
+    EXPECT_GE(similarity, 0.9f);
+    
+    // Unrelated question
+    std::vector<float> unrelated = randomVector(rng, 64);
+    EXPECT_FALSE(cache.lookup(unrelated.data(), unrelated.size(), nullptr, &similarity));
+    EXPECT_LT(similarity, 0.9f);
+    
+    SemanticCacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 2);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_GT(stats.totalLookupUs, 0.0);
+}
+
+TEST(SemanticCacheTest, FilterSeparatesSettings) {
+    std::mt19937 rng(3);
+    SemanticCache cache;
+    
+    // The same question answered under two different maxTokens settings
+    std::vector<float> question = randomVector(rng, 32);
+    cache.insert(question.data(), question.size(), makeResult("short"), 1);
+    cache.insert(question.data(), question.size(), makeResult("long"), 2);
+    
+    InferenceResult result;
+    EXPECT_TRUE(cache.lookup(question.data(), question.size(), &result, nullptr, 2));
+    EXPECT_EQ(result.text, "long");
+    EXPECT_TRUE(cache.lookup(question.data(), question.size(), &result, nullptr, 1));
+    EXPECT_EQ(result.text, "short");
+    EXPECT_FALSE(cache.lookup(question.data(), question.size(), &result, nullptr, 3));
+}
+
+TEST(SemanticCacheTest, RecallAgainstBruteForce) {
+    std::mt19937 rng(7);
+    const size_t dim = 96;
+    const int count = 2000;
+    
+    SemanticCacheConfig config;
+    config.similarityThreshold = 0.8f;
+    config.maxEntries = count;
+    SemanticCache cache(config);
+    
+    std::vector<std::vector<float>> vectors;
+    for (int i = 0; i < count; ++i) {
+        vectors.push_back(randomVector(rng, dim));
+        cache.insert(vectors.back().data(), dim, makeResult(std::to_string(i)));
+    }
+    
+    // Perturbed queries must find their source among 2000 candidates
+    int correct = 0;
+    const int queries = 200;
+    for (int q = 0; q < queries; ++q) {
+        int target = (q * 37) % count;
+        std::vector<float> query = perturb(rng, vectors[target], 0.2f);
+        InferenceResult result;
+        if (cache.lookup(query.data(), dim, &result) && result.text == std::to_string(target)) {
+            correct++;
+        }
+    }
+    EXPECT_GE(correct, queries * 95 / 100);
+    
+    SemanticCacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.entries, static_cast<size_t>(count));
+    std::cout << "[SemanticCache] recall " << correct << "/" << queries
+              << ", avg lookup " << stats.averageLookupUs() << " us"
+              << ", max " << stats.maxLookupUs << " us"
+              << ", index " << stats.indexBytes / 1024 << " KB" << std::endl;
+}
+
+TEST(SemanticCacheTest, BoundedWithEviction) {
+    std::mt19937 rng(3);
+    SemanticCacheConfig config;
+    config.maxEntries = 50;
+    SemanticCache cache(config);
+    
+    std::vector<std::vector<float>> vectors;
+    for (int i = 0; i < 300; ++i) {
+        vectors.push_back(randomVector(rng, 32));
+        cache.insert(vectors.back().data(), 32, makeResult(std::to_string(i)));
+    }
+    
+    SemanticCacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.entries, static_cast<size_t>(50));
+    EXPECT_EQ(stats.evictions, 250);
+    EXPECT_GT(stats.rebuilds, 0);
+    
+    // Newest entries survive, oldest are gone
+    InferenceResult result;
+    EXPECT_TRUE(cache.lookup(vectors[299].data(), 32, &result));
+    EXPECT_EQ(result.text, "299");
+    EXPECT_FALSE(cache.lookup(vectors[0].data(), 32, nullptr));
+}
+
+TEST(SemanticCacheTest, DimensionChangeResets) {
+    std::mt19937 rng(5);
+    SemanticCache cache;
+    
+    std::vector<float> small = randomVector(rng, 16);
+    cache.insert(small.data(), small.size(), makeResult("small"));
+    EXPECT_TRUE(cache.lookup(small.data(), small.size(), nullptr));
+    
+    std::vector<float> large = randomVector(rng, 32);
+    EXPECT_FALSE(cache.lookup(large.data(), large.size(), nullptr));
+    cache.insert(large.data(), large.size(), makeResult("large"));
+    EXPECT_EQ(cache.getStats().entries, static_cast<size_t>(1));
+    EXPECT_FALSE(cache.lookup(small.data(), small.size(), nullptr));
+    
+    cache.clear();
+    EXPECT_EQ(cache.getStats().entries, static_cast<size_t>(0));
+    EXPECT_FALSE(cache.lookup(large.data(), large.size(), nullptr));
+}
+
+TEST(SemanticCacheTest, EngineIntegration) {
+    auto& managerRef = core::RKLLMManager::getInstance();
+    std::shared_ptr<core::RKLLMManager> manager(&managerRef, [](core::RKLLMManager*){});
+    InferenceEngine engine(manager);
+    
+    EXPECT_FALSE(engine.isSemanticCacheEnabled());
+    engine.enableSemanticCache();
+    EXPECT_TRUE(engine.isSemanticCacheEnabled());
+    
+    InferenceEngine::Stats stats = engine.getStats();
+    EXPECT_EQ(stats.semanticCacheHits, 0);
+    EXPECT_EQ(stats.semanticCacheMisses, 0);
+    
+    engine.disableSemanticCache();
+    EXPECT_FALSE(engine.isSemanticCacheEnabled());
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
@@ -0,0 +1,109 @@
+#include "session-scheduler.hpp"
+
+#include <algorithm>
+
+namespace rkllmjs {
+namespace inference {
+
+SessionScheduler::Turn& SessionScheduler::Turn::operator=(Turn&& other) noexcept {
+    if (this != &other) {
+        release();
+        scheduler_ = other.scheduler_;
+        other.scheduler_ = nullptr;
+    }
+    return *this;
+}
+
+void SessionScheduler::Turn::release() {
+    if (scheduler_) {
+        scheduler_->releaseTurn();
+        scheduler_ = nullptr;
+    }
+}
+
+SessionScheduler::SessionScheduler(const SessionSchedulerConfig& config)
+    : config_(config) {
+}
+
+SessionScheduler::Turn SessionScheduler::acquire(const std::string& sessionId) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Waiter waiter;
+    waiter.sessionId = sessionId;
+    waiter.enqueued = std::chrono::steady_clock::now();
+    
+    waiters_.push_back(&waiter);
+    stats_.maxWaiting = std::max(stats_.maxWaiting, waiters_.size());
+    if (!busy_) {
+        grantNextLocked();
+    }
+    granted_.wait(lock, [&waiter] { return waiter.granted; });
+    return Turn(this);
+}
+
+void SessionScheduler::recordSwitch(double switchMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.switches++;
+    stats_.totalSwitchMs += switchMs;
+}
+
+void SessionScheduler::resetCurrent() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_.clear();
+    consecutive_ = 0;
+}
+
+size_t SessionScheduler::waiting() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiters_.size();
+}
+
+SessionSchedulerStats SessionScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SessionScheduler::releaseTurn() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    busy_ = false;
+    grantNextLocked();
+}
+
+void SessionScheduler::grantNextLocked() {
+    if (waiters_.empty()) {
+        return;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    auto choice = waiters_.begin();
+    
+    // Stay on the resident session unless it has had its share or the
+    // oldest waiter of another session has waited too long
+    if (!current_.empty() && consecutive_ < config_.maxConsecutiveTurns) {
+        auto same = std::find_if(waiters_.begin(), waiters_.end(),
+                                 [this](const Waiter* w) { return w->sessionId == current_; });
+        double oldestWaitMs = std::chrono::duration<double, std::milli>(now - (*choice)->enqueued).count();
+        if (same != waiters_.end() && ((*choice)->sessionId == current_ || oldestWaitMs < config_.maxWaitMs)) {
+            choice = same;
+        }
+    }
+    
+    Waiter* waiter = *choice;
+    waiters_.erase(choice);
+    
+    if (!current_.empty() && waiter->sessionId == current_) {
+        consecutive_++;
+        stats_.batchedTurns++;
+    } else {
+        consecutive_ = 1;
+    }
+    current_ = waiter->sessionId;
+    stats_.turns++;
+    stats_.totalWaitMs += std::chrono::duration<double, std::milli>(now - waiter->enqueued).count();
+    
+    busy_ = true;
+    waiter->granted = true;
+    granted_.notify_all();
+}
+
+} // namespace inference
+} // namespace rkllmjs
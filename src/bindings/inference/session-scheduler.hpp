@@ -0,0 +1,115 @@
+/**
+ * @module inference
+ * @purpose Turn scheduling for many chat sessions sharing one model handle
+ * @description Serializes session turns on a handle and decides which waiting
+ *              turn runs next. Switching sessions costs a KV cache clear plus a
+ *              prompt-cache load, so queued turns of the session already resident
+ *              in the cache are preferred, bounded by a consecutive-turn limit and
+ *              a maximum wait so other sessions are not starved.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Session scheduler configuration
+ */
+struct SessionSchedulerConfig {
+    int32_t maxConsecutiveTurns = 4; // Same-session turns run back to back before others get a turn
+    int64_t maxWaitMs = 2000;        // Older waiting turns of other sessions preempt batching
+};
+
+/**
+ * Scheduling and context-switch counters
+ */
+struct SessionSchedulerStats {
+    int64_t turns = 0;
+    int64_t batchedTurns = 0;      // Granted to the session already in the KV cache
+    int64_t switches = 0;          // Turns that had to swap session state in
+    double totalSwitchMs = 0.0;    // Time spent clearing and loading session state
+    double totalWaitMs = 0.0;      // Time turns spent queued
+    size_t maxWaiting = 0;
+    
+    double averageSwitchMs() const { return switches > 0 ? totalSwitchMs / switches : 0.0; }
+    double averageWaitMs() const { return turns > 0 ? totalWaitMs / turns : 0.0; }
+};
+
+/**
+ * Grants exclusive use of the handle to one session turn at a time
+ *
+ * Turns run on the caller's thread: acquire() blocks until the turn is
+ * granted and the returned Turn releases the handle when destroyed.
+ * Without contention turns are granted in arrival order. Thread-safe.
+ */
+class SessionScheduler {
+public:
+    /**
+     * Exclusive handle ownership for one turn (RAII)
+     */
+    class Turn {
+    public:
+        Turn() = default;
+        ~Turn() { release(); }
+        Turn(Turn&& other) noexcept : scheduler_(other.scheduler_) { other.scheduler_ = nullptr; }
+        Turn& operator=(Turn&& other) noexcept;
+        Turn(const Turn&) = delete;
+        Turn& operator=(const Turn&) = delete;
+        
+        bool valid() const { return scheduler_ != nullptr; }
+        void release();
+    
+    private:
+        friend class SessionScheduler;
+        explicit Turn(SessionScheduler* scheduler) : scheduler_(scheduler) {}
+        
+        SessionScheduler* scheduler_ = nullptr;
+    };
+    
+    explicit SessionScheduler(const SessionSchedulerConfig& config = SessionSchedulerConfig());
+    
+    // Block until this session may use the handle
+    Turn acquire(const std::string& sessionId);
+    
+    // Record the cost of swapping a session's state into the KV cache
+    void recordSwitch(double switchMs);
+    
+    // The KV cache no longer holds the last session (e.g. a stateless request ran)
+    void resetCurrent();
+    
+    size_t waiting() const;
+    SessionSchedulerStats getStats() const;
+    const SessionSchedulerConfig& getConfig() const { return config_; }
+
+private:
+    struct Waiter {
+        std::string sessionId;
+        std::chrono::steady_clock::time_point enqueued;
+        bool granted = false;
+    };
+    
+    void releaseTurn();
+    void grantNextLocked();
+    
+    SessionSchedulerConfig config_;
+    mutable std::mutex mutex_;
+    std::condition_variable granted_;
+    std::deque<Waiter*> waiters_;  // Arrival order
+    bool busy_ = false;
+    std::string current_;          // Session granted last
+    int32_t consecutive_ = 0;
+    SessionSchedulerStats stats_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
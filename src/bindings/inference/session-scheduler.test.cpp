@@ -0,0 +1,108 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "session-scheduler.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+// Queue turns behind a held turn of session "a" and record the grant order
+static std::vector<std::string> runQueued(const SessionSchedulerConfig& config,
+                                          const std::vector<std::string>& queued) {
+    SessionScheduler scheduler(config);
+    SessionScheduler::Turn held = scheduler.acquire("a");
+    
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < queued.size(); ++i) {
+        threads.emplace_back([&, i] {
+            SessionScheduler::Turn turn = scheduler.acquire(queued[i]);
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(queued[i] + std::to_string(i));
+        });
+        // Enforce arrival order
+        while (scheduler.waiting() < i + 1) {
+            std::this_thread::yield();
+        }
+    }
+    
+    held.release();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return order;
+}
+
+TEST(SessionSchedulerTest, BatchesTurnsOfResidentSession) {
+    SessionSchedulerConfig config;
+    config.maxWaitMs = 60000;
+    std::vector<std::string> order = runQueued(config, {"b", "a", "a"});
+    EXPECT_EQ(order.size(), 3u);
+    EXPECT_EQ(order[0], std::string("a1"));
+    EXPECT_EQ(order[1], std::string("a2"));
+    EXPECT_EQ(order[2], std::string("b0"));
+}
+
+TEST(SessionSchedulerTest, ConsecutiveLimitPreventsStarvation) {
+    SessionSchedulerConfig config;
+    config.maxWaitMs = 60000;
+    config.maxConsecutiveTurns = 2; // The held turn counts as the first
+    std::vector<std::string> order = runQueued(config, {"b", "a", "a"});
+    EXPECT_EQ(order[0], std::string("a1"));
+    EXPECT_EQ(order[1], std::string("b0"));
+    EXPECT_EQ(order[2], std::string("a2"));
+}
+
+TEST(SessionSchedulerTest, LongWaitPreemptsBatching) {
+    SessionSchedulerConfig config;
+    config.maxWaitMs = 0;
+    std::vector<std::string> order = runQueued(config, {"b", "a"});
+    EXPECT_EQ(order[0], std::string("b0"));
+    EXPECT_EQ(order[1], std::string("a1"));
+}
+
+TEST(SessionSchedulerTest, TracksBatchingAndSwitchCost) {
+    SessionScheduler scheduler;
+    scheduler.acquire("a").release();
+    scheduler.acquire("a").release();
+    scheduler.resetCurrent();
+    scheduler.acquire("a").release();
+    scheduler.acquire("b").release();
+    scheduler.recordSwitch(4.0);
+    scheduler.recordSwitch(2.0);
+    
+    SessionSchedulerStats stats = scheduler.getStats();
+    EXPECT_EQ(stats.turns, 4);
+    EXPECT_EQ(stats.batchedTurns, 1);
+    EXPECT_EQ(stats.switches, 2);
+    EXPECT_NEAR(stats.averageSwitchMs(), 3.0, 1e-9);
+    EXPECT_EQ(scheduler.waiting(), 0u);
+}
+
+TEST(SessionSchedulerTest, TurnReleasesOnceWhenMoved) {
+    SessionScheduler scheduler;
+    SessionScheduler::Turn outer;
+    {
+        SessionScheduler::Turn inner = scheduler.acquire("a");
+        outer = std::move(inner);
+        EXPECT_FALSE(inner.valid());
+    }
+    EXPECT_TRUE(outer.valid());
+    outer.release();
+    EXPECT_FALSE(outer.valid());
+    
+    // The handle is free again
+    SessionScheduler::Turn next = scheduler.acquire("b");
+    EXPECT_TRUE(next.valid());
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
@@ -0,0 +1,271 @@
+#include "session-store.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+#include <sys/stat.h>
+
+namespace rkllmjs {
+namespace inference {
+
+static uint64_t fileSize(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+SessionStore::SessionStore(const SessionStoreConfig& config)
+    : config_(config) {
+    ::mkdir(config_.storageDir.c_str(), 0755); // EEXIST is fine
+    loadIndex();
+}
+
+bool SessionStore::isValidSessionId(const std::string& id) {
+    if (id.empty() || id.size() > 128) {
+        return false;
+    }
+    return std::all_of(id.begin(), id.end(), [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+    });
+}
+
+bool SessionStore::get(const std::string& id, SessionInfo* info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    if (it == sessions_.end()) {
+        return false;
+    }
+    if (info) {
+        *info = it->second;
+    }
+    return true;
+}
+
+SessionInfo SessionStore::open(const std::string& id, const std::string& modelId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    if (it != sessions_.end() && it->second.modelId == modelId) {
+        return it->second;
+    }
+    
+    // A checkpoint from another model is useless; the history is kept so
+    // the next turn can re-prefill it on the new model
+    std::remove(pathFor(id, ".cache").c_str());
+    std::remove(pathFor(id, ".pending").c_str());
+    if (it == sessions_.end()) {
+        std::remove(pathFor(id, ".history").c_str());
+    }
+    
+    SessionInfo info;
+    info.id = id;
+    info.modelId = modelId;
+    info.createdAtMs = it != sessions_.end() ? it->second.createdAtMs : nowMs();
+    info.lastUsedAtMs = nowMs();
+    sessions_[id] = info;
+    saveIndex();
+    return info;
+}
+
+void SessionStore::remove(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    removeLocked(id);
+    saveIndex();
+}
+
+std::string SessionStore::getCacheFile(const std::string& id) const {
+    return pathFor(id, ".cache");
+}
+
+std::string SessionStore::readHistory(const std::string& id) const {
+    return readFile(pathFor(id, ".history"));
+}
+
+std::string SessionStore::readPending(const std::string& id) const {
+    return readFile(pathFor(id, ".pending"));
+}
+
+void SessionStore::recordCheckpoint(const std::string& id, const std::string& prompt, const std::string& reply,
+                                    int32_t prefillTokens, double prefillMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    if (it == sessions_.end()) {
+        return;
+    }
+    
+    {
+        std::ofstream history(pathFor(id, ".history"), std::ios::binary | std::ios::app);
+        history << prompt << reply;
+    }
+    {
+        std::ofstream pending(pathFor(id, ".pending"), std::ios::binary | std::ios::trunc);
+        pending << reply;
+    }
+    
+    SessionInfo& info = it->second;
+    info.turns++;
+    info.cachedTokens += prefillTokens;
+    info.prefillMs += prefillMs;
+    info.lastUsedAtMs = nowMs();
+    info.sizeBytes = fileSize(pathFor(id, ".cache"));
+    stats_.checkpoints++;
+    
+    collectGarbageLocked(id);
+    saveIndex();
+}
+
+void SessionStore::recordResume(const std::string& id, double resumeMs, bool success) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    if (it == sessions_.end()) {
+        return;
+    }
+    
+    it->second.lastUsedAtMs = nowMs();
+    if (success) {
+        stats_.resumes++;
+        stats_.totalResumeMs += resumeMs;
+        stats_.totalReprefillMs += it->second.prefillMs;
+    } else {
+        // Unusable checkpoint: the next turn re-prefills from history
+        stats_.resumeFailures++;
+        std::remove(pathFor(id, ".cache").c_str());
+        it->second.sizeBytes = 0;
+        it->second.cachedTokens = 0;
+    }
+}
+
+size_t SessionStore::collectGarbage(const std::string& keepId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t removed = collectGarbageLocked(keepId);
+    if (removed > 0) {
+        saveIndex();
+    }
+    return removed;
+}
+
+SessionStoreStats SessionStore::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SessionStoreStats stats = stats_;
+    stats.sessions = sessions_.size();
+    for (const auto& entry : sessions_) {
+        stats.storageBytes += entry.second.sizeBytes;
+    }
+    return stats;
+}
+
+int64_t SessionStore::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string SessionStore::pathFor(const std::string& id, const char* extension) const {
+    return config_.storageDir + "/" + id + extension;
+}
+
+void SessionStore::removeLocked(const std::string& id) {
+    std::remove(pathFor(id, ".cache").c_str());
+    std::remove(pathFor(id, ".history").c_str());
+    std::remove(pathFor(id, ".pending").c_str());
+    sessions_.erase(id);
+}
+
+size_t SessionStore::collectGarbageLocked(const std::string& keepId) {
+    size_t removed = 0;
+    int64_t now = nowMs();
+    
+    // Idle sessions first
+    std::vector<std::string> idle;
+    for (const auto& entry : sessions_) {
+        if (entry.first != keepId && config_.maxIdleMs > 0 && now - entry.second.lastUsedAtMs > config_.maxIdleMs) {
+            idle.push_back(entry.first);
+        }
+    }
+    for (const auto& id : idle) {
+        removeLocked(id);
+        removed++;
+    }
+    
+    // Then least recently used sessions until within budget
+    uint64_t bytes = 0;
+    std::vector<std::pair<int64_t, std::string>> byAge;
+    for (const auto& entry : sessions_) {
+        bytes += entry.second.sizeBytes;
+        if (entry.first != keepId) {
+            byAge.emplace_back(entry.second.lastUsedAtMs, entry.first);
+        }
+    }
+    std::sort(byAge.begin(), byAge.end());
+    
+    for (const auto& candidate : byAge) {
+        if (bytes <= config_.maxStorageBytes && sessions_.size() <= config_.maxSessions) {
+            break;
+        }
+        bytes -= sessions_[candidate.second].sizeBytes;
+        removeLocked(candidate.second);
+        removed++;
+    }
+    
+    stats_.collected += static_cast<int64_t>(removed);
+    return removed;
+}
+
+void SessionStore::loadIndex() {
+    std::ifstream index(config_.storageDir + "/index.tsv");
+    std::string line;
+    while (std::getline(index, line)) {
+        std::istringstream fields(line);
+        SessionInfo info;
+        std::string turns, tokens, prefill, created, used;
+        if (!std::getline(fields, info.id, '\t') || !std::getline(fields, info.modelId, '\t') ||
+            !std::getline(fields, turns, '\t') || !std::getline(fields, tokens, '\t') ||
+            !std::getline(fields, prefill, '\t') || !std::getline(fields, created, '\t') ||
+            !std::getline(fields, used, '\t')) {
+            continue; // Skip malformed lines
+        }
+        if (!isValidSessionId(info.id)) {
+            continue;
+        }
+        
+        try {
+            info.turns = std::stoi(turns);
+            info.cachedTokens = std::stoi(tokens);
+            info.prefillMs = std::stod(prefill);
+            info.createdAtMs = std::stoll(created);
+            info.lastUsedAtMs = std::stoll(used);
+        } catch (const std::exception&) {
+            continue;
+        }
+        info.sizeBytes = fileSize(pathFor(info.id, ".cache"));
+        sessions_[info.id] = info;
+    }
+}
+
+bool SessionStore::saveIndex() const {
+    // Write-then-rename so a crash never leaves a truncated index
+    std::string path = config_.storageDir + "/index.tsv";
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream index(temp, std::ios::trunc);
+        if (!index) {
+            return false;
+        }
+        for (const auto& entry : sessions_) {
+            const SessionInfo& info = entry.second;
+            index << info.id << '\t' << info.modelId << '\t' << info.turns << '\t' << info.cachedTokens << '\t'
+                  << info.prefillMs << '\t' << info.createdAtMs << '\t' << info.lastUsedAtMs << '\n';
+        }
+    }
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+} // namespace inference
+} // namespace rkllmjs
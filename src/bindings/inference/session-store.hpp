@@ -0,0 +1,128 @@
+/**
+ * @module inference
+ * @purpose Persistent chat sessions backed by RKLLM prompt-cache files
+ * @description Keeps one prompt-cache checkpoint per chat session on disk,
+ *              written by each turn through RKLLMPromptCacheParam, plus a small
+ *              metadata index. Resuming a session after a restart or model
+ *              eviction reloads the checkpoint with rkllm_load_prompt_cache
+ *              instead of re-running the whole history. Storage is bounded by a
+ *              byte budget, a session count and an idle timeout.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Session store configuration
+ */
+struct SessionStoreConfig {
+    std::string storageDir = "/tmp/rkllmjs-sessions";
+    uint64_t maxStorageBytes = 4ULL * 1024 * 1024 * 1024; // Checkpoint files on disk
+    size_t maxSessions = 1024;
+    int64_t maxIdleMs = 7LL * 24 * 60 * 60 * 1000;        // Sessions unused for longer are removed
+};
+
+/**
+ * Metadata for one persisted session
+ */
+struct SessionInfo {
+    std::string id;
+    std::string modelId;            // Checkpoints only resume on the same model
+    int32_t turns = 0;
+    int32_t cachedTokens = 0;       // Prompt tokens covered by the checkpoint
+    double prefillMs = 0.0;         // Prefill time spent building the history
+    int64_t createdAtMs = 0;
+    int64_t lastUsedAtMs = 0;
+    uint64_t sizeBytes = 0;         // Checkpoint file size
+    
+    bool hasCheckpoint() const { return sizeBytes > 0; }
+};
+
+/**
+ * Session store counters
+ */
+struct SessionStoreStats {
+    size_t sessions = 0;
+    uint64_t storageBytes = 0;
+    int64_t checkpoints = 0;
+    int64_t resumes = 0;
+    int64_t resumeFailures = 0;
+    int64_t collected = 0;          // Sessions removed by GC
+    double totalResumeMs = 0.0;     // Time spent loading checkpoints
+    double totalReprefillMs = 0.0;  // Prefill time the same resumes would have cost
+    
+    double averageResumeMs() const { return resumes > 0 ? totalResumeMs / resumes : 0.0; }
+    double averageReprefillMs() const { return resumes > 0 ? totalReprefillMs / resumes : 0.0; }
+};
+
+/**
+ * On-disk session checkpoints and their metadata index
+ *
+ * Layout under storageDir: index.tsv (one line per session) and, per
+ * session, <id>.cache (prompt cache written by the runtime), <id>.history
+ * (full transcript, for re-prefill when a checkpoint cannot be used) and
+ * <id>.pending (text produced after the last checkpoint, i.e. the last
+ * reply, which must be prepended to the next turn). Thread-safe.
+ */
+class SessionStore {
+public:
+    explicit SessionStore(const SessionStoreConfig& config = SessionStoreConfig());
+    
+    // Session ids become file names: letters, digits, '-' and '_' only
+    static bool isValidSessionId(const std::string& id);
+    
+    bool get(const std::string& id, SessionInfo* info) const;
+    SessionInfo open(const std::string& id, const std::string& modelId);
+    void remove(const std::string& id);
+    
+    std::string getCacheFile(const std::string& id) const;
+    std::string readHistory(const std::string& id) const;
+    std::string readPending(const std::string& id) const;
+    
+    /**
+     * @brief Record a completed turn whose prompt cache was just saved
+     * @param prompt Text sent to the runtime this turn
+     * @param reply Generated text (not covered by the checkpoint)
+     */
+    void recordCheckpoint(const std::string& id, const std::string& prompt, const std::string& reply,
+                          int32_t prefillTokens, double prefillMs);
+    
+    // Record a checkpoint load; reprefill cost is taken from the session's history
+    void recordResume(const std::string& id, double resumeMs, bool success);
+    
+    /**
+     * @brief Remove idle sessions, then least recently used ones over budget
+     * @param keepId Session that must survive (e.g. the active one)
+     * @return Number of sessions removed
+     */
+    size_t collectGarbage(const std::string& keepId = "");
+    
+    SessionStoreStats getStats() const;
+    const SessionStoreConfig& getConfig() const { return config_; }
+    
+    static int64_t nowMs();
+
+private:
+    std::string pathFor(const std::string& id, const char* extension) const;
+    void removeLocked(const std::string& id);
+    size_t collectGarbageLocked(const std::string& keepId);
+    void loadIndex();
+    bool saveIndex() const;
+    
+    SessionStoreConfig config_;
+    mutable std::mutex mutex_;
+    std::map<std::string, SessionInfo> sessions_;
+    SessionStoreStats stats_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
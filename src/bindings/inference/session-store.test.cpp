@@ -0,0 +1,157 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "session-store.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static SessionStoreConfig makeConfig(const std::string& name) {
+    SessionStoreConfig config;
+    config.storageDir = "/tmp/rkllmjs-session-test-" + name + "-" + std::to_string(::getpid());
+    return config;
+}
+
+// Stands in for the prompt cache the runtime writes during a turn
+static void writeCache(const SessionStore& store, const std::string& id, size_t bytes) {
+    std::ofstream file(store.getCacheFile(id), std::ios::binary | std::ios::trunc);
+    file << std::string(bytes, 'k');
+}
+
+static void removeStore(const SessionStoreConfig& config) {
+    std::remove((config.storageDir + "/index.tsv").c_str());
+    ::rmdir(config.storageDir.c_str());
+}
+
+TEST(SessionStoreTest, ValidatesSessionIds) {
+    EXPECT_TRUE(SessionStore::isValidSessionId("chat-42_a"));
+    EXPECT_FALSE(SessionStore::isValidSessionId(""));
+    EXPECT_FALSE(SessionStore::isValidSessionId("../etc"));
+    EXPECT_FALSE(SessionStore::isValidSessionId("a b"));
+    EXPECT_FALSE(SessionStore::isValidSessionId(std::string(200, 'a')));
+}
+
+TEST(SessionStoreTest, CheckpointSurvivesRestart) {
+    SessionStoreConfig config = makeConfig("restart");
+    {
+        SessionStore store(config);
+        store.open("alice", "model.rkllm");
+        writeCache(store, "alice", 1000);
+        store.recordCheckpoint("alice", "Hi. ", "Hello!", 12, 80.0);
+        writeCache(store, "alice", 1500);
+        store.recordCheckpoint("alice", "How are you? ", "Fine.", 20, 120.0);
+    }
+    
+    SessionStore reopened(config);
+    SessionInfo info;
+    EXPECT_TRUE(reopened.get("alice", &info));
+    EXPECT_EQ(info.modelId, std::string("model.rkllm"));
+    EXPECT_EQ(info.turns, 2);
+    EXPECT_EQ(info.cachedTokens, 32);
+    EXPECT_EQ(static_cast<int>(info.sizeBytes), 1500);
+    EXPECT_TRUE(info.hasCheckpoint());
+    EXPECT_EQ(reopened.readHistory("alice"), std::string("Hi. Hello!How are you? Fine."));
+    EXPECT_EQ(reopened.readPending("alice"), std::string("Fine."));
+    
+    reopened.remove("alice");
+    EXPECT_FALSE(reopened.get("alice", nullptr));
+    removeStore(config);
+}
+
+TEST(SessionStoreTest, ResumeStatsCompareAgainstReprefill) {
+    SessionStoreConfig config = makeConfig("resume");
+    SessionStore store(config);
+    store.open("bob", "model.rkllm");
+    writeCache(store, "bob", 64);
+    store.recordCheckpoint("bob", "prompt ", "reply", 100, 250.0);
+    
+    store.recordResume("bob", 5.0, true);
+    SessionStoreStats stats = store.getStats();
+    EXPECT_EQ(stats.resumes, 1);
+    EXPECT_EQ(stats.checkpoints, 1);
+    EXPECT_NEAR(stats.averageResumeMs(), 5.0, 1e-9);
+    EXPECT_NEAR(stats.averageReprefillMs(), 250.0, 1e-9);
+    
+    // A checkpoint that fails to load is discarded; history remains for re-prefill
+    store.recordResume("bob", 1.0, false);
+    SessionInfo info;
+    EXPECT_TRUE(store.get("bob", &info));
+    EXPECT_FALSE(info.hasCheckpoint());
+    EXPECT_EQ(store.getStats().resumeFailures, 1);
+    EXPECT_EQ(store.readHistory("bob"), std::string("prompt reply"));
+    
+    store.remove("bob");
+    removeStore(config);
+}
+
+TEST(SessionStoreTest, ModelChangeDropsCheckpointKeepsHistory) {
+    SessionStoreConfig config = makeConfig("model");
+    SessionStore store(config);
+    store.open("carol", "a.rkllm");
+    writeCache(store, "carol", 64);
+    store.recordCheckpoint("carol", "q ", "a", 4, 10.0);
+    
+    SessionInfo info = store.open("carol", "b.rkllm");
+    EXPECT_EQ(info.modelId, std::string("b.rkllm"));
+    EXPECT_FALSE(info.hasCheckpoint());
+    EXPECT_EQ(info.turns, 0);
+    EXPECT_EQ(store.readHistory("carol"), std::string("q a"));
+    EXPECT_EQ(store.readPending("carol"), std::string(""));
+    
+    store.remove("carol");
+    removeStore(config);
+}
+
+TEST(SessionStoreTest, GarbageCollectionEnforcesBudget) {
+    SessionStoreConfig config = makeConfig("budget");
+    config.maxStorageBytes = 2500;
+    SessionStore store(config);
+    
+    for (const char* id : {"s1", "s2", "s3"}) {
+        store.open(id, "model.rkllm");
+        writeCache(store, id, 1000);
+        store.recordCheckpoint(id, "p", "r", 1, 1.0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    
+    // Third checkpoint exceeded the budget: the least recently used session goes
+    EXPECT_FALSE(store.get("s1", nullptr));
+    EXPECT_TRUE(store.get("s2", nullptr));
+    EXPECT_TRUE(store.get("s3", nullptr));
+    EXPECT_LE(store.getStats().storageBytes, config.maxStorageBytes);
+    EXPECT_EQ(store.getStats().collected, 1);
+    
+    store.remove("s2");
+    store.remove("s3");
+    removeStore(config);
+}
+
+TEST(SessionStoreTest, IdleSessionsAreCollected) {
+    SessionStoreConfig config = makeConfig("idle");
+    config.maxIdleMs = 1;
+    SessionStore store(config);
+    store.open("old", "model.rkllm");
+    store.open("active", "model.rkllm");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    
+    EXPECT_EQ(store.collectGarbage("active"), 1u);
+    EXPECT_FALSE(store.get("old", nullptr));
+    EXPECT_TRUE(store.get("active", nullptr));
+    
+    store.remove("active");
+    removeStore(config);
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
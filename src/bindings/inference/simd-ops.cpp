@@ -0,0 +1,345 @@
+#include "simd-ops.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RKLLMJS_SIMD_NEON 1
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define RKLLMJS_SIMD_SSE 1
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define RKLLMJS_SIMD_SSE2 1
+#endif
+#endif
+
+namespace rkllmjs {
+namespace inference {
+namespace simd {
+
+float dot(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    float sum = 0.0f;
+
+#if defined(RKLLMJS_SIMD_NEON)
+    // Two accumulators hide the FMA latency on Cortex-A76/A55
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+#if defined(__aarch64__)
+    sum = vaddvq_f32(acc);
+#else
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+#elif defined(RKLLMJS_SIMD_SSE)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    // Scalar tail (and the whole vector without SIMD)
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float normalize(float* v, size_t n) {
+    float norm = std::sqrt(dot(v, v, n));
+    if (norm > 0.0f) {
+        float inv = 1.0f / norm;
+        for (size_t i = 0; i < n; ++i) {
+            v[i] *= inv;
+        }
+    }
+    return norm;
+}
+
+float cosineSimilarity(const float* a, const float* b, size_t n) {
+    float denom = std::sqrt(dot(a, a, n) * dot(b, b, n));
+    return denom > 0.0f ? dot(a, b, n) / denom : 0.0f;
+}
+
+// Logits are processed in L1-sized chunks: the chunk maximum decides both the
+// rescaling of the running sum and whether the chunk can reach the top list
+static const size_t kLogitsChunk = 64;
+
+// Cephes single-precision exp: exp(n*ln2 + r) = 2^n * p(r)
+static const float kLog2e = 1.44269504088896341f;
+static const float kLn2Hi = 0.693359375f;
+static const float kLn2Lo = -2.12194440e-4f;
+static const float kExpP0 = 1.9875691500e-4f;
+static const float kExpP1 = 1.3981999507e-3f;
+static const float kExpP2 = 8.3334519073e-3f;
+static const float kExpP3 = 4.1665795894e-2f;
+static const float kExpP4 = 1.6666665459e-1f;
+static const float kExpP5 = 5.0000001201e-1f;
+static const float kExpFloor = -87.0f; // Below this the result is flushed to zero
+
+#if defined(RKLLMJS_SIMD_NEON)
+// exp(x) for x <= 0, which is all the shifted logits ever need
+static inline float32x4_t expNonPositive(float32x4_t x) {
+    uint32x4_t live = vcgtq_f32(x, vdupq_n_f32(kExpFloor));
+    x = vmaxq_f32(x, vdupq_n_f32(kExpFloor));
+    // Round to nearest: truncation of (x*log2e - 0.5) for non-positive x
+    int32x4_t n = vcvtq_s32_f32(vsubq_f32(vmulq_f32(x, vdupq_n_f32(kLog2e)), vdupq_n_f32(0.5f)));
+    float32x4_t nf = vcvtq_f32_s32(n);
+    float32x4_t r = vmlsq_f32(x, nf, vdupq_n_f32(kLn2Hi));
+    r = vmlsq_f32(r, nf, vdupq_n_f32(kLn2Lo));
+    float32x4_t p = vdupq_n_f32(kExpP0);
+    p = vmlaq_f32(vdupq_n_f32(kExpP1), p, r);
+    p = vmlaq_f32(vdupq_n_f32(kExpP2), p, r);
+    p = vmlaq_f32(vdupq_n_f32(kExpP3), p, r);
+    p = vmlaq_f32(vdupq_n_f32(kExpP4), p, r);
+    p = vmlaq_f32(vdupq_n_f32(kExpP5), p, r);
+    p = vmlaq_f32(vaddq_f32(r, vdupq_n_f32(1.0f)), p, vmulq_f32(r, r));
+    float32x4_t scale = vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23));
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(p, scale)), live));
+}
+#elif defined(RKLLMJS_SIMD_SSE2)
+static inline __m128 expNonPositive(__m128 x) {
+    __m128 live = _mm_cmpgt_ps(x, _mm_set1_ps(kExpFloor));
+    x = _mm_max_ps(x, _mm_set1_ps(kExpFloor));
+    __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kLog2e))); // Rounds to nearest
+    __m128 nf = _mm_cvtepi32_ps(n);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(nf, _mm_set1_ps(kLn2Hi)));
+    r = _mm_sub_ps(r, _mm_mul_ps(nf, _mm_set1_ps(kLn2Lo)));
+    __m128 p = _mm_set1_ps(kExpP0);
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP1));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP2));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP3));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP4));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(kExpP5));
+    p = _mm_add_ps(_mm_mul_ps(p, _mm_mul_ps(r, r)), _mm_add_ps(r, _mm_set1_ps(1.0f)));
+    __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    return _mm_and_ps(_mm_mul_ps(p, scale), live);
+}
+#endif
+
+static float maxOf(const float* x, size_t n) {
+    size_t i = 0;
+    float best = -std::numeric_limits<float>::infinity();
+#if defined(RKLLMJS_SIMD_NEON)
+    float32x4_t acc = vdupq_n_f32(best);
+    for (; i + 4 <= n; i += 4) {
+        acc = vmaxq_f32(acc, vld1q_f32(x + i));
+    }
+#if defined(__aarch64__)
+    best = vmaxvq_f32(acc);
+#else
+    float32x2_t half = vpmax_f32(vget_low_f32(acc), vget_high_f32(acc));
+    best = vget_lane_f32(vpmax_f32(half, half), 0);
+#endif
+#elif defined(RKLLMJS_SIMD_SSE)
+    __m128 acc = _mm_set1_ps(best);
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_max_ps(acc, _mm_loadu_ps(x + i));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    best = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+    for (; i < n; ++i) {
+        best = std::max(best, x[i]);
+    }
+    return best;
+}
+
+// Sum of exp(x - shift) with shift >= max(x)
+static float sumExpShifted(const float* x, size_t n, float shift) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(RKLLMJS_SIMD_NEON)
+    float32x4_t offset = vdupq_n_f32(shift);
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vaddq_f32(acc0, expNonPositive(vsubq_f32(vld1q_f32(x + i), offset)));
+        acc1 = vaddq_f32(acc1, expNonPositive(vsubq_f32(vld1q_f32(x + i + 4), offset)));
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+#if defined(__aarch64__)
+    sum = vaddvq_f32(acc);
+#else
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+#elif defined(RKLLMJS_SIMD_SSE2)
+    __m128 offset = _mm_set1_ps(shift);
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, expNonPositive(_mm_sub_ps(_mm_loadu_ps(x + i), offset)));
+        acc1 = _mm_add_ps(acc1, expNonPositive(_mm_sub_ps(_mm_loadu_ps(x + i + 4), offset)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < n; ++i) {
+        sum += std::exp(x[i] - shift);
+    }
+    return sum;
+}
+
+// Keep values[0..top) sorted descending; equal logits keep the earlier id first
+static void insertTop(float value, int32_t id, size_t top, size_t* filled, int32_t* ids, float* values) {
+    size_t pos = *filled;
+    if (pos == top) {
+        if (!(value > values[top - 1])) {
+            return;
+        }
+        pos = top - 1;
+    } else {
+        (*filled)++;
+    }
+    while (pos > 0 && value > values[pos - 1]) {
+        values[pos] = values[pos - 1];
+        ids[pos] = ids[pos - 1];
+        pos--;
+    }
+    values[pos] = value;
+    ids[pos] = id;
+}
+
+float logSumExp(const float* logits, size_t n, size_t top, int32_t* ids, float* values) {
+    const float negInf = -std::numeric_limits<float>::infinity();
+    bool collect = top > 0 && ids && values;
+    size_t filled = 0;
+    float runningMax = negInf;
+    float sum = 0.0f; // Sum of exp(logit - runningMax) so far
+    
+    for (size_t base = 0; base < n; base += kLogitsChunk) {
+        const float* x = logits + base;
+        size_t length = std::min(kLogitsChunk, n - base);
+        float chunkMax = maxOf(x, length);
+        
+        // Once the list is full, only chunks that beat its last entry are scanned
+        if (collect && (filled < top || chunkMax > values[top - 1])) {
+            for (size_t i = 0; i < length; ++i) {
+                insertTop(x[i], static_cast<int32_t>(base + i), top, &filled, ids, values);
+            }
+        }
+        if (chunkMax == negInf) {
+            continue; // Fully masked chunk
+        }
+        if (chunkMax > runningMax) {
+            sum *= std::exp(runningMax - chunkMax);
+            runningMax = chunkMax;
+        }
+        sum += sumExpShifted(x, length, runningMax);
+    }
+    return runningMax == negInf ? negInf : runningMax + std::log(sum);
+}
+
+float softmaxWeights(const float* logits, size_t n, float invTemperature, float* weights) {
+    float shift = maxOf(logits, n);
+    if (shift == -std::numeric_limits<float>::infinity()) {
+        std::fill(weights, weights + n, 0.0f);
+        return 0.0f;
+    }
+    
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(RKLLMJS_SIMD_NEON)
+    float32x4_t offset = vdupq_n_f32(shift);
+    float32x4_t scale = vdupq_n_f32(invTemperature);
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t w = expNonPositive(vmulq_f32(vsubq_f32(vld1q_f32(logits + i), offset), scale));
+        vst1q_f32(weights + i, w);
+        acc = vaddq_f32(acc, w);
+    }
+#if defined(__aarch64__)
+    sum = vaddvq_f32(acc);
+#else
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+#elif defined(RKLLMJS_SIMD_SSE2)
+    __m128 offset = _mm_set1_ps(shift);
+    __m128 scale = _mm_set1_ps(invTemperature);
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        __m128 w = expNonPositive(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(logits + i), offset), scale));
+        _mm_storeu_ps(weights + i, w);
+        acc = _mm_add_ps(acc, w);
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < n; ++i) {
+        weights[i] = std::exp((logits[i] - shift) * invTemperature);
+        sum += weights[i];
+    }
+    return sum;
+}
+
+float sumAtLeast(const float* x, size_t n, float threshold) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(RKLLMJS_SIMD_NEON)
+    float32x4_t limit = vdupq_n_f32(threshold);
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vld1q_f32(x + i);
+        uint32x4_t keep = vcgeq_f32(v, limit);
+        acc = vaddq_f32(acc, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), keep)));
+    }
+#if defined(__aarch64__)
+    sum = vaddvq_f32(acc);
+#else
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+#elif defined(RKLLMJS_SIMD_SSE)
+    __m128 limit = _mm_set1_ps(threshold);
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        acc = _mm_add_ps(acc, _mm_and_ps(v, _mm_cmpge_ps(v, limit)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < n; ++i) {
+        sum += x[i] >= threshold ? x[i] : 0.0f;
+    }
+    return sum;
+}
+
+const char* backendName() {
+#if defined(RKLLMJS_SIMD_NEON)
+    return "neon";
+#elif defined(RKLLMJS_SIMD_SSE)
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace simd
+} // namespace inference
+} // namespace rkllmjs
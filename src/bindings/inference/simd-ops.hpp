@@ -0,0 +1,63 @@
+/**
+ * @module inference
+ * @purpose Vectorized float kernels for embedding and logits processing
+ * @description Small set of SIMD kernels (NEON on ARM, SSE on x86, scalar
+ *              fallback elsewhere) used by the semantic cache and logits
+ *              post-processing. All functions accept unaligned pointers.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rkllmjs {
+namespace inference {
+namespace simd {
+
+/**
+ * @brief Dot product of two float vectors
+ */
+float dot(const float* a, const float* b, size_t n);
+
+/**
+ * @brief Scale a vector to unit L2 norm in place
+ * @return Original norm (0 leaves the vector unchanged)
+ */
+float normalize(float* v, size_t n);
+
+/**
+ * @brief Cosine similarity of two vectors of arbitrary norm
+ */
+float cosineSimilarity(const float* a, const float* b, size_t n);
+
+/**
+ * @brief Log-sum-exp of a logits row in a single pass, optionally collecting its largest entries
+ * @param top Number of largest entries to collect into ids/values (0 skips the selection)
+ * @param ids Receives the token ids of the largest entries, best first (ties keep the lower id)
+ * @param values Receives their raw logits; subtract the return value to get logprobs
+ * @return log(sum(exp(logits))), or -infinity when every entry is -infinity or n is 0
+ * @note Only min(top, n) entries are written
+ */
+float logSumExp(const float* logits, size_t n, size_t top = 0, int32_t* ids = nullptr, float* values = nullptr);
+
+/**
+ * @brief Unnormalized tempered softmax: weights[i] = exp((logits[i] - max) * invTemperature)
+ * @param invTemperature 1 / temperature, must be positive
+ * @return Sum of the weights (the largest weight is exactly 1), or 0 when every entry is -infinity or n is 0
+ */
+float softmaxWeights(const float* logits, size_t n, float invTemperature, float* weights);
+
+/**
+ * @brief Sum of the entries that are >= threshold
+ */
+float sumAtLeast(const float* x, size_t n, float threshold);
+
+// Name of the instruction set the kernels were compiled for
+const char* backendName();
+
+} // namespace simd
+} // namespace inference
+} // namespace rkllmjs
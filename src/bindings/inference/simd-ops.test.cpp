@@ -0,0 +1,158 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "simd-ops.hpp"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static float scalarDot(const std::vector<float>& a, const std::vector<float>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        sum += static_cast<double>(a[i]) * b[i];
+    }
+    return static_cast<float>(sum);
+}
+
+TEST(SimdOpsTest, DotMatchesScalarForAllTailLengths) {
+    // Lengths around the 4- and 8-wide block boundaries exercise every tail path
+    for (size_t n = 0; n <= 37; ++n) {
+        std::vector<float> a(n), b(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = std::sin(static_cast<float>(i) * 0.37f);
+            b[i] = std::cos(static_cast<float>(i) * 0.11f);
+        }
+        EXPECT_NEAR(simd::dot(a.data(), b.data(), n), scalarDot(a, b), 1e-4f);
+    }
+}
+
+TEST(SimdOpsTest, Normalize) {
+    std::vector<float> v = {3.0f, 4.0f, 0.0f, 0.0f, 0.0f};
+    float norm = simd::normalize(v.data(), v.size());
+    EXPECT_NEAR(norm, 5.0f, 1e-5f);
+    EXPECT_NEAR(v[0], 0.6f, 1e-5f);
+    EXPECT_NEAR(v[1], 0.8f, 1e-5f);
+    EXPECT_NEAR(simd::dot(v.data(), v.data(), v.size()), 1.0f, 1e-5f);
+    
+    // Zero vector stays zero
+    std::vector<float> zero(9, 0.0f);
+    EXPECT_EQ(simd::normalize(zero.data(), zero.size()), 0.0f);
+    EXPECT_EQ(zero[0], 0.0f);
+}
+
+TEST(SimdOpsTest, CosineSimilarity) {
+    std::vector<float> a = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+    std::vector<float> scaled(a.size());
+    std::vector<float> opposite(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        scaled[i] = a[i] * 2.5f;
+        opposite[i] = -a[i];
+    }
+    
+    EXPECT_NEAR(simd::cosineSimilarity(a.data(), scaled.data(), a.size()), 1.0f, 1e-5f);
+    EXPECT_NEAR(simd::cosineSimilarity(a.data(), opposite.data(), a.size()), -1.0f, 1e-5f);
+    
+    std::vector<float> x = {1.0f, 0.0f};
+    std::vector<float> y = {0.0f, 1.0f};
+    EXPECT_NEAR(simd::cosineSimilarity(x.data(), y.data(), 2), 0.0f, 1e-6f);
+}
+
+TEST(SimdOpsTest, LogSumExpMatchesScalarAndSelectsTop) {
+    std::mt19937 rng(7);
+    std::normal_distribution<float> normal(0.0f, 4.0f);
+    const float negInf = -std::numeric_limits<float>::infinity();
+    
+    // Lengths around the chunk and vector boundaries, with some masked entries
+    for (size_t n : {1u, 3u, 8u, 63u, 64u, 65u, 130u, 1000u, 32001u}) {
+        std::vector<float> logits(n);
+        for (size_t i = 0; i < n; ++i) {
+            logits[i] = i % 17 == 5 ? negInf : normal(rng);
+        }
+        double maxLogit = negInf;
+        for (float x : logits) {
+            maxLogit = std::max<double>(maxLogit, x);
+        }
+        double sum = 0.0;
+        for (float x : logits) {
+            sum += std::exp(static_cast<double>(x) - maxLogit);
+        }
+        float expected = static_cast<float>(maxLogit + std::log(sum));
+        
+        int32_t ids[5];
+        float values[5];
+        EXPECT_NEAR(simd::logSumExp(logits.data(), n, 5, ids, values), expected, 1e-4f * std::max(1.0f, std::fabs(expected)));
+        EXPECT_NEAR(simd::logSumExp(logits.data(), n), expected, 1e-4f * std::max(1.0f, std::fabs(expected)));
+        
+        std::vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&logits](size_t a, size_t b) { return logits[a] > logits[b]; });
+        for (size_t k = 0; k < std::min<size_t>(5, n); ++k) {
+            EXPECT_EQ(ids[k], static_cast<int32_t>(order[k]));
+            EXPECT_EQ(values[k], logits[order[k]]);
+        }
+    }
+    
+    // Huge logits do not overflow, fully masked rows have no mass, ties keep the lower id
+    std::vector<float> large = {1000.0f, 1000.0f, -1000.0f};
+    int32_t ids[2];
+    float values[2];
+    EXPECT_NEAR(simd::logSumExp(large.data(), large.size(), 2, ids, values), 1000.0f + std::log(2.0f), 1e-3f);
+    EXPECT_EQ(ids[0], 0);
+    EXPECT_EQ(ids[1], 1);
+    std::vector<float> masked(70, negInf);
+    EXPECT_EQ(simd::logSumExp(masked.data(), masked.size()), negInf);
+    EXPECT_EQ(simd::logSumExp(nullptr, 0), negInf);
+}
+
+TEST(SimdOpsTest, SoftmaxWeightsAndThresholdSums) {
+    std::mt19937 rng(9);
+    std::normal_distribution<float> normal(0.0f, 4.0f);
+    const float negInf = -std::numeric_limits<float>::infinity();
+    
+    for (size_t n : {1u, 3u, 4u, 7u, 65u, 1001u}) {
+        std::vector<float> logits(n);
+        for (size_t i = 0; i < n; ++i) {
+            logits[i] = i % 13 == 2 ? negInf : normal(rng);
+        }
+        float maxLogit = *std::max_element(logits.begin(), logits.end());
+        std::vector<float> weights(n);
+        float sum = simd::softmaxWeights(logits.data(), n, 1.0f / 0.7f, weights.data());
+        
+        double expectedSum = 0.0;
+        double expectedKept = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double expected = std::exp((static_cast<double>(logits[i]) - maxLogit) / 0.7);
+            EXPECT_NEAR(weights[i], expected, 1e-5 * std::max(1.0, expected));
+            expectedSum += expected;
+            expectedKept += expected >= 0.05 ? expected : 0.0;
+        }
+        EXPECT_NEAR(sum, expectedSum, 1e-4 * expectedSum);
+        EXPECT_NEAR(simd::sumAtLeast(weights.data(), n, 0.05f), expectedKept, 1e-4 * std::max(1.0, expectedKept));
+        EXPECT_EQ(weights[std::max_element(logits.begin(), logits.end()) - logits.begin()], 1.0f);
+    }
+    
+    // A fully masked row has no mass
+    std::vector<float> masked(9, negInf);
+    std::vector<float> weights(9, 1.0f);
+    EXPECT_EQ(simd::softmaxWeights(masked.data(), masked.size(), 1.0f, weights.data()), 0.0f);
+    EXPECT_EQ(simd::sumAtLeast(weights.data(), weights.size(), 0.0f), 0.0f);
+}
+
+TEST(SimdOpsTest, BackendName) {
+    std::string backend = simd::backendName();
+    EXPECT_TRUE(backend == "neon" || backend == "sse" || backend == "scalar");
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
@@ -0,0 +1,142 @@
+#include "stream-buffer.hpp"
+
+#include <algorithm>
+
+namespace rkllmjs {
+namespace inference {
+
+StreamBuffer::StreamBuffer(const StreamBufferConfig& config, Consumer consumer)
+    : config_(config), consumer_(std::move(consumer)) {
+    config_.capacity = std::max<size_t>(config_.capacity, 1);
+    if (config_.lowWatermark == 0 || config_.lowWatermark >= config_.capacity) {
+        config_.lowWatermark = config_.capacity / 2;
+    }
+    thread_ = std::thread(&StreamBuffer::run, this);
+}
+
+StreamBuffer::~StreamBuffer() {
+    finish();
+}
+
+void StreamBuffer::push(const std::string& chunk) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.dropped || finishing_) {
+        return;
+    }
+    stats_.chunks++;
+    
+    auto now = Clock::now();
+    if (queue_.size() >= config_.capacity) {
+        // Full: a DROP consumer gets a grace period, everyone else keeps bounded memory by merging
+        if (config_.policy == SlowConsumerPolicy::DROP &&
+            std::chrono::duration<double, std::milli>(now - fullSince_).count() >= config_.dropAfterMs) {
+            dropLocked();
+            return;
+        }
+        queue_.back() += chunk;
+        stats_.coalesced++;
+    } else {
+        queue_.push_back(chunk);
+        stats_.highWatermark = std::max(stats_.highWatermark, queue_.size());
+    }
+    updateFullLocked(now);
+    changed_.notify_all();
+}
+
+bool StreamBuffer::shouldPause() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_.policy == SlowConsumerPolicy::PAUSE && !stats_.dropped && queue_.size() >= config_.capacity;
+}
+
+bool StreamBuffer::waitForDrain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto start = Clock::now();
+    stats_.pauses++;
+    
+    bool drained = changed_.wait_for(lock, std::chrono::milliseconds(config_.maxPauseMs), [this] {
+        return stats_.dropped || queue_.size() <= config_.lowWatermark;
+    });
+    stats_.pausedMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    
+    if (!drained) {
+        dropLocked();
+    }
+    return !stats_.dropped;
+}
+
+void StreamBuffer::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finishing_ = true;
+    }
+    changed_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool StreamBuffer::isDropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.dropped;
+}
+
+size_t StreamBuffer::depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+StreamBufferStats StreamBuffer::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StreamBufferStats stats = stats_;
+    if (full_) {
+        stats.stallMs += std::chrono::duration<double, std::milli>(Clock::now() - fullSince_).count();
+    }
+    return stats;
+}
+
+void StreamBuffer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        changed_.wait(lock, [this] { return !queue_.empty() || finishing_; });
+        if (queue_.empty()) {
+            break; // Finishing and fully delivered
+        }
+        
+        std::string chunk = std::move(queue_.front());
+        queue_.pop_front();
+        updateFullLocked(Clock::now());
+        changed_.notify_all(); // A paused producer may resume
+        
+        lock.unlock();
+        if (consumer_) {
+            consumer_(chunk, false);
+        }
+        lock.lock();
+        stats_.delivered++;
+    }
+    lock.unlock();
+    
+    if (consumer_) {
+        consumer_("", true);
+    }
+}
+
+void StreamBuffer::dropLocked() {
+    stats_.dropped = true;
+    queue_.clear();
+    updateFullLocked(Clock::now());
+    changed_.notify_all();
+}
+
+void StreamBuffer::updateFullLocked(Clock::time_point now) {
+    bool full = queue_.size() >= config_.capacity;
+    if (full && !full_) {
+        fullSince_ = now;
+    } else if (!full && full_) {
+        stats_.stallMs += std::chrono::duration<double, std::milli>(now - fullSince_).count();
+    }
+    full_ = full;
+}
+
+} // namespace inference
+} // namespace rkllmjs
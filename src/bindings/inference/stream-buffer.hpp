@@ -0,0 +1,124 @@
+/**
+ * @module inference
+ * @purpose Bounded token buffer between the runtime callback and a stream consumer
+ * @description Decouples decoding from delivery: the rkllm callback pushes
+ *              chunks without blocking and a per-stream thread hands them to the
+ *              client callback. When a slow client lets the buffer fill up, the
+ *              configured policy decides what happens: merge chunks so the
+ *              client receives fewer larger ones (the default), drop the client,
+ *              or hold decoding inside the callback until the client catches up.
+ *              Holding keeps the run's inference slot and KV cache, so every
+ *              other request on the model waits with it; it is opt-in and bounded.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * What to do when the consumer falls a full buffer behind
+ */
+enum class SlowConsumerPolicy {
+    PAUSE,    // Block the callback until drained to the low watermark; holds the NPU and blocks other requests
+    COALESCE, // Keep decoding, merge new chunks into the last queued one (default)
+    DROP      // Coalesce, then drop the client if it stays full for dropAfterMs
+};
+
+/**
+ * Stream buffer configuration
+ */
+struct StreamBufferConfig {
+    size_t capacity = 128;          // Queued chunks before the policy applies
+    size_t lowWatermark = 0;        // Resume threshold for PAUSE (0 = capacity / 2)
+    SlowConsumerPolicy policy = SlowConsumerPolicy::COALESCE;
+    int64_t maxPauseMs = 250;       // A paused stream that does not drain in time is dropped (at most kMaxPauseMs)
+    int64_t dropAfterMs = 5000;     // DROP: time the buffer may stay full
+    
+    // Longest a paused stream may hold the model away from other requests
+    static constexpr int64_t kMaxPauseMs = 2000;
+};
+
+/**
+ * Per-stream delivery counters
+ */
+struct StreamBufferStats {
+    int64_t chunks = 0;             // Chunks pushed by the producer
+    int64_t delivered = 0;          // Callback invocations (after merging)
+    int64_t coalesced = 0;          // Chunks merged into a queued one
+    int64_t pauses = 0;             // Times decoding was paused for this consumer
+    size_t highWatermark = 0;       // Deepest the queue got
+    double stallMs = 0.0;           // Time the buffer spent full
+    double pausedMs = 0.0;          // Time decoding waited for the consumer
+    bool dropped = false;
+};
+
+/**
+ * Single-producer bounded chunk queue with its own delivery thread
+ *
+ * push() never blocks; under PAUSE the producer waits in waitForDrain().
+ * The consumer callback runs on the buffer's thread, in order, and receives
+ * ("", true) exactly once at the end, also after a drop.
+ */
+class StreamBuffer {
+public:
+    using Consumer = std::function<void(const std::string& chunk, bool isLast)>;
+    
+    StreamBuffer(const StreamBufferConfig& config, Consumer consumer);
+    ~StreamBuffer();
+    
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+    
+    // Queue a chunk; ignored once the client has been dropped
+    void push(const std::string& chunk);
+    
+    // PAUSE policy and the queue is full: the producer should stop decoding
+    bool shouldPause() const;
+    
+    /**
+     * @brief Block the producer (decoding stopped) until the queue drains
+     * @return true to resume decoding, false if the client was dropped meanwhile
+     */
+    bool waitForDrain();
+    
+    // Deliver what is queued, send the final marker and stop the thread
+    void finish();
+    
+    bool isDropped() const;
+    size_t depth() const;
+    StreamBufferStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    void run();
+    void dropLocked();
+    void updateFullLocked(Clock::time_point now);
+    
+    StreamBufferConfig config_;
+    Consumer consumer_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<std::string> queue_;
+    bool finishing_ = false;
+    bool full_ = false;
+    Clock::time_point fullSince_;
+    StreamBufferStats stats_;
+    std::thread thread_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
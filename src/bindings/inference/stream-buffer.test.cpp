@@ -0,0 +1,178 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "stream-buffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+// Consumer that blocks until released, standing in for a client on a slow link
+struct GatedConsumer {
+    std::promise<void> gate;
+    std::shared_future<void> open = gate.get_future().share();
+    std::mutex mutex;
+    std::vector<std::string> chunks;
+    std::atomic<int> finals{0};
+    std::atomic<int> taken{0};
+    
+    StreamBuffer::Consumer callback() {
+        return [this](const std::string& chunk, bool isLast) {
+            if (isLast) {
+                finals++;
+                return;
+            }
+            taken++;
+            open.wait();
+            std::lock_guard<std::mutex> lock(mutex);
+            chunks.push_back(chunk);
+        };
+    }
+    
+    std::string joined() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string text;
+        for (const auto& chunk : chunks) {
+            text += chunk;
+        }
+        return text;
+    }
+};
+
+static StreamBufferConfig makeConfig(SlowConsumerPolicy policy) {
+    StreamBufferConfig config;
+    config.capacity = 4;
+    config.lowWatermark = 1;
+    config.policy = policy;
+    return config;
+}
+
+TEST(StreamBufferTest, DeliversInOrderWithFinalMarker) {
+    std::vector<std::string> chunks;
+    int finals = 0;
+    {
+        StreamBuffer buffer(makeConfig(SlowConsumerPolicy::PAUSE), [&](const std::string& chunk, bool isLast) {
+            if (isLast) {
+                finals++;
+            } else {
+                chunks.push_back(chunk);
+            }
+        });
+        for (const char* token : {"a", "b", "c"}) {
+            buffer.push(token);
+        }
+        buffer.finish();
+        EXPECT_EQ(buffer.getStats().delivered, 3);
+    }
+    EXPECT_EQ(chunks.size(), 3u);
+    EXPECT_EQ(chunks[2], std::string("c"));
+    EXPECT_EQ(finals, 1);
+}
+
+TEST(StreamBufferTest, PauseUntilConsumerDrains) {
+    GatedConsumer consumer;
+    StreamBuffer buffer(makeConfig(SlowConsumerPolicy::PAUSE), consumer.callback());
+    
+    // One chunk is held by the blocked consumer, four fill the queue
+    int pushed = 0;
+    while (!buffer.shouldPause() && pushed < 100) {
+        buffer.push(std::to_string(pushed++));
+    }
+    EXPECT_TRUE(buffer.shouldPause());
+    EXPECT_LE(pushed, 5);
+    
+    std::thread release([&consumer] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        consumer.gate.set_value();
+    });
+    EXPECT_TRUE(buffer.waitForDrain());
+    EXPECT_LE(buffer.depth(), 1u);
+    release.join();
+    
+    buffer.finish();
+    StreamBufferStats stats = buffer.getStats();
+    EXPECT_EQ(stats.pauses, 1);
+    EXPECT_EQ(stats.highWatermark, 4u);
+    EXPECT_GT(stats.pausedMs, 0.0);
+    EXPECT_GT(stats.stallMs, 0.0);
+    EXPECT_EQ(stats.coalesced, 0);
+    EXPECT_EQ(consumer.finals.load(), 1);
+}
+
+TEST(StreamBufferTest, CoalesceBoundsQueueWithoutLosingText) {
+    GatedConsumer consumer;
+    StreamBuffer buffer(makeConfig(SlowConsumerPolicy::COALESCE), consumer.callback());
+    
+    std::string expected;
+    for (int i = 0; i < 50; ++i) {
+        std::string token = std::to_string(i) + ",";
+        expected += token;
+        buffer.push(token);
+        EXPECT_FALSE(buffer.shouldPause());
+    }
+    EXPECT_LE(buffer.depth(), 4u);
+    
+    consumer.gate.set_value();
+    buffer.finish();
+    EXPECT_EQ(consumer.joined(), expected);
+    
+    StreamBufferStats stats = buffer.getStats();
+    EXPECT_EQ(stats.chunks, 50);
+    EXPECT_GT(stats.coalesced, 40);
+    EXPECT_EQ(stats.delivered + stats.coalesced, stats.chunks);
+}
+
+TEST(StreamBufferTest, DropsClientThatStaysFull) {
+    GatedConsumer consumer;
+    StreamBufferConfig config = makeConfig(SlowConsumerPolicy::DROP);
+    config.dropAfterMs = 10;
+    StreamBuffer buffer(config, consumer.callback());
+    
+    // The consumer holds the first chunk, the rest fill the queue
+    buffer.push("x");
+    while (consumer.taken.load() == 0) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 5; ++i) {
+        buffer.push("x");
+    }
+    EXPECT_FALSE(buffer.isDropped()); // Full, but within the grace period
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    buffer.push("y");
+    EXPECT_TRUE(buffer.isDropped());
+    EXPECT_EQ(buffer.depth(), 0u);
+    
+    consumer.gate.set_value();
+    buffer.finish();
+    EXPECT_TRUE(buffer.getStats().dropped);
+    EXPECT_EQ(consumer.finals.load(), 1);
+    EXPECT_EQ(consumer.joined().find('y'), std::string::npos);
+}
+
+TEST(StreamBufferTest, PausedStreamThatNeverDrainsIsDropped) {
+    GatedConsumer consumer;
+    StreamBufferConfig config = makeConfig(SlowConsumerPolicy::PAUSE);
+    config.maxPauseMs = 10;
+    StreamBuffer buffer(config, consumer.callback());
+    
+    while (!buffer.shouldPause()) {
+        buffer.push("x");
+    }
+    EXPECT_FALSE(buffer.waitForDrain());
+    EXPECT_TRUE(buffer.isDropped());
+    EXPECT_FALSE(buffer.shouldPause());
+    
+    consumer.gate.set_value();
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
@@ -0,0 +1,248 @@
+#include "tenant-quota.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+
+namespace rkllmjs {
+namespace inference {
+
+static const char* kDefaultTenant = "default";
+
+static int64_t steadyNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// GCRA token bucket: the whole state is the theoretical arrival time (TAT) of
+// the next token; the bucket is full when TAT <= now and empty when TAT is a
+// full burst ahead of now
+class GcraBucket {
+public:
+    void configure(double tokensPerSec, double burst) {
+        if (tokensPerSec <= 0.0) {
+            return;
+        }
+        intervalUs_ = 1e6 / tokensPerSec;
+        toleranceUs_ = static_cast<int64_t>((burst > 0.0 ? burst : tokensPerSec) * intervalUs_);
+    }
+    
+    bool unlimited() const { return intervalUs_ == 0.0; }
+    
+    // Take tokens if there is room; a request larger than the bucket needs it full
+    bool tryTake(int64_t tokens, int64_t nowUs, int64_t* waitUs) {
+        if (unlimited()) {
+            return true;
+        }
+        int64_t cost = std::llround(tokens * intervalUs_);
+        int64_t needed = std::min(cost, toleranceUs_);
+        int64_t tat = tat_.load(std::memory_order_relaxed);
+        while (true) {
+            int64_t start = std::max(tat, nowUs);
+            int64_t wait = start + needed - nowUs - toleranceUs_;
+            if (wait > 0) {
+                *waitUs = wait;
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, start + cost, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+    
+    // Charge unconditionally; may leave the bucket in debt
+    void charge(int64_t tokens, int64_t nowUs) {
+        if (unlimited() || tokens <= 0) {
+            return;
+        }
+        int64_t cost = std::llround(tokens * intervalUs_);
+        int64_t tat = tat_.load(std::memory_order_relaxed);
+        while (!tat_.compare_exchange_weak(tat, std::max(tat, nowUs) + cost, std::memory_order_relaxed)) {
+        }
+    }
+    
+    // Tokens available now (negative while in debt, -1 when unlimited)
+    double available(int64_t nowUs) const {
+        if (unlimited()) {
+            return -1.0;
+        }
+        int64_t ahead = std::max(tat_.load(std::memory_order_relaxed), nowUs) - nowUs;
+        return (toleranceUs_ - ahead) / intervalUs_;
+    }
+
+private:
+    double intervalUs_ = 0.0;     // Time per token (0 = unlimited)
+    int64_t toleranceUs_ = 0;     // Burst size expressed in time
+    std::atomic<int64_t> tat_{0};
+};
+
+struct TenantQuotas::TenantState {
+    std::string id;
+    TenantLimits limits;
+    GcraBucket prompt;
+    GcraBucket completion;
+    std::atomic<int32_t> active{0};
+    std::atomic<int64_t> admitted{0};
+    std::atomic<int64_t> rateLimited{0};
+    std::atomic<int64_t> concurrencyLimited{0};
+    std::atomic<int64_t> promptTokens{0};
+    std::atomic<int64_t> completionTokens{0};
+};
+
+TenantQuotas::Lease::Lease(Lease&& other) noexcept
+    : quotas_(other.quotas_), tenant_(other.tenant_) {
+    other.quotas_ = nullptr;
+    other.tenant_ = nullptr;
+}
+
+TenantQuotas::Lease& TenantQuotas::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        quotas_ = other.quotas_;
+        tenant_ = other.tenant_;
+        other.quotas_ = nullptr;
+        other.tenant_ = nullptr;
+    }
+    return *this;
+}
+
+void TenantQuotas::Lease::complete(int64_t completionTokens) {
+    if (!tenant_ || completionTokens <= 0) {
+        return;
+    }
+    tenant_->completion.charge(completionTokens, quotas_->clock_());
+    tenant_->completionTokens.fetch_add(completionTokens, std::memory_order_relaxed);
+}
+
+void TenantQuotas::Lease::release() {
+    if (tenant_) {
+        tenant_->active.fetch_sub(1, std::memory_order_relaxed);
+    }
+    quotas_ = nullptr;
+    tenant_ = nullptr;
+}
+
+TenantQuotas::TenantQuotas(const TenantQuotaConfig& config, Clock clock)
+    : config_(config), clock_(clock ? std::move(clock) : Clock(steadyNowUs)) {
+}
+
+TenantQuotas::~TenantQuotas() = default;
+
+bool TenantQuotas::isValidTenantId(const std::string& tenantId) {
+    if (tenantId.empty() || tenantId.size() > 64) {
+        return false;
+    }
+    return std::all_of(tenantId.begin(), tenantId.end(), [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '-' || c == '_' || c == '.';
+    });
+}
+
+const char* TenantQuotas::verdictName(QuotaVerdict verdict) {
+    switch (verdict) {
+        case QuotaVerdict::ADMITTED: return "admitted";
+        case QuotaVerdict::RATE_LIMITED: return "rate_limited";
+        case QuotaVerdict::CONCURRENCY_LIMITED: return "concurrency_limited";
+    }
+    return "unknown";
+}
+
+TenantQuotas::TenantState* TenantQuotas::findOrCreate(const std::string& tenantId) {
+    Shard& shard = shards_[std::hash<std::string>()(tenantId) % kShards];
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.tenants.find(tenantId);
+        if (it != shard.tenants.end()) {
+            return it->second.get();
+        }
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto& slot = shard.tenants[tenantId];
+    if (!slot) {
+        auto configured = config_.tenants.find(tenantId);
+        slot = std::make_unique<TenantState>();
+        slot->id = tenantId;
+        slot->limits = configured != config_.tenants.end() ? configured->second : config_.defaults;
+        slot->prompt.configure(slot->limits.promptTokensPerSec, slot->limits.promptBurst);
+        slot->completion.configure(slot->limits.completionTokensPerSec, slot->limits.completionBurst);
+    }
+    return slot.get();
+}
+
+QuotaVerdict TenantQuotas::admit(const std::string& tenantId, int64_t promptTokens, Lease* lease,
+                                 int64_t* retryAfterMs) {
+    TenantState* tenant = findOrCreate(tenantId.empty() ? kDefaultTenant : tenantId);
+    if (retryAfterMs) {
+        *retryAfterMs = 0;
+    }
+    
+    int32_t running = tenant->active.fetch_add(1, std::memory_order_relaxed);
+    if (tenant->limits.maxConcurrent > 0 && running >= tenant->limits.maxConcurrent) {
+        tenant->active.fetch_sub(1, std::memory_order_relaxed);
+        tenant->concurrencyLimited.fetch_add(1, std::memory_order_relaxed);
+        return QuotaVerdict::CONCURRENCY_LIMITED;
+    }
+    
+    // Completion debt from earlier replies blocks admission; the prompt is paid now
+    int64_t now = clock_();
+    int64_t waitUs = 0;
+    if (!tenant->completion.tryTake(0, now, &waitUs) || !tenant->prompt.tryTake(promptTokens, now, &waitUs)) {
+        tenant->active.fetch_sub(1, std::memory_order_relaxed);
+        tenant->rateLimited.fetch_add(1, std::memory_order_relaxed);
+        if (retryAfterMs) {
+            *retryAfterMs = (waitUs + 999) / 1000;
+        }
+        return QuotaVerdict::RATE_LIMITED;
+    }
+    
+    tenant->admitted.fetch_add(1, std::memory_order_relaxed);
+    tenant->promptTokens.fetch_add(promptTokens, std::memory_order_relaxed);
+    *lease = Lease(this, tenant);
+    return QuotaVerdict::ADMITTED;
+}
+
+TenantUsage TenantQuotas::snapshot(const TenantState& tenant, int64_t nowUs) const {
+    TenantUsage usage;
+    usage.tenantId = tenant.id;
+    usage.admitted = tenant.admitted.load(std::memory_order_relaxed);
+    usage.rateLimited = tenant.rateLimited.load(std::memory_order_relaxed);
+    usage.concurrencyLimited = tenant.concurrencyLimited.load(std::memory_order_relaxed);
+    usage.promptTokens = tenant.promptTokens.load(std::memory_order_relaxed);
+    usage.completionTokens = tenant.completionTokens.load(std::memory_order_relaxed);
+    usage.active = tenant.active.load(std::memory_order_relaxed);
+    usage.promptTokensAvailable = tenant.prompt.available(nowUs);
+    usage.completionTokensAvailable = tenant.completion.available(nowUs);
+    return usage;
+}
+
+bool TenantQuotas::getUsage(const std::string& tenantId, TenantUsage* usage) const {
+    const std::string& id = tenantId.empty() ? std::string(kDefaultTenant) : tenantId;
+    const Shard& shard = shards_[std::hash<std::string>()(id) % kShards];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.tenants.find(id);
+    if (it == shard.tenants.end()) {
+        return false;
+    }
+    *usage = snapshot(*it->second, clock_());
+    return true;
+}
+
+std::vector<TenantUsage> TenantQuotas::getAllUsage() const {
+    std::vector<TenantUsage> usage;
+    int64_t now = clock_();
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& entry : shard.tenants) {
+            usage.push_back(snapshot(*entry.second, now));
+        }
+    }
+    std::sort(usage.begin(), usage.end(), [](const TenantUsage& a, const TenantUsage& b) {
+        return a.tenantId < b.tenantId;
+    });
+    return usage;
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,150 @@
+/**
+ * @module inference
+ * @purpose Per-tenant rate limits and concurrency caps at admission
+ * @description Each tenant gets two token buckets, one for prompt tokens and one
+ *              for completion tokens, plus a cap on concurrent requests. Prompt
+ *              tokens are known up front and taken at admission; completion
+ *              tokens are charged when the request finishes, and a tenant in
+ *              completion debt is refused until its bucket refills. Buckets use
+ *              the generic cell rate algorithm (a single atomic theoretical
+ *              arrival time per bucket), and tenants live in a sharded table,
+ *              so admission never takes a global lock.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rkllmjs {
+namespace inference {
+
+/**
+ * Limits applied to one tenant (0 = unlimited)
+ */
+struct TenantLimits {
+    double promptTokensPerSec = 0.0;
+    double promptBurst = 0.0;          // Bucket size in tokens (0 = one second of rate)
+    double completionTokensPerSec = 0.0;
+    double completionBurst = 0.0;
+    int32_t maxConcurrent = 0;
+};
+
+/**
+ * Quota configuration
+ */
+struct TenantQuotaConfig {
+    TenantLimits defaults;                                  // Tenants without an entry below
+    std::unordered_map<std::string, TenantLimits> tenants;
+};
+
+/**
+ * Admission decision
+ */
+enum class QuotaVerdict {
+    ADMITTED,
+    RATE_LIMITED,        // A token bucket is empty (or in completion debt)
+    CONCURRENCY_LIMITED  // maxConcurrent requests already running
+};
+
+/**
+ * Usage counters for one tenant
+ */
+struct TenantUsage {
+    std::string tenantId;
+    int64_t admitted = 0;
+    int64_t rateLimited = 0;
+    int64_t concurrencyLimited = 0;
+    int64_t promptTokens = 0;          // Charged prompt tokens
+    int64_t completionTokens = 0;      // Charged completion tokens
+    int32_t active = 0;                // Requests currently admitted
+    double promptTokensAvailable = 0.0;     // Current bucket levels (-1 = unlimited)
+    double completionTokensAvailable = 0.0;
+};
+
+/**
+ * Sharded per-tenant quota table
+ *
+ * Thread-safe; limits are fixed at construction.
+ */
+class TenantQuotas {
+public:
+    // Monotonic microseconds; replaceable for tests
+    using Clock = std::function<int64_t()>;
+    
+    struct TenantState;
+    
+    /**
+     * Admitted request (RAII, frees its concurrency slot when destroyed)
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        ~Lease() { release(); }
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        
+        // Charge the tokens the request generated
+        void complete(int64_t completionTokens);
+        void release();
+    
+    private:
+        friend class TenantQuotas;
+        
+        Lease(TenantQuotas* quotas, TenantState* tenant) : quotas_(quotas), tenant_(tenant) {}
+        
+        TenantQuotas* quotas_ = nullptr;
+        TenantState* tenant_ = nullptr;
+    };
+    
+    explicit TenantQuotas(const TenantQuotaConfig& config = TenantQuotaConfig(), Clock clock = nullptr);
+    ~TenantQuotas();
+    
+    TenantQuotas(const TenantQuotas&) = delete;
+    TenantQuotas& operator=(const TenantQuotas&) = delete;
+    
+    /**
+     * @brief Admit a request against its tenant's limits
+     * @param tenantId Tenant (empty = "default")
+     * @param promptTokens Prompt tokens taken from the prompt bucket
+     * @param lease Receives the admission on success
+     * @param retryAfterMs Optional: time until the limiting bucket has room again
+     */
+    QuotaVerdict admit(const std::string& tenantId, int64_t promptTokens, Lease* lease,
+                       int64_t* retryAfterMs = nullptr);
+    
+    bool getUsage(const std::string& tenantId, TenantUsage* usage) const;
+    std::vector<TenantUsage> getAllUsage() const; // Sorted by tenant id
+    
+    static bool isValidTenantId(const std::string& tenantId);
+    static const char* verdictName(QuotaVerdict verdict);
+
+private:
+    static constexpr size_t kShards = 16;
+    
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<TenantState>> tenants;
+    };
+    
+    TenantState* findOrCreate(const std::string& tenantId);
+    TenantUsage snapshot(const TenantState& tenant, int64_t nowUs) const;
+    
+    TenantQuotaConfig config_;
+    Clock clock_;
+    std::array<Shard, kShards> shards_;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,153 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "tenant-quota.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+TEST(TenantQuotaTest, PromptBucketLimitsRateAndReportsRetry) {
+    int64_t nowUs = 0;
+    TenantQuotaConfig config;
+    config.defaults.promptTokensPerSec = 100.0;
+    config.defaults.promptBurst = 200.0;
+    TenantQuotas quotas(config, [&nowUs] { return nowUs; });
+    
+    TenantQuotas::Lease first;
+    EXPECT_TRUE(quotas.admit("team-a", 150, &first) == QuotaVerdict::ADMITTED);
+    
+    // 50 tokens left; 100 more need another 500ms of refill
+    TenantQuotas::Lease second;
+    int64_t retryAfterMs = 0;
+    EXPECT_TRUE(quotas.admit("team-a", 100, &second, &retryAfterMs) == QuotaVerdict::RATE_LIMITED);
+    EXPECT_EQ(retryAfterMs, 500);
+    
+    nowUs = 500000;
+    EXPECT_TRUE(quotas.admit("team-a", 100, &second) == QuotaVerdict::ADMITTED);
+    
+    // A prompt larger than the bucket is admitted once the bucket is full
+    TenantQuotas::Lease large;
+    EXPECT_TRUE(quotas.admit("team-b", 500, &large) == QuotaVerdict::ADMITTED);
+    EXPECT_TRUE(quotas.admit("team-b", 1, &large, &retryAfterMs) == QuotaVerdict::RATE_LIMITED);
+    EXPECT_EQ(retryAfterMs, 3010);
+    
+    TenantUsage usage;
+    EXPECT_TRUE(quotas.getUsage("team-a", &usage));
+    EXPECT_EQ(usage.admitted, 2);
+    EXPECT_EQ(usage.rateLimited, 1);
+    EXPECT_EQ(usage.promptTokens, 250);
+    EXPECT_NEAR(usage.promptTokensAvailable, 0.0, 1e-6);
+    EXPECT_FALSE(quotas.getUsage("nobody", &usage));
+}
+
+TEST(TenantQuotaTest, CompletionDebtBlocksUntilRefilled) {
+    int64_t nowUs = 0;
+    TenantQuotaConfig config;
+    config.defaults.completionTokensPerSec = 10.0;
+    config.defaults.completionBurst = 10.0;
+    TenantQuotas quotas(config, [&nowUs] { return nowUs; });
+    
+    {
+        TenantQuotas::Lease lease;
+        EXPECT_TRUE(quotas.admit("", 1000, &lease) == QuotaVerdict::ADMITTED);
+        lease.complete(30); // 20 tokens beyond the bucket
+    }
+    
+    TenantQuotas::Lease lease;
+    int64_t retryAfterMs = 0;
+    EXPECT_TRUE(quotas.admit("", 10, &lease, &retryAfterMs) == QuotaVerdict::RATE_LIMITED);
+    EXPECT_EQ(retryAfterMs, 2000);
+    
+    nowUs = 2000000;
+    EXPECT_TRUE(quotas.admit("", 10, &lease) == QuotaVerdict::ADMITTED);
+    
+    TenantUsage usage;
+    EXPECT_TRUE(quotas.getUsage("default", &usage));
+    EXPECT_EQ(usage.completionTokens, 30);
+    EXPECT_EQ(usage.promptTokensAvailable, -1.0);
+    EXPECT_EQ(usage.active, 1);
+}
+
+TEST(TenantQuotaTest, ConcurrencyCapAndPerTenantOverrides) {
+    TenantQuotaConfig config;
+    config.defaults.maxConcurrent = 1;
+    config.tenants["batch"].maxConcurrent = 2;
+    TenantQuotas quotas(config);
+    
+    TenantQuotas::Lease a;
+    TenantQuotas::Lease b;
+    TenantQuotas::Lease c;
+    EXPECT_TRUE(quotas.admit("batch", 1, &a) == QuotaVerdict::ADMITTED);
+    EXPECT_TRUE(quotas.admit("batch", 1, &b) == QuotaVerdict::ADMITTED);
+    EXPECT_TRUE(quotas.admit("batch", 1, &c) == QuotaVerdict::CONCURRENCY_LIMITED);
+    
+    // Other tenants are unaffected and get the defaults
+    TenantQuotas::Lease d;
+    TenantQuotas::Lease e;
+    EXPECT_TRUE(quotas.admit("chat", 1, &d) == QuotaVerdict::ADMITTED);
+    EXPECT_TRUE(quotas.admit("chat", 1, &e) == QuotaVerdict::CONCURRENCY_LIMITED);
+    
+    a.release();
+    EXPECT_TRUE(quotas.admit("batch", 1, &c) == QuotaVerdict::ADMITTED);
+    
+    std::vector<TenantUsage> usage = quotas.getAllUsage();
+    EXPECT_EQ(usage.size(), 2u);
+    EXPECT_EQ(usage[0].tenantId, std::string("batch"));
+    EXPECT_EQ(usage[0].active, 2);
+    EXPECT_EQ(usage[0].concurrencyLimited, 1);
+    EXPECT_EQ(usage[1].admitted, 1);
+    
+    EXPECT_TRUE(TenantQuotas::isValidTenantId("team.search-1"));
+    EXPECT_FALSE(TenantQuotas::isValidTenantId("team a"));
+    EXPECT_EQ(std::string(TenantQuotas::verdictName(QuotaVerdict::RATE_LIMITED)), std::string("rate_limited"));
+}
+
+TEST(TenantQuotaTest, ConcurrentAdmissionNeverExceedsCap) {
+    TenantQuotaConfig config;
+    config.defaults.maxConcurrent = 3;
+    TenantQuotas quotas(config);
+    
+    std::atomic<int> peak{0};
+    std::atomic<int> running{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            std::string tenant = "tenant-" + std::to_string(t % 2);
+            for (int i = 0; i < 2000; ++i) {
+                TenantQuotas::Lease lease;
+                if (quotas.admit(tenant, 1, &lease) == QuotaVerdict::ADMITTED) {
+                    int now = ++running;
+                    int seen = peak.load();
+                    while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+                    }
+                    --running;
+                    lease.complete(1);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    EXPECT_LE(peak.load(), 6); // Two tenants, three each
+    int64_t total = 0;
+    for (const auto& usage : quotas.getAllUsage()) {
+        EXPECT_EQ(usage.active, 0);
+        EXPECT_EQ(usage.admitted + usage.concurrencyLimited, 8000);
+        EXPECT_EQ(usage.completionTokens, usage.admitted);
+        total += usage.admitted;
+    }
+    EXPECT_GT(total, 0);
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
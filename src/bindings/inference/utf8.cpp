@@ -0,0 +1,378 @@
+#include "utf8.hpp"
+
+#include <cstring>
+
+#if defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define RKLLMJS_UTF8_NEON 1
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define RKLLMJS_UTF8_SSSE3 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RKLLMJS_UTF8_SSE2 1
+#endif
+
+namespace rkllmjs {
+namespace inference {
+namespace utf8 {
+
+enum SequenceCheck {
+    SEQUENCE_INVALID = 0,   // consumed = maximal invalid subpart (at least 1 byte)
+    SEQUENCE_VALID = 1,     // consumed = sequence length
+    SEQUENCE_TRUNCATED = 2  // Valid so far but cut off by the end of the buffer
+};
+
+// Check the sequence at p against Unicode table 3-7 (well-formed byte sequences)
+static SequenceCheck checkSequence(const uint8_t* p, size_t available, size_t* consumed) {
+    uint8_t lead = p[0];
+    if (lead < 0x80) {
+        *consumed = 1;
+        return SEQUENCE_VALID;
+    }
+    
+    size_t length = 0;
+    uint8_t low = 0x80;   // Range of the second byte; later bytes are always 80..BF
+    uint8_t high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead == 0xE0) {
+        length = 3;
+        low = 0xA0;
+    } else if (lead == 0xED) {
+        length = 3;
+        high = 0x9F;
+    } else if (lead >= 0xE1 && lead <= 0xEF) {
+        length = 3;
+    } else if (lead == 0xF0) {
+        length = 4;
+        low = 0x90;
+    } else if (lead == 0xF4) {
+        length = 4;
+        high = 0x8F;
+    } else if (lead >= 0xF1 && lead <= 0xF3) {
+        length = 4;
+    } else {
+        *consumed = 1;
+        return SEQUENCE_INVALID;
+    }
+    
+    for (size_t i = 1; i < length; ++i) {
+        if (i >= available) {
+            *consumed = i;
+            return SEQUENCE_TRUNCATED;
+        }
+        uint8_t byte = p[i];
+        if (byte < (i == 1 ? low : 0x80) || byte > (i == 1 ? high : 0xBF)) {
+            *consumed = i;
+            return SEQUENCE_INVALID;
+        }
+    }
+    *consumed = length;
+    return SEQUENCE_VALID;
+}
+
+bool isValidScalar(const char* data, size_t length) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    size_t i = 0;
+    while (i < length) {
+        size_t consumed = 0;
+        if (checkSequence(p + i, length - i, &consumed) != SEQUENCE_VALID) {
+            return false;
+        }
+        i += consumed;
+    }
+    return true;
+}
+
+#if !defined(RKLLMJS_UTF8_NEON) && !defined(RKLLMJS_UTF8_SSSE3)
+
+static inline bool isAsciiBlock(const uint8_t* p) {
+#if defined(RKLLMJS_UTF8_SSE2)
+    return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) == 0;
+#else
+    uint64_t a;
+    uint64_t b;
+    std::memcpy(&a, p, 8);
+    std::memcpy(&b, p + 8, 8);
+    return ((a | b) & 0x8080808080808080ULL) == 0;
+#endif
+}
+
+// Skip 16-byte ASCII runs, decode everything else one sequence at a time
+static bool validateBlocked(const uint8_t* p, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        if (p[i] < 0x80 && i + 16 <= length && isAsciiBlock(p + i)) {
+            i += 16;
+            continue;
+        }
+        size_t consumed = 0;
+        if (checkSequence(p + i, length - i, &consumed) != SEQUENCE_VALID) {
+            return false;
+        }
+        i += consumed;
+    }
+    return true;
+}
+
+#endif
+
+#if defined(RKLLMJS_UTF8_NEON) || defined(RKLLMJS_UTF8_SSSE3)
+
+// Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"
+// (2021): every error shows up in the high nibble of the previous byte, its
+// low nibble and the high nibble of the current byte, so three 16-entry table
+// lookups ANDed together flag all two-byte errors; missing third and fourth
+// bytes are caught separately from the bytes two and three positions back.
+enum : uint8_t {
+    TOO_SHORT = 1 << 0,      // Lead byte followed by a non-continuation
+    TOO_LONG = 1 << 1,       // ASCII followed by a continuation
+    OVERLONG_3 = 1 << 2,     // E0 80..9F
+    TOO_LARGE = 1 << 3,      // F4 90..BF, F5..FF
+    SURROGATE = 1 << 4,      // ED A0..BF
+    OVERLONG_2 = 1 << 5,     // C0..C1
+    TOO_LARGE_1000 = 1 << 6, // F5..FF 80..8F
+    OVERLONG_4 = 1 << 6,     // F0 80..8F
+    TWO_CONTS = 1 << 7,      // Two continuations in a row (fine only inside 3/4-byte sequences)
+    CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS
+};
+
+alignas(16) static const uint8_t kByte1High[16] = {
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+};
+
+alignas(16) static const uint8_t kByte1Low[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    CARRY | OVERLONG_2,
+    CARRY,
+    CARRY,
+    CARRY | TOO_LARGE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000
+};
+
+alignas(16) static const uint8_t kByte2High[16] = {
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+};
+
+// A lead byte in the last three positions needs bytes from the next block
+alignas(16) static const uint8_t kIncompleteMax[16] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+
+#endif
+
+#if defined(RKLLMJS_UTF8_NEON)
+
+static bool validateSimd(const uint8_t* p, size_t length) {
+    const uint8x16_t byte1High = vld1q_u8(kByte1High);
+    const uint8x16_t byte1Low = vld1q_u8(kByte1Low);
+    const uint8x16_t byte2High = vld1q_u8(kByte2High);
+    const uint8x16_t incompleteMax = vld1q_u8(kIncompleteMax);
+    uint8x16_t previous = vdupq_n_u8(0);
+    uint8x16_t previousIncomplete = vdupq_n_u8(0);
+    uint8x16_t error = vdupq_n_u8(0);
+    
+    auto step = [&](uint8x16_t input) {
+        if (vmaxvq_u8(input) < 0x80) {
+            error = vorrq_u8(error, previousIncomplete);
+            previousIncomplete = vdupq_n_u8(0);
+        } else {
+            uint8x16_t prev1 = vextq_u8(previous, input, 15);
+            uint8x16_t special = vandq_u8(
+                vandq_u8(vqtbl1q_u8(byte1High, vshrq_n_u8(prev1, 4)),
+                         vqtbl1q_u8(byte1Low, vandq_u8(prev1, vdupq_n_u8(0x0F)))),
+                vqtbl1q_u8(byte2High, vshrq_n_u8(input, 4)));
+            uint8x16_t prev2 = vextq_u8(previous, input, 14);
+            uint8x16_t prev3 = vextq_u8(previous, input, 13);
+            uint8x16_t must23 = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80)),
+                                         vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80)));
+            error = vorrq_u8(error, veorq_u8(vandq_u8(must23, vdupq_n_u8(0x80)), special));
+            previousIncomplete = vqsubq_u8(input, incompleteMax);
+        }
+        previous = input;
+    };
+    
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        step(vld1q_u8(p + i));
+    }
+    // Zero padding is ASCII, so it also flags a sequence cut off at the end
+    uint8_t tail[16] = {0};
+    std::memcpy(tail, p + i, length - i);
+    step(vld1q_u8(tail));
+    return vmaxvq_u8(error) == 0;
+}
+
+#elif defined(RKLLMJS_UTF8_SSSE3)
+
+static bool validateSimd(const uint8_t* p, size_t length) {
+    const __m128i byte1High = _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1High));
+    const __m128i byte1Low = _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1Low));
+    const __m128i byte2High = _mm_load_si128(reinterpret_cast<const __m128i*>(kByte2High));
+    const __m128i incompleteMax = _mm_load_si128(reinterpret_cast<const __m128i*>(kIncompleteMax));
+    const __m128i lowNibble = _mm_set1_epi8(0x0F);
+    __m128i previous = _mm_setzero_si128();
+    __m128i previousIncomplete = _mm_setzero_si128();
+    __m128i error = _mm_setzero_si128();
+    
+    auto step = [&](__m128i input) {
+        if (_mm_movemask_epi8(input) == 0) {
+            error = _mm_or_si128(error, previousIncomplete);
+            previousIncomplete = _mm_setzero_si128();
+        } else {
+            __m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+            __m128i special = _mm_and_si128(
+                _mm_and_si128(_mm_shuffle_epi8(byte1High, _mm_and_si128(_mm_srli_epi16(prev1, 4), lowNibble)),
+                              _mm_shuffle_epi8(byte1Low, _mm_and_si128(prev1, lowNibble))),
+                _mm_shuffle_epi8(byte2High, _mm_and_si128(_mm_srli_epi16(input, 4), lowNibble)));
+            __m128i prev2 = _mm_alignr_epi8(input, previous, 14);
+            __m128i prev3 = _mm_alignr_epi8(input, previous, 13);
+            __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80)),
+                                          _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+            error = _mm_or_si128(error, _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80))),
+                                                      special));
+            previousIncomplete = _mm_subs_epu8(input, incompleteMax);
+        }
+        previous = input;
+    };
+    
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        step(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+    }
+    // Zero padding is ASCII, so it also flags a sequence cut off at the end
+    alignas(16) uint8_t tail[16] = {0};
+    std::memcpy(tail, p + i, length - i);
+    step(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+#endif
+
+bool isValid(const char* data, size_t length) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+#if defined(RKLLMJS_UTF8_NEON) || defined(RKLLMJS_UTF8_SSSE3)
+    return validateSimd(p, length);
+#else
+    return validateBlocked(p, length);
+#endif
+}
+
+size_t appendRepaired(const char* data, size_t length, std::string* out) {
+    if (isValid(data, length)) {
+        out->append(data, length);
+        return 0;
+    }
+    
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    size_t replacements = 0;
+    size_t i = 0;
+    size_t runStart = 0; // Start of the valid bytes not yet copied
+    while (i < length) {
+        size_t consumed = 0;
+        if (checkSequence(p + i, length - i, &consumed) == SEQUENCE_VALID) {
+            i += consumed;
+            continue;
+        }
+        out->append(data + runStart, i - runStart);
+        out->append(kReplacement);
+        replacements++;
+        i += consumed;
+        runStart = i;
+    }
+    out->append(data + runStart, length - runStart);
+    return replacements;
+}
+
+size_t repair(std::string& text) {
+    if (isValid(text)) {
+        return 0;
+    }
+    std::string repaired;
+    repaired.reserve(text.size() + 8);
+    size_t replacements = appendRepaired(text.data(), text.size(), &repaired);
+    text.swap(repaired);
+    return replacements;
+}
+
+size_t incompleteTail(const char* data, size_t length) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    for (size_t back = 1; back <= 3 && back <= length; ++back) {
+        uint8_t byte = p[length - back];
+        if (byte < 0x80) {
+            return 0;
+        }
+        if (byte >= 0xC0) {
+            size_t consumed = 0;
+            return checkSequence(p + length - back, back, &consumed) == SEQUENCE_TRUNCATED ? back : 0;
+        }
+    }
+    return 0;
+}
+
+const char* backendName() {
+#if defined(RKLLMJS_UTF8_NEON)
+    return "neon";
+#elif defined(RKLLMJS_UTF8_SSSE3)
+    return "ssse3";
+#elif defined(RKLLMJS_UTF8_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace utf8
+
+size_t Utf8Assembler::push(const char* data, size_t length, std::string* out) {
+    const char* input = data;
+    size_t inputLength = length;
+    if (!pending_.empty()) {
+        scratch_.assign(pending_);
+        scratch_.append(data, length);
+        pending_.clear();
+        input = scratch_.data();
+        inputLength = scratch_.size();
+    }
+    
+    size_t tail = utf8::incompleteTail(input, inputLength);
+    size_t before = out->size();
+    replacements_ += utf8::appendRepaired(input, inputLength - tail, out);
+    pending_.assign(input + inputLength - tail, tail);
+    return out->size() - before;
+}
+
+size_t Utf8Assembler::flush(std::string* out) {
+    if (pending_.empty()) {
+        return 0;
+    }
+    pending_.clear();
+    out->append(utf8::kReplacement);
+    replacements_++;
+    return std::strlen(utf8::kReplacement);
+}
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,92 @@
+/**
+ * @module inference
+ * @purpose UTF-8 validation, repair and streaming reassembly
+ * @description The runtime emits token text as raw bytes and may split a
+ *              multibyte character across callbacks (RKLLM_RUN_WAITING).
+ *              Utf8Assembler holds back an incomplete trailing sequence until
+ *              the rest arrives, so every chunk handed to callers is valid
+ *              UTF-8. Validation uses the Keiser-Lemire lookup algorithm on
+ *              16-byte blocks (NEON on AArch64, SSSE3 on x86) with an ASCII
+ *              fast path; other targets skip ASCII runs and decode the rest
+ *              with a scalar checker. Invalid input is repaired by replacing
+ *              each maximal invalid subpart with U+FFFD, as the Unicode
+ *              standard recommends.
+ * @author RKLLMJS Team
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rkllmjs {
+namespace inference {
+namespace utf8 {
+
+// U+FFFD REPLACEMENT CHARACTER
+constexpr const char* kReplacement = "\xEF\xBF\xBD";
+
+/**
+ * @brief Check that a buffer is well-formed UTF-8 (no overlongs, surrogates or code points past U+10FFFF)
+ */
+bool isValid(const char* data, size_t length);
+inline bool isValid(const std::string& text) { return isValid(text.data(), text.size()); }
+
+// Byte-at-a-time reference checker (used by tests and the benchmark)
+bool isValidScalar(const char* data, size_t length);
+
+/**
+ * @brief Append data to out with invalid sequences replaced by U+FFFD
+ * @return Number of replacements made
+ */
+size_t appendRepaired(const char* data, size_t length, std::string* out);
+
+/**
+ * @brief Replace invalid sequences in place
+ * @return Number of replacements made (0 leaves text untouched)
+ */
+size_t repair(std::string& text);
+
+/**
+ * @brief Length of a truncated but so-far-valid sequence at the end of the buffer
+ * @return 0-3 bytes that need more input to complete a character
+ */
+size_t incompleteTail(const char* data, size_t length);
+
+// Name of the instruction set the validator was compiled for
+const char* backendName();
+
+} // namespace utf8
+
+/**
+ * Reassembles characters split across token callbacks
+ *
+ * Not thread-safe; one per generation.
+ */
+class Utf8Assembler {
+public:
+    /**
+     * @brief Add runtime output and append the text that is now complete to out
+     * @return Bytes appended (an incomplete trailing character is held back)
+     */
+    size_t push(const char* data, size_t length, std::string* out);
+    
+    /**
+     * @brief End of output: anything still held back becomes U+FFFD
+     * @return Bytes appended
+     */
+    size_t flush(std::string* out);
+    
+    size_t pending() const { return pending_.size(); }
+    int64_t replacements() const { return replacements_; }
+
+private:
+    std::string pending_;    // Incomplete trailing sequence (at most 3 bytes)
+    std::string scratch_;    // Reused to join pending bytes with new input
+    int64_t replacements_ = 0;
+};
+
+} // namespace inference
+} // namespace rkllmjs
@@ -0,0 +1,162 @@
+#include "../testing/rkllmjs-test.hpp"
+#include "utf8.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace rkllmjs::testing;
+
+namespace rkllmjs {
+namespace inference {
+namespace test {
+
+static const std::string kFffd = utf8::kReplacement;
+
+TEST(Utf8Test, AcceptsWellFormedAndRejectsMalformedAtEveryOffset) {
+    const std::vector<std::string> valid = {
+        "", "plain ascii", "\xC3\xA4\xC3\xB6", "\xE4\xB8\xAD\xE6\x96\x87", "\xF0\x9F\x8E\x89",
+        "\xEF\xBF\xBF", "\xF4\x8F\xBF\xBF", "\xED\x9F\xBF", "\xE0\xA0\x80", "\xF0\x90\x80\x80"
+    };
+    const std::vector<std::string> invalid = {
+        "\x80", "\xC0\x80", "\xC1\xBF", "\xE0\x80\x80", "\xED\xA0\x80", "\xF0\x80\x80\x80",
+        "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF", "\xE4\xB8", "\xF0\x9F\x8E", "\xC3",
+        "\xC3\x41", "\xE4\x41\xAD", "\xF0\x9F\x41\x89", "\xE4\xB8\xAD\xAD"
+    };
+    
+    // Shift each case across the 16-byte block boundaries
+    for (size_t shift = 0; shift < 20; ++shift) {
+        std::string prefix(shift, 'x');
+        for (const auto& text : valid) {
+            EXPECT_TRUE(utf8::isValid(prefix + text));
+            EXPECT_TRUE(utf8::isValid(prefix + text + "tail"));
+        }
+        for (const auto& text : invalid) {
+            EXPECT_FALSE(utf8::isValid(prefix + text));
+            EXPECT_FALSE(utf8::isValid(prefix + text + "tail after the bad bytes"));
+            EXPECT_FALSE(utf8::isValidScalar((prefix + text).data(), shift + text.size()));
+        }
+    }
+}
+
+TEST(Utf8Test, MatchesScalarReferenceOnRandomInput) {
+    const std::vector<std::string> pieces = {
+        "a", " ", "\xC3\xA9", "\xE4\xBD\xA0", "\xE5\xA5\xBD", "\xF0\x9F\x98\x80", "\xED\x9F\xBF", "\x80", "\xE4",
+        "\xF0\x9F", "\xC0", "\xED\xA0", "\xF4\x90"
+    };
+    std::mt19937 rng(1234);
+    int validCount = 0;
+    for (int round = 0; round < 20000; ++round) {
+        std::string text;
+        size_t count = rng() % 40;
+        for (size_t i = 0; i < count; ++i) {
+            // Mostly well-formed pieces so both outcomes are common
+            size_t pick = rng() % 100 < 97 ? rng() % 7 : 7 + rng() % (pieces.size() - 7);
+            text += pieces[pick];
+        }
+        bool expected = utf8::isValidScalar(text.data(), text.size());
+        EXPECT_EQ(utf8::isValid(text), expected);
+        validCount += expected ? 1 : 0;
+        
+        std::string repaired = text;
+        utf8::repair(repaired);
+        EXPECT_TRUE(utf8::isValid(repaired));
+    }
+    EXPECT_GT(validCount, 1000);
+    EXPECT_LT(validCount, 19000);
+}
+
+TEST(Utf8Test, RepairReplacesMaximalSubparts) {
+    std::string text = "a\xF0\x90\x80" "b";   // Truncated 4-byte sequence: one replacement
+    EXPECT_EQ(utf8::repair(text), 1u);
+    EXPECT_EQ(text, "a" + kFffd + "b");
+    
+    text = "\xC0\xAF";                        // Never-valid lead, then a lone continuation
+    EXPECT_EQ(utf8::repair(text), 2u);
+    EXPECT_EQ(text, kFffd + kFffd);
+    
+    text = "\xED\xA0\x80";                    // Surrogates are three separate errors
+    EXPECT_EQ(utf8::repair(text), 3u);
+    
+    text = "ok \xE4\xB8\xAD";
+    EXPECT_EQ(utf8::repair(text), 0u);
+    EXPECT_EQ(text, std::string("ok \xE4\xB8\xAD"));
+    
+    EXPECT_EQ(utf8::incompleteTail("ab\xE4\xB8", 4), 2u);
+    EXPECT_EQ(utf8::incompleteTail("ab\xF0\x9F\x8E", 5), 3u);
+    EXPECT_EQ(utf8::incompleteTail("ab\xE4\xB8\xAD", 5), 0u);
+    EXPECT_EQ(utf8::incompleteTail("ab\xE0\x80", 4), 0u); // Already invalid: nothing to wait for
+}
+
+TEST(Utf8Test, AssemblerNeverEmitsSplitCharacters) {
+    const std::string reply = "Hi \xE4\xBD\xA0\xE5\xA5\xBD \xF0\x9F\x8E\x89!";
+    
+    // Worst case: the runtime hands over one byte per callback
+    Utf8Assembler assembler;
+    std::string text;
+    for (char byte : reply) {
+        std::string chunk;
+        assembler.push(&byte, 1, &chunk);
+        EXPECT_TRUE(utf8::isValid(chunk));
+        text += chunk;
+    }
+    assembler.flush(&text);
+    EXPECT_EQ(text, reply);
+    EXPECT_EQ(assembler.replacements(), 0);
+    
+    // A character cut off by the end of output, and garbage mid-stream
+    Utf8Assembler cut;
+    std::string out;
+    cut.push("ab\xE4\xB8", 4, &out);
+    EXPECT_EQ(out, std::string("ab"));
+    EXPECT_EQ(cut.pending(), 2u);
+    cut.push("\xFF" "c", 2, &out);
+    EXPECT_EQ(out, "ab" + kFffd + kFffd + "c");
+    cut.push("\xF0\x9F", 2, &out);
+    EXPECT_EQ(cut.flush(&out), kFffd.size());
+    EXPECT_EQ(out, "ab" + kFffd + kFffd + "c" + kFffd);
+    EXPECT_EQ(cut.replacements(), 3);
+    EXPECT_EQ(cut.pending(), 0u);
+}
+
+TEST(Utf8Test, CjkPromptValidationBenchmark) {
+    // CJK-heavy prompt: Chinese and Japanese text with ASCII punctuation and numbers
+    const std::string paragraph =
+        "\xE8\xAF\xB7\xE6\x80\xBB\xE7\xBB\x93\xE4\xBB\xA5\xE4\xB8\x8B\xE6\x96\x87\xE6\xA1\xA3\xE7\x9A\x84"
+        "\xE8\xA6\x81\xE7\x82\xB9, 2024 Q3: \xE5\xA3\xB2\xE4\xB8\x8A\xE9\xAB\x98\xE3\x81\xAF\xE5\x89\x8D"
+        "\xE5\xB9\xB4\xE6\xAF\x94 12% \xE5\xA2\x97\xE5\x8A\xA0\xE3\x81\x97\xE3\x81\xBE\xE3\x81\x97\xE3\x81\x9F\xE3\x80\x82 ";
+    std::string prompt;
+    while (prompt.size() < (1u << 20)) {
+        prompt += paragraph;
+    }
+    
+    auto measure = [&prompt](bool (*validate)(const char*, size_t)) {
+        const int iterations = 20;
+        bool ok = true;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            ok = validate(prompt.data(), prompt.size()) && ok;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_TRUE(ok);
+        return prompt.size() * static_cast<double>(iterations) / (seconds * 1e6);
+    };
+    double simdMbps = measure(&utf8::isValid);
+    double scalarMbps = measure(&utf8::isValidScalar);
+    std::cout << "[Utf8] CJK prompt validation: " << utf8::backendName() << " " << simdMbps
+              << " MB/s, scalar " << scalarMbps << " MB/s" << std::endl;
+    
+    std::string damaged = prompt;
+    damaged[damaged.size() / 2] = '\xFF';
+    EXPECT_FALSE(utf8::isValid(damaged));
+    EXPECT_GE(utf8::repair(damaged), 1u);
+    EXPECT_TRUE(utf8::isValid(damaged));
+}
+
+} // namespace test
+} // namespace inference
+} // namespace rkllmjs
+
+RKLLMJS_TEST_MAIN()
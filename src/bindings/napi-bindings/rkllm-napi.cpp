@@ -4,23 +4,49 @@
 #include "rkllm-napi.hpp"
 #include "../core/rkllm-manager.hpp"
 #include "../inference/inference-engine.hpp"
+#include "../config/config-manager.hpp"
+#include <algorithm>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 
 namespace rkllmjs {
 
 // Implementation for JSRKLLMManager
 class JSRKLLMManager::Impl {
 public:
+    // Guards every field below; loader threads publish through it
+    mutable std::mutex mutex;
     std::string current_model_id;
     rkllmjs::core::LLMHandle current_handle;
     bool initialized;
+    std::shared_ptr<rkllmjs::core::ModelLoadTask> pending_load;
+    std::shared_ptr<rkllmjs::core::PreloadTask> preload;
     
     Impl() : current_handle(nullptr), initialized(false) {}
+    
+    rkllmjs::core::LLMHandle activeHandle() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return initialized ? current_handle : nullptr;
+    }
 };
 
-JSRKLLMManager::JSRKLLMManager() : pImpl(std::make_unique<Impl>()) {}
+// The board's memory profile from configs/runtime.json; the manager applies it to every load
+static void applyBoardMemoryProfile(rkllmjs::core::RKLLMManager& manager) {
+    rkllmjs::config::MemoryProfile profile = rkllmjs::config::ConfigManager::getMemoryProfileForHardware();
+    rkllmjs::core::MemoryProfile settings;
+    settings.embed_flash = profile.embed_flash;
+    settings.memory_budget_mb = static_cast<size_t>(std::max(0, profile.memory_budget_mb));
+    settings.n_keep = profile.n_keep;
+    settings.kv_bytes_per_token = static_cast<size_t>(std::max(0, profile.kv_bytes_per_token));
+    manager.setMemoryProfile(settings);
+}
 
-JSRKLLMManager::~JSRKLLMManager() = default;
+JSRKLLMManager::JSRKLLMManager() : pImpl(std::make_shared<Impl>()) {}
+
+JSRKLLMManager::~JSRKLLMManager() {
+    cleanup();
+}
 
 bool JSRKLLMManager::initializeModel(const std::string& modelPath) {
     // Get singleton manager
@@ -31,23 +57,177 @@ bool JSRKLLMManager::initializeModel(const std::string& modelPath) {
     if (result != rkllmjs::core::ManagerResult::SUCCESS) {
         return false;
     }
+    applyBoardMemoryProfile(manager);
     
     // Create model config
     auto config = rkllmjs::core::RKLLMManager::createDefaultConfig();
     config.model_path = modelPath;
     
     // Create model
-    result = manager.createModel(config, &pImpl->current_handle);
-    if (result == rkllmjs::core::ManagerResult::SUCCESS) {
-        pImpl->initialized = true;
-        return true;
+    rkllmjs::core::LLMHandle handle = nullptr;
+    result = manager.createModel(config, &handle);
+    if (result != rkllmjs::core::ManagerResult::SUCCESS) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->current_handle = handle;
+    pImpl->initialized = true;
+    return true;
+}
+
+std::future<bool> JSRKLLMManager::initializeModelAsync(const std::string& modelPath,
+                                                      std::function<void(const std::string&, float)> onProgress,
+                                                      std::function<void(bool)> onDone) {
+    auto& manager = rkllmjs::core::RKLLMManager::getInstance();
+    
+    if (manager.initialize() != rkllmjs::core::ManagerResult::SUCCESS) {
+        if (onDone) {
+            onDone(false);
+        }
+        std::promise<bool> failed;
+        failed.set_value(false);
+        return failed.get_future();
+    }
+    applyBoardMemoryProfile(manager);
+    
+    auto config = rkllmjs::core::RKLLMManager::createDefaultConfig();
+    config.model_path = modelPath;
+    
+    // Translate load progress into stage names for the JS side
+    rkllmjs::core::LoadProgressCallback progress;
+    if (onProgress) {
+        progress = [onProgress](const rkllmjs::core::LoadProgress& event) {
+            onProgress(rkllmjs::core::RKLLMManager::getLoadStageName(event.stage), event.progress);
+        };
+    }
+    
+    // Completion publishes on the loader thread; it holds the shared state, never this
+    auto done = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = done->get_future();
+    std::shared_ptr<Impl> state = pImpl;
+    
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->pending_load = manager.createModelAsync(config, progress,
+        [state, done, onDone](rkllmjs::core::ManagerResult result, rkllmjs::core::LLMHandle handle) {
+            bool loaded = result == rkllmjs::core::ManagerResult::SUCCESS;
+            if (loaded) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->current_handle = handle;
+                state->initialized = true;
+            }
+            if (onDone) {
+                onDone(loaded);
+            }
+            done->set_value(loaded);
+        });
+    return future;
+}
+
+bool JSRKLLMManager::cancelInitialization() {
+    std::shared_ptr<rkllmjs::core::ModelLoadTask> task;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        task = pImpl->pending_load;
+    }
+    if (!task || task->isDone()) {
+        return false;
+    }
+    task->cancel();
+    return true;
+}
+
+std::future<bool> JSRKLLMManager::preloadModels(const std::string& configFile) {
+    auto& manager = rkllmjs::core::RKLLMManager::getInstance();
+    
+    if (manager.initialize() != rkllmjs::core::ManagerResult::SUCCESS ||
+        !rkllmjs::config::ConfigManager::loadConfig(configFile)) {
+        std::promise<bool> failed;
+        failed.set_value(false);
+        return failed.get_future();
+    }
+    
+    // Each listed model loads with the board's memory profile
+    applyBoardMemoryProfile(manager);
+    rkllmjs::config::PreloadConfig preload = rkllmjs::config::ConfigManager::getPreloadConfig();
+    std::vector<rkllmjs::core::PreloadRequest> requests;
+    for (const auto& id : preload.models) {
+        rkllmjs::config::ModelConfig model = rkllmjs::config::ConfigManager::getModel(id);
+        
+        rkllmjs::core::PreloadRequest request;
+        request.id = id;
+        request.memory_mb = static_cast<size_t>(std::max(0, model.size_mb));
+        request.config = rkllmjs::core::RKLLMManager::createDefaultConfig();
+        request.config.model_path = rkllmjs::config::ConfigManager::resolvePath(model.path);
+        request.config.max_context_len = model.max_context_len;
+        request.config.max_new_tokens = model.max_new_tokens;
+        request.config.top_k = model.top_k;
+        request.config.top_p = model.top_p;
+        request.config.temperature = model.temperature;
+        request.config.repeat_penalty = model.repeat_penalty;
+        request.config.npu_core_num = std::max(1, model.min_npu_cores); // Leave cores for parallel loads
+        requests.push_back(request);
     }
     
-    return false;
+    // The first resident model serves generateText when nothing else was loaded;
+    // the coordinator publishes it under the lock before the preload counts as done
+    auto done = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = done->get_future();
+    std::shared_ptr<Impl> state = pImpl;
+    
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->preload = manager.preloadModels(requests, preload.max_parallel,
+        [state, done](const rkllmjs::core::PreloadReport& report) {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->current_handle) {
+                    for (const auto& model : report.models) {
+                        if (model.result == rkllmjs::core::ManagerResult::SUCCESS && model.handle) {
+                            state->current_handle = model.handle;
+                            state->current_model_id = model.id;
+                            state->initialized = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            done->set_value(report.ready);
+        });
+    return future;
+}
+
+bool JSRKLLMManager::isReady() const {
+    return rkllmjs::core::RKLLMManager::getInstance().isReady();
+}
+
+std::string JSRKLLMManager::getPreloadReport() const {
+    std::shared_ptr<rkllmjs::core::PreloadTask> task;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        task = pImpl->preload;
+    }
+    if (!task) {
+        return "{}";
+    }
+    
+    rkllmjs::core::PreloadReport report = task->getReport();
+    std::ostringstream json;
+    json << "{\"ready\":" << (report.ready ? "true" : "false")
+         << ",\"done\":" << (report.done ? "true" : "false")
+         << ",\"totalMs\":" << report.total_ms << ",\"models\":[";
+    for (size_t i = 0; i < report.models.size(); ++i) {
+        const auto& model = report.models[i];
+        json << (i > 0 ? "," : "") << "{\"id\":\"" << model.id << "\""
+             << ",\"status\":\"" << (model.done ? rkllmjs::core::RKLLMManager::getErrorMessage(model.result) : "Loading") << "\""
+             << ",\"queuedMs\":" << model.queued_ms << ",\"loadMs\":" << model.load_ms << "}";
+    }
+    json << "]}";
+    return json.str();
 }
 
 std::string JSRKLLMManager::generateText(const std::string& prompt) {
-    if (!pImpl->initialized || !pImpl->current_handle) {
+    rkllmjs::core::LLMHandle handle = pImpl->activeHandle();
+    if (!handle) {
         return "";
     }
     
@@ -59,7 +239,7 @@ std::string JSRKLLMManager::generateText(const std::string& prompt) {
     rkllmjs::inference::InferenceEngine engine(manager_ptr);
     
     // Set the model handle for inference
-    engine.setModelHandle(pImpl->current_handle);
+    engine.setModelHandle(handle);
     
     // Set up inference parameters
     rkllmjs::inference::InferenceParams params;
@@ -79,15 +259,40 @@ std::string JSRKLLMManager::generateText(const std::string& prompt) {
 }
 
 void JSRKLLMManager::cleanup() {
-    if (pImpl->initialized && pImpl->current_handle) {
-        auto& manager = rkllmjs::core::RKLLMManager::getInstance();
-        manager.destroyModel(pImpl->current_handle);
+    // Cancel loads in flight and wait for them, so they cannot publish after cleanup
+    std::shared_ptr<rkllmjs::core::ModelLoadTask> load;
+    std::shared_ptr<rkllmjs::core::PreloadTask> preload;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        load.swap(pImpl->pending_load);
+        preload = pImpl->preload;
+    }
+    if (load) {
+        load->cancel();
+        load->wait();
+    }
+    if (preload) {
+        preload->cancel();
+        preload->wait();
+    }
+    
+    rkllmjs::core::LLMHandle handle = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        if (pImpl->initialized) {
+            handle = pImpl->current_handle;
+        }
         pImpl->current_handle = nullptr;
+        pImpl->current_model_id.clear();
         pImpl->initialized = false;
     }
+    if (handle) {
+        rkllmjs::core::RKLLMManager::getInstance().destroyModel(handle);
+    }
 }
 
 bool JSRKLLMManager::isInitialized() const {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
     return pImpl->initialized;
 }
 
@@ -152,6 +357,46 @@ napi_status InitRKLLMBindings(napi_env env, napi_value exports) {
     status = napi_set_named_property(env, exports, "testBindings", test_fn);
     if (status != napi_ok) return status;
     
+    // loadModelAsync(path, callback): the load completes on the loader thread and
+    // reaches JS through a threadsafe function, never by blocking the event loop
+    napi_value load_fn;
+    status = napi_create_function(env, nullptr, 0,
+        [](napi_env env, napi_callback_info info) -> napi_value {
+            size_t argc = 2;
+            napi_value argv[2];
+            napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+            
+            char path[4096];
+            size_t length = 0;
+            napi_get_value_string_utf8(env, argv[0], path, sizeof(path), &length);
+            
+            napi_value name;
+            napi_create_string_utf8(env, "loadModelAsync", NAPI_AUTO_LENGTH, &name);
+            napi_threadsafe_function done;
+            napi_create_threadsafe_function(env, argv[1], nullptr, name, 0, 1, nullptr, nullptr, nullptr,
+                [](napi_env env, napi_value callback, void*, void* data) {
+                    napi_value loaded, undefined;
+                    napi_get_boolean(env, data != nullptr, &loaded);
+                    napi_get_undefined(env, &undefined);
+                    napi_call_function(env, undefined, callback, 1, &loaded, nullptr);
+                }, &done);
+            
+            static JSRKLLMManager manager; // Lives for the process; its destructor joins the load
+            manager.initializeModelAsync(std::string(path, length), nullptr, [done](bool loaded) {
+                napi_call_threadsafe_function(done, loaded ? done : nullptr, napi_tsfn_blocking);
+                napi_release_threadsafe_function(done, napi_tsfn_release);
+            });
+            
+            napi_value undefined;
+            napi_get_undefined(env, &undefined);
+            return undefined;
+        }, nullptr, &load_fn);
+    
+    if (status != napi_ok) return status;
+    
+    status = napi_set_named_property(env, exports, "loadModelAsync", load_fn);
+    if (status != napi_ok) return status;
+    
     return napi_ok;
 }
 
@@ -13,6 +13,8 @@
 #include "../config/build-config.hpp"
 #include <string>
 #include <memory>
+#include <functional>
+#include <future>
 
 namespace rkllmjs {
 namespace napi {
@@ -22,7 +24,7 @@ namespace napi {
     // N-API headers are available when building actual bindings
     /*
     #include <node_api.h>
-
+    
     // N-API module initialization function
     napi_status InitRKLLMBindings(napi_env env, napi_value exports);
     */
@@ -37,7 +39,7 @@ namespace napi {
 class JSRKLLMManager {
 private:
     class Impl;
-    std::unique_ptr<Impl> pImpl;
+    std::shared_ptr<Impl> pImpl;       // Shared with load completions that outlive a call
 
 public:
     JSRKLLMManager();
@@ -45,6 +47,20 @@ public:
     
     // Core functionality
     bool initializeModel(const std::string& modelPath);
+    
+    // Non-blocking model load; onProgress receives (stage, fraction 0-1) and onDone the outcome,
+    // both on the loader thread (wrap them in a ThreadSafeFunction to reach JS). The future never
+    // blocks on destruction; cleanup() and the destructor cancel the load and wait for it.
+    std::future<bool> initializeModelAsync(const std::string& modelPath,
+                                           std::function<void(const std::string&, float)> onProgress = nullptr,
+                                           std::function<void(bool)> onDone = nullptr);
+    bool cancelInitialization();
+    
+    // Load the "preload" list of configs/runtime.json in parallel; resolves true once all are resident
+    std::future<bool> preloadModels(const std::string& configFile = "configs/runtime.json");
+    bool isReady() const;
+    std::string getPreloadReport() const; // JSON with per-model and total startup times
+    
     std::string generateText(const std::string& prompt);
     void cleanup();
     bool isInitialized() const;